@@ -109,3 +109,14 @@ QStringList SyncClientInterface::syncProfilesByType(const QString &aType)
 {
     return d_ptr->syncProfilesByType(aType);
 }
+
+bool SyncClientInterface::subscribeStatus(const QStringList &aProfileIds,
+                                          const QList<unsigned int> &aAccountIds)
+{
+    return d_ptr->subscribeStatus(aProfileIds, aAccountIds);
+}
+
+void SyncClientInterface::unsubscribeStatus()
+{
+    d_ptr->unsubscribeStatus();
+}
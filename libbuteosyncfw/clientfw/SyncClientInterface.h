@@ -188,6 +188,27 @@ public:
      * \return The sync profile ids as string list.
      */
     QStringList syncProfilesByType(const QString &aType);
+
+    /*!
+     * \brief Follows the sync status of the given profiles and accounts only
+     * After this call syncStatus and transferProgress are no longer received
+     * as broadcasts for all profiles. msyncd sends them privately to this
+     * client, for the followed profiles only, in order and batched, with
+     * progress coalesced. A coalesced transferProgress carries the sum of the
+     * committed items. The subscription is renewed automatically if msyncd
+     * restarts. Calling this again replaces the followed profiles.
+     * \param aProfileIds Ids of the profiles to follow.
+     * \param aAccountIds Ids of the accounts whose profiles to follow.
+     * \return True if the subscription was sent.
+     */
+    bool subscribeStatus(const QStringList &aProfileIds,
+                         const QList<unsigned int> &aAccountIds = QList<unsigned int>());
+
+    /*!
+     * \brief Ends the status subscription
+     * syncStatus and transferProgress are received as broadcasts again.
+     */
+    void unsubscribeStatus();
 signals:
 
 	/*! \brief Notifies about Backup start.
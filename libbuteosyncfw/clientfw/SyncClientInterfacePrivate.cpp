@@ -30,13 +30,16 @@
 #include "SyncClientInterfacePrivate.h"
 #include "SyncClientInterface.h"
 #include "LogMacros.h"
+#include "ProfileEngineDefs.h"
 
 using namespace Buteo;
 
 static const QString SYNC_DBUS_OBJECT = "/synchronizer";
 static const QString SYNC_DBUS_SERVICE = "com.meego.msyncd";
+static const QString STATUS_LISTENER_PATH = "/com/meego/msyncd/statuslistener";
 
 SyncClientInterfacePrivate::SyncClientInterfacePrivate(SyncClientInterface *aParent) :
+            iDaemonWatcher(0),
             iParent(aParent)
 {
     FUNCTION_CALL_TRACE;
@@ -55,11 +58,13 @@ SyncClientInterfacePrivate::SyncClientInterfacePrivate(SyncClientInterface *aPar
 		connect(this,SIGNAL(resultsAvailable(QString,Buteo::SyncResults)),
 				iParent,SIGNAL(resultsAvailable(QString,Buteo::SyncResults)));
 
-		connect	(iSyncDaemon,SIGNAL(syncStatus(QString,int,QString,int)),
-				iParent,SIGNAL(syncStatus(QString,int,QString,int)));
+		connectBroadcasts(true);
 
-		connect(iSyncDaemon,SIGNAL(transferProgress(QString,int,int,QString,int)),
-				iParent,SIGNAL(transferProgress(QString,int,int,QString,int)));
+		connect(this, SIGNAL(statusUpdate(QString,int,QString,int)),
+				iParent, SIGNAL(syncStatus(QString,int,QString,int)));
+
+		connect(this, SIGNAL(progressUpdate(QString,int,int,QString,int)),
+				iParent, SIGNAL(transferProgress(QString,int,int,QString,int)));
 
 		connect(iSyncDaemon, SIGNAL(backupInProgress()),
 				iParent, SIGNAL(backupInProgress()));
@@ -80,6 +85,7 @@ SyncClientInterfacePrivate::SyncClientInterfacePrivate(SyncClientInterface *aPar
 SyncClientInterfacePrivate::~SyncClientInterfacePrivate()
 {
     FUNCTION_CALL_TRACE;
+	unsubscribeStatus();
 	delete iSyncDaemon;
 	iSyncDaemon = NULL;
 }
@@ -275,3 +281,115 @@ QStringList SyncClientInterfacePrivate::syncProfilesByType(const QString &aType)
     
     return profileIds;
 }
+
+bool SyncClientInterfacePrivate::subscribeStatus(const QStringList &aProfileIds,
+        const QList<unsigned int> &aAccountIds)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iSyncDaemon == 0) {
+        return false;
+    }
+
+    if (iListenerPath.isEmpty()) {
+        // Each client interface in the process gets its own listener.
+        static QAtomicInt listenerCount;
+        QString path = STATUS_LISTENER_PATH + "/" +
+                QString::number(listenerCount.fetchAndAddOrdered(1));
+        if (!QDBusConnection::sessionBus().registerObject(path, this,
+                QDBusConnection::ExportScriptableSlots)) {
+            LOG_WARNING("Failed to register status listener" << path);
+            return false;
+        }
+        iListenerPath = path;
+        connectBroadcasts(false);
+
+        if (iDaemonWatcher == 0) {
+            iDaemonWatcher = new QDBusServiceWatcher(SYNC_DBUS_SERVICE,
+                    QDBusConnection::sessionBus(),
+                    QDBusServiceWatcher::WatchForRegistration, this);
+            connect(iDaemonWatcher, SIGNAL(serviceRegistered(const QString &)),
+                    this, SLOT(onDaemonRegistered()));
+        }
+    }
+
+    iFollowedProfiles = aProfileIds;
+    iFollowedAccounts = aAccountIds;
+    iSyncDaemon->subscribeStatus(iListenerPath, iFollowedProfiles, iFollowedAccounts);
+    return true;
+}
+
+void SyncClientInterfacePrivate::unsubscribeStatus()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iListenerPath.isEmpty()) {
+        return;
+    }
+
+    if (iSyncDaemon) {
+        iSyncDaemon->unsubscribeStatus(iListenerPath);
+    }
+    QDBusConnection::sessionBus().unregisterObject(iListenerPath);
+    iListenerPath.clear();
+    iFollowedProfiles.clear();
+    iFollowedAccounts.clear();
+    delete iDaemonWatcher;
+    iDaemonWatcher = 0;
+    connectBroadcasts(true);
+}
+
+void SyncClientInterfacePrivate::statusUpdates(const QString &aUpdatesAsXml)
+{
+    FUNCTION_CALL_TRACE;
+
+    QDomDocument doc;
+    if (!doc.setContent(aUpdatesAsXml)) {
+        LOG_DEBUG("Invalid status update Xml Received from msyncd");
+        return;
+    }
+
+    QDomElement update = doc.documentElement().firstChildElement();
+    for (; !update.isNull(); update = update.nextSiblingElement()) {
+        QString profileId = update.attribute(ATTR_NAME);
+        if (update.tagName() == TAG_STATUS) {
+            emit statusUpdate(profileId, update.attribute(ATTR_STATUS).toInt(),
+                    update.attribute(ATTR_MESSAGE),
+                    update.attribute(ATTR_DETAILS).toInt());
+        } else if (update.tagName() == TAG_PROGRESS) {
+            emit progressUpdate(profileId, update.attribute(ATTR_DATABASE).toInt(),
+                    update.attribute(ATTR_TYPE).toInt(),
+                    update.attribute(ATTR_MIME_TYPE),
+                    update.attribute(ATTR_ITEMS).toInt());
+        }
+    }
+}
+
+void SyncClientInterfacePrivate::onDaemonRegistered()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iSyncDaemon && !iListenerPath.isEmpty()) {
+        LOG_DEBUG("msyncd started, renewing status subscription");
+        iSyncDaemon->subscribeStatus(iListenerPath, iFollowedProfiles, iFollowedAccounts);
+    }
+}
+
+void SyncClientInterfacePrivate::connectBroadcasts(bool aConnect)
+{
+    FUNCTION_CALL_TRACE;
+
+    // Disconnecting the proxy signals also removes the bus match rules, so
+    // that broadcasts no longer wake up a subscribed client.
+    if (aConnect) {
+        connect(iSyncDaemon, SIGNAL(syncStatus(QString,int,QString,int)),
+                iParent, SIGNAL(syncStatus(QString,int,QString,int)));
+        connect(iSyncDaemon, SIGNAL(transferProgress(QString,int,int,QString,int)),
+                iParent, SIGNAL(transferProgress(QString,int,int,QString,int)));
+    } else {
+        disconnect(iSyncDaemon, SIGNAL(syncStatus(QString,int,QString,int)),
+                iParent, SIGNAL(syncStatus(QString,int,QString,int)));
+        disconnect(iSyncDaemon, SIGNAL(transferProgress(QString,int,int,QString,int)),
+                iParent, SIGNAL(transferProgress(QString,int,int,QString,int)));
+    }
+}
@@ -39,6 +39,7 @@ class SyncClientInterface;
 class SyncClientInterfacePrivate:public QObject
 {
 	Q_OBJECT
+	Q_CLASSINFO("D-Bus Interface", "com.meego.msyncd.StatusListener")
 public:
 	/*!\brief Constructor
 	 *
@@ -155,8 +156,30 @@ public:
      */
     QStringList syncProfilesByType(const QString &aType);
 
+    /*! \brief Subscribes to the status of profiles and accounts
+     * @param aProfileIds - ids of the profiles to follow
+     * @param aAccountIds - ids of the accounts to follow
+     * @return True if the subscription was sent
+     */
+    bool subscribeStatus(const QStringList &aProfileIds,
+                         const QList<unsigned int> &aAccountIds);
+
+    /*! \brief Ends the status subscription
+     */
+    void unsubscribeStatus();
+
 public slots:
 
+    /*! \brief this is the slot where msyncd delivers subscribed status updates
+     * \code <statusupdates>
+     *  <status name="ovi.com-sr1" status="1" message="" details="0"/>
+     *  <progress name="ovi.com-sr1" database="0" type="0" mimetype="text/x-vcard" items="4"/>
+     * </statusupdates>
+     * \endcode
+     * @param aUpdatesAsXml - batch of updates as xml
+     */
+    Q_SCRIPTABLE Q_NOREPLY void statusUpdates(const QString &aUpdatesAsXml);
+
 	/*! \brief this is the slot where we will receive the xml data for profile from msyncd.
 	 * The XML Data received will be of the following format
 	 * \code <?xml version="1.0" encoding="UTF-8"?>
@@ -197,6 +220,11 @@ public slots:
 	 */
 	void resultsAvailable(QString aProfileId , QString aLastSyncResultAsXml);
 
+private slots:
+
+    // Renews the subscription when msyncd is started again
+    void onDaemonRegistered();
+
 signals:
 
 	/*! \brief Signal that gets emitted on receiving profileChanged from msyncd
@@ -214,10 +242,29 @@ signals:
 	 */
 	void resultsAvailable(QString aProfileId,Buteo::SyncResults aLastResults);
 
+	//! Subscribed status change, relayed as SyncClientInterface::syncStatus
+	void statusUpdate(QString aProfileId, int aStatus, QString aMessage,
+	                  int aStatusDetails);
+
+	//! Subscribed transfer progress, relayed as SyncClientInterface::transferProgress
+	void progressUpdate(QString aProfileId, int aTransferDatabase,
+	                    int aTransferType, QString aMimeType, int aCommittedItems);
+
 private:
 
+	void connectBroadcasts(bool aConnect);
+
 	SyncDaemonProxy *iSyncDaemon;
 
+	//! Object path of the status listener, empty if not subscribed
+	QString iListenerPath;
+
+	QStringList iFollowedProfiles;
+
+	QList<unsigned int> iFollowedAccounts;
+
+	QDBusServiceWatcher *iDaemonWatcher;
+
 	Buteo::SyncClientInterface *iParent;
 
 };
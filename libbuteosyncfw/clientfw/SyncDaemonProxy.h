@@ -147,6 +147,15 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("removeProfile"), argumentList);
     }
 
+    //! \see SyncDBusInterface::reportTargetResults()
+    inline Q_NOREPLY void reportTargetResults(const QString &aProfileId,
+                                              const QString &aTargetResults)
+    {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(aProfileId) << qVariantFromValue(aTargetResults);
+        callWithArgumentList(QDBus::NoBlock, QLatin1String("reportTargetResults"), argumentList);
+    }
+
     //! \see SyncDBusInterface::requestStorages()
     inline QDBusPendingReply<bool> requestStorages(const QStringList &aStorageNames)
     {
@@ -178,6 +187,14 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("setSyncSchedule"), argumentList);
     }
 
+    //! \see SyncDBusInterface::setForegroundActive()
+    inline Q_NOREPLY void setForegroundActive(bool aActive)
+    {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(aActive);
+        callWithArgumentList(QDBus::NoBlock, QLatin1String("setForegroundActive"), argumentList);
+    }
+
     //! \see SyncDBusInterface::startSync()
     inline QDBusPendingReply<bool> startSync(const QString &aProfileId)
     {
@@ -186,6 +203,17 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("startSync"), argumentList);
     }
 
+    //! \see SyncDBusInterface::subscribeStatus()
+    inline Q_NOREPLY void subscribeStatus(const QString &aListenerPath,
+                                          const QStringList &aProfileIds,
+                                          const QList<uint> &aAccountIds)
+    {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(aListenerPath) << qVariantFromValue(aProfileIds)
+                     << qVariantFromValue(aAccountIds);
+        callWithArgumentList(QDBus::NoBlock, QLatin1String("subscribeStatus"), argumentList);
+    }
+
     //! \see SyncDBusInterface::syncProfile()
     inline QDBusPendingReply<QString> syncProfile(const QString &aProfileId)
     {
@@ -210,6 +238,14 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("syncProfilesByType"), argumentList);
     }
 
+    //! \see SyncDBusInterface::unsubscribeStatus()
+    inline Q_NOREPLY void unsubscribeStatus(const QString &aListenerPath)
+    {
+        QList<QVariant> argumentList;
+        argumentList << qVariantFromValue(aListenerPath);
+        callWithArgumentList(QDBus::NoBlock, QLatin1String("unsubscribeStatus"), argumentList);
+    }
+
     //! \see SyncDBusInterface::updateProfile()
     inline QDBusPendingReply<bool> updateProfile(const QString &aProfileAsXml)
     {
@@ -232,6 +268,9 @@ Q_SIGNALS: // SIGNALS
     //! \see SyncDBusInterface::restoreInProgress()
     void restoreInProgress();
 
+    //! \see SyncDBusInterface::deviceActivityChanged()
+    void deviceActivityChanged(int aActivity, bool aCharging);
+
     //! \see SyncDBusInterface::resultsAvailable()
     void resultsAvailable(const QString &aProfileName, const QString &aResultsAsXml);
 
@@ -11,6 +11,8 @@ VER_PAT = 0
 QT += sql xml dbus network
 QT -= gui
 
+LIBS += -lz
+
 CONFIG += dll \
     create_pc \
     create_prl
@@ -27,21 +29,29 @@ HEADERS += common/Logger.h \
            clientfw/SyncClientInterfacePrivate.h \
            clientfw/SyncDaemonProxy.h \
            pluginmgr/ClientPlugin.h \
+           pluginmgr/CompressedTransport.h \
+           pluginmgr/ConflictResolver.h \
            pluginmgr/DeletedItemsIdStorage.h \
+           pluginmgr/FingerprintCache.h \
+           pluginmgr/PayloadCompressor.h \
            pluginmgr/PluginCbInterface.h \
            pluginmgr/PluginManager.h \
+           pluginmgr/ProcessLimits.h \
            pluginmgr/ServerPlugin.h \
            pluginmgr/StorageChangeNotifierPlugin.h \
            pluginmgr/StorageItem.h \
            pluginmgr/StoragePlugin.h \
            pluginmgr/SyncPluginBase.h \
+           pluginmgr/WritePacer.h \
            profile/BtHelper.h \
            profile/Profile.h \
            profile/Profile_p.h \
            profile/ProfileEngineDefs.h \
+           profile/ProfileCodec.h \
            profile/ProfileFactory.h \
            profile/ProfileField.h \
            profile/ProfileManager.h \
+           profile/ProfileService.h \
            profile/StorageProfile.h \
            profile/SyncLog.h \
            profile/SyncProfile.h \
@@ -59,17 +69,25 @@ SOURCES += common/Logger.cpp \
            clientfw/SyncClientInterfacePrivate.cpp \
            clientfw/SyncDaemonProxy.cpp \
            pluginmgr/ClientPlugin.cpp \
+           pluginmgr/CompressedTransport.cpp \
+           pluginmgr/ConflictResolver.cpp \
            pluginmgr/DeletedItemsIdStorage.cpp \
+           pluginmgr/FingerprintCache.cpp \
+           pluginmgr/PayloadCompressor.cpp \
            pluginmgr/PluginManager.cpp \
+           pluginmgr/ProcessLimits.cpp \
            pluginmgr/ServerPlugin.cpp \
            pluginmgr/StorageItem.cpp \
            pluginmgr/StoragePlugin.cpp \
            pluginmgr/SyncPluginBase.cpp \
+           pluginmgr/WritePacer.cpp \
            profile/BtHelper.cpp \
            profile/Profile.cpp \
+           profile/ProfileCodec.cpp \
            profile/ProfileFactory.cpp \
            profile/ProfileField.cpp \
            profile/ProfileManager.cpp \
+           profile/ProfileService.cpp \
            profile/StorageProfile.cpp \
            profile/SyncLog.cpp \
            profile/SyncProfile.cpp \
@@ -120,14 +138,20 @@ headers.files = common/Logger.h \
            clientfw/SyncClientInterfacePrivate.h \
            clientfw/SyncDaemonProxy.h \
            pluginmgr/ClientPlugin.h \
+           pluginmgr/CompressedTransport.h \
+           pluginmgr/ConflictResolver.h \
            pluginmgr/DeletedItemsIdStorage.h \
+           pluginmgr/FingerprintCache.h \
+           pluginmgr/PayloadCompressor.h \
            pluginmgr/PluginCbInterface.h \
            pluginmgr/PluginManager.h \
+           pluginmgr/ProcessLimits.h \
            pluginmgr/ServerPlugin.h \
            pluginmgr/StorageChangeNotifierPlugin.h \
            pluginmgr/StorageItem.h \
            pluginmgr/StoragePlugin.h \
            pluginmgr/SyncPluginBase.h \
+           pluginmgr/WritePacer.h \
            pluginmgr/PluginServiceObj.h \
            pluginmgr/ButeoPluginIfaceAdaptor.h \
            pluginmgr/ButeoPluginIface.h \
@@ -136,9 +160,11 @@ headers.files = common/Logger.h \
            profile/Profile.h \
            profile/Profile_p.h \
            profile/ProfileEngineDefs.h \
+           profile/ProfileCodec.h \
            profile/ProfileFactory.h \
            profile/ProfileField.h \
            profile/ProfileManager.h \
+           profile/ProfileService.h \
            profile/StorageProfile.h \
            profile/SyncLog.h \
            profile/SyncProfile.h \
@@ -106,6 +106,12 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("uninit"), argumentList);
     }
 
+    inline QDBusPendingReply<bool> yieldSync()
+    {
+        QList<QVariant> argumentList;
+        return asyncCallWithArgumentList(QLatin1String("yieldSync"), argumentList);
+    }
+
 Q_SIGNALS: // SIGNALS
     void accquiredStorage(const QString &aMimeType);
     void error(const QString &aProfileName, const QString &aMessage, int aErrorCode);
@@ -111,3 +111,11 @@ bool ButeoPluginIfaceAdaptor::uninit()
     return out0;
 }
 
+bool ButeoPluginIfaceAdaptor::yieldSync()
+{
+    // handle method call com.buteo.msyncd.baseplugin.yieldSync
+    bool out0;
+    QMetaObject::invokeMethod(parent(), "yieldSync", Q_RETURN_ARG(bool, out0));
+    return out0;
+}
+
@@ -77,6 +77,9 @@ class ButeoPluginIfaceAdaptor: public QDBusAbstractAdaptor
 "    <method name=\"startSync\">\n"
 "      <arg direction=\"out\" type=\"b\"/>\n"
 "    </method>\n"
+"    <method name=\"yieldSync\">\n"
+"      <arg direction=\"out\" type=\"b\"/>\n"
+"    </method>\n"
 "    <signal name=\"newSession\">\n"
 "      <arg direction=\"out\" type=\"s\" name=\"aDestination\"/>\n"
 "    </signal>\n"
@@ -105,6 +108,7 @@ public Q_SLOTS: // METHODS
     void stopListen();
     void suspend();
     bool uninit();
+    bool yieldSync();
 Q_SIGNALS: // SIGNALS
     void accquiredStorage(const QString &aMimeType);
     void error(const QString &aProfileName, const QString &aMessage, int aErrorCode);
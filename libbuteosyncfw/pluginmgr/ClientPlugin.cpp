@@ -21,9 +21,22 @@
  *
  */
 #include "ClientPlugin.h"
+#include "FingerprintCache.h"
+#include "SyncCommonDefs.h"
+#include "LogMacros.h"
+#include <QDir>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
 
 using namespace Buteo;
 
+// Fingerprint caches of the existing client plugins, by storage name. They
+// are kept outside the objects so that the object layout stays the same for
+// plugins built against older headers.
+static QMutex cacheMutex;
+static QHash<const ClientPlugin*, QMap<QString, FingerprintCache*> > fingerprintCaches;
+
 ClientPlugin::ClientPlugin( const QString& aPluginName,
                             const SyncProfile& aProfile,
                             PluginCbInterface *aCbInterface )
@@ -34,5 +47,30 @@ ClientPlugin::ClientPlugin( const QString& aPluginName,
 
 ClientPlugin::~ClientPlugin()
 {
+    QMutexLocker locker( &cacheMutex );
+    qDeleteAll( fingerprintCaches.take( this ) );
+}
+
+FingerprintCache *ClientPlugin::fingerprintCache( const QString &aStorageName )
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker( &cacheMutex );
+    QMap<QString, FingerprintCache*> &caches = fingerprintCaches[this];
+    if( caches.contains( aStorageName ) ) {
+        return caches.value( aStorageName );
+    }
+
+    QDir().mkpath( Sync::syncCacheDir() );
+    const QString dbFile = Sync::syncCacheDir() + QDir::separator() + "fingerprints.db";
+
+    FingerprintCache *cache = new FingerprintCache;
+    if( !cache->init( dbFile, iProfile.name(), aStorageName ) ) {
+        LOG_WARNING( "Could not initialize fingerprint cache for" << aStorageName );
+        delete cache;
+        return 0;
+    }
 
+    caches.insert( aStorageName, cache );
+    return cache;
 }
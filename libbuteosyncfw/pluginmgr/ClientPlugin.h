@@ -30,6 +30,7 @@
 namespace Buteo {
 
 class PluginCbInterface;
+class FingerprintCache;
 
 /*! \brief Base class for client plugins
  *
@@ -67,6 +68,17 @@ public:
      */
     SyncProfile &profile() { return iProfile; }
 
+    /*! \brief Returns the fingerprint cache of a storage used by this profile
+     *
+     * The cache is created and loaded on first use and owned by the plugin.
+     * It can be passed to StoragePlugin::setFingerprintCache() so that slow
+     * syncs can skip items whose content has not changed.
+     *
+     * @param aStorageName Name of the storage backend
+     * @return Fingerprint cache, NULL if it could not be initialized
+     */
+    FingerprintCache *fingerprintCache( const QString &aStorageName );
+
 protected:
 
     //! Sync Profile Object that the plugin is currently operating on
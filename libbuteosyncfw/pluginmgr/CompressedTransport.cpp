@@ -0,0 +1,266 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "CompressedTransport.h"
+#include "PayloadCompressor.h"
+#include "StorageItem.h"
+#include "Profile.h"
+#include "SyncResults.h"
+#include "ProfileEngineDefs.h"
+#include "LogMacros.h"
+
+#include <QIODevice>
+#include <QMap>
+
+using namespace Buteo;
+
+const QString CompressedTransport::IDENTITY("identity");
+
+// Item data is read in chunks of this size.
+static const qint64 READ_CHUNK_SIZE = 32 * 1024;
+
+static const QString ENCODING_GZIP("gzip");
+static const QString ENCODING_DEFLATE("deflate");
+
+CompressedTransport::CompressedTransport( const Profile& aProfile )
+:   iLevel( -1 ),
+    iCompressor( 0 ),
+    iOutput( 0 ),
+    iUncompressedBytes( 0 ),
+    iCompressedBytes( 0 ),
+    iReportedUncompressedBytes( 0 ),
+    iReportedCompressedBytes( 0 )
+{
+    FUNCTION_CALL_TRACE;
+
+    QStringList encodings = aProfile.key( KEY_COMPRESSION ).split( ',', QString::SkipEmptyParts );
+    foreach( QString encoding, encodings ) {
+        encoding = encoding.trimmed().toLower();
+        if( !encoding.isEmpty() && !iAcceptedEncodings.contains( encoding ) ) {
+            iAcceptedEncodings.append( encoding );
+        }
+    }
+
+    bool ok = false;
+    int level = aProfile.key( KEY_COMPRESSION_LEVEL ).toInt( &ok );
+    if( ok ) {
+        iLevel = level;
+    }
+}
+
+CompressedTransport::~CompressedTransport()
+{
+    FUNCTION_CALL_TRACE;
+
+    delete iCompressor;
+    iCompressor = 0;
+}
+
+QStringList CompressedTransport::supportedEncodings()
+{
+    return QStringList() << ENCODING_GZIP << ENCODING_DEFLATE;
+}
+
+QStringList CompressedTransport::acceptedEncodings() const
+{
+    return iAcceptedEncodings;
+}
+
+QString CompressedTransport::negotiate( const QStringList& aRemoteEncodings )
+{
+    FUNCTION_CALL_TRACE;
+
+    // Quality values by encoding, e.g. "gzip;q=0.5". An encoding with
+    // q=0 is refused, also when "*" would otherwise accept it.
+    QMap<QString, double> remote;
+    foreach( const QString& encoding, aRemoteEncodings ) {
+        double quality = 1.0;
+        QStringList params = encoding.split( ';' );
+        for( int i = 1; i < params.size(); ++i ) {
+            QString param = params.at( i ).trimmed().toLower();
+            if( param.startsWith( "q=" ) ) {
+                bool ok = false;
+                quality = param.mid( 2 ).toDouble( &ok );
+                if( !ok ) {
+                    quality = 0.0;
+                }
+            }
+        }
+        remote.insert( params.first().trimmed().toLower(), quality );
+    }
+
+    QString selected = IDENTITY;
+    foreach( const QString& encoding, iAcceptedEncodings ) {
+        if( !supportedEncodings().contains( encoding ) ) {
+            continue;
+        }
+        const double quality = remote.contains( encoding ) ?
+                               remote.value( encoding ) : remote.value( "*", 0.0 );
+        if( quality > 0.0 ) {
+            selected = encoding;
+            break;
+        }
+    }
+
+    setCompressor( createCompressor( selected ) );
+    LOG_DEBUG( "Selected payload encoding:" << selected );
+
+    return selected;
+}
+
+QString CompressedTransport::encoding() const
+{
+    return iCompressor ? iCompressor->encoding() : IDENTITY;
+}
+
+void CompressedTransport::setCompressor( PayloadCompressor* aCompressor )
+{
+    if( iCompressor != aCompressor ) {
+        delete iCompressor;
+        iCompressor = aCompressor;
+    }
+}
+
+bool CompressedTransport::begin( QIODevice& aOutput )
+{
+    FUNCTION_CALL_TRACE;
+
+    iOutput = &aOutput;
+
+    if( iCompressor && !iCompressor->begin() ) {
+        iOutput = 0;
+        return false;
+    }
+
+    return true;
+}
+
+bool CompressedTransport::write( const char* aData, qint64 aLength )
+{
+    if( !iOutput ) {
+        LOG_WARNING( "Payload not started" );
+        return false;
+    }
+
+    qint64 written = 0;
+    if( iCompressor ) {
+        written = iCompressor->compress( aData, aLength, *iOutput );
+    }
+    else {
+        written = iOutput->write( aData, aLength );
+        if( written != aLength ) {
+            written = -1;
+        }
+    }
+
+    if( written < 0 ) {
+        LOG_WARNING( "Could not write payload data" );
+        return false;
+    }
+
+    iUncompressedBytes += aLength;
+    iCompressedBytes += written;
+
+    return true;
+}
+
+bool CompressedTransport::writeItem( const StorageItem& aItem )
+{
+    FUNCTION_CALL_TRACE;
+
+    const qint64 size = aItem.getSize();
+    for( qint64 offset = 0; offset < size; offset += READ_CHUNK_SIZE ) {
+        // The read buffer is reused between chunks and items.
+        if( !aItem.read( offset, qMin( READ_CHUNK_SIZE, size - offset ), iReadBuffer ) ) {
+            LOG_WARNING( "Could not read data of item" << aItem.getId() );
+            return false;
+        }
+
+        if( !write( iReadBuffer.constData(), iReadBuffer.size() ) ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CompressedTransport::finish()
+{
+    FUNCTION_CALL_TRACE;
+
+    if( !iOutput ) {
+        LOG_WARNING( "Payload not started" );
+        return false;
+    }
+
+    bool success = true;
+    if( iCompressor ) {
+        qint64 written = iCompressor->finish( *iOutput );
+        if( written < 0 ) {
+            success = false;
+        }
+        else {
+            iCompressedBytes += written;
+        }
+    }
+
+    iOutput = 0;
+    return success;
+}
+
+qint64 CompressedTransport::uncompressedBytes() const
+{
+    return iUncompressedBytes;
+}
+
+qint64 CompressedTransport::compressedBytes() const
+{
+    return iCompressedBytes;
+}
+
+void CompressedTransport::reportTo( SyncResults& aResults )
+{
+    // Only what was written since the last report is added.
+    const qint64 uncompressed = iUncompressedBytes - iReportedUncompressedBytes;
+    const qint64 compressed = iCompressedBytes - iReportedCompressedBytes;
+    if( encoding() == IDENTITY || compressed == 0 ) {
+        return;
+    }
+
+    LOG_DEBUG( "Payload compressed from" << uncompressed << "to"
+               << compressed << "bytes" );
+    aResults.addCompressionStats( uncompressed, compressed );
+    iReportedUncompressedBytes = iUncompressedBytes;
+    iReportedCompressedBytes = iCompressedBytes;
+}
+
+PayloadCompressor* CompressedTransport::createCompressor( const QString& aEncoding ) const
+{
+    if( aEncoding == ENCODING_GZIP ) {
+        return new ZlibCompressor( ZlibCompressor::FORMAT_GZIP, iLevel );
+    }
+    else if( aEncoding == ENCODING_DEFLATE ) {
+        return new ZlibCompressor( ZlibCompressor::FORMAT_DEFLATE, iLevel );
+    }
+
+    return 0;
+}
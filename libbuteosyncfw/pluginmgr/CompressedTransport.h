@@ -0,0 +1,179 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef COMPRESSEDTRANSPORT_H
+#define COMPRESSEDTRANSPORT_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+
+class QIODevice;
+
+namespace Buteo {
+
+class Profile;
+class StorageItem;
+class SyncResults;
+class PayloadCompressor;
+
+/*! \brief Streams sync payloads through an optional compressor
+ *
+ * CompressedTransport is a helper for client plugins that send item data
+ * over HTTP or OBEX. The encodings accepted by the profile are read from the
+ * "compression" key, in order of preference, and matched against the
+ * encodings accepted by the remote side. Item data is then read from
+ * StorageItem objects in chunks and streamed through the selected
+ * compressor to the output device. If no common encoding is found, data is
+ * written as is.
+ *
+ * Payload sizes before and after compression are tracked and can be
+ * reported to SyncResults at the end of the session.
+ */
+class CompressedTransport
+{
+public:
+
+    //! Encoding name used when data is not compressed
+    static const QString IDENTITY;
+
+    /*! \brief Constructor
+     *
+     * Reads the accepted encodings and compression level from the profile.
+     * @param aProfile Profile of the sync session
+     */
+    explicit CompressedTransport( const Profile& aProfile );
+
+    /*! \brief Destructor
+     *
+     */
+    ~CompressedTransport();
+
+    /*! \brief Returns the encodings supported by the framework
+     *
+     * @return Encoding names
+     */
+    static QStringList supportedEncodings();
+
+    /*! \brief Returns the encodings accepted by the profile
+     *
+     * @return Encoding names in order of preference
+     */
+    QStringList acceptedEncodings() const;
+
+    /*! \brief Selects the encoding to use
+     *
+     * The first encoding accepted by the profile that is also accepted by
+     * the remote side and supported by the framework is selected. Remote
+     * encodings with a quality value of zero, e.g. "gzip;q=0", are not
+     * accepted.
+     * @param aRemoteEncodings Encodings accepted by the remote side, e.g.
+     *  parsed from an Accept-Encoding header
+     * @return Selected encoding, IDENTITY if none matched
+     */
+    QString negotiate( const QStringList& aRemoteEncodings );
+
+    /*! \brief Returns the selected encoding
+     *
+     * @return Encoding name
+     */
+    QString encoding() const;
+
+    /*! \brief Uses a custom compressor
+     *
+     * Ownership of the compressor is transferred. Replaces the compressor
+     * selected by negotiate().
+     * @param aCompressor Compressor to use, NULL to disable compression
+     */
+    void setCompressor( PayloadCompressor* aCompressor );
+
+    /*! \brief Starts a new payload
+     *
+     * @param aOutput Device where the encoded payload is written. Must stay
+     *  valid until finish() has been called.
+     * @return True on success, otherwise false
+     */
+    bool begin( QIODevice& aOutput );
+
+    /*! \brief Writes a chunk of payload data
+     *
+     * @param aData Pointer to the data. The data is not copied.
+     * @param aLength Length of the data
+     * @return True on success, otherwise false
+     */
+    bool write( const char* aData, qint64 aLength );
+
+    /*! \brief Writes the data of a storage item
+     *
+     * @param aItem Item whose data to write
+     * @return True on success, otherwise false
+     */
+    bool writeItem( const StorageItem& aItem );
+
+    /*! \brief Finishes the current payload
+     *
+     * @return True on success, otherwise false
+     */
+    bool finish();
+
+    /*! \brief Returns the number of payload bytes written before encoding
+     *
+     * @return Number of bytes
+     */
+    qint64 uncompressedBytes() const;
+
+    /*! \brief Returns the number of bytes written to the output devices
+     *
+     * @return Number of bytes
+     */
+    qint64 compressedBytes() const;
+
+    /*! \brief Adds the transfer statistics to sync results
+     *
+     * Only the bytes written since the previous call are added, so the
+     * statistics can be reported more than once. Nothing is reported if
+     * the payload was not compressed.
+     * @param aResults Results of the sync session
+     */
+    void reportTo( SyncResults& aResults );
+
+private:
+
+    CompressedTransport( const CompressedTransport& );
+    CompressedTransport& operator=( const CompressedTransport& );
+
+    PayloadCompressor* createCompressor( const QString& aEncoding ) const;
+
+    QStringList         iAcceptedEncodings;
+    int                 iLevel;
+    PayloadCompressor*  iCompressor;
+    QIODevice*          iOutput;
+    qint64              iUncompressedBytes;
+    qint64              iCompressedBytes;
+    qint64              iReportedUncompressedBytes;
+    qint64              iReportedCompressedBytes;
+    QByteArray          iReadBuffer;
+};
+
+}
+
+#endif // COMPRESSEDTRANSPORT_H
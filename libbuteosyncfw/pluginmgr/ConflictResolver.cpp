@@ -0,0 +1,224 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "ConflictResolver.h"
+
+#include <QtAlgorithms>
+
+#include "LogMacros.h"
+
+using namespace Buteo;
+
+static bool itemChangeIdLessThan(const ItemChange &aLhs, const ItemChange &aRhs)
+{
+    return aLhs.id < aRhs.id;
+}
+
+ConflictResolver::ConflictResolver(SyncProfile::ConflictResolutionPolicy aPolicy)
+:   iPolicy(aPolicy)
+{
+}
+
+ConflictResolver::ConflictResolver(const SyncProfile &aProfile)
+:   iPolicy(aProfile.conflictResolutionPolicy())
+{
+}
+
+SyncProfile::ConflictResolutionPolicy ConflictResolver::policy() const
+{
+    return iPolicy;
+}
+
+int ConflictResolver::resolve(const QList<ItemChange> &aLocalChanges,
+                              const QList<ItemChange> &aRemoteChanges,
+                              ApplyBatch &aLocalBatch,
+                              ApplyBatch &aRemoteBatch) const
+{
+    FUNCTION_CALL_TRACE;
+
+    QList<ItemChange> local(aLocalChanges);
+    QList<ItemChange> remote(aRemoteChanges);
+    sortById(local);
+    sortById(remote);
+
+    int conflicts = 0;
+    int l = 0;
+    int r = 0;
+    while (l < local.size() || r < remote.size())
+    {
+        if (r >= remote.size() ||
+            (l < local.size() && local[l].id < remote[r].id))
+        {
+            // Changed only locally, send to remote.
+            append(aRemoteBatch, local[l++]);
+        }
+        else if (l >= local.size() || remote[r].id < local[l].id)
+        {
+            // Changed only remotely, apply locally.
+            append(aLocalBatch, remote[r++]);
+        }
+        else
+        {
+            const ItemChange &localChange = local[l++];
+            const ItemChange &remoteChange = remote[r++];
+
+            if (isIdentical(localChange, remoteChange))
+            {
+                continue;
+            } // no else
+
+            ++conflicts;
+            if (localWins(localChange, remoteChange))
+            {
+                LOG_DEBUG("Conflict on item" << localChange.id << ", local wins");
+                applyWinner(aRemoteBatch, localChange, remoteChange);
+            }
+            else
+            {
+                LOG_DEBUG("Conflict on item" << localChange.id << ", remote wins");
+                applyWinner(aLocalBatch, remoteChange, localChange);
+            }
+        }
+    }
+
+    return conflicts;
+}
+
+bool ConflictResolver::isIdentical(const ItemChange &aLocal,
+                                   const ItemChange &aRemote) const
+{
+    if (aLocal.type == ItemChange::DELETED || aRemote.type == ItemChange::DELETED)
+    {
+        return aLocal.type == aRemote.type;
+    } // no else
+
+    return !aLocal.hash.isEmpty() && aLocal.hash == aRemote.hash;
+}
+
+bool ConflictResolver::localWins(const ItemChange &aLocal,
+                                 const ItemChange &aRemote) const
+{
+    switch (iPolicy)
+    {
+        case SyncProfile::CR_POLICY_PREFER_LOCAL_CHANGES:
+            return true;
+        case SyncProfile::CR_POLICY_PREFER_REMOTE_CHANGES:
+            return false;
+        default:
+            // Most recent change wins. Changes without a timestamp lose.
+            if (!aRemote.timestamp.isValid())
+            {
+                return true;
+            } // no else
+            if (!aLocal.timestamp.isValid())
+            {
+                return false;
+            } // no else
+            return aLocal.timestamp >= aRemote.timestamp;
+    }
+}
+
+void ConflictResolver::sortById(QList<ItemChange> &aChanges)
+{
+    qStableSort(aChanges.begin(), aChanges.end(), itemChangeIdLessThan);
+
+    // Fold changes of the same item, the stable sort keeps them in the
+    // order they were reported.
+    int i = 0;
+    while (i + 1 < aChanges.size())
+    {
+        if (aChanges[i].id != aChanges[i + 1].id)
+        {
+            ++i;
+        }
+        else if (fold(aChanges[i], aChanges[i + 1]))
+        {
+            aChanges.removeAt(i + 1);
+        }
+        else
+        {
+            // Added and deleted again, the other side never saw the item.
+            aChanges.removeAt(i + 1);
+            aChanges.removeAt(i);
+        }
+    }
+}
+
+bool ConflictResolver::fold(ItemChange &aEarlier, const ItemChange &aLater)
+{
+    ItemChange::ChangeType type = aLater.type;
+    if (aEarlier.type == ItemChange::ADDED)
+    {
+        if (aLater.type == ItemChange::DELETED)
+        {
+            return false;
+        } // no else
+        type = ItemChange::ADDED;
+    }
+    else if (aEarlier.type == ItemChange::DELETED &&
+             aLater.type == ItemChange::ADDED)
+    {
+        type = ItemChange::MODIFIED;
+    } // no else
+
+    aEarlier = aLater;
+    aEarlier.type = type;
+    return true;
+}
+
+void ConflictResolver::append(ApplyBatch &aBatch, const ItemChange &aChange)
+{
+    switch (aChange.type)
+    {
+        case ItemChange::ADDED:
+            aBatch.additions.append(aChange);
+            break;
+        case ItemChange::MODIFIED:
+            aBatch.modifications.append(aChange);
+            break;
+        case ItemChange::DELETED:
+            aBatch.deletions.append(aChange);
+            break;
+    }
+}
+
+void ConflictResolver::applyWinner(ApplyBatch &aBatch, const ItemChange &aWinner,
+                                   const ItemChange &aLoser)
+{
+    if (aWinner.type == ItemChange::DELETED)
+    {
+        aBatch.deletions.append(aWinner);
+    }
+    else if (aLoser.type == ItemChange::DELETED)
+    {
+        // Item is gone on the losing side, it has to be recreated.
+        ItemChange change(aWinner);
+        change.type = ItemChange::ADDED;
+        aBatch.additions.append(change);
+    }
+    else
+    {
+        ItemChange change(aWinner);
+        change.type = ItemChange::MODIFIED;
+        aBatch.modifications.append(change);
+    }
+}
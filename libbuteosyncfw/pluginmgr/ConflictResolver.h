@@ -0,0 +1,177 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef CONFLICTRESOLVER_H
+#define CONFLICTRESOLVER_H
+
+#include <QString>
+#include <QList>
+#include <QByteArray>
+#include <QDateTime>
+
+#include "SyncProfile.h"
+
+namespace Buteo {
+
+class ConflictResolverTest;
+
+//! \brief Description of a single item change on one side of the sync.
+struct ItemChange {
+
+    //! Type of the change
+    enum ChangeType {
+        //! Item was added
+        ADDED,
+        //! Item was modified
+        MODIFIED,
+        //! Item was deleted
+        DELETED
+    };
+
+    //! Item id, shared by local and remote side (after id mapping)
+    QString id;
+
+    //! Version of the item, as reported by the storage
+    QString version;
+
+    //! Hash of the item content. Empty if not known.
+    QByteArray hash;
+
+    //! Time of the change
+    QDateTime timestamp;
+
+    //! Type of the change
+    ChangeType type;
+
+    //! Default Constructor
+    ItemChange() : type(MODIFIED) { }
+
+    //! Constructor with all parameters
+    ItemChange(const QString &aId, ChangeType aType, const QString &aVersion,
+               const QByteArray &aHash, const QDateTime &aTimestamp)
+        : id(aId), version(aVersion), hash(aHash), timestamp(aTimestamp),
+          type(aType) { }
+};
+
+//! \brief Batch of item changes to be written to one storage.
+struct ApplyBatch {
+
+    //! Items to add to the storage
+    QList<ItemChange> additions;
+
+    //! Items to modify in the storage
+    QList<ItemChange> modifications;
+
+    //! Items to delete from the storage
+    QList<ItemChange> deletions;
+
+    /*! \brief Checks if the batch is empty
+     *
+     * @return True if there is nothing to apply
+     */
+    bool isEmpty() const
+    {
+        return additions.isEmpty() && modifications.isEmpty() &&
+               deletions.isEmpty();
+    }
+};
+
+/*! \brief Resolves conflicts between local and remote change sets.
+ *
+ * Client plugins collect the changes of both sides and pass them to the
+ * resolver as batches. The resolver sorts both sets by item id and walks
+ * them in a single merge pass. Changes present on one side only are
+ * forwarded to the other side. Changes present on both sides are treated
+ * as identical when the content hashes match, otherwise as a conflict that
+ * is resolved according to the conflict resolution policy of the profile.
+ * With CR_POLICY_UNDEFINED the most recent change wins, and local wins ties.
+ *
+ * The result is a pair of apply batches, one for the local storage and one
+ * for the remote side, that can be fed to StoragePlugin::addItems(),
+ * StoragePlugin::modifyItems() and StoragePlugin::deleteItems() without
+ * further per item comparisons.
+ */
+class ConflictResolver
+{
+public:
+
+    /*! \brief Constructor
+     *
+     * @param aPolicy Conflict resolution policy to use
+     */
+    explicit ConflictResolver(SyncProfile::ConflictResolutionPolicy aPolicy);
+
+    /*! \brief Constructor
+     *
+     * Uses the conflict resolution policy of the given profile.
+     * @param aProfile Sync profile
+     */
+    explicit ConflictResolver(const SyncProfile &aProfile);
+
+    /*! \brief Returns the policy used by the resolver
+     *
+     * @return Conflict resolution policy
+     */
+    SyncProfile::ConflictResolutionPolicy policy() const;
+
+    /*! \brief Resolves the given change sets
+     *
+     * Several changes of the same item inside one change set are folded
+     * into one, in list order. An addition followed by modifications stays
+     * an addition with the latest contents, an addition followed by a
+     * deletion drops the item, and a deletion followed by an addition
+     * becomes a modification. Otherwise the last change is used.
+     * @param aLocalChanges Changes made in the local storage
+     * @param aRemoteChanges Changes received from the remote side
+     * @param aLocalBatch Changes to apply to the local storage
+     * @param aRemoteBatch Changes to send to the remote side
+     * @return Number of conflicts that were resolved
+     */
+    int resolve(const QList<ItemChange> &aLocalChanges,
+                const QList<ItemChange> &aRemoteChanges,
+                ApplyBatch &aLocalBatch, ApplyBatch &aRemoteBatch) const;
+
+private:
+
+    bool isIdentical(const ItemChange &aLocal, const ItemChange &aRemote) const;
+
+    bool localWins(const ItemChange &aLocal, const ItemChange &aRemote) const;
+
+    static void sortById(QList<ItemChange> &aChanges);
+
+    static bool fold(ItemChange &aEarlier, const ItemChange &aLater);
+
+    static void append(ApplyBatch &aBatch, const ItemChange &aChange);
+
+    static void applyWinner(ApplyBatch &aBatch, const ItemChange &aWinner,
+                            const ItemChange &aLoser);
+
+    SyncProfile::ConflictResolutionPolicy iPolicy;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class ConflictResolverTest;
+#endif
+};
+
+}
+
+#endif // CONFLICTRESOLVER_H
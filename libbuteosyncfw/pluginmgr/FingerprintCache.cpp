@@ -0,0 +1,323 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "FingerprintCache.h"
+#include "StorageItem.h"
+#include "LogMacros.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QCryptographicHash>
+
+using namespace Buteo;
+
+// Item data is hashed in chunks of this size to keep memory use bounded.
+static const qint64 HASH_CHUNK_SIZE = 64 * 1024;
+
+FingerprintCache::FingerprintCache()
+{
+    FUNCTION_CALL_TRACE;
+}
+
+FingerprintCache::~FingerprintCache()
+{
+    FUNCTION_CALL_TRACE;
+
+    uninit();
+}
+
+bool FingerprintCache::init( const QString& aDbFile, const QString& aProfileName,
+                             const QString& aStorageName )
+{
+    FUNCTION_CALL_TRACE;
+
+    static unsigned connectionNumber = 0;
+    const QString connectionName = "fingerprints";
+
+    iProfileName = aProfileName;
+    iStorageName = aStorageName;
+
+    if( !iDb.isOpen() ) {
+        iConnectionName = connectionName + QString::number( connectionNumber++ );
+        iDb = QSqlDatabase::addDatabase( "QSQLITE", iConnectionName );
+        iDb.setDatabaseName( aDbFile );
+        iDb.open();
+    }
+
+    if( !iDb.isOpen() ) {
+        LOG_CRITICAL( "Could open fingerprint database file:" << aDbFile );
+        return false;
+    }
+
+    if( !ensureFingerprintsExists() ) {
+        return false;
+    }
+
+    return load();
+}
+
+bool FingerprintCache::uninit()
+{
+    FUNCTION_CALL_TRACE;
+
+    if( iDb.isOpen() ) {
+        iDb.close();
+        iDb = QSqlDatabase();
+        QSqlDatabase::removeDatabase( iConnectionName );
+    }
+
+    iFingerprints.clear();
+    iItemsByHash.clear();
+
+    return true;
+}
+
+QByteArray FingerprintCache::contentHash( const StorageItem& aItem )
+{
+    FUNCTION_CALL_TRACE;
+
+    QCryptographicHash hash( QCryptographicHash::Sha1 );
+    const qint64 size = aItem.getSize();
+
+    for( qint64 offset = 0; offset < size; offset += HASH_CHUNK_SIZE ) {
+        QByteArray data;
+        if( !aItem.read( offset, qMin( HASH_CHUNK_SIZE, size - offset ), data ) ) {
+            LOG_WARNING( "Could not read data of item" << aItem.getId() );
+            return QByteArray();
+        }
+        hash.addData( data );
+    }
+
+    return hash.result();
+}
+
+QByteArray FingerprintCache::contentHash( const QByteArray& aData )
+{
+    return QCryptographicHash::hash( aData, QCryptographicHash::Sha1 );
+}
+
+QByteArray FingerprintCache::fingerprint( const QString& aItemId ) const
+{
+    return iFingerprints.value( aItemId );
+}
+
+QList<QString> FingerprintCache::itemsWithFingerprint( const QByteArray& aHash ) const
+{
+    return iItemsByHash.values( aHash );
+}
+
+QList<QString> FingerprintCache::matchingItems( const QMap<QString, QByteArray>& aHashes ) const
+{
+    FUNCTION_CALL_TRACE;
+
+    QList<QString> matching;
+    QMap<QString, QByteArray>::const_iterator i;
+    for( i = aHashes.constBegin(); i != aHashes.constEnd(); ++i ) {
+        if( !i.value().isEmpty() && iFingerprints.value( i.key() ) == i.value() ) {
+            matching.append( i.key() );
+        }
+    }
+
+    LOG_DEBUG( matching.count() << "of" << aHashes.count() << "items are unchanged in"
+               << iStorageName );
+
+    return matching;
+}
+
+bool FingerprintCache::update( const QList<StorageItem*>& aItems )
+{
+    FUNCTION_CALL_TRACE;
+
+    QVariantList profiles;
+    QVariantList storages;
+    QVariantList itemIds;
+    QVariantList hashes;
+
+    foreach( const StorageItem* item, aItems ) {
+        if( item == 0 || item->getId().isEmpty() ) {
+            continue;
+        }
+
+        QByteArray hash = contentHash( *item );
+        if( hash.isEmpty() ) {
+            continue;
+        }
+
+        QByteArray oldHash = iFingerprints.value( item->getId() );
+        if( !oldHash.isEmpty() ) {
+            iItemsByHash.remove( oldHash, item->getId() );
+        }
+        iFingerprints.insert( item->getId(), hash );
+        iItemsByHash.insert( hash, item->getId() );
+
+        profiles << iProfileName;
+        storages << iStorageName;
+        itemIds << item->getId();
+        hashes << hash;
+    }
+
+    if( itemIds.isEmpty() ) {
+        return true;
+    }
+
+    bool supportsTransaction = iDb.transaction();
+    if(!supportsTransaction)
+    {
+        LOG_DEBUG("SQL Db doesn't support transactions");
+    }
+
+    const QString queryString( "INSERT OR REPLACE INTO fingerprints VALUES(:profile, :storage, :itemid, :hash)" );
+    QSqlQuery query( iDb );
+    query.prepare( queryString );
+    query.addBindValue( profiles );
+    query.addBindValue( storages );
+    query.addBindValue( itemIds );
+    query.addBindValue( hashes );
+
+    bool success = query.execBatch();
+    if( success ) {
+        LOG_DEBUG( "Stored fingerprints of" << itemIds.count() << "items" );
+    }
+    else {
+        LOG_WARNING( "Could not store fingerprints" );
+        LOG_WARNING( "Reason:" << query.lastError() );
+    }
+
+    if(supportsTransaction)
+    {
+        if( !iDb.commit() )
+        {
+            LOG_WARNING("Error while commiting : " << iDb.lastError());
+        }
+    }
+
+    return success;
+}
+
+bool FingerprintCache::remove( const QList<QString>& aItemIds )
+{
+    FUNCTION_CALL_TRACE;
+
+    QVariantList profiles;
+    QVariantList storages;
+    QVariantList itemIds;
+
+    foreach( const QString& id, aItemIds ) {
+        QByteArray oldHash = iFingerprints.take( id );
+        if( oldHash.isEmpty() ) {
+            continue;
+        }
+        iItemsByHash.remove( oldHash, id );
+
+        profiles << iProfileName;
+        storages << iStorageName;
+        itemIds << id;
+    }
+
+    if( itemIds.isEmpty() ) {
+        return true;
+    }
+
+    const QString queryString( "DELETE FROM fingerprints WHERE profile = :profile AND storage = :storage AND itemid = :itemid" );
+    QSqlQuery query( iDb );
+    query.prepare( queryString );
+    query.addBindValue( profiles );
+    query.addBindValue( storages );
+    query.addBindValue( itemIds );
+
+    if( !query.execBatch() ) {
+        LOG_WARNING( "Could not remove fingerprints:" << query.lastError() );
+        return false;
+    }
+
+    return true;
+}
+
+bool FingerprintCache::clear()
+{
+    FUNCTION_CALL_TRACE;
+
+    iFingerprints.clear();
+    iItemsByHash.clear();
+
+    const QString queryString( "DELETE FROM fingerprints WHERE profile = :profile AND storage = :storage" );
+    QSqlQuery query( iDb );
+    query.prepare( queryString );
+    query.bindValue( ":profile", iProfileName );
+    query.bindValue( ":storage", iStorageName );
+
+    if( !query.exec() ) {
+        LOG_WARNING( "Could not clear fingerprints:" << query.lastError() );
+        return false;
+    }
+
+    return true;
+}
+
+bool FingerprintCache::ensureFingerprintsExists()
+{
+    FUNCTION_CALL_TRACE;
+
+    const QString queryString( "CREATE TABLE IF NOT EXISTS fingerprints(profile varchar(512), storage varchar(512), itemid varchar(512), hash blob, primary key(profile, storage, itemid))" );
+    QSqlQuery query( iDb );
+    query.prepare( queryString );
+
+    if( !query.exec() ) {
+        LOG_WARNING("Query failed: " << query.lastError());
+        return false;
+    }
+    else {
+        LOG_DEBUG( "Ensured database table: fingerprints" );
+        return true;
+    }
+}
+
+bool FingerprintCache::load()
+{
+    FUNCTION_CALL_TRACE;
+
+    iFingerprints.clear();
+    iItemsByHash.clear();
+
+    const QString queryString( "SELECT itemid, hash FROM fingerprints WHERE profile = :profile AND storage = :storage" );
+    QSqlQuery query( iDb );
+    query.prepare( queryString );
+    query.bindValue( ":profile", iProfileName );
+    query.bindValue( ":storage", iStorageName );
+
+    if( !query.exec() ) {
+        LOG_WARNING("Could not load fingerprints:" << query.lastError());
+        return false;
+    }
+
+    while( query.next() ) {
+        QString id = query.value(0).toString();
+        QByteArray hash = query.value(1).toByteArray();
+        iFingerprints.insert( id, hash );
+        iItemsByHash.insert( hash, id );
+    }
+
+    LOG_DEBUG( "Loaded" << iFingerprints.count() << "fingerprints for" << iProfileName
+               << "/" << iStorageName );
+
+    return true;
+}
@@ -0,0 +1,153 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef FINGERPRINTCACHE_H
+#define FINGERPRINTCACHE_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QList>
+
+namespace Buteo {
+
+class StorageItem;
+
+/*!
+ * \brief Persistent cache of item content fingerprints
+ *
+ * The cache keeps a content hash for each item of one storage used by one
+ * sync profile. It is updated after a successful sync from the items read
+ * through StorageItem. When a slow sync is forced, plugins can compare the
+ * hashes of the incoming items against the cache and skip writing and
+ * transferring the items whose content has not changed.
+ */
+class FingerprintCache {
+public:
+
+    /**
+     * \brief Contructor
+     */
+    FingerprintCache();
+
+    /**
+     * \brief Destructor
+     */
+    ~FingerprintCache();
+
+    /*! \brief Initializes the cache and loads stored fingerprints
+     *
+     * @param aDbFile Path to database to use as persistent storage
+     * @param aProfileName Name of the sync profile
+     * @param aStorageName Name of the storage backend
+     * @return True on success, otherwise false
+     */
+    bool init( const QString& aDbFile, const QString& aProfileName,
+               const QString& aStorageName );
+
+    /*! \brief Uninitializes the cache
+     *
+     * @return True on success, otherwise false
+     */
+    bool uninit();
+
+    /*! \brief Calculates the content hash of an item
+     *
+     * @param aItem Item to hash
+     * @return Hash of the item data, empty if the data could not be read
+     */
+    static QByteArray contentHash( const StorageItem& aItem );
+
+    /*! \brief Calculates the content hash of raw item data
+     *
+     * @param aData Item data
+     * @return Hash of the data
+     */
+    static QByteArray contentHash( const QByteArray& aData );
+
+    /*! \brief Returns the stored fingerprint of an item
+     *
+     * @param aItemId Id of the item
+     * @return Fingerprint, empty if not known
+     */
+    QByteArray fingerprint( const QString& aItemId ) const;
+
+    /*! \brief Returns the id's of items that have the given content
+     *
+     * @param aHash Content hash
+     * @return Item id's
+     */
+    QList<QString> itemsWithFingerprint( const QByteArray& aHash ) const;
+
+    /*! \brief Returns the id's of items whose content matches the given hashes
+     *
+     * @param aHashes Map of local item id's and content hashes to check
+     * @return Id's of the items that are unchanged
+     */
+    QList<QString> matchingItems( const QMap<QString, QByteArray>& aHashes ) const;
+
+    /*! \brief Stores fingerprints of the given items
+     *
+     * @param aItems Items to read and hash
+     * @return True on success, otherwise false
+     */
+    bool update( const QList<StorageItem*>& aItems );
+
+    /*! \brief Removes fingerprints of the given items
+     *
+     * @param aItemIds Id's of the items
+     * @return True on success, otherwise false
+     */
+    bool remove( const QList<QString>& aItemIds );
+
+    /*! \brief Removes all fingerprints of the profile and storage
+     *
+     * @return True on success, otherwise false
+     */
+    bool clear();
+
+protected:
+
+    /**
+     * \brief Checks whether fingerprint table exists and creates it if needed
+     * @return True on success, otherwise false
+     */
+    bool ensureFingerprintsExists();
+
+private:
+
+    bool load();
+
+    QSqlDatabase                iDb;                ///< Database handle
+    QString                     iConnectionName;    ///< Database connection ID string
+    QString                     iProfileName;       ///< Profile of the cache
+    QString                     iStorageName;       ///< Storage of the cache
+    QHash<QString, QByteArray>  iFingerprints;      ///< Item id -> content hash
+    QMultiHash<QByteArray, QString> iItemsByHash;   ///< Content hash -> item ids
+
+};
+
+}
+
+#endif
@@ -141,6 +141,20 @@ void OOPClientPlugin::abortSync( Sync::SyncStatus aStatus )
         LOG_WARNING( "Invalid reply for connectivityStateChanged from plugin" );
 }
 
+bool OOPClientPlugin::yieldSync()
+{
+    FUNCTION_CALL_TRACE;
+
+    QDBusPendingReply<bool> reply = iOopPluginIface->yieldSync();
+    reply.waitForFinished();
+    if( !reply.isValid() ) {
+        LOG_WARNING( "Invalid reply for yieldSync from plugin" );
+        return false;
+    }
+
+    return reply.value();
+}
+
 bool OOPClientPlugin::cleanUp()
 {
     FUNCTION_CALL_TRACE;
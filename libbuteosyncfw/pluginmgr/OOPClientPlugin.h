@@ -47,6 +47,8 @@ public:
 
     virtual void abortSync(Sync::SyncStatus aStatus = Sync::SYNC_ABORTED);
 
+    Q_INVOKABLE bool yieldSync();
+
     virtual Buteo::SyncResults getSyncResults() const;
 
     virtual bool cleanUp();
@@ -0,0 +1,185 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "PayloadCompressor.h"
+#include "LogMacros.h"
+
+#include <QIODevice>
+#include <zlib.h>
+
+namespace Buteo {
+
+// Size of the fixed output buffer used for one deflate round.
+static const int OUTPUT_CHUNK_SIZE = 16 * 1024;
+
+// zlib window bits: 15 writes a zlib header, adding 16 writes a gzip header.
+static const int WINDOW_BITS_DEFLATE = 15;
+static const int WINDOW_BITS_GZIP = 15 + 16;
+
+// Default zlib memory level.
+static const int MEMORY_LEVEL = 8;
+
+//! Private implementation class for ZlibCompressor.
+class ZlibCompressorPrivate
+{
+public:
+    //! Constructor
+    ZlibCompressorPrivate( ZlibCompressor::Format aFormat, int aLevel )
+        : iFormat( aFormat ), iLevel( aLevel ), iActive( false ) { }
+
+    //! Output format
+    ZlibCompressor::Format iFormat;
+
+    //! Compression level
+    int iLevel;
+
+    //! Is the zlib stream initialized
+    bool iActive;
+
+    //! zlib stream state
+    z_stream iStream;
+
+    //! Output buffer, reused for every deflate round
+    char iBuffer[OUTPUT_CHUNK_SIZE];
+};
+
+}
+
+using namespace Buteo;
+
+ZlibCompressor::ZlibCompressor( Format aFormat, int aLevel )
+:   d_ptr( new ZlibCompressorPrivate( aFormat,
+           ( aLevel < 1 || aLevel > 9 ) ? Z_DEFAULT_COMPRESSION : aLevel ) )
+{
+}
+
+ZlibCompressor::~ZlibCompressor()
+{
+    if( d_ptr->iActive ) {
+        deflateEnd( &d_ptr->iStream );
+    }
+    delete d_ptr;
+    d_ptr = 0;
+}
+
+QString ZlibCompressor::encoding() const
+{
+    return ( d_ptr->iFormat == FORMAT_GZIP ) ? "gzip" : "deflate";
+}
+
+bool ZlibCompressor::begin()
+{
+    FUNCTION_CALL_TRACE;
+
+    if( d_ptr->iActive ) {
+        deflateEnd( &d_ptr->iStream );
+        d_ptr->iActive = false;
+    }
+
+    d_ptr->iStream.zalloc = Z_NULL;
+    d_ptr->iStream.zfree = Z_NULL;
+    d_ptr->iStream.opaque = Z_NULL;
+
+    int windowBits = ( d_ptr->iFormat == FORMAT_GZIP ) ? WINDOW_BITS_GZIP : WINDOW_BITS_DEFLATE;
+    if( deflateInit2( &d_ptr->iStream, d_ptr->iLevel, Z_DEFLATED, windowBits,
+                      MEMORY_LEVEL, Z_DEFAULT_STRATEGY ) != Z_OK ) {
+        LOG_WARNING( "Could not initialize" << encoding() << "compressor" );
+        return false;
+    }
+
+    d_ptr->iActive = true;
+    return true;
+}
+
+qint64 ZlibCompressor::compress( const char* aData, qint64 aLength, QIODevice& aOutput )
+{
+    if( !d_ptr->iActive ) {
+        LOG_WARNING( "Compressor not started" );
+        return -1;
+    }
+
+    qint64 written = 0;
+
+    // zlib takes the input as uInt, feed very large buffers in slices.
+    while( aLength > 0 ) {
+        uInt slice = static_cast<uInt>( qMin<qint64>( aLength, 0x40000000 ) );
+        d_ptr->iStream.next_in = reinterpret_cast<Bytef*>( const_cast<char*>( aData ) );
+        d_ptr->iStream.avail_in = slice;
+
+        qint64 produced = deflateTo( aOutput, Z_NO_FLUSH );
+        if( produced < 0 ) {
+            return -1;
+        }
+
+        written += produced;
+        aData += slice;
+        aLength -= slice;
+    }
+
+    return written;
+}
+
+qint64 ZlibCompressor::finish( QIODevice& aOutput )
+{
+    FUNCTION_CALL_TRACE;
+
+    if( !d_ptr->iActive ) {
+        LOG_WARNING( "Compressor not started" );
+        return -1;
+    }
+
+    d_ptr->iStream.next_in = Z_NULL;
+    d_ptr->iStream.avail_in = 0;
+
+    qint64 written = deflateTo( aOutput, Z_FINISH );
+
+    deflateEnd( &d_ptr->iStream );
+    d_ptr->iActive = false;
+
+    return written;
+}
+
+qint64 ZlibCompressor::deflateTo( QIODevice& aOutput, int aFlush )
+{
+    qint64 written = 0;
+    int result = Z_OK;
+    do {
+        d_ptr->iStream.next_out = reinterpret_cast<Bytef*>( d_ptr->iBuffer );
+        d_ptr->iStream.avail_out = OUTPUT_CHUNK_SIZE;
+
+        result = deflate( &d_ptr->iStream, aFlush );
+        if( result == Z_STREAM_ERROR ) {
+            LOG_WARNING( "Deflate failed" );
+            return -1;
+        }
+
+        qint64 produced = OUTPUT_CHUNK_SIZE - d_ptr->iStream.avail_out;
+        if( produced > 0 && aOutput.write( d_ptr->iBuffer, produced ) != produced ) {
+            LOG_WARNING( "Could not write compressed data:" << aOutput.errorString() );
+            return -1;
+        }
+        written += produced;
+    } while( d_ptr->iStream.avail_out == 0 ||
+             ( aFlush == Z_FINISH && result != Z_STREAM_END ) );
+
+    return written;
+}
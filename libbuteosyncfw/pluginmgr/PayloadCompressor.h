@@ -0,0 +1,132 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef PAYLOADCOMPRESSOR_H
+#define PAYLOADCOMPRESSOR_H
+
+#include <QString>
+#include <QByteArray>
+
+class QIODevice;
+
+namespace Buteo {
+
+/*! \brief Interface for streaming payload compressors
+ *
+ * A compressor consumes payload data in chunks and writes the encoded
+ * output directly to a device. Chunks are passed as raw pointers so that
+ * callers can feed data from their own buffers without copying.
+ */
+class PayloadCompressor
+{
+public:
+
+    /*! \brief Destructor
+     *
+     */
+    virtual ~PayloadCompressor() { }
+
+    /*! \brief Returns the content encoding produced by the compressor
+     *
+     * The name matches the HTTP content coding, e.g. "gzip" or "deflate".
+     * @return Encoding name
+     */
+    virtual QString encoding() const = 0;
+
+    /*! \brief Starts a new compressed stream
+     *
+     * @return True on success, otherwise false
+     */
+    virtual bool begin() = 0;
+
+    /*! \brief Compresses a chunk of payload data
+     *
+     * @param aData Pointer to the data. The data is not retained.
+     * @param aLength Length of the data
+     * @param aOutput Device where to write compressed output
+     * @return Number of bytes written to the output, -1 on error
+     */
+    virtual qint64 compress( const char* aData, qint64 aLength, QIODevice& aOutput ) = 0;
+
+    /*! \brief Finishes the stream and flushes remaining output
+     *
+     * @param aOutput Device where to write compressed output
+     * @return Number of bytes written to the output, -1 on error
+     */
+    virtual qint64 finish( QIODevice& aOutput ) = 0;
+};
+
+class ZlibCompressorPrivate;
+
+/*! \brief zlib based compressor for gzip and deflate encodings
+ *
+ */
+class ZlibCompressor : public PayloadCompressor
+{
+public:
+
+    /*! \brief Output format
+     *
+     */
+    enum Format
+    {
+        FORMAT_GZIP,    /*!< gzip (RFC 1952) stream */
+        FORMAT_DEFLATE  /*!< zlib wrapped deflate (RFC 1950) stream, "deflate" in HTTP */
+    };
+
+    /*! \brief Constructor
+     *
+     * @param aFormat Output format
+     * @param aLevel Compression level 1-9, -1 for zlib default
+     */
+    explicit ZlibCompressor( Format aFormat, int aLevel = -1 );
+
+    /*! \brief Destructor
+     *
+     */
+    virtual ~ZlibCompressor();
+
+    //! \see PayloadCompressor::encoding
+    virtual QString encoding() const;
+
+    //! \see PayloadCompressor::begin
+    virtual bool begin();
+
+    //! \see PayloadCompressor::compress
+    virtual qint64 compress( const char* aData, qint64 aLength, QIODevice& aOutput );
+
+    //! \see PayloadCompressor::finish
+    virtual qint64 finish( QIODevice& aOutput );
+
+private:
+
+    ZlibCompressor( const ZlibCompressor& );
+    ZlibCompressor& operator=( const ZlibCompressor& );
+
+    qint64 deflateTo( QIODevice& aOutput, int aFlush );
+
+    ZlibCompressorPrivate* d_ptr;
+};
+
+}
+
+#endif // PAYLOADCOMPRESSOR_H
@@ -24,7 +24,9 @@
 #include "StoragePlugin.h"
 #include "SyncCommonDefs.h"
 #include "Profile.h"
+#include "TargetResults.h"
 #include "LogMacros.h"
+#include <QDomDocument>
 
 using namespace Buteo;
 
@@ -123,3 +125,18 @@ QString PluginCbImpl::getValue(const QString& aAddress, const QString& aKey)
 
     return "";
 }
+
+void PluginCbImpl::reportTargetResults(const SyncPluginBase *aCaller,
+                                       const TargetResults &aDelta)
+{
+    FUNCTION_CALL_TRACE;
+
+    if( imsyncIface && aCaller ) {
+        QDomDocument doc;
+        doc.appendChild(aDelta.toXml(doc));
+        imsyncIface->reportTargetResults(aCaller->getProfileName(),
+                                         doc.toString());
+    } else {
+        LOG_WARNING( "msyncd dbus interface is NULL" );
+    }
+}
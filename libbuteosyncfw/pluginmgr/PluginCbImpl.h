@@ -59,6 +59,10 @@ public:
     /// \see PluginCbInterface::getValue
     virtual QString getValue(const QString& aAddress, const QString& aKey);
 
+    /// \see PluginCbInterface::reportTargetResults
+    virtual void reportTargetResults(const SyncPluginBase *aCaller,
+                                     const TargetResults &aDelta);
+
 signals:
     
     //! emitted by releaseStorages call
@@ -31,6 +31,8 @@ namespace Buteo {
 
 class StoragePlugin;
 class Profile;
+class ProfileService;
+class TargetResults;
              
 /*! \brief Interface which client and server plugins can use to communicate with
  *         synchronization daemon
@@ -103,6 +105,67 @@ public:
      * @return value for the property
      */
     virtual QString getValue(const QString& aAddress, const QString& aKey) = 0;
+
+    /*! \brief Returns the profile service of the sync daemon
+     *
+     * Plug-ins should use the service for reading and changing profiles,
+     * instead of creating their own ProfileManager.
+     * @return Profile service, or NULL if not available, for example in
+     *  out-of-process plug-ins. Ownership is NOT transferred.
+     */
+    virtual ProfileService* profileService() { return 0; }
+
+    /*! \brief Tries to reserve the given storage to one peer session.
+     *
+     * Server plug-ins that serve several peers concurrently reserve storages
+     * per session, so that sessions using different storages can run at the
+     * same time. The default implementation reserves the storage to the
+     * caller with requestStorage().
+     * @param aStorageName Name of the storage backend to reserve.
+     * @param aCaller Object calling this function
+     * @param aSessionId Session id given in ServerPlugin::newPeerSession
+     * @return Success indicator
+     */
+    virtual bool requestSessionStorage(const QString &aStorageName,
+                                       const SyncPluginBase *aCaller,
+                                       const QString &aSessionId)
+    {
+        Q_UNUSED(aSessionId);
+        return requestStorage(aStorageName, aCaller);
+    }
+
+    /*! \brief Releases a storage reserved to one peer session.
+     *
+     * \param aStorageName Name of the storage backend to release.
+     * \param aCaller Object calling this function.
+     * \param aSessionId Session id given in ServerPlugin::newPeerSession
+     */
+    virtual void releaseSessionStorage(const QString &aStorageName,
+                                       const SyncPluginBase *aCaller,
+                                       const QString &aSessionId)
+    {
+        Q_UNUSED(aSessionId);
+        releaseStorage(aStorageName, aCaller);
+    }
+
+    /*! \brief Reports progress of a sync session as partial results
+     *
+     * Client plug-ins may report the items processed in a target while the
+     * session is still running, instead of only returning the results at
+     * the end. The sync daemon sums up the reported counts per target and
+     * saves them to the sync log at regular checkpoints, so that results of
+     * a long or interrupted session are not lost. Counts must not be
+     * reported twice; report only what was processed since the last call.
+     * The default implementation ignores the results.
+     * \param aCaller Object calling this function
+     * \param aDelta Counts of items processed since the previous report
+     */
+    virtual void reportTargetResults(const SyncPluginBase *aCaller,
+                                     const TargetResults &aDelta)
+    {
+        Q_UNUSED(aCaller);
+        Q_UNUSED(aDelta);
+    }
 };
 
 }
@@ -34,6 +34,8 @@
 #include "StorageChangeNotifierPlugin.h"
 #include "OOPClientPlugin.h"
 #include "OOPServerPlugin.h"
+#include "ProfileCodec.h"
+#include "WritePacer.h"
 
 #include "LogMacros.h"
 
@@ -55,6 +57,8 @@ PluginManager::PluginManager( const QString &aPluginPath )
 
     loadOOPPluginMaps( OOP_CLIENT_SUFFIX, iOopClientMaps );
     loadOOPPluginMaps( OOP_SERVER_SUFFIX, iOoPServerMaps );
+
+    iReapedUsage = ProcessLimits::childrenUsage();
 }
 
 PluginManager::~PluginManager()
@@ -273,7 +277,7 @@ ClientPlugin* PluginManager::createClient( const QString& aPluginName,
         // Start the out of process plugin
         QString exePath = iOopClientMaps.value( aPluginName );
 
-        QProcess* process = startOOPPlugin( exePath, aPluginName, aProfile.name() );
+        QProcess* process = startOOPPlugin( exePath, aPluginName, aProfile );
 
         if( process == NULL ) {
             LOG_CRITICAL( "Could not start process" );
@@ -390,7 +394,7 @@ ServerPlugin* PluginManager::createServer( const QString& aPluginName,
         // Start the Oop process plugin
         QString exePath = iOoPServerMaps.value( aPluginName );
 
-        QProcess* process = startOOPPlugin( exePath, aPluginName, aProfile.name() );
+        QProcess* process = startOOPPlugin( exePath, aPluginName, aProfile );
     
         if( process == NULL ) {
             LOG_CRITICAL( "Could not start server plugin process" );
@@ -610,21 +614,45 @@ KLUDGE: Due to NB #169065, crashes are seen in QMetaType if we unload DLLs. Henc
 
 QProcess* PluginManager::startOOPPlugin( const QString &aPath,
                                     const QString& aPluginName,
-                                    const QString& aProfileName)
+                                    const Profile& aProfile)
 {
     FUNCTION_CALL_TRACE;
 
-    LOG_DEBUG( "Starting oop plugin " << aProfileName);
+    LOG_DEBUG( "Starting oop plugin " << aProfile.name());
+
+    // The expanded profile is written to the standard input of the process,
+    // so that the plugin does not need to load it again. Only a summary of
+    // the sync log is passed, the plugin has no use for the target details.
+    QByteArray profileData = ProfileCodec::encode( aProfile, ProfileCodec::LOG_SUMMARY );
 
     bool started = false;
     QStringList args;
-    args << aPluginName << aProfileName;
+    args << aPluginName << aProfile.name();
     LOG_DEBUG( "Starting process " << aPath <<
                " with plugin name " << aPluginName <<
-               " and profile name " << aProfileName);
+               " and profile name " << aProfile.name());
+
+    // Resource limits are applied in the child before the plugin binary
+    // is executed.
+    ProcessLimits limits = ProcessLimits::fromProfile( aProfile, aPluginName );
+    if( !limits.isEmpty() ) {
+        limits.prepare();
+        LOG_DEBUG( "Limits for plugin" << aPluginName << ":" << limits.toString() );
+    }
 
-    QProcess *process = new QProcess();
+    QProcess *process = new LimitedProcess( limits );
     process->setProcessChannelMode( QProcess::ForwardedChannels );
+
+    // The command line stays the same as before, so that plugins built
+    // against an older plugin_main keep working. They just never read
+    // their standard input.
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert( OOP_PROFILE_FROM_STDIN_ENV, "1" );
+    environment.insert( OOP_DEVICE_ACTIVITY_ENV,
+                        QString::number( WritePacer::activity() ) );
+    environment.insert( OOP_DEVICE_CHARGING_ENV,
+                        WritePacer::isCharging() ? "1" : "0" );
+    process->setProcessEnvironment( environment );
     process->start( aPath, args );
 
     // This check is a workaround for the bug https://codereview.qt-project.org/#change,62897
@@ -634,6 +662,9 @@ QProcess* PluginManager::startOOPPlugin( const QString &aPath,
     }
 
     if (started == true) {
+        process->write( profileData );
+        process->closeWriteChannel();
+
         DllInfo info;
         info.iPath = aPath;
         info.iHandle = (void*)process;
@@ -641,6 +672,8 @@ QProcess* PluginManager::startOOPPlugin( const QString &aPath,
 
         iDllLock.lockForWrite();
         iLoadedDlls.append( info );
+        // The usage of an earlier instance does not belong to this one.
+        iProcessUsage.remove( aPath );
         iDllLock.unlock();
 
         LOG_DEBUG( "Process " << process->program() << " started with pid " << process->pid() );
@@ -671,6 +704,15 @@ void PluginManager::stopOOPPlugin( const QString &aPath )
         }
     }
 
+    if( process ) {
+        ProcessLimits::Usage usage = ProcessLimits::usage( process->pid() );
+        if( usage.valid ) {
+            LOG_DEBUG( "Process" << aPath << "used" << usage.cpuTime <<
+                       "ms CPU time and" << usage.peakMemory << "kB memory at peak" );
+            iProcessUsage.insert( aPath, usage );
+        }
+    }
+
     iDllLock.unlock();
 
     // We must terminate the process outside of the locked section because
@@ -683,6 +725,73 @@ void PluginManager::stopOOPPlugin( const QString &aPath )
     }
 }
 
+ProcessLimits::Usage PluginManager::processUsage( const QString& aPluginName ) const
+{
+    FUNCTION_CALL_TRACE;
+
+    QString path = iOopClientMaps.value( aPluginName );
+    if( path.isEmpty() ) {
+        path = iOoPServerMaps.value( aPluginName );
+    }
+
+    iDllLock.lockForRead();
+    ProcessLimits::Usage usage = iProcessUsage.value( path );
+    if( !usage.valid && !path.isEmpty() ) {
+        // Still running, the usage so far
+        for( int i = 0; i < iLoadedDlls.size(); ++i ) {
+            if( iLoadedDlls[i].iPath == path ) {
+                usage = ProcessLimits::usage( ((QProcess*)iLoadedDlls[i].iHandle)->pid() );
+                break;
+            }
+        }
+    }
+    iDllLock.unlock();
+
+    return usage;
+}
+
+bool PluginManager::killOOPPlugin( const QString& aPluginName )
+{
+    FUNCTION_CALL_TRACE;
+
+    QString path = iOopClientMaps.value( aPluginName );
+    if( path.isEmpty() ) {
+        path = iOoPServerMaps.value( aPluginName );
+    }
+    if( path.isEmpty() ) {
+        return false;
+    }
+
+    QProcess *process = NULL;
+
+    iDllLock.lockForWrite();
+
+    for( int i = 0; i < iLoadedDlls.size(); ++i ) {
+        if( iLoadedDlls[i].iPath == path ) {
+            process = (QProcess*)iLoadedDlls[i].iHandle;
+            break;
+        }
+    }
+
+    if( process ) {
+        ProcessLimits::Usage usage = ProcessLimits::usage( process->pid() );
+        if( usage.valid ) {
+            iProcessUsage.insert( path, usage );
+        }
+    }
+
+    iDllLock.unlock();
+
+    if( process == NULL ) {
+        return false;
+    }
+
+    // onProcessFinished handles the rest, as for a crashed process.
+    LOG_WARNING( "Killing process" << path << "with pid" << process->pid() );
+    process->kill();
+    return true;
+}
+
 void PluginManager::onProcessFinished( int exitCode, QProcess::ExitStatus )
 {
     FUNCTION_CALL_TRACE;
@@ -690,14 +799,32 @@ void PluginManager::onProcessFinished( int exitCode, QProcess::ExitStatus )
     QProcess* process = (QProcess*)sender();
     LOG_DEBUG( "Process " << process->program() << " finished with exit code" << exitCode );
 
+    ProcessLimits::Usage children = ProcessLimits::childrenUsage();
+
     iDllLock.lockForWrite();
 
     for( int i = 0; i < iLoadedDlls.size(); ++i ) {
         if( iLoadedDlls[i].iHandle == (void*)process ) {
+            const QString path = iLoadedDlls[i].iPath;
+            if( !iProcessUsage.contains( path ) && children.valid &&
+                iReapedUsage.valid ) {
+                // Crashed, /proc of the process is gone. The kernel has
+                // added its usage to that of the reaped children.
+                ProcessLimits::Usage usage;
+                usage.cpuTime = children.cpuTime - iReapedUsage.cpuTime;
+                if( children.peakMemory > iReapedUsage.peakMemory ) {
+                    usage.peakMemory = children.peakMemory;
+                }
+                usage.valid = true;
+                LOG_DEBUG( "Crashed process" << path << "used" << usage.cpuTime <<
+                           "ms CPU time" );
+                iProcessUsage.insert( path, usage );
+            }
             iLoadedDlls.removeAt( i );
             break;
         }
     }
+    iReapedUsage = children;
 
     iDllLock.unlock();
 
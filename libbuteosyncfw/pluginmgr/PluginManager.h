@@ -28,6 +28,8 @@
 #include <QReadWriteLock>
 #include <QProcess>
 
+#include "ProcessLimits.h"
+
 namespace Buteo {
 
 class StorageChangeNotifierPlugin;
@@ -163,6 +165,29 @@ public:
      */
     void destroyServer( ServerPlugin *aPlugin );
 
+    /*! \brief Returns the resources used by the last out-of-process
+     *  instance of a plugin
+     *
+     * The usage of a running process is read from /proc. The usage of a
+     * stopped or killed process is the one measured just before it was
+     * stopped. For a process that crashed, only the CPU time and peak
+     * memory the kernel accounted when it was reaped are known, and the
+     * peak memory is 0 if it cannot be told apart from earlier children.
+     * @param aPluginName Name of the plugin
+     * @return Usage, not valid if not measured
+     */
+    ProcessLimits::Usage processUsage( const QString& aPluginName ) const;
+
+    /*! \brief Kills the process of an out-of-process plugin
+     *
+     * Used for plugins that have stopped responding. The process is killed
+     * without giving it a chance to clean up.
+     * @param aPluginName Name of the plugin
+     * @return True if the plugin runs out of process and its process was
+     *  killed
+     */
+    bool killOOPPlugin( const QString& aPluginName );
+
 protected slots:
 
     void onProcessFinished( int exitCode, QProcess::ExitStatus exitStatus );
@@ -191,7 +216,7 @@ private:
 
     QProcess* startOOPPlugin( const QString& aPath,
                               const QString& aPluginName,
-                              const QString& aProfileName );
+                              const Profile& aProfile );
 
     void stopOOPPlugin( const QString& aPath );
 
@@ -207,7 +232,13 @@ private:
 
     QList<DllInfo>          iLoadedDlls;
 
-    QReadWriteLock          iDllLock;
+    mutable QReadWriteLock  iDllLock;
+
+    //! Resources used by stopped plugin processes, by executable path
+    QMap<QString, ProcessLimits::Usage> iProcessUsage;
+
+    //! Usage of the reaped children of the daemon when one last exited
+    ProcessLimits::Usage    iReapedUsage;
 
     QString                 iProcBinaryPath;
 
@@ -22,14 +22,31 @@
 #include "PluginServiceObj.h"
 #include <SyncResults.h>
 #include <ProfileManager.h>
+#include <ProfileCodec.h>
 #include <LogMacros.h>
 #include <SyncCommonDefs.h>
+#include <SyncPluginBase.h>
+#include <WritePacer.h>
+#include <QDBusConnection>
+#include <stdlib.h>
 
 using namespace Buteo;
 
 PluginServiceObj::PluginServiceObj( QString aProfileName, QString aPluginName, QObject *parent) :
     QObject(parent), iPlugin(0), iProfileName(aProfileName), iPluginName(aPluginName)
 {
+    // Storage writes of the plugin are paced by the device activity of msyncd.
+    // The state at startup comes from the environment, as the D-Bus signal is
+    // only sent when it changes.
+    QByteArray activity = qgetenv( OOP_DEVICE_ACTIVITY_ENV );
+    if( !activity.isEmpty() ) {
+        deviceActivityChanged( activity.toInt(), qgetenv( OOP_DEVICE_CHARGING_ENV ) == "1" );
+        unsetenv( OOP_DEVICE_ACTIVITY_ENV );
+        unsetenv( OOP_DEVICE_CHARGING_ENV );
+    }
+    QDBusConnection::sessionBus().connect( "com.meego.msyncd", "/synchronizer",
+                                           "com.meego.msyncd", "deviceActivityChanged",
+                                           this, SLOT(deviceActivityChanged(int, bool)) );
 }
 
 PluginServiceObj::~PluginServiceObj()
@@ -40,12 +57,40 @@ PluginServiceObj::~PluginServiceObj()
     }
 }
 
+void PluginServiceObj::setProfileData( const QByteArray &aData )
+{
+    iProfileData = aData;
+}
+
 namespace {
-    void initializePlugin(const QString &profileName, const QString &pluginName, Buteo::PluginCbImpl *pluginCb, CLASSNAME **plugin)
+    Profile *decodeProfile(const QByteArray &profileData, const QString &profileType)
+    {
+        if( profileData.isEmpty() ) {
+            return 0;
+        }
+
+        Profile *profile = ProfileCodec::decode( profileData );
+        if( profile && profile->type() != profileType ) {
+            LOG_WARNING( "Profile passed by msyncd has unexpected type" << profile->type() );
+            delete profile;
+            profile = 0;
+        }
+        if( !profile ) {
+            LOG_WARNING( "Could not decode profile passed by msyncd, loading it" );
+        }
+        return profile;
+    }
+
+    void initializePlugin(const QString &profileName, const QString &pluginName, const QByteArray &profileData, Buteo::PluginCbImpl *pluginCb, CLASSNAME **plugin)
     {
         ProfileManager pm;
 #ifdef CLIENT_PLUGIN
-        SyncProfile *syncProfile = pm.syncProfile( profileName );
+        // RTTI is not allowed, use static_cast. Should be safe, because
+        // type is verified.
+        SyncProfile *syncProfile = static_cast<SyncProfile*>( decodeProfile( profileData, Profile::TYPE_SYNC ) );
+        if( !syncProfile ) {
+            syncProfile = pm.syncProfile( profileName );
+        }
         if( !syncProfile ) {
             LOG_WARNING( "Profile " << profileName << " does not exist" );
             return;
@@ -54,7 +99,10 @@ namespace {
         // Create the plugin (client)
         *plugin = new CLASSNAME( pluginName, *syncProfile, pluginCb );
 #else
-        Profile *profile = pm.profile( profileName, Profile::TYPE_SERVER );
+        Profile *profile = decodeProfile( profileData, Profile::TYPE_SERVER );
+        if( !profile ) {
+            profile = pm.profile( profileName, Profile::TYPE_SERVER );
+        }
         if( !profile || !profile->isValid() ) {
             LOG_WARNING( "Profile " << profileName << " does not exist" );
             return;
@@ -72,7 +120,7 @@ bool PluginServiceObj::init()
 {
     FUNCTION_CALL_TRACE;
 
-    initializePlugin(iProfileName, iPluginName, &iPluginCb, &iPlugin);
+    initializePlugin(iProfileName, iPluginName, iProfileData, &iPluginCb, &iPlugin);
     if (!iPlugin) {
         LOG_WARNING( "PluginServiceObj::init(): unable to initialize plugin" );
         return false;
@@ -126,7 +174,7 @@ bool PluginServiceObj::cleanUp()
     FUNCTION_CALL_TRACE;
 
     if (!iPlugin) {
-        initializePlugin(iProfileName, iPluginName, &iPluginCb, &iPlugin);
+        initializePlugin(iProfileName, iPluginName, iProfileData, &iPluginCb, &iPlugin);
         if (!iPlugin) {
             LOG_WARNING( "PluginServiceObj::cleanUp(): unable to initialize plugin" );
             return false;
@@ -147,6 +195,14 @@ void PluginServiceObj::connectivityStateChanged(int aType, bool aState)
     iPlugin->connectivityStateChanged( static_cast<Sync::ConnectivityType>(aType), aState );
 }
 
+void PluginServiceObj::deviceActivityChanged(int aActivity, bool aCharging)
+{
+    FUNCTION_CALL_TRACE;
+
+    WritePacer::setActivity( static_cast<WritePacer::Activity>(aActivity) );
+    WritePacer::setCharging( aCharging );
+}
+
 QString PluginServiceObj::getSyncResults()
 {
     FUNCTION_CALL_TRACE;
@@ -170,6 +226,17 @@ bool PluginServiceObj::startSync()
     return iPlugin->startSync();
 }
 
+bool PluginServiceObj::yieldSync()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (!iPlugin) {
+        LOG_WARNING( "PluginServiceObj::yieldSync(): called on uninitialized plugin" );
+        return false;
+    }
+    return iPlugin->requestYield();
+}
+
 #else
 void PluginServiceObj::resume()
 {
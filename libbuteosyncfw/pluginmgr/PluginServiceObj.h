@@ -40,6 +40,13 @@ public:
     PluginServiceObj( QString aProfile, QString aPluginName, QObject *parent = 0 );
     virtual ~PluginServiceObj();
 
+    /*! \brief Sets the profile encoded with ProfileCodec
+     *
+     * If set, the profile is used instead of loading it with ProfileManager.
+     * @param aData Encoded profile
+     */
+    void setProfileData( const QByteArray &aData );
+
 public: // PROPERTIES
 public Q_SLOTS: // METHODS
     void abortSync(uchar aStatus);
@@ -50,6 +57,7 @@ public Q_SLOTS: // METHODS
     bool uninit();
 #ifdef CLIENT_PLUGIN
     bool startSync();
+    bool yieldSync();
 #else
     void resume();
     bool startListen();
@@ -64,10 +72,14 @@ Q_SIGNALS: // SIGNALS
     void syncProgressDetail(const QString &aProfileName, int aProgressDetail);
     void transferProgress(const QString &aProfileName, Sync::TransferDatabase aDatabase, Sync::TransferType aType, const QString &aMimeType, int aCommittedItems);
 
+private Q_SLOTS:
+    void deviceActivityChanged(int aActivity, bool aCharging);
+
 private:
     CLASSNAME      *iPlugin;
     QString        iProfileName;
     QString        iPluginName;
+    QByteArray     iProfileData;
     PluginCbImpl   iPluginCb;
 };
 
@@ -0,0 +1,346 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "ProcessLimits.h"
+#include "Profile.h"
+#include "ProfileEngineDefs.h"
+#include "LogMacros.h"
+
+#include <QFile>
+#include <QDir>
+#include <QStringList>
+#include <QTextStream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+using namespace Buteo;
+
+static const QString CGROUP_ROOT( "/sys/fs/cgroup" );
+static const int IOPRIO_WHO_PROCESS = 1;
+static const int IOPRIO_CLASS_SHIFT = 13;
+static const qint64 BYTES_PER_MB = 1024 * 1024;
+static const qint64 MAX_LIMIT = Q_INT64_C( 1 ) << 30;
+
+static qint64 numberKey( const Profile& aProfile, const QString& aKey,
+                         qint64 aMax )
+{
+    bool ok = false;
+    qint64 value = aProfile.key( aKey ).toLongLong( &ok );
+    if( !ok || value < 0 ) {
+        return 0;
+    }
+    return qMin( value, aMax );
+}
+
+ProcessLimits::ProcessLimits()
+ : iNice( 0 ),
+   iIoClass( IO_CLASS_NONE ),
+   iIoPriority( 0 ),
+   iCpuLimit( 0 ),
+   iMemoryLimit( 0 ),
+   iCgroupCpuWeight( 0 ),
+   iCgroupMemoryMax( 0 )
+{
+}
+
+ProcessLimits ProcessLimits::fromProfile( const Profile& aProfile,
+                                          const QString& aPluginName )
+{
+    FUNCTION_CALL_TRACE;
+
+    const Profile* source = aProfile.subProfile( aPluginName, Profile::TYPE_CLIENT );
+    if( source == 0 ) {
+        source = &aProfile;
+    }
+
+    ProcessLimits limits;
+    limits.iNice = numberKey( *source, KEY_NICE, 19 );
+
+    const QString ioClass = source->key( KEY_IO_CLASS );
+    if( ioClass == "idle" ) {
+        limits.iIoClass = IO_CLASS_IDLE;
+    } else if( ioClass == "best-effort" ) {
+        limits.iIoClass = IO_CLASS_BEST_EFFORT;
+        limits.iIoPriority = numberKey( *source, KEY_IO_PRIORITY, 7 );
+    } else if( !ioClass.isEmpty() ) {
+        LOG_WARNING( "Unsupported I/O class" << ioClass << "for plugin" << aPluginName );
+    }
+
+    limits.iCpuLimit = numberKey( *source, KEY_CPU_LIMIT, MAX_LIMIT );
+    limits.iMemoryLimit = numberKey( *source, KEY_MEMORY_LIMIT, MAX_LIMIT );
+    limits.iCgroup = source->key( KEY_CGROUP );
+    limits.iCgroupCpuWeight = numberKey( *source, KEY_CGROUP_CPU_WEIGHT, 10000 );
+    limits.iCgroupMemoryMax = numberKey( *source, KEY_CGROUP_MEMORY_MAX, MAX_LIMIT );
+
+    return limits;
+}
+
+bool ProcessLimits::isEmpty() const
+{
+    return iNice == 0 && iIoClass == IO_CLASS_NONE && iCpuLimit == 0 &&
+           iMemoryLimit == 0 && iCgroup.isEmpty();
+}
+
+int ProcessLimits::nice() const
+{
+    return iNice;
+}
+
+ProcessLimits::IoClass ProcessLimits::ioClass() const
+{
+    return iIoClass;
+}
+
+int ProcessLimits::ioPriority() const
+{
+    return iIoPriority;
+}
+
+qint64 ProcessLimits::cpuLimit() const
+{
+    return iCpuLimit;
+}
+
+qint64 ProcessLimits::memoryLimit() const
+{
+    return iMemoryLimit;
+}
+
+QString ProcessLimits::cgroup() const
+{
+    return iCgroup;
+}
+
+bool ProcessLimits::prepare()
+{
+    FUNCTION_CALL_TRACE;
+
+    iCgroupProcs.clear();
+    if( iCgroup.isEmpty() ) {
+        return true;
+    }
+
+    if( !QFile::exists( CGROUP_ROOT + "/cgroup.controllers" ) ) {
+        LOG_WARNING( "cgroup v2 not available, not using cgroup" << iCgroup );
+        return false;
+    }
+
+    QString path;
+    if( iCgroup.startsWith( '/' ) ) {
+        path = CGROUP_ROOT + iCgroup;
+    } else {
+        QString own = ownCgroup();
+        if( own.isEmpty() ) {
+            LOG_WARNING( "Could not find the cgroup of msyncd" );
+            return false;
+        }
+        path = CGROUP_ROOT + own.left( own.lastIndexOf( '/' ) ) + '/' + iCgroup;
+    }
+    path = QDir::cleanPath( path );
+    if( !path.startsWith( CGROUP_ROOT + '/' ) ) {
+        LOG_WARNING( "Invalid cgroup" << iCgroup );
+        return false;
+    }
+
+    if( !QDir().mkpath( path ) ) {
+        LOG_WARNING( "Could not create cgroup" << path );
+        return false;
+    }
+
+    if( iCgroupCpuWeight > 0 ) {
+        QFile weight( path + "/cpu.weight" );
+        if( !weight.open( QIODevice::WriteOnly ) ||
+            weight.write( QByteArray::number( iCgroupCpuWeight ) ) < 0 ) {
+            LOG_WARNING( "Could not set cpu.weight of cgroup" << path );
+        }
+    }
+
+    if( iCgroupMemoryMax > 0 ) {
+        QFile memory( path + "/memory.max" );
+        if( !memory.open( QIODevice::WriteOnly ) ||
+            memory.write( QByteArray::number( iCgroupMemoryMax * BYTES_PER_MB ) ) < 0 ) {
+            LOG_WARNING( "Could not set memory.max of cgroup" << path );
+        }
+    }
+
+    iCgroupProcs = QFile::encodeName( path + "/cgroup.procs" );
+    return true;
+}
+
+void ProcessLimits::apply() const
+{
+    // Runs between fork and exec: no logging, no allocations.
+    if( !iCgroupProcs.isEmpty() ) {
+        int fd = ::open( iCgroupProcs.constData(), O_WRONLY );
+        if( fd >= 0 ) {
+            // "0" moves the writing process
+            if( ::write( fd, "0\n", 2 ) < 0 ) {
+                // Keep running in the group of msyncd
+            }
+            ::close( fd );
+        }
+    }
+
+    if( iNice > 0 ) {
+        ::setpriority( PRIO_PROCESS, 0, iNice );
+    }
+
+    if( iIoClass != IO_CLASS_NONE ) {
+        ::syscall( SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0,
+                   (iIoClass << IOPRIO_CLASS_SHIFT) | iIoPriority );
+    }
+
+    if( iCpuLimit > 0 ) {
+        struct rlimit limit;
+        limit.rlim_cur = iCpuLimit;
+        // Leave time to handle SIGXCPU before SIGKILL.
+        limit.rlim_max = iCpuLimit + 5;
+        ::setrlimit( RLIMIT_CPU, &limit );
+    }
+
+    if( iMemoryLimit > 0 ) {
+        struct rlimit limit;
+        limit.rlim_cur = limit.rlim_max = iMemoryLimit * BYTES_PER_MB;
+        ::setrlimit( RLIMIT_AS, &limit );
+    }
+}
+
+QString ProcessLimits::toString() const
+{
+    QStringList parts;
+    if( iNice > 0 ) {
+        parts << QString( "nice=%1" ).arg( iNice );
+    }
+    if( iIoClass == IO_CLASS_IDLE ) {
+        parts << "io=idle";
+    } else if( iIoClass == IO_CLASS_BEST_EFFORT ) {
+        parts << QString( "io=best-effort/%1" ).arg( iIoPriority );
+    }
+    if( iCpuLimit > 0 ) {
+        parts << QString( "cpu=%1s" ).arg( iCpuLimit );
+    }
+    if( iMemoryLimit > 0 ) {
+        parts << QString( "memory=%1MB" ).arg( iMemoryLimit );
+    }
+    if( !iCgroup.isEmpty() ) {
+        parts << QString( "cgroup=%1" ).arg( iCgroup );
+    }
+    return parts.join( " " );
+}
+
+ProcessLimits::Usage ProcessLimits::usage( qint64 aPid )
+{
+    FUNCTION_CALL_TRACE;
+
+    Usage usage;
+
+    QFile stat( QString( "/proc/%1/stat" ).arg( aPid ) );
+    if( !stat.open( QIODevice::ReadOnly ) ) {
+        return usage;
+    }
+    QByteArray line = stat.readAll();
+    // The command name may contain spaces, fields are counted after it.
+    int end = line.lastIndexOf( ')' );
+    if( end < 0 ) {
+        return usage;
+    }
+    QList<QByteArray> fields = line.mid( end + 2 ).split( ' ' );
+    if( fields.size() < 13 ) {
+        return usage;
+    }
+    const long ticks = ::sysconf( _SC_CLK_TCK );
+    if( ticks > 0 ) {
+        // utime and stime, fields 14 and 15 of the whole line
+        usage.cpuTime = ( fields.at( 11 ).toLongLong() +
+                          fields.at( 12 ).toLongLong() ) * 1000 / ticks;
+    }
+
+    QFile status( QString( "/proc/%1/status" ).arg( aPid ) );
+    if( status.open( QIODevice::ReadOnly ) ) {
+        QTextStream stream( &status );
+        QString statusLine;
+        while( !( statusLine = stream.readLine() ).isNull() ) {
+            if( statusLine.startsWith( "VmHWM:" ) ) {
+                usage.peakMemory = statusLine.mid( 6 ).trimmed()
+                                   .section( ' ', 0, 0 ).toLongLong();
+                break;
+            }
+        }
+    }
+
+    usage.valid = true;
+    return usage;
+}
+
+ProcessLimits::Usage ProcessLimits::childrenUsage()
+{
+    FUNCTION_CALL_TRACE;
+
+    Usage usage;
+
+    struct rusage children;
+    if( ::getrusage( RUSAGE_CHILDREN, &children ) != 0 ) {
+        return usage;
+    }
+    usage.cpuTime = ( static_cast<qint64>( children.ru_utime.tv_sec ) +
+                      children.ru_stime.tv_sec ) * 1000 +
+                    ( children.ru_utime.tv_usec + children.ru_stime.tv_usec ) / 1000;
+    // ru_maxrss is in kilobytes on Linux
+    usage.peakMemory = children.ru_maxrss;
+    usage.valid = true;
+    return usage;
+}
+
+QString ProcessLimits::ownCgroup()
+{
+    QFile file( "/proc/self/cgroup" );
+    if( !file.open( QIODevice::ReadOnly ) ) {
+        return QString();
+    }
+
+    // cgroup v2 has a single line "0::<path>"
+    foreach( const QByteArray& line, file.readAll().split( '\n' ) ) {
+        if( line.startsWith( "0::" ) ) {
+            return QString::fromUtf8( line.mid( 3 ) ).trimmed();
+        }
+    }
+    return QString();
+}
+
+LimitedProcess::LimitedProcess( const ProcessLimits& aLimits, QObject* aParent )
+ : QProcess( aParent ),
+   iLimits( aLimits )
+{
+}
+
+const ProcessLimits& LimitedProcess::limits() const
+{
+    return iLimits;
+}
+
+void LimitedProcess::setupChildProcess()
+{
+    iLimits.apply();
+}
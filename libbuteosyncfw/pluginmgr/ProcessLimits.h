@@ -0,0 +1,202 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef PROCESSLIMITS_H
+#define PROCESSLIMITS_H
+
+#include <QString>
+#include <QByteArray>
+#include <QProcess>
+
+namespace Buteo {
+
+class Profile;
+
+/*!
+ * \brief Resource limits of an out-of-process plugin
+ *
+ * The limits are read from the client sub-profile of the plugin, or from the
+ * server profile, and applied to the plugin process before its binary is
+ * executed:
+ * - nice: scheduling niceness, 1-19
+ * - io_class and io_priority: I/O scheduling class ("idle" or
+ *   "best-effort") and priority within the best-effort class, 0-7
+ * - cpu_limit: CPU time in seconds, the process gets SIGXCPU when exceeded
+ * - memory_limit: address space in megabytes
+ * - cgroup: cgroup v2 group to run the process in. A relative name is a
+ *   sibling of the group of msyncd, so that the group of msyncd does not get
+ *   child groups with processes of their own. The group is created if
+ *   needed, and cgroup_cpu_weight and cgroup_memory_max (megabytes) are
+ *   written to it if given.
+ *
+ * Limits that cannot be applied are logged and skipped, the plugin is still
+ * started.
+ */
+class ProcessLimits {
+public:
+
+    //! I/O scheduling classes, values as in ioprio_set()
+    enum IoClass {
+        IO_CLASS_NONE = 0,
+        IO_CLASS_BEST_EFFORT = 2,
+        IO_CLASS_IDLE = 3
+    };
+
+    //! Resources used by a plugin process
+    struct Usage {
+        //! User and system CPU time in milliseconds
+        qint64 cpuTime;
+
+        //! Peak resident memory in kilobytes
+        qint64 peakMemory;
+
+        //! Was the usage read successfully
+        bool valid;
+
+        Usage() : cpuTime( 0 ), peakMemory( 0 ), valid( false ) { }
+    };
+
+    /**
+     * \brief Constructor, no limits
+     */
+    ProcessLimits();
+
+    /*! \brief Reads the limits of a plugin from a profile
+     *
+     * @param aProfile Sync profile of a client plugin or server profile
+     * @param aPluginName Name of the plugin
+     * @return Limits
+     */
+    static ProcessLimits fromProfile( const Profile& aProfile,
+                                      const QString& aPluginName );
+
+    /*! \brief Checks if any limits are set
+     *
+     * @return True if there are no limits
+     */
+    bool isEmpty() const;
+
+    //! \brief Niceness, 0 if not set
+    int nice() const;
+
+    //! \brief I/O scheduling class
+    IoClass ioClass() const;
+
+    //! \brief I/O priority within the class
+    int ioPriority() const;
+
+    //! \brief CPU time limit in seconds, 0 if not set
+    qint64 cpuLimit() const;
+
+    //! \brief Address space limit in megabytes, 0 if not set
+    qint64 memoryLimit() const;
+
+    //! \brief Name of the cgroup, empty if not set
+    QString cgroup() const;
+
+    /*! \brief Prepares the limits for a new process
+     *
+     * Resolves and creates the cgroup. Must be called in the parent process
+     * before the plugin process is started.
+     * @return False if the cgroup could not be prepared
+     */
+    bool prepare();
+
+    /*! \brief Applies the limits to the calling process
+     *
+     * Called in the child process between fork and exec, so it only uses
+     * async-signal-safe system calls and no memory allocation.
+     */
+    void apply() const;
+
+    /*! \brief Returns a description of the limits for logs
+     *
+     * @return Description
+     */
+    QString toString() const;
+
+    /*! \brief Reads the resources used by a process so far
+     *
+     * @param aPid Process id
+     * @return Usage, not valid if the process does not exist
+     */
+    static Usage usage( qint64 aPid );
+
+    /*! \brief Reads the resources used by all children of this process
+     *  that have exited and been waited for
+     *
+     * The CPU time is the sum over the children, the peak memory is the
+     * largest peak of a single child.
+     * @return Usage
+     */
+    static Usage childrenUsage();
+
+private:
+
+    static QString ownCgroup();
+
+    int         iNice;
+    IoClass     iIoClass;
+    int         iIoPriority;
+    qint64      iCpuLimit;
+    qint64      iMemoryLimit;
+    QString     iCgroup;
+    int         iCgroupCpuWeight;
+    qint64      iCgroupMemoryMax;
+
+    //! Resolved path of cgroup.procs of the group, set by prepare()
+    QByteArray  iCgroupProcs;
+};
+
+/*!
+ * \brief Process that applies resource limits to itself before exec
+ */
+class LimitedProcess : public QProcess {
+    Q_OBJECT
+
+public:
+
+    /*! \brief Constructor
+     *
+     * @param aLimits Prepared limits
+     * @param aParent Parent object
+     */
+    explicit LimitedProcess( const ProcessLimits& aLimits, QObject* aParent = 0 );
+
+    /*! \brief Returns the limits of the process
+     *
+     * @return Limits
+     */
+    const ProcessLimits& limits() const;
+
+protected:
+
+    virtual void setupChildProcess();
+
+private:
+
+    ProcessLimits iLimits;
+};
+
+}
+
+#endif // PROCESSLIMITS_H
@@ -35,3 +35,19 @@ ServerPlugin::ServerPlugin( const QString& aPluginName,
 ServerPlugin::~ServerPlugin()
 {
 }
+
+int ServerPlugin::maxSessions() const
+{
+    return 1;
+}
+
+SyncResults ServerPlugin::sessionResults(const QString &/*aSessionId*/)
+{
+    return getSyncResults();
+}
+
+void ServerPlugin::abortSession(const QString &/*aSessionId*/,
+                                Sync::SyncStatus aStatus)
+{
+    abortSync(aStatus);
+}
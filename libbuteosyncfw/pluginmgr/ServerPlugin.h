@@ -78,6 +78,33 @@ public:
      */
     virtual void resume() = 0;
 
+    /*! \brief Returns how many peer sessions the plug-in can serve at once
+     *
+     * Plug-ins that serve several peers concurrently reimplement this and
+     * report each session with newPeerSession(), and its outcome with the
+     * session signals below. The default is one session, reported with
+     * newSession() and the plug-in wide signals.
+     * @return Maximum number of concurrent sessions
+     */
+    virtual int maxSessions() const;
+
+    /*! \brief Gets the results of a peer session
+     *
+     * The default implementation returns getSyncResults().
+     * @param aSessionId Session id given in newPeerSession()
+     * @return Results of the session
+     */
+    virtual SyncResults sessionResults(const QString &aSessionId);
+
+    /*! \brief Aborts a peer session
+     *
+     * The default implementation aborts the plug-in with abortSync().
+     * @param aSessionId Session id given in newPeerSession()
+     * @param aStatus Status to abort with
+     */
+    virtual void abortSession(const QString &aSessionId,
+                              Sync::SyncStatus aStatus = Sync::SYNC_ABORTED);
+
 signals:
 
     /*! \brief Signal sent when a new sync session is received by the server
@@ -87,6 +114,28 @@ signals:
      */
     void newSession(const QString &aDestination);
 
+    /*! \brief Signal sent when a new concurrent peer session is received
+     *
+     * Storages used by the session should be reserved with
+     * PluginCbInterface::requestSessionStorage().
+     * @param aDestination Sync destination address, for example BT address
+     *  or URL.
+     * @param aSessionId Id of the session, unique within the plug-in
+     */
+    void newPeerSession(const QString &aDestination, const QString &aSessionId);
+
+    //! @see SyncPluginBase::transferProgress, for one peer session
+    void sessionTransferProgress(const QString &aSessionId,
+            Sync::TransferDatabase aDatabase, Sync::TransferType aType,
+            const QString &aMimeType, int aCommittedItems);
+
+    //! @see SyncPluginBase::error, for one peer session
+    void sessionError(const QString &aSessionId, const QString &aMessage,
+                      int aErrorCode);
+
+    //! @see SyncPluginBase::success, for one peer session
+    void sessionSuccess(const QString &aSessionId, const QString &aMessage);
+
 protected:
 
     //! Profile Object that the server plugin operates on
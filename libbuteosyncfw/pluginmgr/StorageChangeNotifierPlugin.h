@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 
 namespace Buteo
 {
@@ -61,6 +62,19 @@ public:
      */
     virtual void disable(bool disableAfterNextChange = false) = 0;
 
+    /*! \brief Returns the write origins of the changes
+     *
+     * Storage plug-ins tag the changes they write with the token set by
+     * StoragePlugin::setWriteOrigin(), if the storage backend supports it.
+     * Plug-ins that can read the tags back report here the distinct tokens
+     * of the changes received since changesReceived() was last called, with
+     * an empty string for untagged changes. The framework uses this to drop
+     * changes caused by its own sync sessions.
+     *
+     * @return Write origins, empty if not known
+     */
+    virtual QStringList changeOrigins() const { return QStringList(); }
+
 Q_SIGNALS:
     /*! \brief emit this signal when there's a change in this
      * storage. It's upto the plug-in when and how frequently
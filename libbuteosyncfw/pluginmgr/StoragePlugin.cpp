@@ -21,16 +21,60 @@
  *
  */
 #include "StoragePlugin.h"
+#include "StorageItem.h"
+#include "FingerprintCache.h"
+#include "WritePacer.h"
+#include "LogMacros.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
 
 using namespace Buteo;
 
+namespace {
+
+// State of a storage plugin that is not part of the installed class. It
+// is kept outside the object so that the object layout stays the same for
+// plugins built against older headers.
+struct StoragePluginPrivate
+{
+    StoragePluginPrivate() : iFingerprintCache( 0 ) { }
+
+    //! Fingerprint cache of the storage, not owned
+    FingerprintCache*         iFingerprintCache;
+
+    //! Token to tag the changes written by this storage with
+    QString                   iWriteOrigin;
+
+    //! Paces bulk writes
+    WritePacer                iWritePacer;
+};
+
+// Private state of the existing storage plugins. Plugins can be created and
+// used in several threads.
+QMutex privateMutex;
+QHash<const StoragePlugin*, StoragePluginPrivate*> privates;
+
+StoragePluginPrivate* privateData( const StoragePlugin* aPlugin )
+{
+    QMutexLocker locker( &privateMutex );
+    return privates.value( aPlugin );
+}
+
+}
+
 StoragePlugin::StoragePlugin( const QString& aPluginName ) :
   iPluginName( aPluginName )
 {
+    QMutexLocker locker( &privateMutex );
+    privates.insert( this, new StoragePluginPrivate );
 }
 
 StoragePlugin::~StoragePlugin()
 {
+    QMutexLocker locker( &privateMutex );
+    delete privates.take( this );
 }
 
 const QString& StoragePlugin::getPluginName() const
@@ -52,3 +96,95 @@ void StoragePlugin::getProperties( QMap<QString, QString>& aProperties ) const
 {
     aProperties = iProperties;
 }
+
+void StoragePlugin::setFingerprintCache( FingerprintCache* aCache )
+{
+    privateData( this )->iFingerprintCache = aCache;
+}
+
+FingerprintCache* StoragePlugin::fingerprintCache() const
+{
+    return privateData( this )->iFingerprintCache;
+}
+
+bool StoragePlugin::updateFingerprints( const QList<QString>& aItemIds )
+{
+    FUNCTION_CALL_TRACE;
+
+    FingerprintCache* cache = fingerprintCache();
+    if( !cache ) {
+        return false;
+    }
+
+    if( aItemIds.isEmpty() ) {
+        return true;
+    }
+
+    QList<StorageItem*> items = getItems( aItemIds );
+    bool success = cache->update( items );
+    qDeleteAll( items );
+
+    return success;
+}
+
+QList<QString> StoragePlugin::getIdenticalItemIds( const QMap<QString, QByteArray>& aContentHashes ) const
+{
+    FUNCTION_CALL_TRACE;
+
+    FingerprintCache* cache = fingerprintCache();
+    if( !cache ) {
+        return QList<QString>();
+    }
+
+    return cache->matchingItems( aContentHashes );
+}
+
+void StoragePlugin::setWriteOrigin( const QString& aOrigin )
+{
+    privateData( this )->iWriteOrigin = aOrigin;
+}
+
+QString StoragePlugin::writeOrigin() const
+{
+    return privateData( this )->iWriteOrigin;
+}
+
+QList<StoragePlugin::OperationStatus> StoragePlugin::addItemsPaced( const QList<StorageItem*>& aItems )
+{
+    return writePaced( aItems, false );
+}
+
+QList<StoragePlugin::OperationStatus> StoragePlugin::modifyItemsPaced( const QList<StorageItem*>& aItems )
+{
+    return writePaced( aItems, true );
+}
+
+WritePacer* StoragePlugin::writePacer() const
+{
+    return &privateData( this )->iWritePacer;
+}
+
+QList<StoragePlugin::OperationStatus> StoragePlugin::writePaced( const QList<StorageItem*>& aItems,
+                                                                 bool aModify )
+{
+    FUNCTION_CALL_TRACE;
+
+    WritePacer* pacer = writePacer();
+    QList<OperationStatus> results;
+    QElapsedTimer timer;
+    int index = 0;
+
+    while( index < aItems.count() ) {
+        if( index > 0 ) {
+            pacer->wait();
+        }
+
+        QList<StorageItem*> chunk = aItems.mid( index, pacer->chunkSize() );
+        timer.start();
+        results.append( aModify ? modifyItems( chunk ) : addItems( chunk ) );
+        pacer->chunkCommitted( chunk.count(), timer.elapsed() );
+        index += chunk.count();
+    }
+
+    return results;
+}
@@ -27,10 +27,13 @@
 #include <QMap>
 #include <QList>
 #include <QDateTime>
+#include <QByteArray>
 
 namespace Buteo {
 
 class StorageItem;
+class FingerprintCache;
+class WritePacer;
 
 /*! \brief Base class for storage plugins
  *
@@ -215,6 +218,26 @@ public:
      */
     virtual QList<OperationStatus> modifyItems( const QList<StorageItem*>& aItems ) = 0;
 
+    /*! \brief Adds items to the storage in paced chunks
+     *
+     * Commits the items with addItems() in chunks sized by the write pacer of
+     * the storage, pausing between the chunks so that bulk commits do not
+     * starve the I/O of foreground applications. Plug-ins should use this
+     * instead of addItems() when committing large numbers of items.
+     *
+     * @param aItems Items to add
+     * @return Operation status codes
+     */
+    QList<OperationStatus> addItemsPaced( const QList<StorageItem*>& aItems );
+
+    /*! \brief Modifies items in the storage in paced chunks
+     *
+     * @see addItemsPaced()
+     * @param aItems Items to modify
+     * @return Operation status codes
+     */
+    QList<OperationStatus> modifyItemsPaced( const QList<StorageItem*>& aItems );
+
     /*! \brief Deletes an item from the storage
      *
      * @param aItemId Id of the item to be deleted
@@ -229,13 +252,77 @@ public:
      */
     virtual QList<OperationStatus> deleteItems( const QList<QString>& aItemIds ) = 0;
 
+    /*! \brief Sets the fingerprint cache used by this storage
+     *
+     * The cache is owned by the caller, typically the client plugin.
+     * @param aCache Fingerprint cache, NULL to disable fingerprinting
+     */
+    void setFingerprintCache( FingerprintCache* aCache );
+
+    /*! \brief Returns the fingerprint cache used by this storage
+     *
+     * @return Fingerprint cache, NULL if not set
+     */
+    FingerprintCache* fingerprintCache() const;
+
+    /*! \brief Updates the fingerprints of the given items
+     *
+     * Should be called after a successful sync for the items that were
+     * synchronized. Reads the items with getItems() and stores their
+     * content hashes in the fingerprint cache.
+     *
+     * @param aItemIds Id's of the items
+     * @return True on success, otherwise false
+     */
+    bool updateFingerprints( const QList<QString>& aItemIds );
+
+    /*! \brief Returns the items whose content is already up to date
+     *
+     * Used during slow syncs to skip writing and transferring items that
+     * have not changed. Content hashes can be calculated with
+     * FingerprintCache::contentHash().
+     *
+     * @param aContentHashes Map of local item id's and content hashes of the
+     *  incoming items
+     * @return Id's of the items that already have identical content
+     */
+    QList<QString> getIdenticalItemIds( const QMap<QString, QByteArray>& aContentHashes ) const;
+
+    /*! \brief Sets the write origin token of the storage
+     *
+     * Set by the framework when the storage is created for a sync session.
+     * Plug-ins whose backend can record where a change came from should tag
+     * the items they add, modify and delete with this token, so that change
+     * notifiers can tell the changes made by the session apart.
+     *
+     * @param aOrigin Write origin token, empty if changes are not tagged
+     */
+    void setWriteOrigin( const QString& aOrigin );
+
+    /*! \brief Returns the write origin token of the storage
+     *
+     * @return Write origin token, empty if not set
+     */
+    QString writeOrigin() const;
+
 protected:
 
+    /*! \brief Returns the write pacer of the storage
+     *
+     * @return Write pacer
+     */
+    WritePacer* writePacer() const;
+
     //! Name of the plugin
     QString                   iPluginName;
 
     //! Properties of the plugin as read from profile xml
     QMap<QString, QString>    iProperties;
+
+private:
+
+    QList<OperationStatus> writePaced( const QList<StorageItem*>& aItems,
+                                       bool aModify );
 };
 
 }
@@ -159,6 +159,17 @@ signals:
      * \param aNextSyncTime This is an out parameter. The next sync time.
      */
     void statusChanged(unsigned int aAccountId, int aNewStatus, int aFailedReason, qlonglong aPrevSyncTime, qlonglong aNextSyncTime);
+
+    /*! \brief Notifies about a change in device activity
+     *
+     * Out-of-process plug-ins use this to pace their storage writes.
+     * \param aActivity WritePacer::Activity of the device:
+     *      0 (UNKNOWN): No activity hint has been given.
+     *      1 (FOREGROUND): The user is interacting with the device.
+     *      2 (IDLE): The user is not interacting with the device.
+     * \param aCharging True if the device is charging
+     */
+    void deviceActivityChanged(int aActivity, bool aCharging);
  
 public slots:
 
@@ -345,6 +356,50 @@ public slots:
      * 1 = Last sync succeeded, 2 = last sync failed
      */
     virtual int status(unsigned int aAccountId, int &aFailedReason, qlonglong &aPrevSyncTime, qlonglong &aNextSyncTime) = 0;
+
+    /*! \brief Tells whether the user is interacting with the device
+     *
+     * Bulk storage writes of sync sessions yield to foreground I/O while the
+     * user is interacting with the device, and speed up when the device is
+     * idle or charging. The hint should be given by the component that
+     * tracks the display and input state.
+     * \param aActive True if the user is interacting with the device
+     */
+    virtual Q_NOREPLY void setForegroundActive(bool aActive) = 0;
+
+    /*! \brief Subscribes the caller to the status of profiles and accounts
+     *
+     * Status changes and transfer progress of the followed profiles are
+     * delivered only to the caller, in order, batched and with progress
+     * coalesced. Batches are sent as XML to the statusUpdates method of the
+     * com.meego.msyncd.StatusListener interface at the given object path.
+     * A new subscription replaces the earlier one of the same listener. The
+     * subscription ends when the caller leaves the bus.
+     * \param aListenerPath Object path of the caller's listener
+     * \param aProfileIds Profiles to follow
+     * \param aAccountIds Accounts whose sync profiles to follow
+     */
+    virtual Q_NOREPLY void subscribeStatus(QString aListenerPath,
+                                           QStringList aProfileIds,
+                                           QList<unsigned int> aAccountIds) = 0;
+
+    /*! \brief Ends a status subscription of the caller
+     *
+     * \param aListenerPath Object path given in subscribeStatus
+     */
+    virtual Q_NOREPLY void unsubscribeStatus(QString aListenerPath) = 0;
+
+    /*! \brief Reports partial results of a running sync session
+     *
+     * Used by out-of-process client plug-ins to stream the items processed
+     * in a target while the session is running.
+     * \see PluginCbInterface::reportTargetResults
+     * \param aProfileId Name of the profile being synchronized
+     * \param aTargetResults Item counts processed since the previous report,
+     *  as TargetResults XML
+     */
+    virtual Q_NOREPLY void reportTargetResults(QString aProfileId,
+                                               QString aTargetResults) = 0;
 };
 
 }
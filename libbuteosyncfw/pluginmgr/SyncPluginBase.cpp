@@ -55,3 +55,13 @@ SyncResults SyncPluginBase::getSyncResults() const
 {
     return SyncResults();
 }
+
+bool SyncPluginBase::requestYield()
+{
+    bool yielding = false;
+    if( metaObject()->indexOfMethod( "yieldSync()" ) >= 0 ) {
+        QMetaObject::invokeMethod( this, "yieldSync", Qt::DirectConnection,
+                                   Q_RETURN_ARG( bool, yielding ) );
+    }
+    return yielding;
+}
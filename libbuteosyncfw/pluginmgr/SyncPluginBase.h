@@ -35,6 +35,16 @@
 #define DBUS_SERVICE_NAME_PREFIX "com.buteo.msyncd.plugin."
 #define DBUS_SERVICE_OBJ_PATH "/"
 
+// Environment variable telling an out-of-process plugin that the encoded
+// profile is available in its standard input
+#define OOP_PROFILE_FROM_STDIN_ENV "BUTEO_PROFILE_FROM_STDIN"
+
+// Environment variables carrying the device activity and charging state of
+// msyncd when an out-of-process plugin is started. Later changes are
+// signaled over D-Bus.
+#define OOP_DEVICE_ACTIVITY_ENV "BUTEO_DEVICE_ACTIVITY"
+#define OOP_DEVICE_CHARGING_ENV "BUTEO_DEVICE_CHARGING"
+
 namespace Buteo {
 
 class PluginCbInterface;
@@ -112,6 +122,22 @@ public:
 	 */
 	virtual SyncResults getSyncResults() const;
 
+	/*! \brief Asks the plug-in to checkpoint and yield its storages
+	 *
+	 * Called when a sync requested by the user needs storages that this
+	 * scheduled session is using. Plug-ins that support yielding declare
+	 * \code Q_INVOKABLE bool yieldSync(); \endcode
+	 * which is looked up through the meta object, so that plug-ins built
+	 * without it keep working. yieldSync() should save enough state for the
+	 * next session of the same profile to continue from where this one
+	 * stopped, return true and then finish the session by emitting error()
+	 * with SyncResults::YIELDED. The session is queued again automatically.
+	 *
+	 * @return True if the session will yield, false if it keeps running or
+	 *  the plug-in does not support yielding
+	 */
+	bool requestYield();
+
 signals:
 
 	/*! \brief Emitted when progress has been made in synchronization in
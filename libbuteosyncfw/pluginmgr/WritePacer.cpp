@@ -0,0 +1,158 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "WritePacer.h"
+#include "LogMacros.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <unistd.h>
+
+using namespace Buteo;
+
+static const int INITIAL_CHUNK_SIZE = 32;
+static const int MAX_PAUSE = 2000;
+
+//! Pacing targets of a mode
+struct PacingLimits {
+    //! Largest chunk size
+    int maxChunkSize;
+    //! Commit latency of a chunk to aim for, in milliseconds
+    qint64 targetLatency;
+    //! Shortest pause between chunks, in milliseconds
+    int minPause;
+    //! Pause between chunks in percents of the latency of the last chunk
+    int pauseRatio;
+};
+
+static const PacingLimits LIMITS[] = {
+    { 16, 25, 250, 400 },   // MODE_FOREGROUND
+    { 128, 100, 0, 100 },   // MODE_NORMAL
+    { 1024, 500, 0, 0 }     // MODE_RELAXED
+};
+
+static QMutex stateMutex;
+static WritePacer::Activity currentActivity = WritePacer::ACTIVITY_UNKNOWN;
+static bool charging = false;
+
+void WritePacer::setActivity( Activity aActivity )
+{
+    QMutexLocker locker( &stateMutex );
+    currentActivity = aActivity;
+}
+
+WritePacer::Activity WritePacer::activity()
+{
+    QMutexLocker locker( &stateMutex );
+    return currentActivity;
+}
+
+void WritePacer::setCharging( bool aCharging )
+{
+    QMutexLocker locker( &stateMutex );
+    charging = aCharging;
+}
+
+bool WritePacer::isCharging()
+{
+    QMutexLocker locker( &stateMutex );
+    return charging;
+}
+
+WritePacer::Mode WritePacer::mode()
+{
+    QMutexLocker locker( &stateMutex );
+
+    if( currentActivity == ACTIVITY_FOREGROUND ) {
+        return MODE_FOREGROUND;
+    }
+    else if( currentActivity == ACTIVITY_IDLE || charging ) {
+        return MODE_RELAXED;
+    }
+    else {
+        return MODE_NORMAL;
+    }
+}
+
+WritePacer::WritePacer()
+ : iChunkSize( INITIAL_CHUNK_SIZE ),
+   iLastLatency( 0 )
+{
+}
+
+WritePacer::~WritePacer()
+{
+}
+
+int WritePacer::chunkSize() const
+{
+    return qBound( 1, iChunkSize, LIMITS[mode()].maxChunkSize );
+}
+
+int WritePacer::pause() const
+{
+    const PacingLimits& limits = LIMITS[mode()];
+    qint64 pause = iLastLatency * limits.pauseRatio / 100;
+    return static_cast<int>( qMin( qMax( pause, qint64( limits.minPause ) ),
+                                   qint64( MAX_PAUSE ) ) );
+}
+
+void WritePacer::chunkCommitted( int aItems, qint64 aLatency )
+{
+    FUNCTION_CALL_TRACE;
+
+    if( aItems <= 0 ) {
+        return;
+    }
+
+    const PacingLimits& limits = LIMITS[mode()];
+    int current = chunkSize();
+    iLastLatency = qMax( aLatency, qint64( 0 ) );
+
+    if( iLastLatency > limits.targetLatency ) {
+        iChunkSize = qMax( 1, current / 2 );
+    }
+    else if( iLastLatency * 2 < limits.targetLatency && aItems >= current ) {
+        // Only full chunks tell whether a larger one would still fit.
+        iChunkSize = qMin( limits.maxChunkSize, current + qMax( 1, current / 2 ) );
+    }
+    else {
+        iChunkSize = current;
+    }
+
+    LOG_DEBUG( "Committed" << aItems << "items in" << aLatency
+               << "ms, next chunk size" << iChunkSize );
+}
+
+void WritePacer::wait()
+{
+    int msecs = pause();
+    if( msecs > 0 ) {
+        sleep( msecs );
+    }
+}
+
+void WritePacer::sleep( int aMsecs )
+{
+    ::usleep( aMsecs * 1000 );
+}
@@ -0,0 +1,151 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef WRITEPACER_H
+#define WRITEPACER_H
+
+#include <QtGlobal>
+
+namespace Buteo {
+
+/*!
+ * \brief Paces bulk writes to a storage backend
+ *
+ * Large syncs commit thousands of items, which competes for the flash with
+ * the applications the user is running. The pacer splits bulk commits into
+ * chunks and waits between them. The chunk size adapts to the observed
+ * commit latency: it is halved when a chunk takes longer than the target
+ * latency and grown while chunks commit well within it.
+ *
+ * The targets depend on the device activity, which is process wide and set
+ * by the sync daemon:
+ * - foreground: the user is interacting with the device. Chunks are small
+ *   and the pauses long, so that foreground I/O is served first.
+ * - normal: no activity hint has been given. Writes get about half of the
+ *   time.
+ * - relaxed: the device is idle or charging. Chunks are large and there
+ *   are no pauses.
+ *
+ * Storage plug-ins get paced writes with StoragePlugin::addItemsPaced() and
+ * StoragePlugin::modifyItemsPaced().
+ */
+class WritePacer
+{
+public:
+
+    //! Activity hint of the device
+    enum Activity {
+        ACTIVITY_UNKNOWN,    /*!< No hint given*/
+        ACTIVITY_FOREGROUND, /*!< User is interacting with the device*/
+        ACTIVITY_IDLE        /*!< User is not interacting with the device*/
+    };
+
+    //! Pacing modes, derived from the activity and charging state
+    enum Mode {
+        MODE_FOREGROUND,
+        MODE_NORMAL,
+        MODE_RELAXED
+    };
+
+    /*! \brief Sets the activity hint of this process
+     *
+     * @param aActivity Activity
+     */
+    static void setActivity( Activity aActivity );
+
+    /*! \brief Returns the activity hint of this process
+     *
+     * @return Activity
+     */
+    static Activity activity();
+
+    /*! \brief Sets whether the device is charging
+     *
+     * @param aCharging True if charging
+     */
+    static void setCharging( bool aCharging );
+
+    /*! \brief Returns whether the device is charging
+     *
+     * @return True if charging
+     */
+    static bool isCharging();
+
+    /*! \brief Returns the current pacing mode
+     *
+     * Foreground activity takes precedence over charging.
+     * @return Mode
+     */
+    static Mode mode();
+
+    /*! \brief Constructor
+     *
+     */
+    WritePacer();
+
+    /*! \brief Destructor
+     *
+     */
+    virtual ~WritePacer();
+
+    /*! \brief Returns the number of items to commit in the next chunk
+     *
+     * @return Chunk size, at least 1
+     */
+    int chunkSize() const;
+
+    /*! \brief Returns the pause before the next chunk
+     *
+     * @return Pause in milliseconds
+     */
+    int pause() const;
+
+    /*! \brief Adapts the chunk size to the latency of a committed chunk
+     *
+     * @param aItems Number of items in the chunk
+     * @param aLatency Time it took to commit the chunk in milliseconds
+     */
+    void chunkCommitted( int aItems, qint64 aLatency );
+
+    /*! \brief Waits for the pause before the next chunk
+     *
+     */
+    void wait();
+
+protected:
+
+    /*! \brief Sleeps the calling thread
+     *
+     * @param aMsecs Milliseconds to sleep
+     */
+    virtual void sleep( int aMsecs );
+
+private:
+
+    int iChunkSize;
+
+    qint64 iLastLatency;
+};
+
+}
+
+#endif // WRITEPACER_H
@@ -22,12 +22,15 @@
 #include <QCoreApplication>
 #include <QDBusConnection>
 #include <QRegExp>
+#include <QFile>
+#include <stdlib.h>
 #include "PluginServiceObj.h"
 #include "ButeoPluginIfaceAdaptor.h"
 #include "LogMacros.h"
 
 #define DBUS_SERVICE_NAME_PREFIX "com.buteo.msyncd.plugin."
 #define DBUS_SERVICE_OBJ_PATH "/"
+#define OOP_PROFILE_FROM_STDIN_ENV "BUTEO_PROFILE_FROM_STDIN"
 
 int main( int argc, char** argv )
 {
@@ -44,6 +47,21 @@ int main( int argc, char** argv )
     QString pluginName = QString( argv[1] );
     QString profileName = QString( argv[2] );
 
+    // msyncd passes the expanded profile in stdin, so that it does not
+    // need to be loaded from disk here. The variable is not passed on to
+    // processes started by the plugin.
+    QByteArray profileData;
+    if( qgetenv( OOP_PROFILE_FROM_STDIN_ENV ) == "1" )
+    {
+        unsetenv( OOP_PROFILE_FROM_STDIN_ENV );
+        QFile input;
+        if( input.open( stdin, QIODevice::ReadOnly ) ) {
+            profileData = input.readAll();
+            input.close();
+        }
+        LOG_DEBUG( "Read" << profileData.size() << "bytes of profile data" );
+    }
+
 #ifndef CLASSNAME
     LOG_FATAL( "CLASSNAME value not defined in project file" );
 #endif
@@ -52,6 +70,7 @@ int main( int argc, char** argv )
     if( !serviceObj ) {
         LOG_FATAL( "Unable to create the service adaptor object" );
     }
+    serviceObj->setProfileData( profileData );
 
     new ButeoPluginIfaceAdaptor( serviceObj );
 
@@ -357,6 +357,38 @@ QString Profile::toString() const
     return doc.toString(PROFILE_INDENT);
 }
 
+// Checks that the profile has values for the field and that they are valid.
+// Looks the values up in place, without collecting them to a list.
+static bool hasValidValues(const ProfilePrivate &aProfile,
+                           const ProfileField &aField)
+{
+    const QString name = aField.name();
+    const QMap<QString, QString> *keys[] = { &aProfile.iLocalKeys,
+                                             &aProfile.iMergedKeys };
+    bool found = false;
+
+    for (unsigned k = 0; k < sizeof(keys) / sizeof(keys[0]); ++k)
+    {
+        QMap<QString, QString>::const_iterator i = keys[k]->constFind(name);
+        for (; i != keys[k]->constEnd() && i.key() == name; ++i)
+        {
+            found = true;
+            if (!aField.validate(i.value())) {
+                LOG_DEBUG( "Error: Value" << i.value() <<
+                    "is not valid for profile" << aProfile.iName );
+                return false;
+            }
+        }
+    }
+
+    if (!found) {
+        LOG_DEBUG( "Error: Cannot find value for field" << name <<
+            "for profile" << aProfile.iName );
+    }
+
+    return found;
+}
+
 bool Profile::isValid() const
 {
     // Profile name and type must be set.
@@ -372,24 +404,15 @@ bool Profile::isValid() const
 
     // For each field a key with the same name must exist, and the
     // key values must be valid for the field.
-    QList<const ProfileField*> fields = allFields();
-    foreach (const ProfileField *f, fields)
+    foreach (const ProfileField *f, d_ptr->iLocalFields)
     {
-        QStringList values = keyValues(f->name());
-        if (values.isEmpty() ) {
-            LOG_DEBUG( "Error: Cannot find value for field" << f->name() <<
-                "for profile" << d_ptr->iName );
+        if (!hasValidValues(*d_ptr, *f))
+            return false;
+    }
+    foreach (const ProfileField *f, d_ptr->iMergedFields)
+    {
+        if (!hasValidValues(*d_ptr, *f))
             return false;
-        }
-        foreach (QString value, values)
-        {
-            if (!f->validate(value)) {
-                LOG_DEBUG( "Error: Value" << value <<
-                    "is not valid for profile" << d_ptr->iName );
-                return false;
-            }
-
-        }
     }
 
     // Enabled sub-profiles must be valid.
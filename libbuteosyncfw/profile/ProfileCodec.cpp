@@ -0,0 +1,491 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "ProfileCodec.h"
+#include "Profile.h"
+#include "SyncProfile.h"
+#include "SyncLog.h"
+#include "ProfileField.h"
+#include "ProfileFactory.h"
+#include "ProfileEngineDefs.h"
+#include "LogMacros.h"
+
+#include <QDomDocument>
+#include <QDomNamedNodeMap>
+#include <QHash>
+#include <QStringList>
+#include <QMap>
+#include <QScopedPointer>
+
+using namespace Buteo;
+
+static const char FORMAT_MAGIC[] = "BPF";
+static const int FORMAT_MAGIC_LENGTH = 3;
+static const int MAX_DEPTH = 32;
+
+// Holds the contents merged to sub-profiles from separate files
+static const QString TAG_MERGED = "merged";
+
+enum NodeKind
+{
+    NODE_ELEMENT = 0,
+    NODE_TEXT = 1
+};
+
+namespace {
+
+//! Writes the element tree and collects the string table.
+class Writer
+{
+public:
+    void writeNumber(QByteArray &aOut, quint32 aValue)
+    {
+        while (aValue >= 0x80)
+        {
+            aOut.append(char((aValue & 0x7f) | 0x80));
+            aValue >>= 7;
+        }
+        aOut.append(char(aValue));
+    }
+
+    void writeString(const QString &aString)
+    {
+        QHash<QString, quint32>::const_iterator i = iIndexes.constFind(aString);
+        if (i == iIndexes.constEnd())
+        {
+            i = iIndexes.insert(aString, iStrings.size());
+            iStrings.append(aString);
+        } // no else
+        writeNumber(iBody, i.value());
+    }
+
+    void writeElement(const QDomElement &aElement)
+    {
+        writeString(aElement.tagName());
+
+        QDomNamedNodeMap attributes = aElement.attributes();
+        writeNumber(iBody, attributes.count());
+        for (int i = 0; i < attributes.count(); ++i)
+        {
+            QDomAttr attribute = attributes.item(i).toAttr();
+            writeString(attribute.name());
+            writeString(attribute.value());
+        }
+
+        QList<QDomNode> children;
+        for (QDomNode n = aElement.firstChild(); !n.isNull(); n = n.nextSibling())
+        {
+            if (n.isElement() || n.isText())
+            {
+                children.append(n);
+            } // no else
+        }
+        writeNumber(iBody, children.size());
+        foreach (const QDomNode &child, children)
+        {
+            if (child.isElement())
+            {
+                iBody.append(char(NODE_ELEMENT));
+                writeElement(child.toElement());
+            }
+            else
+            {
+                iBody.append(char(NODE_TEXT));
+                writeString(child.toText().data());
+            }
+        }
+    }
+
+    QByteArray result()
+    {
+        QByteArray out(FORMAT_MAGIC, FORMAT_MAGIC_LENGTH);
+        out.append(char(ProfileCodec::FORMAT_VERSION));
+        writeNumber(out, iStrings.size());
+        foreach (const QString &string, iStrings)
+        {
+            QByteArray utf8 = string.toUtf8();
+            writeNumber(out, utf8.size());
+            out.append(utf8);
+        }
+        out.append(iBody);
+        return out;
+    }
+
+private:
+    QByteArray iBody;
+    QStringList iStrings;
+    QHash<QString, quint32> iIndexes;
+};
+
+//! Reads data written by Writer, with bounds checks.
+class Reader
+{
+public:
+    explicit Reader(const QByteArray &aData) : iData(aData), iPos(0), iOk(true) { }
+
+    bool ok() const { return iOk; }
+
+    bool atEnd() const { return iPos == iData.size(); }
+
+    quint32 readNumber()
+    {
+        quint32 value = 0;
+        for (int shift = 0; shift < 32; shift += 7)
+        {
+            if (iPos >= iData.size())
+            {
+                break;
+            } // no else
+            quint8 byte = quint8(iData.at(iPos++));
+            value |= quint32(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            } // no else
+        }
+        iOk = false;
+        return 0;
+    }
+
+    quint8 readByte()
+    {
+        if (iPos >= iData.size())
+        {
+            iOk = false;
+            return 0;
+        } // no else
+        return quint8(iData.at(iPos++));
+    }
+
+    bool readHeader()
+    {
+        if (iData.size() < FORMAT_MAGIC_LENGTH + 1 ||
+            !iData.startsWith(QByteArray(FORMAT_MAGIC, FORMAT_MAGIC_LENGTH)))
+        {
+            LOG_WARNING("Not an encoded profile");
+            return false;
+        } // no else
+        iPos = FORMAT_MAGIC_LENGTH;
+        int version = readByte();
+        if (version != ProfileCodec::FORMAT_VERSION)
+        {
+            LOG_WARNING("Unsupported profile encoding version:" << version);
+            return false;
+        } // no else
+
+        quint32 count = readNumber();
+        for (quint32 i = 0; iOk && i < count; ++i)
+        {
+            quint32 length = readNumber();
+            if (!iOk || length > quint32(iData.size() - iPos))
+            {
+                iOk = false;
+                break;
+            } // no else
+            iStrings.append(QString::fromUtf8(iData.constData() + iPos, length));
+            iPos += length;
+        }
+        return iOk;
+    }
+
+    QString readString()
+    {
+        quint32 index = readNumber();
+        if (!iOk || index >= quint32(iStrings.size()))
+        {
+            iOk = false;
+            return QString();
+        } // no else
+        return iStrings.at(index);
+    }
+
+    QDomElement readElement(QDomDocument &aDoc, int aDepth)
+    {
+        if (aDepth > MAX_DEPTH)
+        {
+            iOk = false;
+            return QDomElement();
+        } // no else
+
+        QDomElement element = aDoc.createElement(readString());
+        quint32 attributes = readNumber();
+        for (quint32 i = 0; iOk && i < attributes; ++i)
+        {
+            QString name = readString();
+            QString value = readString();
+            element.setAttribute(name, value);
+        }
+
+        quint32 children = readNumber();
+        for (quint32 i = 0; iOk && i < children; ++i)
+        {
+            quint8 kind = readByte();
+            if (kind == NODE_ELEMENT)
+            {
+                element.appendChild(readElement(aDoc, aDepth + 1));
+            }
+            else if (kind == NODE_TEXT)
+            {
+                element.appendChild(aDoc.createTextNode(readString()));
+            }
+            else
+            {
+                iOk = false;
+            }
+        }
+        return iOk ? element : QDomElement();
+    }
+
+private:
+    const QByteArray &iData;
+    int iPos;
+    bool iOk;
+    QStringList iStrings;
+};
+
+}
+
+QByteArray ProfileCodec::encode(const Profile &aProfile, LogContent aLogContent)
+{
+    FUNCTION_CALL_TRACE;
+
+    QDomDocument doc;
+    QDomElement root = aProfile.toXml(doc, true);
+    restoreKeyOrder(root);
+
+    QDomElement merged = mergedXml(aProfile, doc);
+    if (merged.hasChildNodes())
+    {
+        root.appendChild(merged);
+    } // no else
+
+    if (aProfile.type() == Profile::TYPE_SYNC)
+    {
+        // RTTI is not allowed, use static_cast. Should be safe, because
+        // type is verified.
+        const SyncLog *log = static_cast<const SyncProfile&>(aProfile).log();
+        if (log != 0 && aLogContent == LOG_SUMMARY)
+        {
+            // The target details are the bulk of the log. The times and
+            // codes are enough for the last sync time queries.
+            SyncLog summary(log->profileName());
+            foreach (const SyncResults *results, log->allResults())
+            {
+                SyncResults entry(results->syncTime(), results->majorCode(),
+                                  results->minorCode());
+                entry.setTargetId(results->getTargetId());
+                entry.setScheduled(results->isScheduled());
+                summary.addResults(entry);
+            }
+            root.appendChild(summary.toXml(doc));
+        }
+        else if (log != 0)
+        {
+            root.appendChild(log->toXml(doc));
+        } // no else
+    } // no else
+    return encodeElement(root);
+}
+
+Profile *ProfileCodec::decode(const QByteArray &aData)
+{
+    FUNCTION_CALL_TRACE;
+
+    QDomDocument doc;
+    QDomElement root = decodeElement(aData, doc);
+    if (root.isNull() || root.tagName() != TAG_PROFILE)
+    {
+        return 0;
+    } // no else
+
+    QDomElement merged = root.firstChildElement(TAG_MERGED);
+    if (!merged.isNull())
+    {
+        root.removeChild(merged);
+    } // no else
+
+    ProfileFactory pf;
+    Profile *profile = pf.createProfile(root);
+    if (profile == 0)
+    {
+        return 0;
+    } // no else
+
+    // Merge the sub-profile contents again, as ProfileManager::expand does,
+    // so that they stay separate from the local contents of the profile.
+    for (QDomElement e = merged.firstChildElement(TAG_PROFILE); !e.isNull();
+         e = e.nextSiblingElement(TAG_PROFILE))
+    {
+        QScopedPointer<Profile> source(pf.createProfile(e));
+        if (source != 0)
+        {
+            profile->merge(*source);
+        } // no else
+    }
+
+    profile->setLoaded(true);
+    foreach (Profile *sub, profile->allSubProfiles())
+    {
+        sub->setLoaded(true);
+    }
+
+    QDomElement log = root.firstChildElement(TAG_SYNC_LOG);
+    if (!log.isNull() && profile->type() == Profile::TYPE_SYNC)
+    {
+        static_cast<SyncProfile*>(profile)->setLog(new SyncLog(log));
+    } // no else
+
+    return profile;
+}
+
+QByteArray ProfileCodec::encodeElement(const QDomElement &aRoot)
+{
+    Writer writer;
+    writer.writeElement(aRoot);
+    return writer.result();
+}
+
+QDomElement ProfileCodec::decodeElement(const QByteArray &aData, QDomDocument &aDoc)
+{
+    Reader reader(aData);
+    if (!reader.readHeader())
+    {
+        return QDomElement();
+    } // no else
+
+    QDomElement root = reader.readElement(aDoc, 0);
+    if (!reader.ok() || !reader.atEnd())
+    {
+        LOG_WARNING("Invalid encoded profile");
+        return QDomElement();
+    } // no else
+
+    aDoc.appendChild(root);
+    return root;
+}
+
+QDomElement ProfileCodec::mergedXml(const Profile &aProfile, QDomDocument &aDoc)
+{
+    // Merged content is only ever added to the direct sub-profiles, see
+    // Profile::merge. Profile::toXml writes the merged keys and fields
+    // after the local ones, so they are what the full XML has in addition
+    // to the local XML.
+    QDomElement merged = aDoc.createElement(TAG_MERGED);
+    QDomElement local = aProfile.toXml(aDoc, true);
+    foreach (const Profile *sub, aProfile.allSubProfiles())
+    {
+        QDomElement subLocal = sub->toXml(aDoc, true);
+        QDomElement subFull = sub->toXml(aDoc, false);
+        int localKeys = 0;
+        int localFields = 0;
+        for (QDomElement e = subLocal.firstChildElement(); !e.isNull();
+             e = e.nextSiblingElement())
+        {
+            if (e.tagName() == TAG_KEY)
+            {
+                ++localKeys;
+            }
+            else if (e.tagName() == TAG_FIELD)
+            {
+                ++localFields;
+            } // no else
+        }
+
+        QDomElement entry = aDoc.createElement(TAG_PROFILE);
+        entry.setAttribute(ATTR_NAME, sub->name());
+        entry.setAttribute(ATTR_TYPE, sub->type());
+        int keys = 0;
+        int fields = 0;
+        QDomElement child = subFull.firstChildElement();
+        while (!child.isNull())
+        {
+            QDomElement next = child.nextSiblingElement();
+            if ((child.tagName() == TAG_KEY && keys++ >= localKeys) ||
+                (child.tagName() == TAG_FIELD && fields++ >= localFields))
+            {
+                entry.appendChild(child);
+            } // no else
+            child = next;
+        }
+        restoreKeyOrder(entry);
+
+        // Sub-profiles created by merging are left out of the local XML,
+        // they must be created again even if they have nothing to merge.
+        bool inLocal = false;
+        for (QDomElement e = local.firstChildElement(TAG_PROFILE); !e.isNull();
+             e = e.nextSiblingElement(TAG_PROFILE))
+        {
+            if (e.attribute(ATTR_NAME) == sub->name() &&
+                e.attribute(ATTR_TYPE) == sub->type())
+            {
+                inLocal = true;
+                break;
+            } // no else
+        }
+
+        if (entry.hasChildNodes() || !inLocal)
+        {
+            merged.appendChild(entry);
+        } // no else
+    }
+
+    return merged;
+}
+
+void ProfileCodec::restoreKeyOrder(QDomElement &aElement)
+{
+    // Profile::toXml writes the values of a multi-valued key latest first,
+    // and loading inserts them in document order. Writing them in reverse
+    // makes key() of the decoded profile return the same value as key() of
+    // the original.
+    QStringList names;
+    QMap<QString, QList<QDomElement> > keys;
+    QDomElement child = aElement.firstChildElement();
+    while (!child.isNull())
+    {
+        QDomElement next = child.nextSiblingElement();
+        if (child.tagName() == TAG_KEY)
+        {
+            QString name = child.attribute(ATTR_NAME);
+            if (!keys.contains(name))
+            {
+                names.append(name);
+            } // no else
+            keys[name].prepend(child);
+            aElement.removeChild(child);
+        }
+        else if (child.tagName() == TAG_PROFILE)
+        {
+            restoreKeyOrder(child);
+        } // no else
+        child = next;
+    }
+
+    QDomNode first = aElement.firstChild();
+    foreach (const QString &name, names)
+    {
+        foreach (const QDomElement &key, keys.value(name))
+        {
+            aElement.insertBefore(key, first);
+        }
+    }
+}
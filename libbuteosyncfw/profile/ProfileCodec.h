@@ -0,0 +1,110 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef PROFILECODEC_H
+#define PROFILECODEC_H
+
+#include <QByteArray>
+
+class QDomDocument;
+class QDomElement;
+
+namespace Buteo {
+
+class Profile;
+
+/*! \brief Compact binary encoding of profiles.
+ *
+ * Used for passing profiles between processes, for example from msyncd to
+ * out-of-process plug-ins. The encoding stores the same element tree as the
+ * XML representation of the profile. All strings, like tag, key and
+ * attribute names, are interned in a string table, and the tree refers to
+ * them by index. Numbers are stored as variable length integers. The data
+ * starts with a magic string and a format version, so that a reader can
+ * reject data it does not understand.
+ */
+class ProfileCodec
+{
+public:
+
+    //! Version of the encoding written by this class
+    static const int FORMAT_VERSION = 2;
+
+    //! How much of the sync log of a sync profile is encoded
+    enum LogContent
+    {
+        //! All results with their target details
+        FULL_LOG,
+
+        //! Only the time and result codes of each sync
+        LOG_SUMMARY
+    };
+
+    /*! \brief Encodes a profile with all its sub-profiles
+     *
+     * Keys and fields merged from sub-profile files are included, so the
+     * decoded profile does not need to be expanded again. They are kept
+     * apart from the local contents, so that saving the decoded profile
+     * writes the same file as saving the original. The sync log of a sync
+     * profile is included too, in full or as a summary.
+     * @param aProfile Profile to encode
+     * @param aLogContent How much of the sync log to include
+     * @return Encoded profile
+     */
+    static QByteArray encode(const Profile &aProfile,
+                             LogContent aLogContent = FULL_LOG);
+
+    /*! \brief Decodes a profile encoded with encode()
+     *
+     * @param aData Encoded profile
+     * @return Decoded profile or NULL if the data is not valid. Ownership is
+     *  transferred to the caller. The profile has the class matching its
+     *  type, and is marked as loaded.
+     */
+    static Profile *decode(const QByteArray &aData);
+
+    /*! \brief Encodes an element tree
+     *
+     * @param aRoot Root element
+     * @return Encoded tree
+     */
+    static QByteArray encodeElement(const QDomElement &aRoot);
+
+    /*! \brief Decodes an element tree encoded with encodeElement()
+     *
+     * @param aData Encoded tree
+     * @param aDoc Document for creating the elements
+     * @return Root element or a null element if the data is not valid
+     */
+    static QDomElement decodeElement(const QByteArray &aData, QDomDocument &aDoc);
+
+private:
+
+    static QDomElement mergedXml(const Profile &aProfile, QDomDocument &aDoc);
+
+    static void restoreKeyOrder(QDomElement &aElement);
+
+};
+
+}
+
+#endif // PROFILECODEC_H
@@ -48,6 +48,16 @@ const QString ATTR_MINOR_CODE("minorcode");
 const QString ATTR_ENABLED("enabled");
 const QString ATTR_SYNC_CONFIGURE("syncconfiguredtime");
 const QString ATTR_EXTERNAL_SYNC("externalsync");
+const QString ATTR_UNCOMPRESSED_BYTES("uncompressedbytes");
+const QString ATTR_COMPRESSED_BYTES("compressedbytes");
+const QString ATTR_CPU_TIME("cputime");
+const QString ATTR_PEAK_MEMORY("peakmemory");
+const QString ATTR_STATUS("status");
+const QString ATTR_MESSAGE("message");
+const QString ATTR_DETAILS("details");
+const QString ATTR_DATABASE("database");
+const QString ATTR_MIME_TYPE("mimetype");
+const QString ATTR_ITEMS("items");
 
 const QString TAG_FIELD("field");
 const QString TAG_PROFILE("profile");
@@ -62,6 +72,9 @@ const QString TAG_SCHEDULE("schedule");
 const QString TAG_RUSH("rush");
 const QString TAG_ERROR_ATTEMPTS("attempts");
 const QString TAG_ATTEMPT_DELAY("attemptdelay");
+const QString TAG_STATUS_UPDATES("statusupdates");
+const QString TAG_STATUS("status");
+const QString TAG_PROGRESS("progress");
 
 const QString KEY_ENABLED("enabled");
 const QString KEY_DISPLAY_NAME("displayname");
@@ -101,6 +114,26 @@ const QString KEY_STORAGE_UPDATED("storage_updated");
 const QString KEY_HTTP_PROXY_HOST("http_proxy_host");
 const QString KEY_HTTP_PROXY_PORT("http_proxy_port");
 const QString KEY_PROFILE_ID("profile_id");
+const QString KEY_COMPRESSION("compression"); // accepted payload encodings in order of preference, e.g. "gzip,deflate"
+const QString KEY_COMPRESSION_LEVEL("compression_level");
+const QString KEY_RUN_AFTER("run_after"); // name of a profile that must sync successfully first, may be repeated
+const QString KEY_MAX_SESSIONS("max_sessions"); // concurrent sessions of the client plug-in, default 1, 0 for no limit
+const QString KEY_MAX_SESSIONS_PER_HOST("max_sessions_per_host"); // concurrent sessions with the same remote host, 0 for no limit
+const QString KEY_REMOTE_HOST("remote_host"); // remote host for limits, defaults to the host of "Remote database"
+const QString KEY_RATE_LIMIT("rate_limit"); // session starts per hour allowed for the client plug-in, 0 for no limit
+const QString KEY_RATE_LIMIT_BURST("rate_limit_burst"); // session starts allowed at once, default 1
+const QString KEY_PREFETCH("prefetch"); // sync shortly before the times the user usually syncs manually
+const QString KEY_NICE("nice"); // niceness of an out-of-process plug-in, 1-19
+const QString KEY_IO_CLASS("io_class"); // I/O class of an out-of-process plug-in, "idle" or "best-effort"
+const QString KEY_IO_PRIORITY("io_priority"); // I/O priority within the best-effort class, 0-7
+const QString KEY_CPU_LIMIT("cpu_limit"); // CPU time limit of an out-of-process plug-in in seconds
+const QString KEY_MEMORY_LIMIT("memory_limit"); // address space limit of an out-of-process plug-in in megabytes
+const QString KEY_CGROUP("cgroup"); // cgroup v2 group of an out-of-process plug-in, relative names are siblings of the group of msyncd
+const QString KEY_CGROUP_CPU_WEIGHT("cgroup_cpu_weight"); // cpu.weight of the cgroup, 1-10000
+const QString KEY_CGROUP_MEMORY_MAX("cgroup_memory_max"); // memory.max of the cgroup in megabytes
+const QString KEY_INIT_TIMEOUT("init_timeout"); // seconds the client plug-in may take to initialize and start, 0 for no limit
+const QString KEY_SYNC_TIMEOUT("sync_timeout"); // seconds the client plug-in may sync without progress, 0 for no limit
+const QString KEY_UNINIT_TIMEOUT("uninit_timeout"); // seconds the client plug-in may take to return results and uninitialize, 0 for no limit
 
 const QString BOOLEAN_TRUE("true");
 const QString BOOLEAN_FALSE("false");
@@ -24,6 +24,7 @@
 #include "ProfileField.h"
 #include "ProfileEngineDefs.h"
 #include <QDomDocument>
+#include <QSet>
 
 namespace Buteo {
 
@@ -39,6 +40,9 @@ const QString ProfileField::VISIBLE_USER = "user";
 //! ProfileField Visbility Const string for boolean
 const QString ProfileField::TYPE_BOOLEAN = "boolean";
 
+//! ProfileField type string for integer
+const QString ProfileField::TYPE_INTEGER = "integer";
+
 // Private implementation class for ProfileField.
 class ProfileFieldPrivate
 {
@@ -48,6 +52,21 @@ public:
 
     //! \brief Copy Constructor
     ProfileFieldPrivate(const ProfileFieldPrivate &aSource);
+
+    //! \brief Compiles the validation rules from the type and options
+    void compile();
+
+    //! How values of the field are validated
+    enum ValueCheck {
+        //! Any non-empty value
+        CHECK_ANY,
+        //! "true" or "false"
+        CHECK_BOOLEAN,
+        //! An integer
+        CHECK_INTEGER,
+        //! One of the options
+        CHECK_OPTIONS
+    };
 
     //! \brief Name of the ProfileField
     QString iName;
@@ -69,6 +88,12 @@ public:
 
     //! \brief Write Access Specifier of the ProfileField
     bool iReadOnly;
+
+    //! \brief Validation of the values, compiled from type and options
+    ValueCheck iCheck;
+
+    //! \brief Options of the ProfileField for fast lookup
+    QSet<QString> iOptionSet;
 };
 
 }
@@ -76,7 +101,8 @@ public:
 using namespace Buteo;
 
 ProfileFieldPrivate::ProfileFieldPrivate()
-:   iReadOnly(false)
+:   iReadOnly(false),
+    iCheck(CHECK_ANY)
 {
 }
 
@@ -87,8 +113,35 @@ ProfileFieldPrivate::ProfileFieldPrivate(const ProfileFieldPrivate &aSource)
     iOptions(aSource.iOptions),
     iLabel(aSource.iLabel),
     iVisible(aSource.iVisible),
-    iReadOnly(aSource.iReadOnly)
+    iReadOnly(aSource.iReadOnly),
+    iCheck(aSource.iCheck),
+    iOptionSet(aSource.iOptionSet)
+{
+}
+
+void ProfileFieldPrivate::compile()
 {
+    iOptionSet.clear();
+
+    if (iType == ProfileField::TYPE_BOOLEAN &&
+        iOptions.size() == 2 && iOptions.contains(BOOLEAN_TRUE) &&
+        iOptions.contains(BOOLEAN_FALSE))
+    {
+        iCheck = CHECK_BOOLEAN;
+    }
+    else if (!iOptions.isEmpty())
+    {
+        iCheck = CHECK_OPTIONS;
+        iOptionSet = iOptions.toSet();
+    }
+    else if (iType == ProfileField::TYPE_INTEGER)
+    {
+        iCheck = CHECK_INTEGER;
+    }
+    else
+    {
+        iCheck = CHECK_ANY;
+    }
 }
 
 ProfileField::ProfileField(const QDomElement &aRoot)
@@ -126,6 +179,8 @@ ProfileField::ProfileField(const QDomElement &aRoot)
             d_ptr->iOptions.append(BOOLEAN_FALSE);
         } // no else
     } // no else
+
+    d_ptr->compile();
 }
 
 ProfileField::ProfileField(const ProfileField &aSource)
@@ -168,14 +223,28 @@ bool ProfileField::validate(const QString &aValue) const
 {
     // Value is valid if it exists in the list of options,
     // or if options have not been defined.
-    if (!aValue.isEmpty() &&
-        (d_ptr->iOptions.contains(aValue) || d_ptr->iOptions.empty()))
-    {
-        return true;
-    }
-    else
+    if (aValue.isEmpty())
     {
         return false;
+    } // no else
+
+    switch (d_ptr->iCheck)
+    {
+        case ProfileFieldPrivate::CHECK_BOOLEAN:
+            return (aValue == BOOLEAN_TRUE || aValue == BOOLEAN_FALSE);
+
+        case ProfileFieldPrivate::CHECK_INTEGER:
+        {
+            bool ok = false;
+            aValue.toLongLong(&ok);
+            return ok;
+        }
+
+        case ProfileFieldPrivate::CHECK_OPTIONS:
+            return d_ptr->iOptionSet.contains(aValue);
+
+        default:
+            return true;
     }
 }
 
@@ -62,6 +62,9 @@ public:
     //! Field type for boolean fields.
     static const QString TYPE_BOOLEAN;
 
+    //! Field type for integer fields.
+    static const QString TYPE_INTEGER;
+
     /*! \brief Constructs a ProfileField from XML.
      *
      * \param aRoot Root element of the field XML.
@@ -112,7 +115,10 @@ public:
 
     /*! \brief Checks if the given value is in the list of allowed values.
      *
-     * If allowed values have not been defined, any value is accepted.
+     * If allowed values have not been defined, any value is accepted, except
+     * that the values of integer fields must be integers. The allowed values
+     * are compiled when the field is constructed, so validation does not
+     * depend on the number of options.
      * \param aValue The value to validate.
      * \return Is the given value in the list of allowed values (options).
      */
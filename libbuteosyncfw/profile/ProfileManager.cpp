@@ -25,8 +25,10 @@
 
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
 #include <QDomDocument>
+#include <QMutex>
 
 #include "ProfileFactory.h"
 #include "ProfileEngineDefs.h"
@@ -43,6 +45,10 @@ static const QString LOG_EXT = ".log";
 static const QString LOG_DIRECTORY = "logs";
 static const QString BT_PROFILE_TEMPLATE("bt_template");
 
+// Serializes read-modify-write of sync logs, which can be saved from
+// several threads.
+static QMutex logMutex;
+
 const QString ProfileManager::DEFAULT_PRIMARY_PROFILE_PATH =
         Sync::syncCacheDir();
 const QString ProfileManager::DEFAULT_SECONDARY_PROFILE_PATH =
@@ -1035,6 +1041,7 @@ bool ProfileManager::saveSyncResults(QString aProfileName,
     FUNCTION_CALL_TRACE;
     bool success = false;
 
+    QMutexLocker locker(&logMutex);
     SyncProfile *profile = syncProfile(aProfileName);
     if (profile) {
         SyncLog *log = profile->log();
@@ -1053,6 +1060,30 @@ bool ProfileManager::saveSyncResults(QString aProfileName,
     return success;
 }
 
+bool ProfileManager::saveSyncResults(QString aProfileName,
+        const SyncResults &aResults, const QDateTime &aCheckpointTime)
+{
+    FUNCTION_CALL_TRACE;
+    bool success = false;
+
+    QMutexLocker locker(&logMutex);
+    SyncProfile *profile = syncProfile(aProfileName);
+    if (profile) {
+        SyncLog *log = profile->log();
+        if (log)
+        {
+            log->replaceResults(aCheckpointTime, aResults);
+            success = saveLog(*log);
+            emit signalProfileChanged(aProfileName,ProfileManager::PROFILE_LOGS_MODIFIED,profile->toString());
+        }
+
+        delete profile;
+        profile = 0;
+    }
+
+    return success;
+}
+
 bool ProfileManager::setSyncSchedule(QString aProfileId , QString aScheduleAsXml)
 {
     FUNCTION_CALL_TRACE;
@@ -1257,3 +1288,11 @@ void ProfileManager::retriesDone(const QString& aProfileName)
        LOG_DEBUG("syncretries : retry success for" << aProfileName);
     }
 }
+
+QDateTime ProfileManager::lastModified(const QString &aName, const QString &aType)
+{
+    FUNCTION_CALL_TRACE;
+
+    QFileInfo info(d_ptr->findProfileFile(aName, aType));
+    return info.exists() ? info.lastModified() : QDateTime();
+}
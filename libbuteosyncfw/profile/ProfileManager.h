@@ -235,13 +235,26 @@ public:
      *
      * This is a convenience function that loads the log associated with the
      * given profile, appends the given results to the log and then saves the
-     * log.
+     * log. Concurrent calls from different threads are serialized.
      * \param aProfileName Name of the profile used in the sync session.
      * \param aResults Results.
      * \return True if saving was successful.
      */
     bool saveSyncResults(QString aProfileName, const SyncResults &aResults);
 
+    /*! \brief Saves results of a sync session over an earlier checkpoint.
+     *
+     * Like saveSyncResults, but an unfinished entry saved earlier for the
+     * same session is replaced instead of adding a new entry.
+     * \see SyncLog::replaceResults
+     * \param aProfileName Name of the profile used in the sync session.
+     * \param aResults Results.
+     * \param aCheckpointTime Sync time of the checkpoint to replace.
+     * \return True if saving was successful.
+     */
+    bool saveSyncResults(QString aProfileName, const SyncResults &aResults,
+                         const QDateTime &aCheckpointTime);
+
     /*! \brief Gets a profile.
      *
      * \param aName Name of the profile to get.
@@ -355,6 +368,18 @@ public:
      */
     void retriesDone(const QString& aProfileName);
 
+    /*! \brief Returns the time the file of a profile was last modified
+     *
+     * Profiles can also be changed on disk by other processes. Comparing
+     * the times tells if a profile loaded earlier is still up to date.
+     *
+     * \param aName Name of the profile.
+     * \param aType Type of the profile.
+     * \return Modification time, invalid if the profile does not exist.
+     */
+    QDateTime lastModified(const QString &aName,
+                           const QString &aType = Profile::TYPE_SYNC);
+
 #ifdef SYNCFW_UNIT_TESTS
     friend class ProfileManagerTest;
 #endif
@@ -0,0 +1,404 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "ProfileService.h"
+#include "ProfileManager.h"
+#include "SyncProfile.h"
+#include "ProfileEngineDefs.h"
+#include "LogMacros.h"
+
+#include <QMutexLocker>
+#include <QMetaObject>
+
+using namespace Buteo;
+
+static const QChar PATH_SEPARATOR('/');
+
+ProfileTransaction::ProfileTransaction(const QString &aProfileName, int aRevision)
+:   iProfileName(aProfileName),
+    iRevision(aRevision)
+{
+}
+
+void ProfileTransaction::setValue(const QString &aPath, const QString &aKey,
+                                  const QString &aValue)
+{
+    QStringList values;
+    if (!aValue.isNull())
+    {
+        values.append(aValue);
+    } // no else
+    setValues(aPath, aKey, values);
+}
+
+void ProfileTransaction::setBoolValue(const QString &aPath, const QString &aKey,
+                                      bool aValue)
+{
+    setValue(aPath, aKey, aValue ? BOOLEAN_TRUE : BOOLEAN_FALSE);
+}
+
+void ProfileTransaction::setIntValue(const QString &aPath, const QString &aKey,
+                                     int aValue)
+{
+    setValue(aPath, aKey, QString::number(aValue));
+}
+
+void ProfileTransaction::setValues(const QString &aPath, const QString &aKey,
+                                   const QStringList &aValues)
+{
+    Change change;
+    change.path = aPath;
+    change.key = aKey;
+    change.values = aValues;
+    iChanges.append(change);
+}
+
+void ProfileTransaction::removeKey(const QString &aPath, const QString &aKey)
+{
+    setValues(aPath, aKey, QStringList());
+}
+
+QString ProfileTransaction::profileName() const
+{
+    return iProfileName;
+}
+
+int ProfileTransaction::revision() const
+{
+    return iRevision;
+}
+
+bool ProfileTransaction::isEmpty() const
+{
+    return iChanges.isEmpty();
+}
+
+ProfileService::ProfileService(ProfileManager &aManager, QObject *aParent)
+:   QObject(aParent),
+    iManager(aManager),
+    iMutex(QMutex::Recursive)
+{
+    FUNCTION_CALL_TRACE;
+
+    // Direct connection, so that the cache is up to date as soon as the
+    // manager has changed a profile, in whichever thread that happened.
+    connect(&iManager, SIGNAL(signalProfileChanged(QString, int, QString)),
+            this, SLOT(onProfileChanged(QString, int, QString)),
+            Qt::DirectConnection);
+}
+
+ProfileService::~ProfileService()
+{
+    FUNCTION_CALL_TRACE;
+
+    qDeleteAll(iCache);
+    iCache.clear();
+}
+
+QStringList ProfileService::profileNames()
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+    return iManager.profileNames(Profile::TYPE_SYNC);
+}
+
+bool ProfileService::exists(const QString &aPath)
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+    SyncProfile *profile = cachedProfile(aPath.section(PATH_SEPARATOR, 0, 0));
+    return (resolve(profile, aPath) != 0);
+}
+
+int ProfileService::revision(const QString &aProfileName)
+{
+    QMutexLocker locker(&iMutex);
+    if (iCache.contains(aProfileName))
+    {
+        // Counts changes made on disk since the profile was loaded.
+        cachedProfile(aProfileName);
+    } // no else
+    return iRevisions.value(aProfileName, 0);
+}
+
+SyncProfile *ProfileService::syncProfile(const QString &aProfileName)
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+    SyncProfile *profile = cachedProfile(aProfileName);
+    return (profile != 0) ? profile->clone() : 0;
+}
+
+QString ProfileService::value(const QString &aPath, const QString &aKey,
+                              const QString &aDefault)
+{
+    QMutexLocker locker(&iMutex);
+    SyncProfile *profile = cachedProfile(aPath.section(PATH_SEPARATOR, 0, 0));
+    Profile *target = resolve(profile, aPath);
+    return (target != 0) ? target->key(aKey, aDefault) : aDefault;
+}
+
+bool ProfileService::boolValue(const QString &aPath, const QString &aKey,
+                               bool aDefault)
+{
+    QString v = value(aPath, aKey);
+    if (v.isNull())
+    {
+        return aDefault;
+    } // no else
+    return (v.compare(BOOLEAN_TRUE, Qt::CaseInsensitive) == 0);
+}
+
+int ProfileService::intValue(const QString &aPath, const QString &aKey,
+                             int aDefault)
+{
+    bool ok = false;
+    int v = value(aPath, aKey).toInt(&ok);
+    return ok ? v : aDefault;
+}
+
+QStringList ProfileService::values(const QString &aPath, const QString &aKey)
+{
+    QMutexLocker locker(&iMutex);
+    SyncProfile *profile = cachedProfile(aPath.section(PATH_SEPARATOR, 0, 0));
+    Profile *target = resolve(profile, aPath);
+    return (target != 0) ? target->keyValues(aKey) : QStringList();
+}
+
+bool ProfileService::setValue(const QString &aPath, const QString &aKey,
+                              const QString &aValue)
+{
+    ProfileTransaction transaction(aPath.section(PATH_SEPARATOR, 0, 0));
+    transaction.setValue(aPath, aKey, aValue);
+    return commit(transaction);
+}
+
+bool ProfileService::commit(const ProfileTransaction &aTransaction)
+{
+    FUNCTION_CALL_TRACE;
+
+    const QString name = aTransaction.profileName();
+    QStringList changedKeys;
+    {
+        QMutexLocker locker(&iMutex);
+
+        // Looked up first, so that changes made on disk count as a new
+        // revision and are not overwritten.
+        SyncProfile *cached = cachedProfile(name);
+        if (cached == 0)
+        {
+            LOG_WARNING("No such profile:" << name);
+            return false;
+        } // no else
+
+        if (aTransaction.revision() >= 0 &&
+            aTransaction.revision() != iRevisions.value(name, 0))
+        {
+            LOG_DEBUG("Profile" << name << "changed since revision"
+                      << aTransaction.revision());
+            return false;
+        } // no else
+
+        // Changes are applied to a copy, so that a failure leaves the cache
+        // untouched.
+        SyncProfile *profile = cached->clone();
+        foreach (const ProfileTransaction::Change &change, aTransaction.iChanges)
+        {
+            Profile *target = 0;
+            if (change.path.section(PATH_SEPARATOR, 0, 0) == name)
+            {
+                target = resolve(profile, change.path);
+            } // no else
+            if (target == 0)
+            {
+                LOG_WARNING("Invalid profile path:" << change.path);
+                delete profile;
+                return false;
+            } // no else
+            target->setKeyValues(change.key, change.values);
+            if (!changedKeys.contains(change.key))
+            {
+                changedKeys.append(change.key);
+            } // no else
+        }
+
+        iCommitting = name;
+        bool saved = !iManager.updateProfile(*profile).isEmpty();
+        iCommitting.clear();
+        if (!saved)
+        {
+            LOG_WARNING("Failed to save profile:" << name);
+            delete profile;
+            return false;
+        } // no else
+
+        delete iCache.take(name);
+        iCache.insert(name, profile);
+        iModified.insert(name, iManager.lastModified(name));
+        iRevisions[name]++;
+    }
+
+    notify(name, changedKeys);
+    return true;
+}
+
+void ProfileService::watch(const QString &aProfileName, QObject *aReceiver,
+                           const char *aMethod)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aReceiver == 0 || aMethod == 0)
+    {
+        return;
+    } // no else
+
+    Watch w;
+    w.profileName = aProfileName;
+    w.receiver = aReceiver;
+    w.method = aMethod;
+
+    QMutexLocker locker(&iMutex);
+    iWatches.append(w);
+}
+
+void ProfileService::unwatch(QObject *aReceiver, const QString &aProfileName)
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+    QList<Watch>::iterator i = iWatches.begin();
+    while (i != iWatches.end())
+    {
+        if (i->receiver.isNull() ||
+            (i->receiver == aReceiver &&
+             (aProfileName.isEmpty() || i->profileName == aProfileName)))
+        {
+            i = iWatches.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void ProfileService::onProfileChanged(QString aProfileName, int aChangeType,
+                                      QString aProfileAsXml)
+{
+    FUNCTION_CALL_TRACE;
+
+    Q_UNUSED(aChangeType);
+    Q_UNUSED(aProfileAsXml);
+
+    {
+        QMutexLocker locker(&iMutex);
+        if (aProfileName == iCommitting)
+        {
+            // commit() updates the cache and notifies watchers itself.
+            return;
+        } // no else
+
+        delete iCache.take(aProfileName);
+        iModified.remove(aProfileName);
+        iRevisions[aProfileName]++;
+    }
+
+    notify(aProfileName, QStringList());
+}
+
+SyncProfile *ProfileService::cachedProfile(const QString &aProfileName)
+{
+    SyncProfile *profile = iCache.value(aProfileName);
+    if (profile != 0 &&
+        iManager.lastModified(aProfileName) != iModified.value(aProfileName))
+    {
+        // Changed on disk by another process.
+        LOG_DEBUG("Profile" << aProfileName << "was modified on disk");
+        delete iCache.take(aProfileName);
+        iModified.remove(aProfileName);
+        iRevisions[aProfileName]++;
+        profile = 0;
+    } // no else
+
+    if (profile == 0 && !aProfileName.isEmpty())
+    {
+        // The time is read before the file, so that a write in between
+        // is noticed on the next lookup.
+        QDateTime modified = iManager.lastModified(aProfileName);
+        profile = iManager.syncProfile(aProfileName);
+        if (profile != 0)
+        {
+            iCache.insert(aProfileName, profile);
+            iModified.insert(aProfileName, modified);
+        } // no else
+    } // no else
+    return profile;
+}
+
+Profile *ProfileService::resolve(SyncProfile *aProfile, const QString &aPath)
+{
+    if (aProfile == 0)
+    {
+        return 0;
+    } // no else
+
+    QString subName = aPath.section(PATH_SEPARATOR, 1);
+    if (subName.isEmpty())
+    {
+        return aProfile;
+    } // no else
+
+    return aProfile->subProfile(subName);
+}
+
+void ProfileService::notify(const QString &aProfileName, const QStringList &aKeys)
+{
+    FUNCTION_CALL_TRACE;
+
+    QList<Watch> watches;
+    {
+        QMutexLocker locker(&iMutex);
+        foreach (const Watch &w, iWatches)
+        {
+            if (w.profileName == aProfileName && !w.receiver.isNull())
+            {
+                watches.append(w);
+            } // no else
+        }
+    }
+
+    foreach (const Watch &w, watches)
+    {
+        QObject *receiver = w.receiver.data();
+        if (receiver != 0)
+        {
+            QMetaObject::invokeMethod(receiver, w.method.constData(),
+                                      Q_ARG(QString, aProfileName),
+                                      Q_ARG(QStringList, aKeys));
+        } // no else
+    }
+
+    emit profileChanged(aProfileName, aKeys);
+}
@@ -0,0 +1,314 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef PROFILESERVICE_H
+#define PROFILESERVICE_H
+
+#include <QObject>
+#include <QHash>
+#include <QDateTime>
+#include <QList>
+#include <QMutex>
+#include <QPointer>
+#include <QStringList>
+
+namespace Buteo {
+
+class ProfileManager;
+class SyncProfile;
+class Profile;
+class ProfileServiceTest;
+
+/*! \brief A set of key changes applied to a profile at once.
+ *
+ * Changes are collected with the setters and applied with
+ * ProfileService::commit(). If the transaction was created with a revision,
+ * the commit fails if the profile was changed after that revision.
+ *
+ * Keys are addressed with a path, which is the name of a sync profile,
+ * optionally followed by a slash and the name of one of its sub-profiles,
+ * for example "google-calendars/caldav".
+ */
+class ProfileTransaction
+{
+public:
+
+    /*! \brief Constructor
+     *
+     * @param aProfileName Name of the sync profile to change
+     * @param aRevision Revision of the profile the changes are based on, as
+     *  returned by ProfileService::revision(), or -1 to apply the changes
+     *  regardless of other changes
+     */
+    explicit ProfileTransaction(const QString &aProfileName, int aRevision = -1);
+
+    /*! \brief Sets a key
+     *
+     * @param aPath Profile path
+     * @param aKey Key name
+     * @param aValue Value, a null string removes the key
+     */
+    void setValue(const QString &aPath, const QString &aKey, const QString &aValue);
+
+    /*! \brief Sets a boolean key
+     *
+     * @param aPath Profile path
+     * @param aKey Key name
+     * @param aValue Value
+     */
+    void setBoolValue(const QString &aPath, const QString &aKey, bool aValue);
+
+    /*! \brief Sets an integer key
+     *
+     * @param aPath Profile path
+     * @param aKey Key name
+     * @param aValue Value
+     */
+    void setIntValue(const QString &aPath, const QString &aKey, int aValue);
+
+    /*! \brief Sets all values of a multi-valued key
+     *
+     * @param aPath Profile path
+     * @param aKey Key name
+     * @param aValues Values, an empty list removes the key
+     */
+    void setValues(const QString &aPath, const QString &aKey, const QStringList &aValues);
+
+    /*! \brief Removes a key
+     *
+     * @param aPath Profile path
+     * @param aKey Key name
+     */
+    void removeKey(const QString &aPath, const QString &aKey);
+
+    //! \brief Returns the name of the sync profile to change
+    QString profileName() const;
+
+    //! \brief Returns the revision the changes are based on
+    int revision() const;
+
+    //! \brief Checks if the transaction has no changes
+    bool isEmpty() const;
+
+private:
+
+    friend class ProfileService;
+
+    struct Change
+    {
+        QString path;
+        QString key;
+        QStringList values;
+    };
+
+    QString iProfileName;
+
+    int iRevision;
+
+    QList<Change> iChanges;
+};
+
+/*! \brief In-process access to the profiles of the sync daemon.
+ *
+ * The service is owned by the daemon and offered to plug-ins through
+ * PluginCbInterface::profileService(), so that plug-ins do not need their
+ * own ProfileManager. Expanded sync profiles are cached in memory and
+ * dropped when the daemon's ProfileManager reports a change, or when the
+ * profile file has been modified on disk since it was loaded. Changes are
+ * written through the daemon's ProfileManager.
+ *
+ * Keys are addressed with a path, see ProfileTransaction. The service can
+ * be used from plug-in threads.
+ */
+class ProfileService : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /*! \brief Constructor
+     *
+     * @param aManager Profile manager of the daemon. Ownership is NOT
+     *  transferred.
+     * @param aParent Parent object
+     */
+    explicit ProfileService(ProfileManager &aManager, QObject *aParent = 0);
+
+    //! \brief Destructor
+    virtual ~ProfileService();
+
+    /*! \brief Returns the names of all sync profiles
+     *
+     * @return Profile names
+     */
+    QStringList profileNames();
+
+    /*! \brief Checks if a profile path exists
+     *
+     * @param aPath Profile path
+     * @return True if the profile exists
+     */
+    bool exists(const QString &aPath);
+
+    /*! \brief Returns the current revision of a sync profile
+     *
+     * The revision changes whenever the profile is changed.
+     * @param aProfileName Name of the sync profile
+     * @return Revision
+     */
+    int revision(const QString &aProfileName);
+
+    /*! \brief Returns a copy of an expanded sync profile
+     *
+     * @param aProfileName Name of the sync profile
+     * @return Profile or NULL if not found. Ownership is transferred.
+     */
+    SyncProfile *syncProfile(const QString &aProfileName);
+
+    /*! \brief Returns the value of a key
+     *
+     * @param aPath Profile path
+     * @param aKey Key name
+     * @param aDefault Value returned if the key does not exist
+     * @return Value
+     */
+    QString value(const QString &aPath, const QString &aKey,
+                  const QString &aDefault = QString());
+
+    /*! \brief Returns the value of a boolean key
+     *
+     * @param aPath Profile path
+     * @param aKey Key name
+     * @param aDefault Value returned if the key does not exist
+     * @return Value
+     */
+    bool boolValue(const QString &aPath, const QString &aKey, bool aDefault = false);
+
+    /*! \brief Returns the value of an integer key
+     *
+     * @param aPath Profile path
+     * @param aKey Key name
+     * @param aDefault Value returned if the key does not exist or is not a
+     *  number
+     * @return Value
+     */
+    int intValue(const QString &aPath, const QString &aKey, int aDefault = 0);
+
+    /*! \brief Returns all values of a multi-valued key
+     *
+     * @param aPath Profile path
+     * @param aKey Key name
+     * @return Values
+     */
+    QStringList values(const QString &aPath, const QString &aKey);
+
+    /*! \brief Sets a key and saves the profile
+     *
+     * @param aPath Profile path
+     * @param aKey Key name
+     * @param aValue Value, a null string removes the key
+     * @return True on success
+     */
+    bool setValue(const QString &aPath, const QString &aKey, const QString &aValue);
+
+    /*! \brief Applies the changes of a transaction and saves the profile
+     *
+     * Either all changes are applied or none.
+     * @param aTransaction Changes
+     * @return True on success, false if a path does not exist, the profile
+     *  was changed after the revision of the transaction or saving failed
+     */
+    bool commit(const ProfileTransaction &aTransaction);
+
+    /*! \brief Starts watching changes of a sync profile
+     *
+     * The given method of the receiver is invoked with the profile name and
+     * the list of changed keys whenever the profile changes. The list is
+     * empty if the changed keys are not known. The method is invoked in the
+     * thread of the receiver.
+     * @param aProfileName Name of the sync profile
+     * @param aReceiver Object to notify
+     * @param aMethod Name of the method, with signature
+     *  (const QString &aProfileName, const QStringList &aKeys)
+     */
+    void watch(const QString &aProfileName, QObject *aReceiver, const char *aMethod);
+
+    /*! \brief Stops watching changes
+     *
+     * @param aReceiver Object given to watch()
+     * @param aProfileName Name of the profile, or empty to stop watching
+     *  all profiles
+     */
+    void unwatch(QObject *aReceiver, const QString &aProfileName = QString());
+
+signals:
+
+    /*! \brief Emitted when a sync profile changes
+     *
+     * @param aProfileName Name of the sync profile
+     * @param aKeys Changed keys, empty if not known
+     */
+    void profileChanged(const QString &aProfileName, const QStringList &aKeys);
+
+private slots:
+
+    void onProfileChanged(QString aProfileName, int aChangeType, QString aProfileAsXml);
+
+private:
+
+    struct Watch
+    {
+        QString profileName;
+        QPointer<QObject> receiver;
+        QByteArray method;
+    };
+
+    SyncProfile *cachedProfile(const QString &aProfileName);
+
+    Profile *resolve(SyncProfile *aProfile, const QString &aPath);
+
+    void notify(const QString &aProfileName, const QStringList &aKeys);
+
+    ProfileManager &iManager;
+
+    QHash<QString, SyncProfile*> iCache;
+
+    //! Modification times of the files of the cached profiles
+    QHash<QString, QDateTime> iModified;
+
+    QHash<QString, int> iRevisions;
+
+    QList<Watch> iWatches;
+
+    //! Profile being saved by commit()
+    QString iCommitting;
+
+    QMutex iMutex;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class ProfileServiceTest;
+#endif
+};
+
+}
+
+#endif // PROFILESERVICE_H
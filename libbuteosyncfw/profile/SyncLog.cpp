@@ -100,6 +100,22 @@ SyncLog::SyncLog(const QDomElement &aRoot)
     //qSort(d_ptr->iResults.begin(), d_ptr->iResults.end(), syncResultPointerLessThan);
 }
 
+void SyncLog::replaceResults(const QDateTime &aTime, const SyncResults &aResults)
+{
+    FUNCTION_CALL_TRACE;
+
+    for (int i = d_ptr->iResults.size() - 1; i >= 0; --i) {
+        SyncResults *results = d_ptr->iResults[i];
+        if (results->majorCode() == SyncResults::SYNC_RESULT_INVALID &&
+            results->syncTime() == aTime) {
+            *results = aResults;
+            return;
+        } // no else
+    }
+
+    addResults(aResults);
+}
+
 SyncLog::SyncLog(const SyncLog &aSource)
 :   d_ptr(new SyncLogPrivate(*aSource.d_ptr))
 {
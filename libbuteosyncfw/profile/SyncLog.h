@@ -106,6 +106,17 @@ public:
      */
     void addResults(const SyncResults &aResults);
 
+    /*! \brief Replaces the results of an unfinished sync session.
+     *
+     * Results of a running session are saved as checkpoints, with major code
+     * SYNC_RESULT_INVALID. If the log contains such an entry with the given
+     * sync time, it is replaced with the given results. Otherwise the
+     * results are added like with addResults.
+     * \param aTime Sync time of the checkpoint to replace.
+     * \param aResults Results to store.
+     */
+    void replaceResults(const QDateTime &aTime, const SyncResults &aResults);
+
 private:
 
     SyncLog& operator=(const SyncLog &aRhs);
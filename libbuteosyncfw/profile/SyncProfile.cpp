@@ -673,6 +673,26 @@ void SyncProfile::setConflictResolutionPolicy(ConflictResolutionPolicy aPolicy)
     }
 }
 
+QStringList SyncProfile::runAfter() const
+{
+    QStringList profileNames;
+    foreach (QString name, keyValues(KEY_RUN_AFTER))
+    {
+        name = name.trimmed();
+        if (!name.isEmpty() && name != this->name() && !profileNames.contains(name))
+        {
+            profileNames.append(name);
+        } // no else
+    }
+
+    return profileNames;
+}
+
+void SyncProfile::setRunAfter(const QStringList &aProfileNames)
+{
+    setKeyValues(KEY_RUN_AFTER, aProfileNames);
+}
+
 bool SyncProfile::hasRetries() const
 {
     return d_ptr->iSyncRetriesInfo.retries() ? true : false;
@@ -687,7 +707,8 @@ SyncProfile::CurrentSyncStatus SyncProfile::currentSyncStatus() const
 {
     //Fetch the last sync result
     const SyncResults *syncResult = lastResults();
-    SyncProfile::CurrentSyncStatus syncStatus;
+    // Unfinished sessions, saved as checkpoints, are reported as failed
+    SyncProfile::CurrentSyncStatus syncStatus = SyncProfile::SYNC_FAILED;
 
     if (syncResult)
     {
@@ -345,6 +345,23 @@ public:
      */
     bool isSOCProfile() const;
 
+    /*! \brief Gets the profiles this profile depends on.
+     *
+     * A sync of this profile is started only after the syncs of these
+     * profiles have finished successfully. When one of them finishes with
+     * changes, a sync of this profile is started automatically. Profiles
+     * that do not depend on each other are synchronized independently.
+     *
+     * \return Names of the profiles to run after.
+     */
+    QStringList runAfter() const;
+
+    /*! \brief Sets the profiles this profile depends on.
+     *
+     * \param aProfileNames Names of the profiles to run after.
+     */
+    void setRunAfter(const QStringList &aProfileNames);
+
     bool hasRetries() const;
     QList<quint32> retryIntervals() const;
 
@@ -56,6 +56,18 @@ namespace Buteo {
 
 		//! Are results for Scheduled Sync
 		bool iScheduled;
+
+		//! Payload bytes before compression
+		qint64 iUncompressedBytes;
+
+		//! Payload bytes after compression
+		qint64 iCompressedBytes;
+
+		//! CPU time of the plug-in process in milliseconds
+		qint64 iCpuTime;
+
+		//! Peak resident memory of the plug-in process in kilobytes
+		qint64 iPeakMemory;
 	};
 
 
@@ -63,7 +75,11 @@ SyncResultsPrivate::SyncResultsPrivate()
 :   iTime(QDateTime::currentDateTime()),
     iMajorCode(0),
     iMinorCode(0),
-    iScheduled(false)
+    iScheduled(false),
+    iUncompressedBytes(0),
+    iCompressedBytes(0),
+    iCpuTime(0),
+    iPeakMemory(0)
 {
 }
 
@@ -73,7 +89,11 @@ SyncResultsPrivate::SyncResultsPrivate(const SyncResultsPrivate &aSource)
     iMajorCode(aSource.iMajorCode),
     iMinorCode(aSource.iMinorCode),
     iTargetId(aSource.iTargetId),
-    iScheduled(aSource.iScheduled)
+    iScheduled(aSource.iScheduled),
+    iUncompressedBytes(aSource.iUncompressedBytes),
+    iCompressedBytes(aSource.iCompressedBytes),
+    iCpuTime(aSource.iCpuTime),
+    iPeakMemory(aSource.iPeakMemory)
 {
 }
 
@@ -107,6 +127,10 @@ SyncResults::SyncResults(const QDomElement &aRoot)
     d_ptr->iMajorCode = aRoot.attribute(ATTR_MAJOR_CODE).toInt();
     d_ptr->iMinorCode = aRoot.attribute(ATTR_MINOR_CODE).toInt();
     d_ptr->iScheduled = (aRoot.attribute(KEY_SYNC_SCHEDULED) == BOOLEAN_TRUE);
+    d_ptr->iUncompressedBytes = aRoot.attribute(ATTR_UNCOMPRESSED_BYTES).toLongLong();
+    d_ptr->iCompressedBytes = aRoot.attribute(ATTR_COMPRESSED_BYTES).toLongLong();
+    d_ptr->iCpuTime = aRoot.attribute(ATTR_CPU_TIME).toLongLong();
+    d_ptr->iPeakMemory = aRoot.attribute(ATTR_PEAK_MEMORY).toLongLong();
 
     QDomElement target = aRoot.firstChildElement(TAG_TARGET_RESULTS);
     for (; !target.isNull();
@@ -141,6 +165,18 @@ QDomElement SyncResults::toXml(QDomDocument &aDoc) const
     root.setAttribute(ATTR_MINOR_CODE, QString::number(d_ptr->iMinorCode));
     root.setAttribute(KEY_SYNC_SCHEDULED, d_ptr->iScheduled ? BOOLEAN_TRUE :
         BOOLEAN_FALSE);
+    if (d_ptr->iCompressedBytes > 0)
+    {
+        root.setAttribute(ATTR_UNCOMPRESSED_BYTES,
+            QString::number(d_ptr->iUncompressedBytes));
+        root.setAttribute(ATTR_COMPRESSED_BYTES,
+            QString::number(d_ptr->iCompressedBytes));
+    } // no else
+    if (d_ptr->iCpuTime > 0 || d_ptr->iPeakMemory > 0)
+    {
+        root.setAttribute(ATTR_CPU_TIME, QString::number(d_ptr->iCpuTime));
+        root.setAttribute(ATTR_PEAK_MEMORY, QString::number(d_ptr->iPeakMemory));
+    } // no else
 
     foreach (TargetResults tr, d_ptr->iTargetResults)
     {
@@ -225,3 +261,50 @@ bool SyncResults::isScheduled() const
 {
     return d_ptr->iScheduled;
 }
+
+void SyncResults::addCompressionStats(qint64 aUncompressedBytes, qint64 aCompressedBytes)
+{
+    d_ptr->iUncompressedBytes += aUncompressedBytes;
+    d_ptr->iCompressedBytes += aCompressedBytes;
+}
+
+qint64 SyncResults::uncompressedBytes() const
+{
+    return d_ptr->iUncompressedBytes;
+}
+
+qint64 SyncResults::compressedBytes() const
+{
+    return d_ptr->iCompressedBytes;
+}
+
+qint64 SyncResults::bytesSaved() const
+{
+    return d_ptr->iUncompressedBytes - d_ptr->iCompressedBytes;
+}
+
+double SyncResults::compressionRatio() const
+{
+    if (d_ptr->iCompressedBytes <= 0)
+    {
+        return 1.0;
+    } // no else
+
+    return static_cast<double>(d_ptr->iUncompressedBytes) / d_ptr->iCompressedBytes;
+}
+
+void SyncResults::setProcessUsage(qint64 aCpuTime, qint64 aPeakMemory)
+{
+    d_ptr->iCpuTime = aCpuTime;
+    d_ptr->iPeakMemory = aPeakMemory;
+}
+
+qint64 SyncResults::cpuTime() const
+{
+    return d_ptr->iCpuTime;
+}
+
+qint64 SyncResults::peakMemory() const
+{
+    return d_ptr->iPeakMemory;
+}
@@ -87,6 +87,7 @@ public:
         INTERNAL_ERROR = 401,
         AUTHENTICATION_FAILURE,
         DATABASE_FAILURE,
+        PLUGIN_HUNG,
 
         // Server/Network errors 5xx
         SUSPENDED = 501,
@@ -102,7 +103,8 @@ public:
         POWER_SAVING_MODE,
         OFFLINE_MODE,
         BACKUP_IN_PROGRESS,
-        LOW_MEMORY
+        LOW_MEMORY,
+        YIELDED
     };
 
     /*! \brief Constructs an empty sync results object.
@@ -229,6 +231,59 @@ public:
      */
     bool isScheduled() const;
 
+    /*! \brief Adds payload compression statistics.
+     *
+     * Statistics are accumulated over all calls during the session.
+     * \param aUncompressedBytes Payload size before compression.
+     * \param aCompressedBytes Payload size after compression.
+     */
+    void addCompressionStats(qint64 aUncompressedBytes, qint64 aCompressedBytes);
+
+    /*! \brief Gets the total payload size before compression.
+     *
+     * \return Number of bytes.
+     */
+    qint64 uncompressedBytes() const;
+
+    /*! \brief Gets the total payload size after compression.
+     *
+     * \return Number of bytes.
+     */
+    qint64 compressedBytes() const;
+
+    /*! \brief Gets the number of bytes saved by payload compression.
+     *
+     * \return Number of bytes.
+     */
+    qint64 bytesSaved() const;
+
+    /*! \brief Gets the payload compression ratio.
+     *
+     * \return Uncompressed size divided by compressed size, 1.0 if no
+     *  compressed payload was transferred.
+     */
+    double compressionRatio() const;
+
+    /*! \brief Sets the resources used by the plug-in process.
+     *
+     * Only measured for out-of-process plug-ins.
+     * \param aCpuTime User and system CPU time in milliseconds.
+     * \param aPeakMemory Peak resident memory in kilobytes, 0 if not known.
+     */
+    void setProcessUsage(qint64 aCpuTime, qint64 aPeakMemory);
+
+    /*! \brief Gets the CPU time used by the plug-in process.
+     *
+     * \return Milliseconds, 0 if not measured.
+     */
+    qint64 cpuTime() const;
+
+    /*! \brief Gets the peak resident memory of the plug-in process.
+     *
+     * \return Kilobytes, 0 if not measured.
+     */
+    qint64 peakMemory() const;
+
 private:
 
     SyncResultsPrivate *d_ptr;
@@ -23,14 +23,15 @@
 
 #include "ClientPluginRunner.h"
 #include "ClientThread.h"
+#include "SyncEventChannel.h"
 #include "ClientPlugin.h"
 #include "LogMacros.h"
 #include "PluginManager.h"
 
 using namespace Buteo;
 
-// Maximum time in milliseconds for a plugin to finish sync
-static const unsigned long long MAX_PLUGIN_SYNC_TIME = 1800000; //30 mins
+// Time in milliseconds a hung plug-in gets to stop, before it is killed
+static const unsigned long HUNG_PLUGIN_GRACE_TIME = 2000;
 
 ClientPluginRunner::ClientPluginRunner(const QString &aPluginName,
     SyncProfile *aProfile, PluginManager *aPluginMgr,
@@ -38,7 +39,8 @@ ClientPluginRunner::ClientPluginRunner(const QString &aPluginName,
 :   PluginRunner(PLUGIN_CLIENT, aPluginName, aPluginMgr, aPluginCbIf, aParent),
     iProfile(aProfile),
     iPlugin(0),
-    iThread(0)
+    iThread(0),
+    iHung(false)
 {
     FUNCTION_CALL_TRACE;
 }
@@ -93,10 +95,13 @@ bool ClientPluginRunner::init()
     connect(this, SIGNAL(connectivityStateChanged(Sync::ConnectivityType, bool)),
         iPlugin, SLOT(connectivityStateChanged(Sync::ConnectivityType, bool)));
 
-    // Connect signals from the plug-in.
+    // Connect signals from the plug-in. Progress signals are handled directly
+    // in the plug-in thread, so that they can be posted to the event channel
+    // without a queued call per event.
 
     connect(iPlugin, SIGNAL(transferProgress(const QString &, Sync::TransferDatabase, Sync::TransferType, const QString &, int)),
-        this, SLOT(onTransferProgress(const QString &, Sync::TransferDatabase, Sync::TransferType, const QString &, int)));
+        this, SLOT(onTransferProgress(const QString &, Sync::TransferDatabase, Sync::TransferType, const QString &, int)),
+        Qt::DirectConnection);
 
     connect(iPlugin, SIGNAL(error(const QString &, const QString &, int)),
         this, SLOT(onError(const QString &, const QString &, int)));
@@ -105,10 +110,10 @@ bool ClientPluginRunner::init()
         this, SLOT(onSuccess(const QString &, const QString &)));
 
     connect(iPlugin, SIGNAL(accquiredStorage(const QString &)),
-        this, SLOT(onStorageAccquired(const QString &)));
+        this, SLOT(onStorageAccquired(const QString &)), Qt::DirectConnection);
 
     connect(iPlugin,SIGNAL(syncProgressDetail(const QString &,int)),
-    		this ,SLOT(onSyncProgressDetail(const QString &,int)));
+    		this ,SLOT(onSyncProgressDetail(const QString &,int)), Qt::DirectConnection);
 
     // Connect signals from the thread.
     connect(iThread, SIGNAL(initError(const QString &, const QString &, int)),
@@ -120,11 +125,30 @@ bool ClientPluginRunner::init()
 
     connect(iThread, SIGNAL(finished()), this, SLOT(onThreadExit()));
 
+    // Watch the phases of the plug-in for hangs.
+    iWatchdog.configure(*iProfile);
+    connect(iThread, SIGNAL(phaseChanged(int)), &iWatchdog, SLOT(enterPhase(int)));
+    connect(&iWatchdog, SIGNAL(hung(int)), this, SLOT(onPluginHung(int)));
+
     iInitialized = true;
 
     return true;
 }
 
+void ClientPluginRunner::setCredentialBroker(CredentialBroker *aBroker)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iThread != 0)
+    {
+        iThread->setCredentialBroker(aBroker);
+    }
+    else
+    {
+        LOG_WARNING("Plug-in runner not initialized");
+    }
+}
+
 bool ClientPluginRunner::start()
 {
     FUNCTION_CALL_TRACE;
@@ -132,10 +156,13 @@ bool ClientPluginRunner::start()
     bool rv = false;
     if (iInitialized && iThread != 0)
     {
-        // Set a timer after which the sync session should stop
-        QTimer::singleShot( MAX_PLUGIN_SYNC_TIME, this, SLOT(pluginTimeout()) );
+        iWatchdog.enterPhase(PluginWatchdog::PHASE_INIT);
 
         rv = iThread->startThread(iPlugin);
+        if (!rv)
+        {
+            iWatchdog.stop();
+        } // no else
     }
 
     return rv;
@@ -148,7 +175,26 @@ void ClientPluginRunner::stop()
     if (iThread != 0)
     {
         iThread->stopThread();
-        iThread->wait();
+
+        // The main thread is blocked while waiting, so the uninit deadline
+        // is enforced here instead of by the watchdog timer.
+        const int deadline = iWatchdog.deadline(PluginWatchdog::PHASE_UNINIT);
+        if (iHung || deadline == 0)
+        {
+            iThread->wait();
+        }
+        else
+        {
+            iWatchdog.enterPhase(PluginWatchdog::PHASE_UNINIT);
+            if (iThread->wait(deadline * 1000UL))
+            {
+                iWatchdog.stop();
+            }
+            else
+            {
+                onPluginHung(PluginWatchdog::PHASE_UNINIT);
+            }
+        }
     }
 }
 
@@ -156,12 +202,25 @@ void ClientPluginRunner::abort(Sync::SyncStatus aStatus)
 {
     FUNCTION_CALL_TRACE;
 
-    if (iPlugin != 0)
+    if (iPlugin != 0 && !iHung)
     {
         iPlugin->abortSync(aStatus);
     }
 }
 
+bool ClientPluginRunner::yield()
+{
+    FUNCTION_CALL_TRACE;
+
+    bool yielding = false;
+    if (iPlugin != 0 && !iHung)
+    {
+        yielding = iPlugin->requestYield();
+    }
+
+    return yielding;
+}
+
 SyncPluginBase *ClientPluginRunner::plugin()
 {
     FUNCTION_CALL_TRACE;
@@ -173,7 +232,12 @@ SyncResults ClientPluginRunner::syncResults()
 {
     FUNCTION_CALL_TRACE;
 
-    if (iPlugin != 0)
+    if (iThread != 0 && iThread->isFinished())
+    {
+        // Fetched by the thread before the plug-in was uninitialized.
+        return iThread->getSyncResults();
+    }
+    else if (iPlugin != 0 && !iHung)
     {
         return iPlugin->getSyncResults();
     }
@@ -188,7 +252,7 @@ bool ClientPluginRunner::cleanUp()
     FUNCTION_CALL_TRACE;
 
     bool retval = false;
-    if (iPlugin != 0)
+    if (iPlugin != 0 && !iHung)
     {
         retval = iPlugin->cleanUp();
     }
@@ -201,6 +265,15 @@ void ClientPluginRunner::onTransferProgress(const QString &aProfileName,
 {
     FUNCTION_CALL_TRACE;
 
+    iWatchdog.recordActivity();
+
+    if (iEventChannel != 0 &&
+        iEventChannel->post(SyncEvent(SyncEvent::TRANSFER_PROGRESS, iProfileAtom,
+            SyncEventAtoms::intern(aMimeType), aCommittedItems, aDatabase, aType)))
+    {
+        return;
+    } // no else
+
     emit transferProgress(aProfileName, aDatabase, aType, aMimeType, aCommittedItems);
 }
 
@@ -209,8 +282,17 @@ void ClientPluginRunner::onError(const QString &aProfileName,
 {
     FUNCTION_CALL_TRACE;
 
-    emit error(aProfileName, aMessage, aErrorCode);
+    if (iHung)
+    {
+        return;
+    } // no else
+
+    // Stop first, so that a plug-in hanging in uninit is reported as hung.
     stop();
+    if (!iHung)
+    {
+        emit error(aProfileName, aMessage, aErrorCode);
+    } // no else
 }
 
 void ClientPluginRunner::onSuccess(const QString &aProfileName,
@@ -218,15 +300,30 @@ void ClientPluginRunner::onSuccess(const QString &aProfileName,
 {
     FUNCTION_CALL_TRACE;
 
-    emit success(aProfileName, aMessage);
-    stop();
+    if (iHung)
+    {
+        return;
+    } // no else
 
+    // Stop first, so that a plug-in hanging in uninit is reported as hung.
+    stop();
+    if (!iHung)
+    {
+        emit success(aProfileName, aMessage);
+    } // no else
 }
 
 void ClientPluginRunner::onStorageAccquired(const QString &aMimeType )
 {
     FUNCTION_CALL_TRACE;
 
+    if (iEventChannel != 0 &&
+        iEventChannel->post(SyncEvent(SyncEvent::STORAGE_ACQUIRED, iProfileAtom,
+            SyncEventAtoms::intern(aMimeType))))
+    {
+        return;
+    } // no else
+
     emit storageAccquired(aMimeType);
 }
 
@@ -234,6 +331,15 @@ void ClientPluginRunner::onSyncProgressDetail(const QString &aProfileName,int aP
 {
 	FUNCTION_CALL_TRACE;
 
+	iWatchdog.recordActivity();
+
+	if (iEventChannel != 0 &&
+		iEventChannel->post(SyncEvent(SyncEvent::PROGRESS_DETAIL, iProfileAtom,
+			SyncEventAtoms::NONE, aProgressDetail)))
+	{
+		return;
+	} // no else
+
 	emit syncProgressDetail(aProfileName,aProgressDetail);
 }
 
@@ -242,13 +348,60 @@ void ClientPluginRunner::onThreadExit()
 {
     FUNCTION_CALL_TRACE;
 
+    iWatchdog.stop();
     emit done();
 }
 
-void ClientPluginRunner::pluginTimeout()
+void ClientPluginRunner::onPluginHung(int aPhase)
 {
     FUNCTION_CALL_TRACE;
 
-    emit error(iProfile->name(), "Plugin timeout occured", Sync::SYNC_PLUGIN_TIMEOUT);
-    stop();
+    if (iHung)
+    {
+        return;
+    } // no else
+
+    iHung = true;
+    const QString diagnostic = iWatchdog.diagnostic(iPluginName);
+    LOG_CRITICAL(diagnostic);
+    iWatchdog.stop();
+
+    stopHungThread();
+
+    LOG_WARNING("Plug-in" << iPluginName << "stopped after hanging in phase" <<
+                PluginWatchdog::phaseName(static_cast<PluginWatchdog::Phase>(aPhase)));
+    emit error(iProfile->name(), diagnostic, SyncResults::PLUGIN_HUNG);
+}
+
+void ClientPluginRunner::stopHungThread()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iThread == 0)
+    {
+        return;
+    } // no else
+
+    // Give the plug-in a moment to return to the event loop.
+    iThread->stopThread();
+    if (iThread->wait(HUNG_PLUGIN_GRACE_TIME))
+    {
+        return;
+    } // no else
+
+    // An out-of-process plug-in is killed, which makes its pending D-Bus
+    // calls fail and lets the thread finish.
+    if (iPluginMgr != 0 && iPluginMgr->killOOPPlugin(iPluginName) &&
+        iThread->wait(HUNG_PLUGIN_GRACE_TIME))
+    {
+        return;
+    } // no else
+
+    LOG_CRITICAL("Terminating the thread of plug-in" << iPluginName);
+    iThread->terminate();
+    iThread->wait();
+
+    // The plug-in may be left in any state, so it is leaked rather than
+    // destroyed.
+    iPlugin = 0;
 }
@@ -25,12 +25,14 @@
 #define CLIENTPLUGINRUNNER_H
 
 #include "PluginRunner.h"
+#include "PluginWatchdog.h"
 #include <QProcess>
 
 namespace Buteo {
 
 class ClientPlugin;
 class ClientThread;
+class CredentialBroker;
 class SyncProfile;
     
 /*! \brief Class for running client sync plug-ins
@@ -70,6 +72,9 @@ public:
     //! @see PluginRunner::abort
     virtual void abort(Sync::SyncStatus aStatus = Sync::SYNC_ABORTED);
 
+    //! @see PluginRunner::yield
+    virtual bool yield();
+
     //! @see PluginRunner::syncResults
     virtual SyncResults syncResults();
 
@@ -79,6 +84,13 @@ public:
     //! @see PluginRunner::plugin
     virtual bool cleanUp();
 
+    /*! \brief Sets the broker used for getting credentials from SSO
+     *
+     * Must be called before start().
+     * @param aBroker Credential broker. Ownership is NOT transferred.
+     */
+    void setCredentialBroker(CredentialBroker *aBroker);
+
 private slots:
 
     // Slots for catching plug-in signals.
@@ -98,15 +110,22 @@ private slots:
     // Slot for observing thread exit
     void onThreadExit();
 
-    void pluginTimeout();
+    void onPluginHung(int aPhase);
 
 private:
 
+    void stopHungThread();
+
     SyncProfile *iProfile;
 
     ClientPlugin *iPlugin;
 
     ClientThread *iThread;
+
+    PluginWatchdog iWatchdog;
+
+    // Set when the plug-in has hung, after which it is not called anymore.
+    bool iHung;
     
 #ifdef SYNCFW_UNIT_TESTS
     friend class ClientPluginRunnerTest;
@@ -22,6 +22,8 @@
  */
 #include "ClientThread.h"
 #include "ClientPlugin.h"
+#include "CredentialBroker.h"
+#include "PluginWatchdog.h"
 #include "LogMacros.h"
 #include <QCoreApplication>
 
@@ -29,9 +31,7 @@ using namespace Buteo;
 
 ClientThread::ClientThread()
  : iClientPlugin( 0 ),
-   iIdentity(NULL),
-   iService(NULL),
-   iSession(NULL),
+   iCredentialBroker(NULL),
    iRunning(false)
 {
     FUNCTION_CALL_TRACE;
@@ -40,10 +40,6 @@ ClientThread::ClientThread()
 ClientThread::~ClientThread()
 {
     FUNCTION_CALL_TRACE;
-    if (iSession) {
-        iIdentity->destroySession(iSession);
-    }
-    delete iIdentity;
 }
 
 QString ClientThread::getProfileName() const
@@ -101,10 +97,14 @@ bool ClientThread::startThread( ClientPlugin* aClientPlugin )
         // this instance lives.
         iProvider = username.mid(prefix.size());
         LOG_DEBUG("SSO provider::" << iProvider);
-        iService = new SignOn::AuthService(this);
-        connect(iService, SIGNAL(identities(const QList<SignOn::IdentityInfo> &)),
-                this, SLOT(identities(const QList<SignOn::IdentityInfo> &)));
-        iService->queryIdentities();
+        if (iCredentialBroker == NULL) {
+            iCredentialBroker = new CredentialBroker(this);
+        }
+        connect(iCredentialBroker, SIGNAL(credentialsReady(const QString &, const QString &, const QString &)),
+                this, SLOT(credentialsReady(const QString &, const QString &, const QString &)));
+        connect(iCredentialBroker, SIGNAL(credentialsFailed(const QString &, const QString &)),
+                this, SLOT(credentialsFailed(const QString &, const QString &)));
+        iCredentialBroker->requestCredentials(iProvider);
     } else {
         // Move to client thread
         iClientPlugin->moveToThread( this );
@@ -114,6 +114,13 @@ bool ClientThread::startThread( ClientPlugin* aClientPlugin )
     return true;
 }
 
+void ClientThread::setCredentialBroker(CredentialBroker *aBroker)
+{
+    FUNCTION_CALL_TRACE;
+
+    iCredentialBroker = aBroker;
+}
+
 void ClientThread::stopThread()
 {
     FUNCTION_CALL_TRACE;
@@ -137,8 +144,12 @@ void ClientThread::run()
         return;
     }
 
+    emit phaseChanged(PluginWatchdog::PHASE_SYNC);
+
     exec();
 
+    emit phaseChanged(PluginWatchdog::PHASE_UNINIT);
+
     iSyncResults = iClientPlugin->getSyncResults();
 
     iClientPlugin->uninit();
@@ -160,49 +171,37 @@ SyncResults ClientThread::getSyncResults()
 	return iSyncResults;
 }
 
-void ClientThread::identities(const QList<SignOn::IdentityInfo> &identityList)
+void ClientThread::credentialsReady(const QString &aProvider,
+                                    const QString &aUsername,
+                                    const QString &aSecret)
 {
     FUNCTION_CALL_TRACE;
 
-    for (int i = 0; i < identityList.size(); ++i) {
-        const SignOn::IdentityInfo &info = identityList.at(i);
-        LOG_DEBUG("Signon identity::" << info.caption());
-        if (info.caption() == iProvider) {
-            iIdentity = SignOn::Identity::existingIdentity(info.id(), this);
-            // Setup an authentication session using the "password" method
-            iSession =
-                iIdentity->createSession(QLatin1String("password"));
-            connect(iSession, SIGNAL(response(const SignOn::SessionData &)),
-                    this, SLOT(identityResponse(const SignOn::SessionData &)));
-            connect(iSession, SIGNAL(error(SignOn::Error)),
-                    this, SLOT(identityError(SignOn::Error)));
-            // Get the password!
-            iSession->process(SignOn::SessionData(), QLatin1String("password"));
-            return;
-        }
+    if (aProvider != iProvider) {
+        return;
     }
-    emit initError( getProfileName(), "credentials not found in SSO", 0 );
-}
-
-void ClientThread::identityResponse(const SignOn::SessionData &sessionData)
-{
-    FUNCTION_CALL_TRACE;
+    iCredentialBroker->disconnect(this);
 
     // temporarily set real username/password, then invoke client
     SyncProfile &profile = iClientPlugin->profile();
-    LOG_DEBUG("Username::" << sessionData.UserName());
-    profile.setKey("Username", sessionData.UserName());
-    profile.setKey("Password", sessionData.Secret());
+    LOG_DEBUG("Username::" << aUsername);
+    profile.setKey("Username", aUsername);
+    profile.setKey("Password", aSecret);
 
     // delayed starting of thread
     iClientPlugin->moveToThread( this );
     start();
 }
 
-void ClientThread::identityError(SignOn::Error err)
+void ClientThread::credentialsFailed(const QString &aProvider,
+                                     const QString &aMessage)
 {
     FUNCTION_CALL_TRACE;
 
-    emit initError( getProfileName(), err.message(), 0 );
-}
+    if (aProvider != iProvider) {
+        return;
+    }
+    iCredentialBroker->disconnect(this);
 
+    emit initError( getProfileName(), aMessage, 0 );
+}
@@ -27,12 +27,10 @@
 #include <QMutex>
 #include <SyncResults.h>
 
-#include "SignOn/AuthService"
-#include "SignOn/Identity"
-
 namespace Buteo {
 
 class ClientPlugin;
+class CredentialBroker;
     
 /*! \brief Thread for client plugins
  *
@@ -72,6 +70,13 @@ public:
      */
     bool startThread( ClientPlugin* aClientPlugin );
 
+    /*! \brief Sets the broker used for getting credentials from SSO
+     *
+     * If no broker is set, the thread creates its own broker when needed.
+     * @param aBroker Credential broker. Ownership is NOT transferred.
+     */
+    void setCredentialBroker(CredentialBroker *aBroker);
+
     /*! \brief Stops client thread
      *
      */
@@ -94,6 +99,12 @@ signals:
     void initError( const QString &aProfileName, const QString &aMessage,
         int aErrorCode);
 
+    /*! \brief Emitted from the thread when the plug-in enters a new phase
+     *
+     * @param aPhase PluginWatchdog::Phase entered
+     */
+    void phaseChanged(int aPhase);
+
 protected:
     /*! \brief overriding method for QThread::run
      */
@@ -105,9 +116,7 @@ private:
 
     SyncResults iSyncResults;
     
-    SignOn::Identity *iIdentity;
-    SignOn::AuthService *iService;
-    SignOn::AuthSession *iSession;
+    CredentialBroker *iCredentialBroker;
     QString iProvider;
     
     bool iRunning;
@@ -125,8 +134,8 @@ private:
      * credentials set in the Username/Password keys.  It is called
      * either in run() or, if the Username key starts with the
      * "sso-provider=" prefix, after retrieving the credentials from
-     * SSO (queryIdentities() -> identities() -> session ->
-     * identityResponse() -> startSync()).
+     * SSO through the credential broker (requestCredentials() ->
+     * credentialsReady() -> startSync()).
      *
      * @return true for success (run thread), else failure (running
      * thread is no longer necessary)
@@ -134,9 +143,9 @@ private:
     bool startSync();
 
 private slots:
-    void identities(const QList<SignOn::IdentityInfo> &identityList);
-    void identityResponse(const SignOn::SessionData &session);
-    void identityError(SignOn::Error error);
+    void credentialsReady(const QString &aProvider, const QString &aUsername,
+                          const QString &aSecret);
+    void credentialsFailed(const QString &aProvider, const QString &aMessage);
 };
 
 }
@@ -0,0 +1,416 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "CredentialBroker.h"
+#include "LogMacros.h"
+
+using namespace Buteo;
+
+static const QLatin1String PASSWORD_MECHANISM("password");
+
+CredentialBroker::CredentialBroker(QObject *aParent)
+ :  QObject(aParent),
+    iService(0),
+    iLookupRunning(false)
+{
+    FUNCTION_CALL_TRACE;
+
+    iClock.start();
+    iRefreshTimer.setInterval(CREDENTIALS_TTL / 2);
+    connect(&iRefreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+}
+
+CredentialBroker::~CredentialBroker()
+{
+    FUNCTION_CALL_TRACE;
+
+    invalidateAll();
+}
+
+bool CredentialBroker::cachedCredentials(const QString &aProvider,
+                                         QString &aUsername, QString &aSecret)
+{
+    FUNCTION_CALL_TRACE;
+
+    QHash<QString, Credentials>::iterator i = iCredentials.find(aProvider);
+    if (i == iCredentials.end())
+    {
+        return false;
+    } // no else
+
+    if (now() - i->fetched >= CREDENTIALS_TTL)
+    {
+        LOG_DEBUG("Cached credentials of" << aProvider << "expired");
+        iCredentials.erase(i);
+        return false;
+    } // no else
+
+    i->used = true;
+    aUsername = i->username;
+    aSecret = i->secret;
+    return true;
+}
+
+void CredentialBroker::requestCredentials(const QString &aProvider)
+{
+    FUNCTION_CALL_TRACE;
+
+    QString username;
+    QString secret;
+    if (cachedCredentials(aProvider, username, secret))
+    {
+        LOG_DEBUG("Using cached credentials of" << aProvider);
+        emit credentialsReady(aProvider, username, secret);
+    }
+    else if (iInProgress.contains(aProvider))
+    {
+        LOG_DEBUG("Credentials of" << aProvider << "already requested");
+    }
+    else
+    {
+        iInProgress.insert(aProvider);
+        if (iIdentities.contains(aProvider))
+        {
+            fetch(aProvider);
+        }
+        else
+        {
+            iPendingLookups.insert(aProvider);
+            lookupIdentities();
+        }
+    }
+}
+
+void CredentialBroker::invalidate(const QString &aProvider)
+{
+    FUNCTION_CALL_TRACE;
+
+    iCredentials.remove(aProvider);
+
+    SignOn::Identity *identity = iIdentities.take(aProvider);
+    if (identity == 0)
+    {
+        return;
+    } // no else
+
+    foreach (SignOn::AuthSession *session, iFinishedSessions.keys(aProvider))
+    {
+        iFinishedSessions.remove(session);
+        identity->destroySession(session);
+    }
+
+    bool restart = false;
+    foreach (SignOn::AuthSession *session, iSessions.keys(aProvider))
+    {
+        iSessions.remove(session);
+        identity->destroySession(session);
+        restart = true;
+    }
+    identity->disconnect(this);
+    identity->deleteLater();
+
+    // A request in progress must look up the identity again.
+    if (restart)
+    {
+        iPendingLookups.insert(aProvider);
+        lookupIdentities();
+    } // no else
+}
+
+void CredentialBroker::invalidateAll()
+{
+    FUNCTION_CALL_TRACE;
+
+    foreach (const QString &provider, iIdentities.keys())
+    {
+        invalidate(provider);
+    }
+    iCredentials.clear();
+    iRefreshTimer.stop();
+}
+
+qint64 CredentialBroker::now() const
+{
+    return iClock.elapsed();
+}
+
+void CredentialBroker::storeCredentials(const QString &aProvider,
+                                        const QString &aUsername,
+                                        const QString &aSecret)
+{
+    FUNCTION_CALL_TRACE;
+
+    Credentials credentials;
+    credentials.username = aUsername;
+    credentials.secret = aSecret;
+    credentials.fetched = now();
+    credentials.used = false;
+    iCredentials.insert(aProvider, credentials);
+
+    if (!iRefreshTimer.isActive())
+    {
+        iRefreshTimer.start();
+    } // no else
+}
+
+QStringList CredentialBroker::expireCredentials()
+{
+    FUNCTION_CALL_TRACE;
+
+    // Credentials that would expire before the next refresh are either
+    // refreshed, if they were used, or dropped.
+    QStringList refreshed;
+    const qint64 currentTime = now();
+    QHash<QString, Credentials>::iterator i = iCredentials.begin();
+    while (i != iCredentials.end())
+    {
+        if (currentTime - i->fetched < CREDENTIALS_TTL / 2)
+        {
+            ++i;
+        }
+        else if (i->used)
+        {
+            i->used = false;
+            refreshed.append(i.key());
+            ++i;
+        }
+        else
+        {
+            LOG_DEBUG("Dropping unused credentials of" << i.key());
+            i = iCredentials.erase(i);
+        }
+    }
+    return refreshed;
+}
+
+void CredentialBroker::identities(const QList<SignOn::IdentityInfo> &aIdentityList)
+{
+    FUNCTION_CALL_TRACE;
+
+    iLookupRunning = false;
+
+    QSet<QString> pending = iPendingLookups;
+    iPendingLookups.clear();
+    foreach (const QString &provider, pending)
+    {
+        SignOn::Identity *identity = 0;
+        foreach (const SignOn::IdentityInfo &info, aIdentityList)
+        {
+            if (info.caption() == provider)
+            {
+                identity = SignOn::Identity::existingIdentity(info.id(), this);
+                break;
+            } // no else
+        }
+
+        if (identity == 0)
+        {
+            fail(provider, "credentials not found in SSO");
+            continue;
+        } // no else
+
+        LOG_DEBUG("Signon identity::" << provider);
+        connect(identity, SIGNAL(removed()), this, SLOT(identityChanged()));
+        connect(identity, SIGNAL(signedOut()), this, SLOT(identityChanged()));
+        iIdentities.insert(provider, identity);
+        fetch(provider);
+    }
+}
+
+void CredentialBroker::serviceError(const SignOn::Error &aError)
+{
+    FUNCTION_CALL_TRACE;
+
+    LOG_WARNING("Identity query failed:" << aError.message());
+    iLookupRunning = false;
+
+    QSet<QString> pending = iPendingLookups;
+    iPendingLookups.clear();
+    foreach (const QString &provider, pending)
+    {
+        fail(provider, aError.message());
+    }
+}
+
+void CredentialBroker::sessionResponse(const SignOn::SessionData &aSessionData)
+{
+    FUNCTION_CALL_TRACE;
+
+    SignOn::AuthSession *session = qobject_cast<SignOn::AuthSession*>(sender());
+    if (!iSessions.contains(session))
+    {
+        return;
+    } // no else
+
+    QString provider = iSessions.value(session);
+    finishSession(session);
+
+    LOG_DEBUG("Got credentials of" << provider);
+    storeCredentials(provider, aSessionData.UserName(), aSessionData.Secret());
+    iInProgress.remove(provider);
+    emit credentialsReady(provider, aSessionData.UserName(), aSessionData.Secret());
+}
+
+void CredentialBroker::sessionError(const SignOn::Error &aError)
+{
+    FUNCTION_CALL_TRACE;
+
+    SignOn::AuthSession *session = qobject_cast<SignOn::AuthSession*>(sender());
+    if (!iSessions.contains(session))
+    {
+        return;
+    } // no else
+
+    QString provider = iSessions.value(session);
+    finishSession(session);
+    fail(provider, aError.message());
+}
+
+void CredentialBroker::identityChanged()
+{
+    FUNCTION_CALL_TRACE;
+
+    QString provider = providerOf(sender());
+    if (!provider.isEmpty())
+    {
+        LOG_DEBUG("Signon identity of" << provider << "changed");
+        invalidate(provider);
+    } // no else
+}
+
+void CredentialBroker::refresh()
+{
+    FUNCTION_CALL_TRACE;
+
+    foreach (const QString &provider, expireCredentials())
+    {
+        if (!iInProgress.contains(provider))
+        {
+            LOG_DEBUG("Refreshing credentials of" << provider);
+            iInProgress.insert(provider);
+            if (iIdentities.contains(provider))
+            {
+                fetch(provider);
+            }
+            else
+            {
+                iPendingLookups.insert(provider);
+                lookupIdentities();
+            }
+        } // no else
+    }
+
+    if (iCredentials.isEmpty() && iInProgress.isEmpty())
+    {
+        iRefreshTimer.stop();
+    } // no else
+}
+
+void CredentialBroker::lookupIdentities()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iService == 0)
+    {
+        iService = new SignOn::AuthService(this);
+        connect(iService, SIGNAL(identities(const QList<SignOn::IdentityInfo> &)),
+                this, SLOT(identities(const QList<SignOn::IdentityInfo> &)));
+        connect(iService, SIGNAL(error(const SignOn::Error &)),
+                this, SLOT(serviceError(const SignOn::Error &)));
+    } // no else
+
+    if (!iLookupRunning)
+    {
+        iLookupRunning = true;
+        iService->queryIdentities();
+    } // no else
+}
+
+void CredentialBroker::fetch(const QString &aProvider)
+{
+    FUNCTION_CALL_TRACE;
+
+    SignOn::Identity *identity = iIdentities.value(aProvider);
+    SignOn::AuthSession *session = identity->createSession(PASSWORD_MECHANISM);
+    if (session == 0)
+    {
+        fail(aProvider, "failed to create SSO session");
+        return;
+    } // no else
+
+    iSessions.insert(session, aProvider);
+    connect(session, SIGNAL(response(const SignOn::SessionData &)),
+            this, SLOT(sessionResponse(const SignOn::SessionData &)));
+    connect(session, SIGNAL(error(const SignOn::Error &)),
+            this, SLOT(sessionError(const SignOn::Error &)));
+    session->process(SignOn::SessionData(), PASSWORD_MECHANISM);
+}
+
+void CredentialBroker::finishSession(SignOn::AuthSession *aSession)
+{
+    FUNCTION_CALL_TRACE;
+
+    // The session is destroyed later, as we are in its signal handler.
+    aSession->disconnect(this);
+    iFinishedSessions.insert(aSession, iSessions.take(aSession));
+    QMetaObject::invokeMethod(this, "destroyFinishedSessions",
+                              Qt::QueuedConnection);
+}
+
+void CredentialBroker::destroyFinishedSessions()
+{
+    FUNCTION_CALL_TRACE;
+
+    QHash<SignOn::AuthSession*, QString>::const_iterator i;
+    for (i = iFinishedSessions.constBegin(); i != iFinishedSessions.constEnd(); ++i)
+    {
+        SignOn::Identity *identity = iIdentities.value(i.value());
+        if (identity != 0)
+        {
+            identity->destroySession(i.key());
+        } // no else
+    }
+    iFinishedSessions.clear();
+}
+
+void CredentialBroker::fail(const QString &aProvider, const QString &aMessage)
+{
+    FUNCTION_CALL_TRACE;
+
+    LOG_WARNING("Failed to get credentials of" << aProvider << ":" << aMessage);
+    iInProgress.remove(aProvider);
+    iCredentials.remove(aProvider);
+    emit credentialsFailed(aProvider, aMessage);
+}
+
+QString CredentialBroker::providerOf(QObject *aObject) const
+{
+    QHash<QString, SignOn::Identity*>::const_iterator i;
+    for (i = iIdentities.constBegin(); i != iIdentities.constEnd(); ++i)
+    {
+        if (i.value() == aObject)
+        {
+            return i.key();
+        } // no else
+    }
+    return QString();
+}
@@ -0,0 +1,210 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef CREDENTIALBROKER_H
+#define CREDENTIALBROKER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include "SignOn/AuthService"
+#include "SignOn/Identity"
+
+namespace Buteo {
+
+class CredentialBrokerTest;
+
+/*! \brief Daemon wide cache of SSO credentials
+ *
+ * Client plug-ins can get their credentials from SSO by setting the
+ * Username key of the profile to "sso-provider=<caption>". Looking up the
+ * identity and running the password mechanism takes several round trips
+ * to the SSO daemon, so the broker caches the provider to identity mapping
+ * and the retrieved credentials in memory. Credentials are kept for a short
+ * time only. Credentials that were used while cached are refreshed in the
+ * background before they expire, others are dropped. Cached data of an
+ * identity is dropped when SSO reports that the identity was removed or
+ * signed out.
+ *
+ * The broker lives in the application thread.
+ */
+class CredentialBroker : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    //! How long retrieved credentials are kept, in milliseconds
+    static const int CREDENTIALS_TTL = 5 * 60 * 1000;
+
+    /*! \brief Constructor
+     *
+     * @param aParent Parent object
+     */
+    explicit CredentialBroker(QObject *aParent = 0);
+
+    //! \brief Destructor
+    virtual ~CredentialBroker();
+
+    /*! \brief Returns cached credentials of a provider
+     *
+     * @param aProvider Caption of the SSO identity
+     * @param aUsername Set to the user name if credentials are cached
+     * @param aSecret Set to the secret if credentials are cached
+     * @return True if valid credentials were cached
+     */
+    bool cachedCredentials(const QString &aProvider, QString &aUsername,
+                           QString &aSecret);
+
+    /*! \brief Requests credentials of a provider
+     *
+     * credentialsReady() or credentialsFailed() is emitted with the provider
+     * when the request completes, possibly before this function returns if
+     * the credentials are cached. Concurrent requests for the same provider
+     * share one lookup.
+     * @param aProvider Caption of the SSO identity
+     */
+    void requestCredentials(const QString &aProvider);
+
+    /*! \brief Drops cached data of a provider
+     *
+     * @param aProvider Caption of the SSO identity
+     */
+    void invalidate(const QString &aProvider);
+
+    //! \brief Drops all cached data
+    void invalidateAll();
+
+signals:
+
+    /*! \brief Emitted when credentials of a provider are available
+     *
+     * @param aProvider Caption of the SSO identity
+     * @param aUsername User name
+     * @param aSecret Secret
+     */
+    void credentialsReady(const QString &aProvider, const QString &aUsername,
+                          const QString &aSecret);
+
+    /*! \brief Emitted when credentials of a provider could not be retrieved
+     *
+     * @param aProvider Caption of the SSO identity
+     * @param aMessage Error message
+     */
+    void credentialsFailed(const QString &aProvider, const QString &aMessage);
+
+protected:
+
+    /*! \brief Returns monotonic time in milliseconds
+     *
+     * @return Current time
+     */
+    virtual qint64 now() const;
+
+    /*! \brief Stores retrieved credentials of a provider
+     *
+     * @param aProvider Caption of the SSO identity
+     * @param aUsername User name
+     * @param aSecret Secret
+     */
+    void storeCredentials(const QString &aProvider, const QString &aUsername,
+                          const QString &aSecret);
+
+    /*! \brief Expires old credentials and returns the providers to refresh
+     *
+     * @return Providers whose credentials were used since the last refresh
+     */
+    QStringList expireCredentials();
+
+private slots:
+
+    void identities(const QList<SignOn::IdentityInfo> &aIdentityList);
+
+    void serviceError(const SignOn::Error &aError);
+
+    void sessionResponse(const SignOn::SessionData &aSessionData);
+
+    void sessionError(const SignOn::Error &aError);
+
+    void identityChanged();
+
+    void refresh();
+
+    void destroyFinishedSessions();
+
+private:
+
+    struct Credentials
+    {
+        QString username;
+        QString secret;
+        qint64 fetched;
+        bool used;
+    };
+
+    void lookupIdentities();
+
+    void fetch(const QString &aProvider);
+
+    void finishSession(SignOn::AuthSession *aSession);
+
+    void fail(const QString &aProvider, const QString &aMessage);
+
+    QString providerOf(QObject *aObject) const;
+
+    SignOn::AuthService *iService;
+
+    //! Identities by provider
+    QHash<QString, SignOn::Identity*> iIdentities;
+
+    //! Password sessions in progress, with their provider
+    QHash<SignOn::AuthSession*, QString> iSessions;
+
+    //! Completed password sessions waiting to be destroyed
+    QHash<SignOn::AuthSession*, QString> iFinishedSessions;
+
+    QHash<QString, Credentials> iCredentials;
+
+    //! Providers waiting for the identity lookup
+    QSet<QString> iPendingLookups;
+
+    //! Providers with a request in progress
+    QSet<QString> iInProgress;
+
+    bool iLookupRunning;
+
+    QTimer iRefreshTimer;
+
+    QElapsedTimer iClock;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class CredentialBrokerTest;
+#endif
+};
+
+}
+
+#endif // CREDENTIALBROKER_H
@@ -0,0 +1,314 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "DeadlineTimer.h"
+#include "LogMacros.h"
+
+#include <QSocketNotifier>
+
+#include <time.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#ifndef TFD_TIMER_CANCEL_ON_SET
+#define TFD_TIMER_CANCEL_ON_SET (1 << 1)
+#endif
+
+using namespace Buteo;
+
+// Longest time to sleep before checking the clocks again, without timerfd
+static const qint64 MAX_SLICE_MS = 60 * 1000;
+
+// Differences between the clocks smaller than this are not clock changes
+static const qint64 CLOCK_JUMP_TOLERANCE_MS = 2000;
+
+// Current time of a clock in milliseconds, -1 on failure
+static qint64 clockTime(clockid_t aClock)
+{
+    struct timespec ts;
+    if (clock_gettime(aClock, &ts) != 0)
+    {
+        return -1;
+    } // no else
+
+    return static_cast<qint64>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+DeadlineTimer::DeadlineTimer(QObject *aParent)
+:   QObject(aParent),
+    iDeadline(-1),
+    iWallOffset(0),
+    iClockId(CLOCK_MONOTONIC),
+    iDeadlineFd(-1),
+    iClockFd(-1),
+    iDeadlineNotifier(0),
+    iClockNotifier(0)
+{
+    FUNCTION_CALL_TRACE;
+
+    iTimer.setSingleShot(true);
+    connect(&iTimer, SIGNAL(timeout()), this, SLOT(check()));
+
+#ifdef CLOCK_BOOTTIME
+    iDeadlineFd = timerfd_create(CLOCK_BOOTTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (iDeadlineFd >= 0)
+    {
+        iClockId = CLOCK_BOOTTIME;
+    } // no else
+#endif
+    if (iDeadlineFd < 0)
+    {
+        // Suspend is not counted, the deadline fires late after a resume.
+        iDeadlineFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    } // no else
+
+    if (iDeadlineFd >= 0)
+    {
+        iDeadlineNotifier = new QSocketNotifier(iDeadlineFd, QSocketNotifier::Read, this);
+        connect(iDeadlineNotifier, SIGNAL(activated(int)), this, SLOT(onDeadlineExpired()));
+
+        iClockFd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (iClockFd >= 0)
+        {
+            iClockNotifier = new QSocketNotifier(iClockFd, QSocketNotifier::Read, this);
+            connect(iClockNotifier, SIGNAL(activated(int)), this, SLOT(onClockSet()));
+            watchClock();
+        } // no else
+    }
+    else
+    {
+        LOG_WARNING("timerfd not available:" << strerror(errno));
+    }
+}
+
+DeadlineTimer::~DeadlineTimer()
+{
+    FUNCTION_CALL_TRACE;
+
+    delete iDeadlineNotifier;
+    iDeadlineNotifier = 0;
+    delete iClockNotifier;
+    iClockNotifier = 0;
+
+    if (iDeadlineFd >= 0)
+    {
+        close(iDeadlineFd);
+        iDeadlineFd = -1;
+    } // no else
+    if (iClockFd >= 0)
+    {
+        close(iClockFd);
+        iClockFd = -1;
+    } // no else
+}
+
+qint64 DeadlineTimer::deadlineFor(const QDateTime &aWallTime) const
+{
+    qint64 wait = wallNow().msecsTo(aWallTime);
+    return now() + (wait > 0 ? wait : 0);
+}
+
+void DeadlineTimer::start(qint64 aDeadline)
+{
+    FUNCTION_CALL_TRACE;
+
+    const qint64 currentTime = now();
+    iDeadline = aDeadline;
+    iWallOffset = wallOffset(currentTime);
+    arm(currentTime);
+}
+
+void DeadlineTimer::startAt(const QDateTime &aWallTime)
+{
+    start(deadlineFor(aWallTime));
+}
+
+void DeadlineTimer::stop()
+{
+    iTimer.stop();
+    if (iDeadlineFd >= 0)
+    {
+        struct itimerspec spec;
+        memset(&spec, 0, sizeof(spec));
+        timerfd_settime(iDeadlineFd, 0, &spec, 0);
+    } // no else
+    iDeadline = -1;
+}
+
+bool DeadlineTimer::isActive() const
+{
+    return iDeadline >= 0;
+}
+
+qint64 DeadlineTimer::deadline() const
+{
+    return iDeadline;
+}
+
+qint64 DeadlineTimer::remaining() const
+{
+    if (!isActive())
+    {
+        return -1;
+    } // no else
+
+    qint64 left = iDeadline - now();
+    return left > 0 ? left : 0;
+}
+
+qint64 DeadlineTimer::bootTime()
+{
+    qint64 time = -1;
+#ifdef CLOCK_BOOTTIME
+    time = clockTime(CLOCK_BOOTTIME);
+#endif
+    if (time < 0)
+    {
+        time = clockTime(CLOCK_MONOTONIC);
+    } // no else
+
+    return time;
+}
+
+qint64 DeadlineTimer::now() const
+{
+    return bootTime();
+}
+
+QDateTime DeadlineTimer::wallNow() const
+{
+    return QDateTime::currentDateTime();
+}
+
+void DeadlineTimer::check()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (!isActive())
+    {
+        return;
+    } // no else
+
+    const qint64 currentTime = now();
+    const qint64 offset = wallOffset(currentTime);
+    const qint64 jump = offset - iWallOffset;
+    iWallOffset = offset;
+    if (jump > CLOCK_JUMP_TOLERANCE_MS || jump < -CLOCK_JUMP_TOLERANCE_MS)
+    {
+        LOG_DEBUG("Wall clock changed by" << jump << "ms");
+        emit clockChanged(jump);
+    } // no else
+
+    if (currentTime >= iDeadline)
+    {
+        stop();
+        emit timeout();
+    }
+    else
+    {
+        arm(currentTime);
+    }
+}
+
+void DeadlineTimer::onDeadlineExpired()
+{
+    FUNCTION_CALL_TRACE;
+
+    quint64 expirations = 0;
+    if (read(iDeadlineFd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN)
+    {
+        LOG_WARNING("Failed to read deadline timer:" << strerror(errno));
+    } // no else
+
+    check();
+}
+
+void DeadlineTimer::onClockSet()
+{
+    FUNCTION_CALL_TRACE;
+
+    // Reading a cancelled timer fails with ECANCELED, it must be armed
+    // again to notice the next change.
+    quint64 expirations = 0;
+    if (read(iClockFd, &expirations, sizeof(expirations)) < 0 && errno == ECANCELED)
+    {
+        LOG_DEBUG("Wall clock was set");
+    } // no else
+
+    watchClock();
+    check();
+}
+
+void DeadlineTimer::arm(qint64 aNow)
+{
+    qint64 wait = iDeadline - aNow;
+    if (wait < 0)
+    {
+        wait = 0;
+    } // no else
+
+    if (iDeadlineFd >= 0)
+    {
+        // An expiry of zero would disarm the timer.
+        const qint64 expiry = qMax(clockTime(static_cast<clockid_t>(iClockId)) + wait,
+                                   static_cast<qint64>(1));
+        struct itimerspec spec;
+        memset(&spec, 0, sizeof(spec));
+        spec.it_value.tv_sec = expiry / 1000;
+        spec.it_value.tv_nsec = (expiry % 1000) * 1000000;
+        if (timerfd_settime(iDeadlineFd, TFD_TIMER_ABSTIME, &spec, 0) == 0)
+        {
+            return;
+        } // no else
+        LOG_WARNING("Failed to arm deadline timer:" << strerror(errno));
+    } // no else
+
+    if (wait > MAX_SLICE_MS)
+    {
+        wait = MAX_SLICE_MS;
+    } // no else
+
+    iTimer.start(static_cast<int>(wait));
+}
+
+void DeadlineTimer::watchClock()
+{
+    // Armed far in the future, it only ever fires by being cancelled.
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = 0x7fffffff;
+    if (timerfd_settime(iClockFd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET,
+                        &spec, 0) != 0)
+    {
+        LOG_WARNING("Failed to watch the wall clock:" << strerror(errno));
+    } // no else
+}
+
+qint64 DeadlineTimer::wallOffset(qint64 aNow) const
+{
+    // Local wall time read as UTC, so that time zone changes count as well
+    QDateTime wall = wallNow();
+    wall.setTimeSpec(Qt::UTC);
+    return wall.toMSecsSinceEpoch() - aNow;
+}
@@ -0,0 +1,187 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef DEADLINETIMER_H
+#define DEADLINETIMER_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QTimer>
+
+class QSocketNotifier;
+
+namespace Buteo {
+
+class DeadlineTimerTest;
+
+/*! \brief Timer firing at a deadline on the monotonic boot clock.
+ *
+ * Deadlines are measured with CLOCK_BOOTTIME, which keeps running while the
+ * device is suspended and is not affected by changes of the wall clock,
+ * like NTP corrections or time zone changes. Wall clock times are converted
+ * to a deadline once, when the timer is started, so a later clock change
+ * neither fires the timer early nor delays it.
+ *
+ * The deadline is armed as an absolute expiry of a CLOCK_BOOTTIME timerfd,
+ * so the daemon does not wake up before it and a deadline which passed
+ * during suspend fires right after resume. Changes of the wall clock are
+ * noticed through a CLOCK_REALTIME timerfd that is cancelled when the clock
+ * is set. Time zone changes are noticed when the deadline is reached.
+ *
+ * On systems without timerfd, the timer falls back to sleeping in slices
+ * of at most a minute.
+ */
+class DeadlineTimer : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /*! \brief Constructor
+     *
+     * @param aParent Parent object
+     */
+    explicit DeadlineTimer(QObject *aParent = 0);
+
+    //! \brief Destructor
+    virtual ~DeadlineTimer();
+
+    /*! \brief Returns the deadline corresponding to a wall clock time
+     *
+     * @param aWallTime Wall clock time. Times in the past give the current
+     *  time as the deadline.
+     * @return Deadline in milliseconds of the boot clock
+     */
+    qint64 deadlineFor(const QDateTime &aWallTime) const;
+
+    /*! \brief Starts the timer, replacing an earlier deadline
+     *
+     * @param aDeadline Deadline in milliseconds of the boot clock
+     */
+    void start(qint64 aDeadline);
+
+    /*! \brief Starts the timer to fire at a wall clock time
+     *
+     * @param aWallTime Wall clock time
+     */
+    void startAt(const QDateTime &aWallTime);
+
+    //! \brief Stops the timer
+    void stop();
+
+    /*! \brief Checks if the timer is running
+     *
+     * @return True if running
+     */
+    bool isActive() const;
+
+    /*! \brief Returns the deadline of the timer
+     *
+     * @return Deadline in milliseconds of the boot clock, or -1 if the
+     *  timer is not running
+     */
+    qint64 deadline() const;
+
+    /*! \brief Returns the time left until the deadline
+     *
+     * @return Milliseconds, or -1 if the timer is not running
+     */
+    qint64 remaining() const;
+
+    /*! \brief Returns the current time of the boot clock
+     *
+     * Falls back to CLOCK_MONOTONIC on systems without CLOCK_BOOTTIME.
+     * @return Milliseconds since boot
+     */
+    static qint64 bootTime();
+
+signals:
+
+    //! \brief Emitted when the deadline is reached
+    void timeout();
+
+    /*! \brief Emitted when the wall clock has been changed
+     *
+     * The running deadline is not affected.
+     * @param aJumpMsecs Amount the wall clock moved, negative if backwards
+     */
+    void clockChanged(qint64 aJumpMsecs);
+
+protected:
+
+    /*! \brief Returns the current time of the boot clock in milliseconds
+     *
+     * @return Current time
+     */
+    virtual qint64 now() const;
+
+    /*! \brief Returns the current wall clock time
+     *
+     * @return Current time
+     */
+    virtual QDateTime wallNow() const;
+
+private slots:
+
+    void check();
+
+    void onDeadlineExpired();
+
+    void onClockSet();
+
+private:
+
+    void arm(qint64 aNow);
+
+    void watchClock();
+
+    qint64 wallOffset(qint64 aNow) const;
+
+    //! Fallback timer when timerfd is not available
+    QTimer iTimer;
+
+    qint64 iDeadline;
+
+    //! Wall clock minus boot clock when last checked
+    qint64 iWallOffset;
+
+    //! Clock of iDeadlineFd, clockid_t
+    int iClockId;
+
+    //! timerfd armed at the deadline
+    int iDeadlineFd;
+
+    //! timerfd cancelled when the wall clock is set
+    int iClockFd;
+
+    QSocketNotifier *iDeadlineNotifier;
+
+    QSocketNotifier *iClockNotifier;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class DeadlineTimerTest;
+#endif
+};
+
+}
+
+#endif // DEADLINETIMER_H
@@ -0,0 +1,209 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "IdleExit.h"
+#include "SyncCommonDefs.h"
+#include "ProfileEngineDefs.h"
+#include "LogMacros.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QStringList>
+#include <QTextStream>
+#include <QtXml/QDomDocument>
+
+using namespace Buteo;
+
+static const QString STATE_FILE("idlestate.xml");
+static const QString TAG_STATE("idlestate");
+static const QString TAG_SYNC("sync");
+static const QString ATTR_PROFILE("profile");
+static const QString ATTR_TIME("time");
+
+static const QString WAKEUP_COMMAND("systemd-run");
+static const QString WAKEUP_PING("/usr/bin/dbus-send");
+
+IdleExit::IdleExit(const QString &aStatePath, QObject *aParent)
+:   QObject(aParent),
+    iStatePath(aStatePath),
+    iEnabled(false)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iStatePath.isEmpty())
+    {
+        iStatePath = Sync::syncCacheDir() + QDir::separator() + STATE_FILE;
+    } // no else
+
+    iTimer.setSingleShot(true);
+    iTimer.setInterval(IDLE_TIMEOUT_MINUTES * 60 * 1000);
+    connect(&iTimer, SIGNAL(timeout()), this, SIGNAL(idle()));
+}
+
+IdleExit::~IdleExit()
+{
+    FUNCTION_CALL_TRACE;
+}
+
+void IdleExit::setEnabled(bool aEnabled)
+{
+    FUNCTION_CALL_TRACE;
+
+    iEnabled = aEnabled;
+    if (!iEnabled)
+    {
+        iTimer.stop();
+    } // no else
+}
+
+bool IdleExit::isEnabled() const
+{
+    return iEnabled;
+}
+
+void IdleExit::reset()
+{
+    if (iEnabled)
+    {
+        iTimer.start();
+    } // no else
+}
+
+bool IdleExit::suspend(const QMap<QString, QDateTime> &aSyncTimes,
+                       const QDateTime &aWakeup)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (!saveState(aSyncTimes))
+    {
+        return false;
+    } // no else
+
+    if (aWakeup.isValid() && !registerWakeup(aWakeup))
+    {
+        LOG_WARNING("Could not register wakeup at" << aWakeup << ", staying up");
+        QFile::remove(iStatePath);
+        return false;
+    } // no else
+
+    LOG_DEBUG("Suspended until" << aWakeup);
+    return true;
+}
+
+QMap<QString, QDateTime> IdleExit::takeState()
+{
+    FUNCTION_CALL_TRACE;
+
+    QMap<QString, QDateTime> syncTimes;
+    QFile file(iStatePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return syncTimes;
+    } // no else
+
+    QDomDocument doc;
+    if (doc.setContent(&file))
+    {
+        QDomElement sync = doc.documentElement().firstChildElement(TAG_SYNC);
+        for (; !sync.isNull(); sync = sync.nextSiblingElement(TAG_SYNC))
+        {
+            QDateTime time = QDateTime::fromString(sync.attribute(ATTR_TIME),
+                                                   Qt::ISODate);
+            time.setTimeSpec(Qt::UTC);
+            QString profileName = sync.attribute(ATTR_PROFILE);
+            if (!profileName.isEmpty() && time.isValid())
+            {
+                syncTimes.insert(profileName, time.toLocalTime());
+            } // no else
+        }
+    }
+    else
+    {
+        LOG_WARNING("Invalid idle state in" << iStatePath);
+    }
+
+    file.close();
+    file.remove();
+
+    return syncTimes;
+}
+
+bool IdleExit::registerWakeup(const QDateTime &aWakeup)
+{
+    FUNCTION_CALL_TRACE;
+
+    // The timer pings the msyncd service, which gets activated by D-Bus.
+    QStringList args;
+    args << "--user"
+         << QString("--unit=%1").arg(wakeupUnit(aWakeup))
+         << QString("--on-calendar=%1").arg(
+                aWakeup.toLocalTime().toString("yyyy-MM-dd hh:mm:ss"))
+         << "--timer-property=AccuracySec=1s"
+         << WAKEUP_PING << "--session" << "--type=method_call"
+         << "--dest=com.meego.msyncd" << "/synchronizer"
+         << "org.freedesktop.DBus.Peer.Ping";
+
+    return QProcess::execute(WAKEUP_COMMAND, args) == 0;
+}
+
+QString IdleExit::wakeupUnit(const QDateTime &aWakeup)
+{
+    // Transient unit names must be unique while the unit is loaded, and a
+    // timer for the same time may still be loaded from an earlier exit.
+    static int registrations = 0;
+    return QString("msyncd-wakeup-%1-%2-%3").arg(aWakeup.toTime_t())
+           .arg(QCoreApplication::applicationPid()).arg(++registrations);
+}
+
+bool IdleExit::saveState(const QMap<QString, QDateTime> &aSyncTimes)
+{
+    FUNCTION_CALL_TRACE;
+
+    QDomDocument doc;
+    QDomElement root = doc.createElement(TAG_STATE);
+    doc.appendChild(root);
+
+    QMapIterator<QString, QDateTime> i(aSyncTimes);
+    while (i.hasNext())
+    {
+        i.next();
+        QDomElement sync = doc.createElement(TAG_SYNC);
+        sync.setAttribute(ATTR_PROFILE, i.key());
+        sync.setAttribute(ATTR_TIME, i.value().toUTC().toString(Qt::ISODate));
+        root.appendChild(sync);
+    }
+
+    QDir().mkpath(QFileInfo(iStatePath).absolutePath());
+    QFile file(iStatePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        LOG_WARNING("Could not write idle state to" << iStatePath);
+        return false;
+    } // no else
+
+    QTextStream stream(&file);
+    stream << doc.toString(PROFILE_INDENT);
+    return true;
+}
@@ -0,0 +1,141 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef IDLEEXIT_H
+#define IDLEEXIT_H
+
+#include <QObject>
+#include <QMap>
+#include <QString>
+#include <QDateTime>
+#include <QTimer>
+
+namespace Buteo {
+
+class IdleExitTest;
+
+/*! \brief Lets msyncd exit while it has nothing to do.
+ *
+ * When enabled, idle() is emitted IDLE_TIMEOUT_MINUTES after the last
+ * reset(). The synchronizer then checks that no sessions, servers or
+ * imminent scheduled syncs remain, and calls suspend(), which persists the
+ * scheduled sync times and registers the next wakeup with an external timer.
+ * The timer activates msyncd again over D-Bus, and the synchronizer picks up
+ * the persisted schedule with takeState().
+ *
+ * The default wakeup timer is a transient systemd user timer that pings the
+ * msyncd D-Bus service. A wakeup that cannot be registered keeps msyncd
+ * running.
+ */
+class IdleExit : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    //! Time without activity before idle() is emitted, in minutes
+    static const int IDLE_TIMEOUT_MINUTES = 5;
+
+    //! msyncd stays running if a sync is due within this many minutes
+    static const int MIN_SLEEP_MINUTES = 10;
+
+    /*! \brief Constructor
+     *
+     * @param aStatePath Path of the persisted state, empty for the default
+     *  path in the sync cache directory
+     * @param aParent Parent object
+     */
+    explicit IdleExit(const QString &aStatePath = QString(),
+                      QObject *aParent = 0);
+
+    //! \brief Destructor
+    virtual ~IdleExit();
+
+    /*! \brief Enables or disables idle exit
+     *
+     * @param aEnabled True to enable
+     */
+    void setEnabled(bool aEnabled);
+
+    /*! \brief Checks if idle exit is enabled
+     *
+     * @return True if enabled
+     */
+    bool isEnabled() const;
+
+    /*! \brief Restarts the idle timeout
+     *
+     * Should be called when activity ends. Has no effect if idle exit is
+     * disabled.
+     */
+    void reset();
+
+    /*! \brief Persists the schedule and registers the next wakeup
+     *
+     * @param aSyncTimes Next sync times, by profile name
+     * @param aWakeup Time to wake up at, invalid if no wakeup is needed
+     * @return True if msyncd can exit now
+     */
+    bool suspend(const QMap<QString, QDateTime> &aSyncTimes,
+                 const QDateTime &aWakeup);
+
+    /*! \brief Reads and removes the persisted schedule
+     *
+     * @return Next sync times, by profile name. Empty if msyncd did not exit
+     *  because of idleness.
+     */
+    QMap<QString, QDateTime> takeState();
+
+signals:
+
+    //! \brief Emitted when there has been no activity for the idle timeout
+    void idle();
+
+protected:
+
+    /*! \brief Registers a wakeup with the external timer
+     *
+     * @param aWakeup Time to wake up at
+     * @return True on success
+     */
+    virtual bool registerWakeup(const QDateTime &aWakeup);
+
+private:
+
+    bool saveState(const QMap<QString, QDateTime> &aSyncTimes);
+
+    static QString wakeupUnit(const QDateTime &aWakeup);
+
+    QString iStatePath;
+
+    bool iEnabled;
+
+    QTimer iTimer;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class IdleExitTest;
+#endif
+};
+
+}
+
+#endif // IDLEEXIT_H
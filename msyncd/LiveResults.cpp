@@ -0,0 +1,160 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "LiveResults.h"
+#include "LogMacros.h"
+
+using namespace Buteo;
+
+static ItemCounts sum(const ItemCounts &aLhs, const ItemCounts &aRhs)
+{
+    return ItemCounts(aLhs.added + aRhs.added, aLhs.deleted + aRhs.deleted,
+                      aLhs.modified + aRhs.modified);
+}
+
+LiveResults::LiveResults()
+{
+    FUNCTION_CALL_TRACE;
+}
+
+LiveResults::~LiveResults()
+{
+    FUNCTION_CALL_TRACE;
+}
+
+void LiveResults::begin(const QString &aProfileName, bool aScheduled)
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+    if (!iSessions.contains(aProfileName))
+    {
+        QDateTime now = QDateTime::currentDateTime();
+        now.setTime(QTime(now.time().hour(), now.time().minute(),
+                          now.time().second()));
+        iSessions[aProfileName].iStartTime = now;
+        iSessions[aProfileName].iScheduled = aScheduled;
+    } // no else
+}
+
+bool LiveResults::add(const QString &aProfileName, const TargetResults &aDelta)
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+    if (!iSessions.contains(aProfileName))
+    {
+        LOG_DEBUG("No running session for reported results of" << aProfileName);
+        return false;
+    } // no else
+
+    QMap<QString, TargetResults> &targets = iSessions[aProfileName].iTargets;
+    const QString target = aDelta.targetName();
+    QMap<QString, TargetResults>::iterator old = targets.find(target);
+    if (old != targets.end())
+    {
+        *old = TargetResults(target,
+                             sum(old->localItems(), aDelta.localItems()),
+                             sum(old->remoteItems(), aDelta.remoteItems()));
+    }
+    else
+    {
+        targets.insert(target, aDelta);
+    }
+    iDirty.insert(aProfileName);
+
+    return true;
+}
+
+bool LiveResults::contains(const QString &aProfileName) const
+{
+    QMutexLocker locker(&iMutex);
+    return iSessions.contains(aProfileName);
+}
+
+QStringList LiveResults::takeDirty()
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+    QStringList dirty = iDirty.toList();
+    iDirty.clear();
+    return dirty;
+}
+
+SyncResults LiveResults::snapshot(const QString &aProfileName) const
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+    if (!iSessions.contains(aProfileName))
+    {
+        return SyncResults();
+    } // no else
+
+    const Session &session = iSessions[aProfileName];
+    SyncResults results(session.iStartTime, SyncResults::SYNC_RESULT_INVALID,
+                        SyncResults::NO_ERROR);
+    results.setScheduled(session.iScheduled);
+    addTargets(session, results);
+    return results;
+}
+
+QDateTime LiveResults::startTime(const QString &aProfileName) const
+{
+    QMutexLocker locker(&iMutex);
+    return iSessions.value(aProfileName).iStartTime;
+}
+
+SyncResults LiveResults::finish(const QString &aProfileName,
+                                const SyncResults &aFinalResults)
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+    SyncResults results(aFinalResults);
+    iDirty.remove(aProfileName);
+    if (iSessions.contains(aProfileName))
+    {
+        Session session = iSessions.take(aProfileName);
+        if (results.targetResults().isEmpty())
+        {
+            addTargets(session, results);
+        } // no else
+    } // no else
+
+    return results;
+}
+
+int LiveResults::count() const
+{
+    QMutexLocker locker(&iMutex);
+    return iSessions.count();
+}
+
+void LiveResults::addTargets(const Session &aSession, SyncResults &aResults) const
+{
+    foreach (const TargetResults &target, aSession.iTargets)
+    {
+        aResults.addTargetResults(target);
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef LIVERESULTS_H
+#define LIVERESULTS_H
+
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QMap>
+#include <QSet>
+#include <QMutex>
+#include "SyncResults.h"
+
+namespace Buteo {
+
+class LiveResultsTest;
+
+/*! \brief Results of running sync sessions, as reported by plug-ins.
+ *
+ * Client plug-ins may report the items processed in each target while the
+ * session is running. The reports are summed up per target, so that the
+ * results can be saved to the sync log at checkpoints during the session
+ * instead of only at its end. Reports arrive from plug-in threads, so all
+ * functions of this class are thread safe.
+ */
+class LiveResults
+{
+public:
+
+    //! \brief Constructor
+    LiveResults();
+
+    //! \brief Destructor
+    ~LiveResults();
+
+    /*! \brief Starts collecting results of a session
+     *
+     * If results of the profile are already being collected, they are
+     * kept.
+     * @param aProfileName Name of the profile being synchronized
+     * @param aScheduled True if the session is a scheduled sync
+     */
+    void begin(const QString &aProfileName, bool aScheduled = false);
+
+    /*! \brief Adds reported item counts to a running session
+     *
+     * @param aProfileName Name of the profile being synchronized
+     * @param aDelta Counts processed since the previous report
+     * @return True if a session of the profile is running
+     */
+    bool add(const QString &aProfileName, const TargetResults &aDelta);
+
+    /*! \brief Checks if results of a session are being collected
+     *
+     * @param aProfileName Name of the profile
+     * @return True if begin has been called without finish
+     */
+    bool contains(const QString &aProfileName) const;
+
+    /*! \brief Returns the sessions that got reports since the last call
+     *
+     * @return Profile names
+     */
+    QStringList takeDirty();
+
+    /*! \brief Returns the results of a running session collected so far
+     *
+     * The results have major code SYNC_RESULT_INVALID, which marks them
+     * as a checkpoint of an unfinished session, and are marked scheduled
+     * if the session is.
+     * @param aProfileName Name of the profile
+     * @return Results, or empty results if no session is running
+     */
+    SyncResults snapshot(const QString &aProfileName) const;
+
+    /*! \brief Returns the time the session was started
+     *
+     * The time is truncated to seconds, the precision stored in the sync
+     * log, so that checkpoints read back from the log can be matched.
+     * @param aProfileName Name of the profile
+     * @return Start time, or invalid time if no session is running
+     */
+    QDateTime startTime(const QString &aProfileName) const;
+
+    /*! \brief Stops collecting results of a session
+     *
+     * If the plug-in did not return any target results at the end of the
+     * session, the reported ones are added to the final results.
+     * @param aProfileName Name of the profile
+     * @param aFinalResults Results returned by the plug-in
+     * @return Final results of the session
+     */
+    SyncResults finish(const QString &aProfileName,
+                       const SyncResults &aFinalResults);
+
+    /*! \brief Returns the number of sessions being collected
+     *
+     * @return Session count
+     */
+    int count() const;
+
+private:
+
+    struct Session
+    {
+        Session() : iScheduled(false) { }
+
+        QDateTime iStartTime;
+
+        bool iScheduled;
+
+        QMap<QString, TargetResults> iTargets;
+    };
+
+    void addTargets(const Session &aSession, SyncResults &aResults) const;
+
+    QMap<QString, Session> iSessions;
+
+    QSet<QString> iDirty;
+
+    mutable QMutex iMutex;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class LiveResultsTest;
+#endif
+};
+
+}
+
+#endif // LIVERESULTS_H
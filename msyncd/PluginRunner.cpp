@@ -22,6 +22,7 @@
  */
 
 #include "PluginRunner.h"
+#include "SyncEventChannel.h"
 #include "LogMacros.h"
 
 using namespace Buteo;
@@ -33,7 +34,9 @@ PluginRunner::PluginRunner(PluginType aPluginType, const QString &aPluginName,
     iPluginMgr(aPluginMgr),
     iPluginCbIf(aPluginCbIf),
     iType(aPluginType),
-    iPluginName(aPluginName)
+    iPluginName(aPluginName),
+    iEventChannel(0),
+    iProfileAtom(SyncEventAtoms::NONE)
 {
     FUNCTION_CALL_TRACE;
 
@@ -60,5 +63,33 @@ QString PluginRunner::pluginName() const
     return iPluginName;
 }
 
+bool PluginRunner::yield()
+{
+    FUNCTION_CALL_TRACE;
 
+    return false;
+}
 
+SyncResults PluginRunner::sessionResults(const QString &/*aSessionId*/)
+{
+    FUNCTION_CALL_TRACE;
+
+    return syncResults();
+}
+
+void PluginRunner::abortSession(const QString &/*aSessionId*/,
+                                Sync::SyncStatus aStatus)
+{
+    FUNCTION_CALL_TRACE;
+
+    abort(aStatus);
+}
+
+void PluginRunner::setEventChannel(SyncEventChannel *aChannel,
+    const QString &aProfileName)
+{
+    FUNCTION_CALL_TRACE;
+
+    iEventChannel = aChannel;
+    iProfileAtom = SyncEventAtoms::intern(aProfileName);
+}
@@ -34,6 +34,7 @@ namespace Buteo {
 
 class PluginManager;
 class PluginCbInterface;
+class SyncEventChannel;
     
 /*! \brief Base class for running sync plug-ins.
  *
@@ -94,6 +95,14 @@ public:
      */
     virtual void abort(Sync::SyncStatus aStatus = Sync::SYNC_ABORTED) = 0;
 
+    /*! \brief Asks the plug-in to checkpoint and yield its storages
+     *
+     * The default implementation does not support yielding.
+     * @see SyncPluginBase::requestYield
+     * @return True if the plug-in will yield
+     */
+    virtual bool yield();
+
     /*! \brief Gets the sync results from the plug-in.
      *
      * Should be called only after success or error signal is received from
@@ -102,6 +111,25 @@ public:
      */
     virtual SyncResults syncResults() = 0;
 
+    /*! \brief Gets the results of one peer session of the plug-in
+     *
+     * The default implementation returns syncResults().
+     * @see ServerPlugin::sessionResults
+     * @param aSessionId Session id
+     * @return Sync results
+     */
+    virtual SyncResults sessionResults(const QString &aSessionId);
+
+    /*! \brief Aborts one peer session of the plug-in
+     *
+     * The default implementation aborts the plug-in.
+     * @see ServerPlugin::abortSession
+     * @param aSessionId Session id
+     * @param aStatus Status to abort with
+     */
+    virtual void abortSession(const QString &aSessionId,
+                              Sync::SyncStatus aStatus = Sync::SYNC_ABORTED);
+
     
     /*! \brief Calls the cleanup for the plugin  
      *
@@ -127,6 +155,17 @@ public:
      */
     virtual SyncPluginBase *plugin() = 0;
 
+    /*! \brief Relays progress events through an event channel
+     *
+     * When a channel is set, transfer progress, progress detail and storage
+     * events from the plug-in are posted to the channel as compact events
+     * instead of being emitted as signals. The signals are still emitted if
+     * the channel is full.
+     * @param aChannel Event channel, NULL to use signals only
+     * @param aProfileName Name of the profile the events belong to
+     */
+    void setEventChannel(SyncEventChannel *aChannel, const QString &aProfileName);
+
 signals:
     //! @see SyncPluginBase::transferProgress
     void transferProgress(const QString &aProfileName,
@@ -154,6 +193,21 @@ signals:
     //! @see SyncPluginBase::newSession
     void newSession(const QString &aDestination);
 
+    //! @see ServerPlugin::newPeerSession
+    void newPeerSession(const QString &aDestination, const QString &aSessionId);
+
+    //! @see ServerPlugin::sessionTransferProgress
+    void sessionTransferProgress(const QString &aSessionId,
+        Sync::TransferDatabase aDatabase, Sync::TransferType aType,
+        const QString &aMimeType, int aCommittedItems);
+
+    //! @see ServerPlugin::sessionError
+    void sessionError(const QString &aSessionId, const QString &aMessage,
+                      int aErrorCode);
+
+    //! @see ServerPlugin::sessionSuccess
+    void sessionSuccess(const QString &aSessionId, const QString &aMessage);
+
     //! @see SyncPluginBase::connectivityStateChanged
     void connectivityStateChanged(Sync::ConnectivityType aType, bool aState);
 
@@ -174,6 +228,12 @@ protected:
     //! name of the plugin
     QString iPluginName;
 
+    //! Channel for relaying progress events, not owned
+    SyncEventChannel *iEventChannel;
+
+    //! Interned name of the profile the events belong to
+    quint32 iProfileAtom;
+
 private:
 
 #ifdef SYNCFW_UNIT_TESTS
@@ -0,0 +1,182 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "PluginWatchdog.h"
+#include "SyncProfile.h"
+#include "ProfileEngineDefs.h"
+#include "LogMacros.h"
+
+using namespace Buteo;
+
+PluginWatchdog::PluginWatchdog(QObject *aParent)
+:   QObject(aParent),
+    iPhase(PHASE_IDLE),
+    iPhaseActivity(0),
+    iArmedActivity(0)
+{
+    FUNCTION_CALL_TRACE;
+
+    iDeadlines[PHASE_IDLE] = 0;
+    iDeadlines[PHASE_INIT] = DEFAULT_INIT_TIMEOUT;
+    iDeadlines[PHASE_SYNC] = DEFAULT_SYNC_TIMEOUT;
+    iDeadlines[PHASE_UNINIT] = DEFAULT_UNINIT_TIMEOUT;
+
+    iTimer.setSingleShot(true);
+    connect(&iTimer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+}
+
+PluginWatchdog::~PluginWatchdog()
+{
+    FUNCTION_CALL_TRACE;
+}
+
+void PluginWatchdog::configure(const SyncProfile &aProfile)
+{
+    FUNCTION_CALL_TRACE;
+
+    const Profile *client = aProfile.clientProfile();
+    if (client == 0)
+    {
+        return;
+    } // no else
+
+    const QString keys[] = { QString(), KEY_INIT_TIMEOUT, KEY_SYNC_TIMEOUT,
+                             KEY_UNINIT_TIMEOUT };
+    for (int phase = PHASE_INIT; phase <= PHASE_UNINIT; ++phase)
+    {
+        bool ok = false;
+        int seconds = client->key(keys[phase]).toInt(&ok);
+        if (ok && seconds >= 0)
+        {
+            setDeadline(static_cast<Phase>(phase), seconds);
+        } // no else
+    }
+}
+
+void PluginWatchdog::setDeadline(Phase aPhase, int aSeconds)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aPhase != PHASE_IDLE)
+    {
+        iDeadlines[aPhase] = qMax(0, aSeconds);
+    } // no else
+}
+
+int PluginWatchdog::deadline(Phase aPhase) const
+{
+    return iDeadlines[aPhase];
+}
+
+PluginWatchdog::Phase PluginWatchdog::phase() const
+{
+    return iPhase;
+}
+
+void PluginWatchdog::recordActivity()
+{
+    iActivity.ref();
+}
+
+QString PluginWatchdog::diagnostic(const QString &aPluginName) const
+{
+    FUNCTION_CALL_TRACE;
+
+    const int progress = iActivity.fetchAndAddOrdered(0) - iPhaseActivity;
+    return QString("Plug-in %1 hung in %2 phase: no completion in %3 s "
+                   "(deadline %4 s), %5 progress events in the phase")
+            .arg(aPluginName)
+            .arg(phaseName(iPhase))
+            .arg(iPhaseClock.isValid() ? iPhaseClock.elapsed() / 1000 : 0)
+            .arg(iDeadlines[iPhase])
+            .arg(progress);
+}
+
+QString PluginWatchdog::phaseName(Phase aPhase)
+{
+    switch (aPhase)
+    {
+        case PHASE_INIT:
+            return "init";
+        case PHASE_SYNC:
+            return "sync";
+        case PHASE_UNINIT:
+            return "uninit";
+        default:
+            return "idle";
+    }
+}
+
+void PluginWatchdog::enterPhase(int aPhase)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aPhase < PHASE_IDLE || aPhase > PHASE_UNINIT)
+    {
+        LOG_WARNING("Invalid plug-in phase" << aPhase);
+        return;
+    } // no else
+
+    iPhase = static_cast<Phase>(aPhase);
+    iPhaseClock.start();
+    iPhaseActivity = iActivity.fetchAndAddOrdered(0);
+    iArmedActivity = iPhaseActivity;
+
+    const int seconds = iDeadlines[iPhase];
+    if (iPhase == PHASE_IDLE || seconds == 0)
+    {
+        iTimer.stop();
+    }
+    else
+    {
+        LOG_DEBUG("Watching plug-in phase" << phaseName(iPhase) << "for" << seconds << "s");
+        iTimer.start(seconds * 1000);
+    }
+}
+
+void PluginWatchdog::stop()
+{
+    FUNCTION_CALL_TRACE;
+
+    enterPhase(PHASE_IDLE);
+}
+
+void PluginWatchdog::onTimeout()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iPhase == PHASE_IDLE)
+    {
+        return;
+    } // no else
+
+    // Progress during the last period keeps a syncing plug-in alive.
+    const int activity = iActivity.fetchAndAddOrdered(0);
+    if (iPhase == PHASE_SYNC && activity != iArmedActivity)
+    {
+        iArmedActivity = activity;
+        iTimer.start(iDeadlines[iPhase] * 1000);
+        return;
+    } // no else
+
+    emit hung(iPhase);
+}
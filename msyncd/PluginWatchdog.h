@@ -0,0 +1,182 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef PLUGINWATCHDOG_H
+#define PLUGINWATCHDOG_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QString>
+
+namespace Buteo {
+
+class SyncProfile;
+class PluginWatchdogTest;
+
+/*! \brief Detects client plug-ins that hang.
+ *
+ * A client session goes through phases: initialization and start,
+ * synchronization, and finally returning results and uninitialization.
+ * Each phase has a deadline, which can be set in the client sub-profile
+ * with the keys init_timeout, sync_timeout and uninit_timeout, in seconds.
+ * If a phase is not left before its deadline, hung() is emitted and
+ * diagnostic() describes what the plug-in was doing. A sync can take any
+ * time as long as it makes progress, so the deadline of the sync phase is
+ * an inactivity timeout: it is restarted whenever progress was recorded.
+ */
+class PluginWatchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    //! Phases of a client session
+    enum Phase
+    {
+        //! Not watching
+        PHASE_IDLE,
+
+        //! Plug-in is initialized and sync is started
+        PHASE_INIT,
+
+        //! Plug-in is syncing
+        PHASE_SYNC,
+
+        //! Results are fetched and the plug-in is uninitialized
+        PHASE_UNINIT
+    };
+
+    //! Default deadline of the init phase in seconds
+    static const int DEFAULT_INIT_TIMEOUT = 120;
+
+    //! Default inactivity timeout of the sync phase in seconds
+    static const int DEFAULT_SYNC_TIMEOUT = 1800;
+
+    //! Default deadline of the uninit phase in seconds
+    static const int DEFAULT_UNINIT_TIMEOUT = 60;
+
+    /*! \brief Constructor
+     *
+     * @param aParent Parent object
+     */
+    explicit PluginWatchdog(QObject *aParent = 0);
+
+    //! \brief Destructor
+    virtual ~PluginWatchdog();
+
+    /*! \brief Reads the phase deadlines from a profile
+     *
+     * @param aProfile Sync profile with a client sub-profile
+     */
+    void configure(const SyncProfile &aProfile);
+
+    /*! \brief Sets the deadline of a phase
+     *
+     * @param aPhase Phase
+     * @param aSeconds Deadline in seconds, 0 for no deadline
+     */
+    void setDeadline(Phase aPhase, int aSeconds);
+
+    /*! \brief Returns the deadline of a phase
+     *
+     * @param aPhase Phase
+     * @return Deadline in seconds, 0 if there is no deadline
+     */
+    int deadline(Phase aPhase) const;
+
+    /*! \brief Returns the current phase
+     *
+     * @return Phase
+     */
+    Phase phase() const;
+
+    /*! \brief Records progress made by the plug-in
+     *
+     * Can be called from any thread. Progress restarts the deadline of
+     * the sync phase; in the other phases it is only reported in the
+     * diagnostic.
+     */
+    void recordActivity();
+
+    /*! \brief Describes the state of the watched plug-in
+     *
+     * @param aPluginName Name of the plug-in
+     * @return Diagnostic message
+     */
+    QString diagnostic(const QString &aPluginName) const;
+
+    /*! \brief Returns the name of a phase
+     *
+     * @param aPhase Phase
+     * @return Name
+     */
+    static QString phaseName(Phase aPhase);
+
+public slots:
+
+    /*! \brief Starts watching a phase
+     *
+     * @param aPhase Phase entered, PluginWatchdog::Phase
+     */
+    void enterPhase(int aPhase);
+
+    //! \brief Stops watching
+    void stop();
+
+signals:
+
+    /*! \brief Emitted when a phase has not finished before its deadline
+     *
+     * @param aPhase The phase, PluginWatchdog::Phase
+     */
+    void hung(int aPhase);
+
+private slots:
+
+    void onTimeout();
+
+private:
+
+    Phase iPhase;
+
+    int iDeadlines[PHASE_UNINIT + 1];
+
+    QTimer iTimer;
+
+    QElapsedTimer iPhaseClock;
+
+    mutable QAtomicInt iActivity;
+
+    int iPhaseActivity;
+
+    int iArmedActivity;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class PluginWatchdogTest;
+#endif
+};
+
+}
+
+#endif // PLUGINWATCHDOG_H
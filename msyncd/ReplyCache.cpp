@@ -0,0 +1,143 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "ReplyCache.h"
+#include "LogMacros.h"
+#include <QDir>
+
+using namespace Buteo;
+
+ReplyCache::ReplyCache(QObject *aParent)
+:   QObject(aParent),
+    iRevision(0)
+{
+    FUNCTION_CALL_TRACE;
+
+    iClock.start();
+    connect(&iWatcher, SIGNAL(directoryChanged(QString)),
+            this, SLOT(invalidate()));
+}
+
+ReplyCache::~ReplyCache()
+{
+    FUNCTION_CALL_TRACE;
+}
+
+void ReplyCache::watch(const QStringList &aPaths)
+{
+    FUNCTION_CALL_TRACE;
+
+    foreach (const QString &path, aPaths)
+    {
+        if (QDir(path).exists())
+        {
+            iWatcher.addPath(path);
+        } // no else
+    }
+}
+
+QString ReplyCache::key(const QString &aMethod, const QStringList &aArgs)
+{
+    // Arguments come from D-Bus strings, which cannot contain nul.
+    return (QStringList() << aMethod << aArgs).join(QString(QChar(0)));
+}
+
+int ReplyCache::revision() const
+{
+    return iRevision;
+}
+
+bool ReplyCache::lookup(const QString &aKey, QVariant &aReply) const
+{
+    FUNCTION_CALL_TRACE;
+
+    QHash<QString, QVariant>::const_iterator i = iReplies.constFind(aKey);
+    if (i == iReplies.constEnd())
+    {
+        return false;
+    } // no else
+
+    if (now() - iInsertTimes.value(aKey) > MAX_AGE_MS)
+    {
+        return false;
+    } // no else
+
+    aReply = i.value();
+    return true;
+}
+
+void ReplyCache::insert(const QString &aKey, const QVariant &aReply)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iReplies.size() >= MAX_REPLIES && !iReplies.contains(aKey))
+    {
+        LOG_DEBUG("Reply cache full, clearing");
+        iReplies.clear();
+        iInsertTimes.clear();
+    } // no else
+
+    iReplies.insert(aKey, aReply);
+    iInsertTimes.insert(aKey, now());
+}
+
+ExecutorTask *ReplyCache::runningQuery(const QString &aKey) const
+{
+    return iRunning.value(aKey, 0);
+}
+
+void ReplyCache::queryStarted(const QString &aKey, ExecutorTask *aTask)
+{
+    FUNCTION_CALL_TRACE;
+
+    iRunning.insert(aKey, aTask);
+}
+
+void ReplyCache::queryFinished(ExecutorTask *aTask, const QVariant &aReply)
+{
+    FUNCTION_CALL_TRACE;
+
+    QString key = iRunning.key(aTask);
+    if (key.isEmpty())
+    {
+        return;
+    } // no else
+
+    iRunning.remove(key);
+    insert(key, aReply);
+}
+
+void ReplyCache::invalidate()
+{
+    FUNCTION_CALL_TRACE;
+
+    iRevision++;
+    iReplies.clear();
+    iInsertTimes.clear();
+    iRunning.clear();
+    LOG_DEBUG("Profile store revision" << iRevision);
+}
+
+qint64 ReplyCache::now() const
+{
+    return iClock.elapsed();
+}
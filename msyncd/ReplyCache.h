@@ -0,0 +1,174 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef REPLYCACHE_H
+#define REPLYCACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+namespace Buteo {
+
+class ExecutorTask;
+class ReplyCacheTest;
+
+/*! \brief Caches replies of the read-only D-Bus queries of msyncd.
+ *
+ * UIs tend to call the same profile queries in bursts, typically after
+ * every profile change. This class keeps the reply of each query until the
+ * profile store changes, and tracks the queries that are being computed so
+ * identical calls arriving meanwhile can wait for the same result instead
+ * of starting another computation.
+ *
+ * Queries are identified by a key made of the method name and arguments.
+ * The store revision is bumped by invalidate(), which is called when
+ * msyncd changes a profile or its log, and when an entry is added to or
+ * removed from one of the watched profile directories by another process.
+ * Files rewritten in place by other processes do not touch the directory,
+ * so replies also expire MAX_AGE_MS after they were cached. Results of
+ * queries that were started before a change are not cached.
+ */
+class ReplyCache : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    //! Maximum number of cached replies
+    static const int MAX_REPLIES = 64;
+
+    //! Time in milliseconds a reply is kept
+    static const qint64 MAX_AGE_MS = 5000;
+
+    /*! \brief Constructor
+     *
+     * @param aParent Parent object
+     */
+    explicit ReplyCache(QObject *aParent = 0);
+
+    //! \brief Destructor
+    virtual ~ReplyCache();
+
+    /*! \brief Invalidates the cache when a directory changes on disk
+     *
+     * Directories that do not exist are ignored.
+     * @param aPaths Profile directories to watch
+     */
+    void watch(const QStringList &aPaths);
+
+    /*! \brief Makes the key of a query
+     *
+     * @param aMethod Method name
+     * @param aArgs Method arguments
+     * @return Query key
+     */
+    static QString key(const QString &aMethod,
+                       const QStringList &aArgs = QStringList());
+
+    /*! \brief Returns the revision of the profile store
+     *
+     * @return Revision, incremented on every invalidation
+     */
+    int revision() const;
+
+    /*! \brief Looks up a cached reply
+     *
+     * @param aKey Query key
+     * @param aReply Set to the cached reply, if found
+     * @return True if the reply was found
+     */
+    bool lookup(const QString &aKey, QVariant &aReply) const;
+
+    /*! \brief Caches the reply of a query computed in the current revision
+     *
+     * @param aKey Query key
+     * @param aReply Reply
+     */
+    void insert(const QString &aKey, const QVariant &aReply);
+
+    /*! \brief Returns the task computing a query
+     *
+     * @param aKey Query key
+     * @return Task started in the current revision, or null
+     */
+    ExecutorTask *runningQuery(const QString &aKey) const;
+
+    /*! \brief Records that a task has started computing a query
+     *
+     * @param aKey Query key
+     * @param aTask Task computing the reply
+     */
+    void queryStarted(const QString &aKey, ExecutorTask *aTask);
+
+    /*! \brief Records that a task has finished
+     *
+     * The reply is cached if the task was computing a query and the store
+     * has not changed since the task was started.
+     * @param aTask Finished task
+     * @param aReply Result of the task
+     */
+    void queryFinished(ExecutorTask *aTask, const QVariant &aReply);
+
+public slots:
+
+    /*! \brief Drops all cached replies and bumps the store revision
+     *
+     * Queries that are running are forgotten, so their results are not
+     * cached and new calls do not join them.
+     */
+    void invalidate();
+
+protected:
+
+    /*! \brief Returns monotonic time in milliseconds
+     *
+     * @return Current time
+     */
+    virtual qint64 now() const;
+
+private:
+
+    int iRevision;
+
+    QHash<QString, QVariant> iReplies;
+
+    QHash<QString, qint64> iInsertTimes;
+
+    QHash<QString, ExecutorTask*> iRunning;
+
+    QFileSystemWatcher iWatcher;
+
+    QElapsedTimer iClock;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class ReplyCacheTest;
+#endif
+};
+
+}
+
+#endif // REPLYCACHE_H
@@ -95,6 +95,18 @@ bool ServerPluginRunner::init()
     connect(iPlugin, SIGNAL(newSession(const QString &)),
         this, SLOT(onNewSession(const QString &)));
 
+    connect(iPlugin, SIGNAL(newPeerSession(const QString &, const QString &)),
+        this, SLOT(onNewPeerSession(const QString &, const QString &)));
+
+    connect(iPlugin, SIGNAL(sessionTransferProgress(const QString &, Sync::TransferDatabase, Sync::TransferType, const QString &,int)),
+        this, SIGNAL(sessionTransferProgress(const QString &, Sync::TransferDatabase, Sync::TransferType, const QString &,int)));
+
+    connect(iPlugin, SIGNAL(sessionError(const QString &, const QString &, int)),
+        this, SLOT(onSessionError(const QString &, const QString &, int)));
+
+    connect(iPlugin, SIGNAL(sessionSuccess(const QString &, const QString &)),
+        this, SLOT(onSessionSuccess(const QString &, const QString &)));
+
     // Connect signals from the plug-in.
 
     connect(iPlugin, SIGNAL(transferProgress(const QString &, Sync::TransferDatabase, Sync::TransferType, const QString &,int)),
@@ -206,6 +218,31 @@ SyncResults ServerPluginRunner::syncResults()
     }
 }
 
+SyncResults ServerPluginRunner::sessionResults(const QString &aSessionId)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iPlugin != 0)
+    {
+        return iPlugin->sessionResults(aSessionId);
+    }
+    else
+    {
+        return SyncResults();
+    }
+}
+
+void ServerPluginRunner::abortSession(const QString &aSessionId,
+                                      Sync::SyncStatus aStatus)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iPlugin != 0)
+    {
+        iPlugin->abortSession(aSessionId, aStatus);
+    }
+}
+
 bool ServerPluginRunner::cleanUp()
 {
     FUNCTION_CALL_TRACE;
@@ -230,6 +267,47 @@ void ServerPluginRunner::onNewSession(const QString &aDestination)
     emit newSession(aDestination);
 }
 
+void ServerPluginRunner::onNewPeerSession(const QString &aDestination,
+                                          const QString &aSessionId)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iSessionIds.contains(aSessionId) ||
+        iSessionIds.count() >= iPlugin->maxSessions())
+    {
+        LOG_WARNING("Rejecting peer session" << aSessionId << "from" <<
+                    aDestination << ", running sessions:" << iSessionIds.count());
+        iPlugin->abortSession(aSessionId, Sync::SYNC_ERROR);
+        return;
+    } // no else
+
+    iSessionIds.insert(aSessionId);
+    if (iServerActivator != 0)
+    {
+        iServerActivator->addRef(plugin()->getProfileName());
+    }
+
+    emit newPeerSession(aDestination, aSessionId);
+}
+
+void ServerPluginRunner::onSessionError(const QString &aSessionId,
+                                        const QString &aMessage, int aErrorCode)
+{
+    FUNCTION_CALL_TRACE;
+
+    iSessionIds.remove(aSessionId);
+    emit sessionError(aSessionId, aMessage, aErrorCode);
+}
+
+void ServerPluginRunner::onSessionSuccess(const QString &aSessionId,
+                                          const QString &aMessage)
+{
+    FUNCTION_CALL_TRACE;
+
+    iSessionIds.remove(aSessionId);
+    emit sessionSuccess(aSessionId, aMessage);
+}
+
 void ServerPluginRunner::onTransferProgress(const QString &aProfileName,
     Sync::TransferDatabase aDatabase, Sync::TransferType aType,
     const QString &aMimeType, int aCommittedItems)
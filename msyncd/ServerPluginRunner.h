@@ -25,6 +25,7 @@
 #define SERVERPLUGINRUNNER_H
 
 #include "PluginRunner.h"
+#include <QSet>
 
 namespace Buteo {
     
@@ -75,6 +76,13 @@ public:
     //! @see PluginRunner::syncResults
     virtual SyncResults syncResults();
 
+    //! @see PluginRunner::sessionResults
+    virtual SyncResults sessionResults(const QString &aSessionId);
+
+    //! @see PluginRunner::abortSession
+    virtual void abortSession(const QString &aSessionId,
+                              Sync::SyncStatus aStatus = Sync::SYNC_ABORTED);
+
     //! @see PluginRunner::plugin
     virtual SyncPluginBase *plugin();
     
@@ -93,6 +101,13 @@ private slots:
 
     void onNewSession(const QString &aDestination);
 
+    void onNewPeerSession(const QString &aDestination, const QString &aSessionId);
+
+    void onSessionError(const QString &aSessionId, const QString &aMessage,
+                        int aErrorCode);
+
+    void onSessionSuccess(const QString &aSessionId, const QString &aMessage);
+
     void onTransferProgress(const QString &aProfileName,
         Sync::TransferDatabase aDatabase, Sync::TransferType aType,
         const QString &aMimeType, int aCommittedItems);
@@ -117,6 +132,9 @@ private:
 
     ServerActivator *iServerActivator;
 
+    //! Ids of the running peer sessions
+    QSet<QString> iSessionIds;
+
 #ifdef SYNCFW_UNIT_TESTS
     friend class ServerPluginRunnerTest;
 #endif
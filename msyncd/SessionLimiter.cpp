@@ -0,0 +1,217 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "SessionLimiter.h"
+#include "SyncProfile.h"
+#include "ProfileEngineDefs.h"
+#include "LogMacros.h"
+
+#include <QUrl>
+
+using namespace Buteo;
+
+static const double MSECS_PER_HOUR = 60.0 * 60.0 * 1000.0;
+
+SessionLimiter::SessionLimiter()
+{
+    FUNCTION_CALL_TRACE;
+
+    iClock.start();
+}
+
+SessionLimiter::~SessionLimiter()
+{
+    FUNCTION_CALL_TRACE;
+}
+
+qint64 SessionLimiter::admit(const SyncProfile &aProfile)
+{
+    FUNCTION_CALL_TRACE;
+
+    const Profile *client = aProfile.clientProfile();
+    if (client == 0)
+    {
+        return 0;
+    } // no else
+
+    const QString plugin = client->name();
+    const QString host = remoteHost(aProfile);
+    const int maxSessions = intKey(aProfile, KEY_MAX_SESSIONS, 1);
+    const int maxPerHost = intKey(aProfile, KEY_MAX_SESSIONS_PER_HOST, 0);
+    const int rate = intKey(aProfile, KEY_RATE_LIMIT, 0);
+    const qint64 currentTime = now();
+
+    int pluginSessions = 0;
+    int hostSessions = 0;
+    foreach (const ActiveSession &session, iActive)
+    {
+        if (session.plugin == plugin)
+        {
+            ++pluginSessions;
+        } // no else
+        if (!host.isEmpty() && session.host == host)
+        {
+            ++hostSessions;
+        } // no else
+    }
+
+    qint64 wait = 0;
+    if ((maxSessions > 0 && pluginSessions >= maxSessions) ||
+        (maxPerHost > 0 && hostSessions >= maxPerHost))
+    {
+        LOG_DEBUG("Concurrency limit reached for" << aProfile.name()
+                  << "plugin:" << plugin << pluginSessions
+                  << "host:" << host << hostSessions);
+        wait = WAIT_FOR_SESSION;
+    }
+    else if (rate > 0)
+    {
+        const int burst = qMax(1, intKey(aProfile, KEY_RATE_LIMIT_BURST, 1));
+        if (!iBuckets.contains(plugin))
+        {
+            Bucket bucket;
+            bucket.tokens = burst;
+            bucket.lastRefill = currentTime;
+            iBuckets.insert(plugin, bucket);
+        } // no else
+
+        Bucket &bucket = iBuckets[plugin];
+        refill(bucket, rate, burst, currentTime);
+        if (bucket.tokens < 1.0)
+        {
+            wait = qMax<qint64>(1, qint64((1.0 - bucket.tokens) *
+                                          MSECS_PER_HOUR / rate + 0.5));
+            LOG_DEBUG("Rate limit reached for" << aProfile.name()
+                      << "plugin:" << plugin << "wait:" << wait << "ms");
+        } // no else
+    } // no else
+
+    if (wait != 0 && !iThrottledSince.contains(aProfile.name()))
+    {
+        iThrottledSince.insert(aProfile.name(), currentTime);
+    } // no else
+
+    return wait;
+}
+
+void SessionLimiter::sessionStarted(const SyncProfile &aProfile, bool aTakeToken)
+{
+    FUNCTION_CALL_TRACE;
+
+    const Profile *client = aProfile.clientProfile();
+    if (client == 0)
+    {
+        return;
+    } // no else
+
+    ActiveSession session;
+    session.plugin = client->name();
+    session.host = remoteHost(aProfile);
+    iActive.insert(aProfile.name(), session);
+
+    const qint64 currentTime = now();
+    if (aTakeToken && iBuckets.contains(session.plugin))
+    {
+        const int rate = intKey(aProfile, KEY_RATE_LIMIT, 0);
+        const int burst = qMax(1, intKey(aProfile, KEY_RATE_LIMIT_BURST, 1));
+        Bucket &bucket = iBuckets[session.plugin];
+        refill(bucket, rate, burst, currentTime);
+        bucket.tokens = qMax(0.0, bucket.tokens - 1.0);
+    } // no else
+
+    if (iThrottledSince.contains(aProfile.name()))
+    {
+        const qint64 waited = currentTime - iThrottledSince.take(aProfile.name());
+        ThrottleStats &stats = iStats[session.plugin];
+        ++stats.throttled;
+        stats.totalWait += waited;
+        stats.maxWait = qMax(stats.maxWait, waited);
+        LOG_DEBUG("Session" << aProfile.name() << "was throttled for" << waited
+                  << "ms, plugin" << session.plugin << "throttled sessions:"
+                  << stats.throttled << "total wait:" << stats.totalWait << "ms");
+    } // no else
+}
+
+void SessionLimiter::sessionFinished(const QString &aProfileName)
+{
+    FUNCTION_CALL_TRACE;
+
+    iActive.remove(aProfileName);
+}
+
+void SessionLimiter::sessionCancelled(const QString &aProfileName)
+{
+    FUNCTION_CALL_TRACE;
+
+    iThrottledSince.remove(aProfileName);
+}
+
+SessionLimiter::ThrottleStats SessionLimiter::stats(const QString &aPluginName) const
+{
+    return iStats.value(aPluginName);
+}
+
+qint64 SessionLimiter::now() const
+{
+    return iClock.elapsed();
+}
+
+QString SessionLimiter::remoteHost(const SyncProfile &aProfile)
+{
+    const Profile *client = aProfile.clientProfile();
+    QString host = client->key(KEY_REMOTE_HOST, aProfile.key(KEY_REMOTE_HOST));
+    if (host.isEmpty())
+    {
+        QString database = client->key(KEY_REMOTE_DATABASE,
+                                       aProfile.key(KEY_REMOTE_DATABASE));
+        host = QUrl(database).host();
+    } // no else
+    return host.toLower();
+}
+
+int SessionLimiter::intKey(const SyncProfile &aProfile, const QString &aKey,
+                           int aDefault)
+{
+    const Profile *client = aProfile.clientProfile();
+    bool ok = false;
+    int value = client->key(aKey).toInt(&ok);
+    if (!ok || value < 0)
+    {
+        value = aDefault;
+    } // no else
+    return value;
+}
+
+void SessionLimiter::refill(Bucket &aBucket, double aRatePerHour, int aBurst,
+                            qint64 aNow)
+{
+    if (aRatePerHour > 0 && aNow > aBucket.lastRefill)
+    {
+        aBucket.tokens = qMin<double>(aBurst, aBucket.tokens +
+            (aNow - aBucket.lastRefill) * aRatePerHour / MSECS_PER_HOUR);
+    }
+    else if (aRatePerHour <= 0)
+    {
+        aBucket.tokens = aBurst;
+    } // no else
+    aBucket.lastRefill = aNow;
+}
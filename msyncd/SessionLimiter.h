@@ -0,0 +1,165 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef SESSIONLIMITER_H
+#define SESSIONLIMITER_H
+
+#include <QHash>
+#include <QString>
+#include <QElapsedTimer>
+
+namespace Buteo {
+
+class SyncProfile;
+class SessionLimiterTest;
+
+/*! \brief Concurrency and rate limits for client sync sessions.
+ *
+ * The limits are declared in the client sub-profile of a sync profile:
+ * - max_sessions: sessions of the client plug-in that can run at the same
+ *   time, 1 by default, 0 for no limit.
+ * - max_sessions_per_host: sessions with the same remote host that can run
+ *   at the same time, 0 (no limit) by default. The remote host is given
+ *   with remote_host, or taken from the "Remote database" URL.
+ * - rate_limit and rate_limit_burst: a token bucket for session starts of
+ *   the client plug-in, refilled with rate_limit tokens per hour and
+ *   holding at most rate_limit_burst tokens.
+ *
+ * The limiter also keeps statistics of the time sessions had to wait
+ * because of the limits.
+ */
+class SessionLimiter
+{
+public:
+
+    //! Statistics of throttled session starts for one client plug-in
+    struct ThrottleStats
+    {
+        //! Number of sessions that had to wait
+        int throttled;
+
+        //! Total time the sessions waited, in milliseconds
+        qint64 totalWait;
+
+        //! Longest wait of a session, in milliseconds
+        qint64 maxWait;
+
+        ThrottleStats() : throttled(0), totalWait(0), maxWait(0) { }
+    };
+
+    //! Return value of admit() when a running session must finish first
+    static const qint64 WAIT_FOR_SESSION = -1;
+
+    //! \brief Constructor
+    SessionLimiter();
+
+    //! \brief Destructor
+    virtual ~SessionLimiter();
+
+    /*! \brief Checks if a session of the profile can be started now
+     *
+     * Does not reserve anything, call sessionStarted() when the session
+     * is started.
+     * @param aProfile Sync profile
+     * @return 0 if the session can be started, WAIT_FOR_SESSION if a
+     *  concurrency limit is reached, otherwise the time in milliseconds
+     *  until the rate limit allows the session
+     */
+    qint64 admit(const SyncProfile &aProfile);
+
+    /*! \brief Records the start of a session
+     *
+     * Takes a token from the rate limit bucket and updates the wait
+     * statistics if the session was throttled earlier. Sessions started
+     * by a remote device count against the concurrency limits only.
+     * @param aProfile Sync profile
+     * @param aTakeToken Should a token be taken from the rate limit bucket
+     */
+    void sessionStarted(const SyncProfile &aProfile, bool aTakeToken = true);
+
+    /*! \brief Records the end of a session
+     *
+     * Sessions that were not started are ignored.
+     * @param aProfileName Name of the sync profile
+     */
+    void sessionFinished(const QString &aProfileName);
+
+    /*! \brief Forgets a throttled session that will not be started
+     *
+     * @param aProfileName Name of the sync profile
+     */
+    void sessionCancelled(const QString &aProfileName);
+
+    /*! \brief Returns the wait statistics of a client plug-in
+     *
+     * @param aPluginName Name of the client plug-in
+     * @return Statistics
+     */
+    ThrottleStats stats(const QString &aPluginName) const;
+
+protected:
+
+    /*! \brief Returns monotonic time in milliseconds
+     *
+     * @return Current time
+     */
+    virtual qint64 now() const;
+
+private:
+
+    struct Bucket
+    {
+        double tokens;
+        qint64 lastRefill;
+    };
+
+    struct ActiveSession
+    {
+        QString plugin;
+        QString host;
+    };
+
+    static QString remoteHost(const SyncProfile &aProfile);
+
+    static int intKey(const SyncProfile &aProfile, const QString &aKey,
+                      int aDefault);
+
+    void refill(Bucket &aBucket, double aRatePerHour, int aBurst, qint64 aNow);
+
+    QHash<QString, ActiveSession> iActive;
+
+    QHash<QString, Bucket> iBuckets;
+
+    QHash<QString, qint64> iThrottledSince;
+
+    QHash<QString, ThrottleStats> iStats;
+
+    QElapsedTimer iClock;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class SessionLimiterTest;
+#endif
+};
+
+}
+
+#endif // SESSIONLIMITER_H
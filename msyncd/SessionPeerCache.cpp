@@ -0,0 +1,335 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "SessionPeerCache.h"
+#include "ProfileManager.h"
+#include "SyncProfile.h"
+#include "ProfileEngineDefs.h"
+#include "LogMacros.h"
+#include "BtHelper.h"
+
+#include <QtAlgorithms>
+
+using namespace Buteo;
+
+static const QString BT_PROFILE_TEMPLATE("bt_template");
+static const QString BT_PROPERTIES_NAME("Name");
+static const QString BT_PROPERTIES_CLASS("Class");
+static const QString DEFAULT_DEVICE_NAME("qtn_sync_dest_name_device_default");
+
+//! Major Device Class - Computer
+static const uint COMPUTER_CLASS = 0x100;
+
+// Visible and enabled profiles are preferred.
+static bool profilePreferred(SyncProfile *aLhs, SyncProfile *aRhs)
+{
+    if (aLhs->isHidden() != aRhs->isHidden())
+        return !aLhs->isHidden();
+    if (aLhs->isEnabled() != aRhs->isEnabled())
+        return aLhs->isEnabled();
+    return false;
+}
+
+SessionPeerCache::SessionPeerCache(ProfileManager &aProfileManager,
+                                   QObject *aParent)
+:   QObject(aParent),
+    iProfileManager(aProfileManager),
+    iPcTemplate(0),
+    iBtTemplate(0)
+{
+    FUNCTION_CALL_TRACE;
+}
+
+SessionPeerCache::~SessionPeerCache()
+{
+    FUNCTION_CALL_TRACE;
+
+    clearProfiles();
+    delete iPcTemplate;
+    iPcTemplate = 0;
+    delete iBtTemplate;
+    iBtTemplate = 0;
+}
+
+void SessionPeerCache::preload()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iPcTemplate == 0)
+    {
+        iPcTemplate = new SyncProfile(PC_SYNC);
+        iPcTemplate->setBoolKey(KEY_HIDDEN, true);
+        iPcTemplate->setKey(KEY_DISPLAY_NAME, PC_SYNC);
+    } // no else
+
+    if (iBtTemplate == 0)
+    {
+        iBtTemplate = iProfileManager.syncProfile(BT_PROFILE_TEMPLATE);
+        if (iBtTemplate == 0)
+        {
+            LOG_WARNING("Bluetooth template profile not found");
+        } // no else
+    } // no else
+
+    // Resolve the PC sync profile now, it is the one most sessions use.
+    storedProfile(PC_SYNC, PEER_PC);
+}
+
+SessionPeerCache::PeerClass SessionPeerCache::peerClass(const QString &aAddress)
+{
+    FUNCTION_CALL_TRACE;
+
+    return peer(aAddress).iClass;
+}
+
+QString SessionPeerCache::peerName(const QString &aAddress)
+{
+    FUNCTION_CALL_TRACE;
+
+    return peer(aAddress).iName;
+}
+
+SyncProfile *SessionPeerCache::sessionProfile(const QString &aAddress,
+                                              bool &aTemporary, bool &aSave)
+{
+    FUNCTION_CALL_TRACE;
+
+    aTemporary = false;
+    aSave = false;
+    Peer p = peer(aAddress);
+    QString key = (p.iClass == PEER_PC) ? PC_SYNC : aAddress;
+
+    SyncProfile *stored = storedProfile(key, p.iClass);
+    if (stored != 0)
+    {
+        return stored->clone();
+    } // no else
+
+    aTemporary = true;
+    return createProfile(aAddress, p, aSave);
+}
+
+void SessionPeerCache::invalidate(QString aProfileName, int aChangeType,
+                                  QString aProfileAsXml)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aChangeType == ProfileManager::PROFILE_LOGS_MODIFIED)
+    {
+        // Sync logs do not affect which profile is selected.
+        return;
+    } // no else
+
+    if (aProfileName == BT_PROFILE_TEMPLATE)
+    {
+        delete iBtTemplate;
+        iBtTemplate = 0;
+    } // no else
+
+    foreach (const QString &key, iProfiles.keys())
+    {
+        if (iProfiles.value(key)->name() == aProfileName)
+        {
+            dropProfile(key);
+        } // no else
+    }
+
+    if (aChangeType == ProfileManager::PROFILE_REMOVED)
+    {
+        return;
+    } // no else
+
+    // The profile may now be the preferred one for the peer it matches.
+    Profile *changed = aProfileAsXml.isEmpty() ? 0 :
+        iProfileManager.profileFromXml(aProfileAsXml);
+    if (changed == 0)
+    {
+        clearProfiles();
+        return;
+    } // no else
+
+    if (changed->key(KEY_DISPLAY_NAME) == PC_SYNC)
+    {
+        dropProfile(PC_SYNC);
+    } // no else
+
+    QString address = changed->key(KEY_BT_ADDRESS);
+    if (!address.isEmpty())
+    {
+        dropProfile(address);
+    } // no else
+    delete changed;
+}
+
+QMap<QString, QVariant> SessionPeerCache::deviceProperties(const QString &aAddress)
+{
+    FUNCTION_CALL_TRACE;
+
+    BtHelper btHelper(aAddress);
+    return btHelper.getDeviceProperties();
+}
+
+SessionPeerCache::Peer SessionPeerCache::peer(const QString &aAddress)
+{
+    FUNCTION_CALL_TRACE;
+
+    QHash<QString, Peer>::const_iterator i = iPeers.constFind(aAddress);
+    if (i != iPeers.constEnd())
+    {
+        return i.value();
+    } // no else
+
+    Peer p;
+    if (aAddress.contains("USB"))
+    {
+        p.iClass = PEER_PC;
+        p.iName = PC_SYNC;
+    }
+    else
+    {
+        QMap<QString, QVariant> properties = deviceProperties(aAddress);
+        if (!properties.contains(BT_PROPERTIES_CLASS))
+        {
+            // The lookup failed, try again for the next session.
+            LOG_WARNING("No Bluetooth properties for" << aAddress);
+            p.iClass = PEER_DEVICE;
+            return p;
+        } // no else
+
+        uint classType = properties.value(BT_PROPERTIES_CLASS).toUInt();
+        if (classType & COMPUTER_CLASS)
+        {
+            p.iClass = PEER_PC;
+            p.iName = PC_SYNC;
+        }
+        else
+        {
+            p.iClass = PEER_DEVICE;
+            p.iName = properties.value(BT_PROPERTIES_NAME).toString();
+        }
+    }
+
+    LOG_DEBUG("Classified peer" << aAddress << "as" << p.iClass);
+    iPeers.insert(aAddress, p);
+    return p;
+}
+
+SyncProfile *SessionPeerCache::storedProfile(const QString &aKey,
+                                             PeerClass aClass)
+{
+    FUNCTION_CALL_TRACE;
+
+    QHash<QString, SyncProfile*>::const_iterator i = iProfiles.constFind(aKey);
+    if (i != iProfiles.constEnd())
+    {
+        if (iProfileManager.lastModified(i.value()->name()) == iModified.value(aKey))
+        {
+            return i.value();
+        } // no else
+
+        LOG_DEBUG("Profile" << i.value()->name() << "was modified on disk");
+        dropProfile(aKey);
+    } // no else
+
+    QList<SyncProfile*> profiles;
+    if (aClass == PEER_PC)
+    {
+        profiles = iProfileManager.getSyncProfilesByData(
+                QString::null, QString::null, KEY_DISPLAY_NAME, PC_SYNC);
+    }
+    else
+    {
+        profiles = iProfileManager.getSyncProfilesByData(
+                QString::null, Profile::TYPE_SYNC, KEY_BT_ADDRESS, aKey);
+    }
+
+    SyncProfile *profile = 0;
+    if (!profiles.isEmpty())
+    {
+        qStableSort(profiles.begin(), profiles.end(), profilePreferred);
+        profile = profiles.takeFirst();
+        qDeleteAll(profiles);
+        LOG_DEBUG("Selected profile" << profile->name() << "for" << aKey);
+        iProfiles.insert(aKey, profile);
+        iModified.insert(aKey, iProfileManager.lastModified(profile->name()));
+    } // no else
+
+    return profile;
+}
+
+SyncProfile *SessionPeerCache::createProfile(const QString &aAddress,
+                                             const Peer &aPeer, bool &aSave)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iPcTemplate == 0 || iBtTemplate == 0)
+    {
+        preload();
+    } // no else
+
+    if (aPeer.iClass == PEER_PC)
+    {
+        // PC sync profiles are not saved.
+        return iPcTemplate->clone();
+    } // no else
+
+    if (iBtTemplate == 0)
+    {
+        return 0;
+    } // no else
+
+    QString displayName = aPeer.iName;
+    if (displayName.isEmpty())
+    {
+        displayName = DEFAULT_DEVICE_NAME;
+    } // no else
+
+    SyncProfile *profile = iBtTemplate->clone();
+    QStringList keys;
+    keys << aAddress << profile->name();
+    profile->setName(keys);
+    profile->setKey(KEY_DISPLAY_NAME, displayName);
+    profile->setEnabled(true);
+    profile->setBoolKey(KEY_HIDDEN, false);
+    profile->setKey(KEY_BT_ADDRESS, aAddress);
+    profile->setKey(KEY_BT_NAME, displayName);
+    aSave = true;
+
+    return profile;
+}
+
+void SessionPeerCache::dropProfile(const QString &aKey)
+{
+    FUNCTION_CALL_TRACE;
+
+    delete iProfiles.take(aKey);
+    iModified.remove(aKey);
+}
+
+void SessionPeerCache::clearProfiles()
+{
+    FUNCTION_CALL_TRACE;
+
+    qDeleteAll(iProfiles);
+    iProfiles.clear();
+    iModified.clear();
+}
@@ -0,0 +1,182 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef SESSIONPEERCACHE_H
+#define SESSIONPEERCACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QDateTime>
+#include <QMap>
+#include <QString>
+#include <QVariant>
+
+namespace Buteo {
+
+class ProfileManager;
+class SyncProfile;
+class SessionPeerCacheTest;
+
+/*! \brief Resolves the profile for an incoming server session quickly.
+ *
+ * A remote device that opens a USB or Bluetooth session waits on the wire
+ * while msyncd picks a profile for it. Resolving that profile from scratch
+ * needs a Bluetooth property lookup, a scan of all sync profiles and, for
+ * new devices, a load of the Bluetooth template profile.
+ *
+ * This class keeps the PC sync and Bluetooth template profiles preloaded,
+ * and caches the classification of each peer address and the profile that
+ * was selected for it, so a session for a known peer can start without any
+ * disk or D-Bus access. Cached profiles must be dropped with invalidate()
+ * whenever a profile changes; a cached profile whose file was modified on
+ * disk is also loaded again. Failed Bluetooth lookups and peers without a
+ * stored profile are not cached, so they are resolved again for the next
+ * session.
+ */
+class SessionPeerCache : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    //! Peer classes
+    enum PeerClass
+    {
+        //! Peer is a PC, synced with the PC sync profile
+        PEER_PC,
+
+        //! Peer is another device, synced with a Bluetooth profile
+        PEER_DEVICE
+    };
+
+    /*! \brief Constructor
+     *
+     * @param aProfileManager Profile manager to load profiles with
+     * @param aParent Parent object
+     */
+    explicit SessionPeerCache(ProfileManager &aProfileManager,
+                              QObject *aParent = 0);
+
+    //! \brief Destructor
+    virtual ~SessionPeerCache();
+
+    /*! \brief Loads the template profiles
+     *
+     * Should be called once at startup, before any sessions arrive.
+     */
+    void preload();
+
+    /*! \brief Classifies a peer
+     *
+     * @param aAddress Bluetooth address of the peer, or a USB destination
+     * @return Peer class
+     */
+    PeerClass peerClass(const QString &aAddress);
+
+    /*! \brief Gets the name of a peer
+     *
+     * @param aAddress Bluetooth address of the peer, or a USB destination
+     * @return PC sync name for PCs, Bluetooth name for other devices
+     */
+    QString peerName(const QString &aAddress);
+
+    /*! \brief Gets the profile to use for a session with a peer
+     *
+     * If no stored profile matches the peer, a temporary profile is created
+     * from the preloaded templates.
+     *
+     * @param aAddress Bluetooth address of the peer, or a USB destination
+     * @param aTemporary Set to true if the profile was created from a
+     *  template
+     * @param aSave Set to true if the temporary profile was created from the
+     *  Bluetooth template and should be saved
+     * @return Profile, owned by the caller. Null if the Bluetooth template
+     *  could not be loaded.
+     */
+    SyncProfile *sessionProfile(const QString &aAddress, bool &aTemporary,
+                                bool &aSave);
+
+public slots:
+
+    /*! \brief Drops cached profiles after a profile has changed
+     *
+     * Only the peers the profile was selected for or now matches are
+     * dropped. Log changes are ignored. Peer classifications are kept, as
+     * they do not depend on profiles.
+     *
+     * @param aProfileName Name of the changed profile
+     * @param aChangeType ProfileManager::ProfileChangeType
+     * @param aProfileAsXml Changed profile as XML, empty if not known
+     */
+    void invalidate(QString aProfileName, int aChangeType,
+                    QString aProfileAsXml);
+
+protected:
+
+    /*! \brief Fetches the Bluetooth properties of a peer
+     *
+     * @param aAddress Bluetooth address of the peer
+     * @return Device properties
+     */
+    virtual QMap<QString, QVariant> deviceProperties(const QString &aAddress);
+
+private:
+
+    struct Peer
+    {
+        PeerClass iClass;
+        QString iName;
+    };
+
+    Peer peer(const QString &aAddress);
+
+    SyncProfile *storedProfile(const QString &aKey, PeerClass aClass);
+
+    SyncProfile *createProfile(const QString &aAddress, const Peer &aPeer,
+                               bool &aSave);
+
+    void dropProfile(const QString &aKey);
+
+    void clearProfiles();
+
+    ProfileManager &iProfileManager;
+
+    SyncProfile *iPcTemplate;
+
+    SyncProfile *iBtTemplate;
+
+    QHash<QString, Peer> iPeers;
+
+    // Stored profile by peer key.
+    QHash<QString, SyncProfile*> iProfiles;
+
+    // Modification time of the file of each stored profile, by peer key.
+    QHash<QString, QDateTime> iModified;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class SessionPeerCacheTest;
+#endif
+};
+
+}
+
+#endif // SESSIONPEERCACHE_H
@@ -0,0 +1,292 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "StatusStream.h"
+#include "SyncCommonDefs.h"
+#include "ProfileEngineDefs.h"
+#include "LogMacros.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusServiceWatcher>
+#include <QtXml/QDomDocument>
+
+using namespace Buteo;
+
+static const QString LISTENER_INTERFACE("com.meego.msyncd.StatusListener");
+static const QString LISTENER_METHOD("statusUpdates");
+
+static QString subscriptionKey(const QString &aService, const QString &aPath)
+{
+    return aService + aPath;
+}
+
+StatusStream::StatusStream(QObject *aParent)
+:   QObject(aParent),
+    iWatcher(0)
+{
+    FUNCTION_CALL_TRACE;
+
+    iFlushTimer.setSingleShot(true);
+    iFlushTimer.setInterval(FLUSH_INTERVAL_MS);
+    connect(&iFlushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+
+    iWatcher = new QDBusServiceWatcher(this);
+    iWatcher->setConnection(QDBusConnection::sessionBus());
+    iWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    connect(iWatcher, SIGNAL(serviceUnregistered(const QString &)),
+            this, SLOT(onServiceUnregistered(const QString &)));
+}
+
+StatusStream::~StatusStream()
+{
+    FUNCTION_CALL_TRACE;
+}
+
+void StatusStream::subscribe(const QString &aService, const QString &aPath,
+                             const QStringList &aProfileNames)
+{
+    FUNCTION_CALL_TRACE;
+
+    Subscription &subscription = iSubscriptions[subscriptionKey(aService, aPath)];
+    subscription.iService = aService;
+    subscription.iPath = aPath;
+    subscription.iProfileNames = aProfileNames.toSet();
+
+    // Pending updates of profiles that are no longer followed are dropped.
+    QList<Update>::iterator i = subscription.iPending.begin();
+    while (i != subscription.iPending.end())
+    {
+        if (subscription.iProfileNames.contains(i->iProfileName))
+        {
+            ++i;
+        }
+        else
+        {
+            i = subscription.iPending.erase(i);
+        }
+    }
+
+    if (!iWatcher->watchedServices().contains(aService))
+    {
+        iWatcher->addWatchedService(aService);
+    } // no else
+
+    LOG_DEBUG("Client" << aService << aPath << "follows" << aProfileNames);
+}
+
+void StatusStream::unsubscribe(const QString &aService, const QString &aPath)
+{
+    FUNCTION_CALL_TRACE;
+
+    iSubscriptions.remove(subscriptionKey(aService, aPath));
+}
+
+bool StatusStream::isFollowed(const QString &aProfileName) const
+{
+    FUNCTION_CALL_TRACE;
+
+    foreach (const Subscription &subscription, iSubscriptions)
+    {
+        if (subscription.iProfileNames.contains(aProfileName))
+        {
+            return true;
+        } // no else
+    }
+
+    return false;
+}
+
+void StatusStream::publishStatus(QString aProfileName, int aStatus,
+                                 QString aMessage, int aDetails)
+{
+    FUNCTION_CALL_TRACE;
+
+    Update update;
+    update.iKind = (aStatus == Sync::SYNC_PROGRESS) ? DETAIL : STATUS;
+    update.iProfileName = aProfileName;
+    update.iStatus = aStatus;
+    update.iMessage = aMessage;
+    update.iDetails = aDetails;
+    update.iDatabase = 0;
+    update.iType = 0;
+    update.iItems = 0;
+    queue(update);
+}
+
+void StatusStream::publishProgress(QString aProfileName, int aDatabase,
+                                   int aType, QString aMimeType, int aItems)
+{
+    FUNCTION_CALL_TRACE;
+
+    Update update;
+    update.iKind = TRANSFER;
+    update.iProfileName = aProfileName;
+    update.iStatus = Sync::SYNC_PROGRESS;
+    update.iDetails = 0;
+    update.iDatabase = aDatabase;
+    update.iType = aType;
+    update.iMimeType = aMimeType;
+    update.iItems = aItems;
+    queue(update);
+}
+
+void StatusStream::deliver(const QString &aService, const QString &aPath,
+                           const QString &aUpdatesAsXml)
+{
+    FUNCTION_CALL_TRACE;
+
+    QDBusMessage call = QDBusMessage::createMethodCall(aService, aPath,
+            LISTENER_INTERFACE, LISTENER_METHOD);
+    call << aUpdatesAsXml;
+    if (!QDBusConnection::sessionBus().send(call))
+    {
+        LOG_WARNING("Failed to deliver status updates to" << aService);
+    } // no else
+}
+
+void StatusStream::flush()
+{
+    FUNCTION_CALL_TRACE;
+
+    QHash<QString, Subscription>::iterator i;
+    for (i = iSubscriptions.begin(); i != iSubscriptions.end(); ++i)
+    {
+        if (!i->iPending.isEmpty())
+        {
+            deliver(i->iService, i->iPath, toXml(i->iPending));
+            i->iPending.clear();
+        } // no else
+    }
+}
+
+void StatusStream::onServiceUnregistered(const QString &aService)
+{
+    FUNCTION_CALL_TRACE;
+
+    QHash<QString, Subscription>::iterator i = iSubscriptions.begin();
+    while (i != iSubscriptions.end())
+    {
+        if (i->iService == aService)
+        {
+            i = iSubscriptions.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    iWatcher->removeWatchedService(aService);
+    LOG_DEBUG("Client" << aService << "left, subscriptions removed");
+}
+
+void StatusStream::queue(const Update &aUpdate)
+{
+    FUNCTION_CALL_TRACE;
+
+    bool queued = false;
+    QHash<QString, Subscription>::iterator i;
+    for (i = iSubscriptions.begin(); i != iSubscriptions.end(); ++i)
+    {
+        if (i->iProfileNames.contains(aUpdate.iProfileName))
+        {
+            merge(i->iPending, aUpdate);
+            queued = true;
+        } // no else
+    }
+
+    if (queued && !iFlushTimer.isActive())
+    {
+        iFlushTimer.start();
+    } // no else
+}
+
+void StatusStream::merge(QList<Update> &aPending, const Update &aUpdate)
+{
+    if (aUpdate.iKind != STATUS)
+    {
+        for (int i = aPending.count() - 1; i >= 0; --i)
+        {
+            Update &pending = aPending[i];
+            if (pending.iProfileName != aUpdate.iProfileName)
+            {
+                continue;
+            } // no else
+
+            if (pending.iKind == STATUS)
+            {
+                // Progress is not merged across a status transition.
+                break;
+            } // no else
+
+            if (pending.iKind == DETAIL && aUpdate.iKind == DETAIL)
+            {
+                pending.iMessage = aUpdate.iMessage;
+                pending.iDetails = aUpdate.iDetails;
+                return;
+            } // no else
+
+            if (pending.iKind == TRANSFER && aUpdate.iKind == TRANSFER &&
+                pending.iDatabase == aUpdate.iDatabase &&
+                pending.iType == aUpdate.iType &&
+                pending.iMimeType == aUpdate.iMimeType)
+            {
+                pending.iItems += aUpdate.iItems;
+                return;
+            } // no else
+        }
+    } // no else
+
+    aPending.append(aUpdate);
+}
+
+QString StatusStream::toXml(const QList<Update> &aUpdates)
+{
+    QDomDocument doc;
+    QDomElement root = doc.createElement(TAG_STATUS_UPDATES);
+    doc.appendChild(root);
+
+    foreach (const Update &update, aUpdates)
+    {
+        QDomElement element;
+        if (update.iKind == TRANSFER)
+        {
+            element = doc.createElement(TAG_PROGRESS);
+            element.setAttribute(ATTR_DATABASE, update.iDatabase);
+            element.setAttribute(ATTR_TYPE, update.iType);
+            element.setAttribute(ATTR_MIME_TYPE, update.iMimeType);
+            element.setAttribute(ATTR_ITEMS, update.iItems);
+        }
+        else
+        {
+            element = doc.createElement(TAG_STATUS);
+            element.setAttribute(ATTR_STATUS, update.iStatus);
+            element.setAttribute(ATTR_MESSAGE, update.iMessage);
+            element.setAttribute(ATTR_DETAILS, update.iDetails);
+        }
+        element.setAttribute(ATTR_NAME, update.iProfileName);
+        root.appendChild(element);
+    }
+
+    return doc.toString(-1);
+}
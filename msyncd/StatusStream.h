@@ -0,0 +1,189 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef STATUSSTREAM_H
+#define STATUSSTREAM_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+class QDBusServiceWatcher;
+
+namespace Buteo {
+
+class StatusStreamTest;
+
+/*! \brief Delivers sync status to subscribed clients only.
+ *
+ * Clients subscribe to the profiles they are interested in. Status changes
+ * and transfer progress of those profiles are queued per client, and sent in
+ * order as one batch after FLUSH_INTERVAL_MS, so a client wakes up at most
+ * once per interval and never for profiles it does not follow.
+ *
+ * Within a batch, status transitions are kept as they are. Progress is
+ * coalesced: a newer progress detail replaces the pending one of the same
+ * profile, and transfer progress of the same profile, database, transfer type
+ * and MIME type is summed. Progress is never merged across a status
+ * transition of its profile, so the order of events is preserved.
+ *
+ * A batch is delivered with a D-Bus call to the subscriber's bus name and
+ * object path, on the com.meego.msyncd.StatusListener interface. The
+ * subscription is dropped when the subscriber leaves the bus.
+ */
+class StatusStream : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    //! Delay before queued updates are delivered, in milliseconds
+    static const int FLUSH_INTERVAL_MS = 100;
+
+    /*! \brief Constructor
+     *
+     * @param aParent Parent object
+     */
+    explicit StatusStream(QObject *aParent = 0);
+
+    //! \brief Destructor
+    virtual ~StatusStream();
+
+    /*! \brief Subscribes a client to the status of profiles
+     *
+     * Replaces any earlier subscription of the same listener.
+     * @param aService Bus name of the client
+     * @param aPath Object path of the client's listener
+     * @param aProfileNames Profiles to follow
+     */
+    void subscribe(const QString &aService, const QString &aPath,
+                   const QStringList &aProfileNames);
+
+    /*! \brief Removes a subscription
+     *
+     * @param aService Bus name of the client
+     * @param aPath Object path of the client's listener
+     */
+    void unsubscribe(const QString &aService, const QString &aPath);
+
+    /*! \brief Checks if any client follows a profile
+     *
+     * @param aProfileName Name of the profile
+     * @return True if the profile has subscribers
+     */
+    bool isFollowed(const QString &aProfileName) const;
+
+public slots:
+
+    /*! \brief Queues a status change
+     *
+     * @param aProfileName Name of the profile
+     * @param aStatus Sync::SyncStatus
+     * @param aMessage Status message
+     * @param aDetails Error code or progress detail
+     */
+    void publishStatus(QString aProfileName, int aStatus, QString aMessage,
+                       int aDetails);
+
+    /*! \brief Queues transfer progress
+     *
+     * @param aProfileName Name of the profile
+     * @param aDatabase Sync::TransferDatabase
+     * @param aType Sync::TransferType
+     * @param aMimeType MIME type of the items
+     * @param aItems Number of committed items
+     */
+    void publishProgress(QString aProfileName, int aDatabase, int aType,
+                         QString aMimeType, int aItems);
+
+protected:
+
+    /*! \brief Delivers a batch of updates to a client
+     *
+     * @param aService Bus name of the client
+     * @param aPath Object path of the client's listener
+     * @param aUpdatesAsXml Updates as XML
+     */
+    virtual void deliver(const QString &aService, const QString &aPath,
+                         const QString &aUpdatesAsXml);
+
+private slots:
+
+    void flush();
+
+    void onServiceUnregistered(const QString &aService);
+
+private:
+
+    enum Kind
+    {
+        STATUS,
+        DETAIL,
+        TRANSFER
+    };
+
+    struct Update
+    {
+        Kind iKind;
+        QString iProfileName;
+        int iStatus;
+        QString iMessage;
+        int iDetails;
+        int iDatabase;
+        int iType;
+        QString iMimeType;
+        int iItems;
+    };
+
+    struct Subscription
+    {
+        QString iService;
+        QString iPath;
+        QSet<QString> iProfileNames;
+        QList<Update> iPending;
+    };
+
+    void queue(const Update &aUpdate);
+
+    static void merge(QList<Update> &aPending, const Update &aUpdate);
+
+    static QString toXml(const QList<Update> &aUpdates);
+
+    // Subscriptions by bus name and object path.
+    QHash<QString, Subscription> iSubscriptions;
+
+    QTimer iFlushTimer;
+
+    QDBusServiceWatcher *iWatcher;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class StatusStreamTest;
+#endif
+};
+
+}
+
+#endif // STATUSSTREAM_H
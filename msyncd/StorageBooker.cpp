@@ -136,6 +136,36 @@ void StorageBooker::releaseStorages(const QStringList &aStorageNames)
     }
 }
 
+unsigned StorageBooker::releaseClientStorages(const QString &aClientId)
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+
+    unsigned released = 0;
+    if (aClientId.isEmpty())
+    {
+        return released;
+    } // no else
+
+    QMap<QString, StorageMapItem>::iterator i = iStorageMap.begin();
+    while (i != iStorageMap.end())
+    {
+        if (i.value().iClientId == aClientId)
+        {
+            LOG_DEBUG("Releasing storage" << i.key() << "of" << aClientId);
+            i = iStorageMap.erase(i);
+            ++released;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    return released;
+}
+
 bool StorageBooker::isStorageAvailable(const QString &aStorageName,
                                        const QString &aClientId) const
 {
@@ -164,3 +194,21 @@ bool StorageBooker::storagesAvailable(const QStringList &aStorageNames,
 
     return true;
 }
+
+QString StorageBooker::storageOwner(const QString &aStorageName) const
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+
+    return iStorageMap.value(aStorageName).iClientId;
+}
+
+bool StorageBooker::hasReservations() const
+{
+    FUNCTION_CALL_TRACE;
+
+    QMutexLocker locker(&iMutex);
+
+    return !iStorageMap.isEmpty();
+}
@@ -85,6 +85,14 @@ public:
      */
     void releaseStorages(const QStringList &aStorageNames);
 
+    /*! \brief Releases all reservations of the given client.
+     *
+     * Used when the client can no longer release its storages itself.
+     * \param aClientId ID of the client.
+     * \return Number of storages released.
+     */
+    unsigned releaseClientStorages(const QString &aClientId);
+
     /*! \brief Checks if the given storage is available for the given client.
      *
      * The storage is available if there are no reservations for it or if the
@@ -106,6 +114,20 @@ public:
     bool storagesAvailable(const QStringList &aStorageNames,
                            const QString &aClientId = "") const;
 
+    /*! \brief Returns the client the given storage is reserved for.
+     *
+     * \param aStorageName Name of the storage.
+     * \return ID of the client, empty if the storage is not reserved or is
+     *  reserved without a client ID.
+     */
+    QString storageOwner(const QString &aStorageName) const;
+
+    /*! \brief Checks if any storage is reserved.
+     *
+     * \return True if at least one storage is reserved.
+     */
+    bool hasReservations() const;
+
 private:
 
     struct StorageMapItem
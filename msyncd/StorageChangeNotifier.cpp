@@ -51,26 +51,38 @@ void StorageChangeNotifier::loadNotifiers(PluginManager* aPluginManager,
 bool StorageChangeNotifier::startListen(QStringList& aFailedStorages)
 {
     FUNCTION_CALL_TRACE;
-    bool success = true;
-    StorageChangeNotifierPlugin* plugin = 0;
 
     if(!iNotifierMap.count())
     {
-        success = false;
+        return false;
     }
-    for(QHash<QString,StorageChangeNotifierPlugin*>::iterator storageNameItr = iNotifierMap.begin();
-        storageNameItr != iNotifierMap.end(); ++storageNameItr)
+    return startListen(iNotifierMap.keys(), aFailedStorages);
+}
+
+bool StorageChangeNotifier::startListen(const QStringList& aStorageNames,
+                                        QStringList& aFailedStorages)
+{
+    FUNCTION_CALL_TRACE;
+    bool success = true;
+    StorageChangeNotifierPlugin* plugin = 0;
+
+    for(QStringList::const_iterator storageNameItr = aStorageNames.constBegin();
+        storageNameItr != aStorageNames.constEnd(); ++storageNameItr)
     {
-        plugin = storageNameItr.value();
+        if(!iNotifierMap.contains(*storageNameItr))
+        {
+            continue;
+        }
+        plugin = iNotifierMap.value(*storageNameItr);
         if(plugin)
         {
             QObject::connect(plugin, SIGNAL(storageChange()),
-                             this, SLOT(storageChanged()));
+                             this, SLOT(storageChanged()), Qt::UniqueConnection);
             plugin->enable();
         }
         else
         {
-            aFailedStorages << storageNameItr.key();
+            aFailedStorages << *storageNameItr;
             success = false;
         }
     }
@@ -78,13 +90,20 @@ bool StorageChangeNotifier::startListen(QStringList& aFailedStorages)
 }
 
 void StorageChangeNotifier::stopListen(bool disableAfterNextChange)
+{
+    FUNCTION_CALL_TRACE;
+    stopListen(iNotifierMap.keys(), disableAfterNextChange);
+}
+
+void StorageChangeNotifier::stopListen(const QStringList& aStorageNames,
+                                       bool disableAfterNextChange)
 {
     FUNCTION_CALL_TRACE;
     StorageChangeNotifierPlugin* plugin = 0;
-    for(QHash<QString,StorageChangeNotifierPlugin*>::iterator storageNameItr = iNotifierMap.begin();
-        storageNameItr != iNotifierMap.end(); ++storageNameItr)
+    for(QStringList::const_iterator storageNameItr = aStorageNames.constBegin();
+        storageNameItr != aStorageNames.constEnd(); ++storageNameItr)
     {
-        plugin = storageNameItr.value();
+        plugin = iNotifierMap.value(*storageNameItr);
         if(plugin)
         {
             QObject::disconnect(plugin, SIGNAL(storageChange()),
@@ -101,23 +120,31 @@ void StorageChangeNotifier::storageChanged()
     if(plugin)
     {
         LOG_DEBUG("Change in storage" << plugin->name());
+        QStringList origins = plugin->changeOrigins();
         plugin->changesReceived();
-        emit storageChange(plugin->name());
+        emit storageChange(plugin->name(), origins);
     }
 }
 
 void StorageChangeNotifier::checkForChanges()
+{
+    FUNCTION_CALL_TRACE;
+    checkForChanges(iNotifierMap.keys());
+}
+
+void StorageChangeNotifier::checkForChanges(const QStringList& aStorageNames)
 {
     FUNCTION_CALL_TRACE;
     StorageChangeNotifierPlugin* plugin = 0;
-    for(QHash<QString,StorageChangeNotifierPlugin*>::iterator storageNameItr = iNotifierMap.begin();
-        storageNameItr != iNotifierMap.end(); ++storageNameItr)
+    for(QStringList::const_iterator storageNameItr = aStorageNames.constBegin();
+        storageNameItr != aStorageNames.constEnd(); ++storageNameItr)
     {
-        plugin = storageNameItr.value();
+        plugin = iNotifierMap.value(*storageNameItr);
         if(plugin && plugin->hasChanges())
         {
+            QStringList origins = plugin->changeOrigins();
             plugin->changesReceived();
-            emit storageChange(plugin->name());
+            emit storageChange(plugin->name(), origins);
         }
     }
 }
@@ -3,12 +3,14 @@
 
 #include <QObject>
 #include <QHash>
+#include <QStringList>
 
 namespace Buteo
 {
 
 class StorageChangeNotifierPlugin;
 class PluginManager;
+class SyncOnChangeTest;
 
 /*! \brief Notifies about changes in storages
  * that it's asked to monitor
@@ -42,6 +44,15 @@ public:
      */
     bool startListen(QStringList& aFailedStorages);
 
+    /*! Call this to start monitoring changes in the given storages
+     *
+     * @param aStorageNames storages to monitor
+     * @param aFailedStorages list of storage names which can't be monitored
+     * @return true if we can monitor all storages requested for
+     * false otherwise
+     */
+    bool startListen(const QStringList& aStorageNames, QStringList& aFailedStorages);
+
     /*! \brief call this to ignore taking action on
      * storage changes. Whether there was a change can
      * be determined by calling hasChanges() on the notifier plug-in
@@ -56,10 +67,23 @@ public:
      */
     void stopListen(bool disableAfterNextChange = false);
 
+    /*! \brief stop listening to changes in the given storages
+     *
+     * @param aStorageNames storages to stop monitoring
+     * @param disableAfterNextChange see stopListen(bool)
+     */
+    void stopListen(const QStringList& aStorageNames, bool disableAfterNextChange = false);
+
     /*! Manually check and notify changes in storage
      */
     void checkForChanges();
 
+    /*! Manually check and notify changes in the given storages
+     *
+     * @param aStorageNames storages to check
+     */
+    void checkForChanges(const QStringList& aStorageNames);
+
 private Q_SLOTS:
     /*! \brief process a storage change notification
      */
@@ -69,12 +93,17 @@ Q_SIGNALS:
     /*! emit this signal if a storage changed
      *
      * @param storageName name of the storage that changed
+     * @param aOrigins write origins of the changes, empty if not known
      */
-    void storageChange(QString aStorageName);
+    void storageChange(QString aStorageName, QStringList aOrigins);
 
 private:
     QHash<QString,StorageChangeNotifierPlugin*> iNotifierMap;
     PluginManager* iPluginManager;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class SyncOnChangeTest;
+#endif
 };
 
 }
@@ -0,0 +1,80 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "StorageCycleMeter.h"
+#include "LogMacros.h"
+
+using namespace Buteo;
+
+static const qint64 MSECS_PER_HOUR = 60 * 60 * 1000;
+
+StorageCycleMeter::StorageCycleMeter()
+:   iTotal(0)
+{
+    FUNCTION_CALL_TRACE;
+
+    iClock.start();
+}
+
+StorageCycleMeter::~StorageCycleMeter()
+{
+    FUNCTION_CALL_TRACE;
+}
+
+void StorageCycleMeter::cycleCompleted(const QString &aPluginName)
+{
+    FUNCTION_CALL_TRACE;
+
+    const qint64 currentTime = now();
+    iCycleTimes.enqueue(currentTime);
+    ++iTotal;
+    expire(currentTime);
+
+    LOG_DEBUG("Storage" << aPluginName << "uninitialized," <<
+              iCycleTimes.size() << "init/uninit cycles during the last hour");
+}
+
+int StorageCycleMeter::cyclesPerHour()
+{
+    FUNCTION_CALL_TRACE;
+
+    expire(now());
+    return iCycleTimes.size();
+}
+
+int StorageCycleMeter::totalCycles() const
+{
+    return iTotal;
+}
+
+qint64 StorageCycleMeter::now() const
+{
+    return iClock.elapsed();
+}
+
+void StorageCycleMeter::expire(qint64 aNow)
+{
+    while (!iCycleTimes.isEmpty() && aNow - iCycleTimes.head() >= MSECS_PER_HOUR)
+    {
+        iCycleTimes.dequeue();
+    }
+}
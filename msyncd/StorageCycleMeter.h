@@ -0,0 +1,94 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef STORAGECYCLEMETER_H
+#define STORAGECYCLEMETER_H
+
+#include <QString>
+#include <QQueue>
+#include <QElapsedTimer>
+
+namespace Buteo {
+
+class StorageCycleMeterTest;
+
+/*! \brief Counts storage plug-in init/uninit cycles.
+ *
+ * Every storage plug-in instance created for a session is initialized and
+ * uninitialized once, dropping its caches. The meter counts the instances
+ * destroyed during the last hour, which shows how well the sync queue
+ * manages to run sessions using the same storages one after another.
+ */
+class StorageCycleMeter
+{
+public:
+
+    //! \brief Constructor
+    StorageCycleMeter();
+
+    //! \brief Destructor
+    virtual ~StorageCycleMeter();
+
+    /*! \brief Records a storage plug-in instance that has been destroyed
+     *
+     * @param aPluginName Name of the storage plug-in
+     */
+    void cycleCompleted(const QString &aPluginName);
+
+    /*! \brief Returns the number of cycles during the last hour
+     *
+     * @return Cycle count
+     */
+    int cyclesPerHour();
+
+    /*! \brief Returns the number of cycles since the meter was created
+     *
+     * @return Cycle count
+     */
+    int totalCycles() const;
+
+protected:
+
+    /*! \brief Returns monotonic time in milliseconds
+     *
+     * @return Current time
+     */
+    virtual qint64 now() const;
+
+private:
+
+    void expire(qint64 aNow);
+
+    QQueue<qint64> iCycleTimes;
+
+    int iTotal;
+
+    QElapsedTimer iClock;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class StorageCycleMeterTest;
+#endif
+};
+
+}
+
+#endif // STORAGECYCLEMETER_H
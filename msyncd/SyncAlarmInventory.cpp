@@ -32,12 +32,9 @@
 
 const QString ALARM_CONNECTION_NAME( "alarms" );
 
-const int TRIGGER_COUNT = 1;
-
 SyncAlarmInventory::SyncAlarmInventory():
         iTimer(0),
-        currentAlarm(0),
-        triggerCount(TRIGGER_COUNT)
+        currentAlarm(0)
 {
   // empty.explicitly call init
 }
@@ -66,8 +63,17 @@ bool SyncAlarmInventory::init()
     	LOG_DEBUG("DB Opened Successfully");
     }
 
-    // Create the alarms table
-    const QString createTableQuery( "CREATE TABLE IF NOT EXISTS alarms(alarmid INTEGER PRIMARY KEY AUTOINCREMENT, synctime DATETIME)" );
+    // Clear any old alarms that may have lingered. Deadlines are only valid
+    // until the next boot, so the table is created again on every start.
+    QSqlQuery dropQuery( "DROP TABLE IF EXISTS alarms", iDbHandle );
+    LOG_DEBUG("SQL Query::" << dropQuery.lastQuery());
+    if ( !dropQuery.exec() ) {
+    	LOG_WARNING("Failed to drop the old alarms table");
+    }
+
+    // Create the alarms table. synctime is the wall clock time of the alarm,
+    // deadline the time of the monotonic boot clock in milliseconds.
+    const QString createTableQuery( "CREATE TABLE IF NOT EXISTS alarms(alarmid INTEGER PRIMARY KEY AUTOINCREMENT, synctime DATETIME, deadline INTEGER)" );
     QSqlQuery query( createTableQuery, iDbHandle );
     LOG_DEBUG("SQL Query::" << query.lastQuery());
     if ( !query.exec() ) {
@@ -75,13 +81,11 @@ bool SyncAlarmInventory::init()
     	return false;
     }
 
-    // Clear any old alarms that may have lingered
-    removeAllAlarms();
-
     // Create the iTimer object
-    iTimer = new QTimer(this);
+    iTimer = new Buteo::DeadlineTimer(this);
     if(iTimer) {
     	connect( iTimer, SIGNAL(timeout()), this, SLOT(timerTriggered()) );
+    	connect( iTimer, SIGNAL(clockChanged(qint64)), this, SIGNAL(clockChanged(qint64)) );
     	currentAlarm = 0;
     	return true;
     } else {
@@ -118,7 +122,7 @@ int SyncAlarmInventory::addAlarm( QDateTime alarmDate )
 
     // Store the alarm 
     int alarmId = 0;
-    if ( (alarmId = addAlarmToDb(alarmDate)) == 0 ) {
+    if ( (alarmId = addAlarmToDb(alarmDate, iTimer->deadlineFor(alarmDate))) == 0 ) {
         // Note: Even incase of an already existing profile, false is returned by the query
         // There is no way to detect a record insertion from an already existing alarm
 
@@ -127,37 +131,7 @@ int SyncAlarmInventory::addAlarm( QDateTime alarmDate )
     	LOG_WARNING("(alarmId = addAlarmToDb(alarmDate)) == 0");
     }
 
-    // Select all the alarms from the db sorted by alarm time
-    QSqlQuery selectQuery( iDbHandle );
-    if ( selectQuery.exec("SELECT alarmid,synctime FROM alarms ORDER BY synctime ASC") ) {
-        LOG_DEBUG("SQL Query::" << selectQuery.lastQuery());
-        if ( selectQuery.first() ) {
-            int newAlarm = selectQuery.value(0).toInt();
-            QDateTime alarmTime = selectQuery.value(1).toDateTime();
-
-            // If the newAlarm != currentAlarm that is fetched from DB, stop the
-            // previous iTimer
-            if ( (currentAlarm != 0) && (newAlarm != currentAlarm) ) {
-                if ( !iTimer->isActive() )
-                    iTimer->stop();
-            }
-
-            // This is a new alarm. Set the iTimer for the alarm
-            currentAlarm = newAlarm;
-            QDateTime now = QDateTime::currentDateTime();
-            int iTimerInterval = 0;
-            if(now < alarmTime)
-            {
-                iTimerInterval = (now.secsTo( alarmTime ) / TRIGGER_COUNT) * 1000;  // time interval in millisec
-            }
-            LOG_DEBUG("currentAlarm"<<currentAlarm<<"alarmTime"<<alarmTime<<"iTimerInterval"<<iTimerInterval);
-            triggerCount = TRIGGER_COUNT;
-            iTimer->setInterval( iTimerInterval );
-            iTimer->start();
-        }
-    } else {
-    	LOG_WARNING("Select Query Execution Failed" );
-    }
+    startNextAlarm();
 
     return alarmId;
 }
@@ -187,42 +161,40 @@ void SyncAlarmInventory::timerTriggered()
 {
     FUNCTION_CALL_TRACE;
 
-    // Decrement the alarm counter
-    triggerCount--;
-
     // Alarm expired. Trigger the alarm and delete it from DB and set the alarm for the next one
-    if (triggerCount == 0) {
-    	LOG_DEBUG("Triggering the alarm " << currentAlarm );
-        emit triggerAlarm(currentAlarm);
+    LOG_DEBUG("Triggering the alarm " << currentAlarm );
+    emit triggerAlarm(currentAlarm);
 
-        // Delete the alarm from DB
-        if ( !deleteAlarmFromDb(currentAlarm) ) {
-        }
-        iTimer->stop();
-        currentAlarm = 0;
-
-        // Set the new alarm iTimer
-        // Select all the alarms from the db sorted by alarm time
-        QSqlQuery selectQuery( iDbHandle );
-        if ( selectQuery.exec("SELECT alarmid,synctime FROM alarms ORDER BY synctime ASC") ) {
-            LOG_DEBUG("SQL Query::" << selectQuery.lastQuery());
-            if ( selectQuery.first() ) {
-                currentAlarm = selectQuery.value(0).toInt();
-                QDateTime alarmTime = selectQuery.value(1).toDateTime();
-
-                // Set the iTimer for the alarm
-                QDateTime now = QDateTime::currentDateTime();
-                int iTimerInterval = 0;
-                if(now < alarmTime)
-                {
-                    iTimerInterval = (now.secsTo( alarmTime ) / TRIGGER_COUNT) * 1000;  // time interval in millisec
-                }
-                triggerCount = TRIGGER_COUNT;
-                LOG_DEBUG("Starting timer with interval::" << iTimerInterval);
-                iTimer->setInterval( iTimerInterval );
-                iTimer->start();
-            }
+    // Delete the alarm from DB
+    if ( !deleteAlarmFromDb(currentAlarm) ) {
+        LOG_WARNING("Failed to delete the triggered alarm" << currentAlarm);
+    }
+    iTimer->stop();
+    currentAlarm = 0;
+
+    // Set the new alarm iTimer
+    startNextAlarm();
+}
+
+void SyncAlarmInventory::startNextAlarm()
+{
+    FUNCTION_CALL_TRACE;
+
+    // Select all the alarms from the db sorted by deadline
+    QSqlQuery selectQuery( iDbHandle );
+    if ( selectQuery.exec("SELECT alarmid,synctime,deadline FROM alarms ORDER BY deadline ASC") ) {
+        LOG_DEBUG("SQL Query::" << selectQuery.lastQuery());
+        if ( selectQuery.first() ) {
+            currentAlarm = selectQuery.value(0).toInt();
+            QDateTime alarmTime = selectQuery.value(1).toDateTime();
+            qint64 deadline = selectQuery.value(2).toLongLong();
+
+            // Set the iTimer for the alarm, replacing an earlier alarm
+            LOG_DEBUG("currentAlarm"<<currentAlarm<<"alarmTime"<<alarmTime<<"deadline"<<deadline);
+            iTimer->start( deadline );
         }
+    } else {
+    	LOG_WARNING("Select Query Execution Failed" );
     }
 }
 
@@ -241,13 +213,14 @@ bool SyncAlarmInventory::deleteAlarmFromDb( int alarmId )
         return true;
 }
 
-int SyncAlarmInventory::addAlarmToDb( QDateTime timeStamp )
+int SyncAlarmInventory::addAlarmToDb( QDateTime timeStamp, qint64 deadline )
 {
     FUNCTION_CALL_TRACE;
 
     QSqlQuery insertQuery( iDbHandle );
-    insertQuery.prepare( "INSERT INTO alarms(synctime) VALUES(:synctime)" );
+    insertQuery.prepare( "INSERT INTO alarms(synctime,deadline) VALUES(:synctime,:deadline)" );
     insertQuery.bindValue( ":synctime", timeStamp );
+    insertQuery.bindValue( ":deadline", deadline );
 
     LOG_DEBUG("SQL Query::" << insertQuery.lastQuery());
     if ( insertQuery.exec() )
@@ -28,11 +28,14 @@
 #include <QObject>
 #include <QDateTime>
 #include <QtSql>
+#include "DeadlineTimer.h"
 
 /*! \brief Class for storing alarms
  *
  * This class stores alarms for scheduled synchronizations. The main elements
- * are the sync time and the alarm id
+ * are the sync time and the alarm id. The sync time is converted to a
+ * deadline of the monotonic boot clock when the alarm is added, so alarms
+ * fire on time across suspend and are not affected by wall clock changes.
  */
 class SyncAlarmInventory : public QObject
 {
@@ -77,25 +80,33 @@ class SyncAlarmInventory : public QObject
          * */
         void triggerAlarm(int alarmId);
 
+        /*! \brief Signal triggered when the wall clock has been changed
+         *
+         * Alarms keep their deadlines. Alarms computed from times of day
+         * need to be added again.
+         * @param aJumpMsecs - amount the wall clock moved
+         */
+        void clockChanged(qint64 aJumpMsecs);
+
     private:
         /* Deletes the alarm from DB */
         bool deleteAlarmFromDb( int alarmName );
 
         /* Method to add an alarm to the database */
-        int addAlarmToDb( QDateTime timeStamp );
+        int addAlarmToDb( QDateTime timeStamp, qint64 deadline );
+
+        /* Starts the timer for the alarm with the earliest deadline */
+        void startNextAlarm();
 
         /* Method to fetch the database handle */
         QSqlDatabase*  getDbHandle();
 
         /* Timer object to keep tracke of alarm timers */
-        QTimer*        iTimer;
+        Buteo::DeadlineTimer* iTimer;
 
         /* Current alarm that is under work */
         int            currentAlarm;
 
-        /* Number of times that the alarm triggers */
-        int            triggerCount;
-
         /* Database handle */
         QSqlDatabase   iDbHandle;
 
@@ -101,6 +101,12 @@ bool SyncDBusAdaptor::removeProfile(const QString &aProfileId)
     return out0;
 }
 
+void SyncDBusAdaptor::reportTargetResults(const QString &aProfileId, const QString &aTargetResults)
+{
+    // handle method call com.meego.msyncd.reportTargetResults
+    QMetaObject::invokeMethod(parent(), "reportTargetResults", Q_ARG(QString, aProfileId), Q_ARG(QString, aTargetResults));
+}
+
 bool SyncDBusAdaptor::requestStorages(const QStringList &aStorageNames)
 {
     // handle method call com.meego.msyncd.requestStorages
@@ -133,6 +139,12 @@ bool SyncDBusAdaptor::setSyncSchedule(const QString &aProfileId, const QString &
     return out0;
 }
 
+void SyncDBusAdaptor::setForegroundActive(bool aActive)
+{
+    // handle method call com.meego.msyncd.setForegroundActive
+    QMetaObject::invokeMethod(parent(), "setForegroundActive", Q_ARG(bool, aActive));
+}
+
 void SyncDBusAdaptor::start(uint aAccountId)
 {
     // handle method call com.meego.msyncd.start
@@ -159,6 +171,12 @@ void SyncDBusAdaptor::stop(uint aAccountId)
     QMetaObject::invokeMethod(parent(), "stop", Q_ARG(uint, aAccountId));
 }
 
+void SyncDBusAdaptor::subscribeStatus(const QString &aListenerPath, const QStringList &aProfileIds, const QList<uint> &aAccountIds)
+{
+    // handle method call com.meego.msyncd.subscribeStatus
+    QMetaObject::invokeMethod(parent(), "subscribeStatus", Q_ARG(QString, aListenerPath), Q_ARG(QStringList, aProfileIds), Q_ARG(QList<uint>, aAccountIds));
+}
+
 QString SyncDBusAdaptor::syncProfile(const QString &aProfileId)
 {
     // handle method call com.meego.msyncd.syncProfile
@@ -191,6 +209,12 @@ QList<uint> SyncDBusAdaptor::syncingAccounts()
     return out0;
 }
 
+void SyncDBusAdaptor::unsubscribeStatus(const QString &aListenerPath)
+{
+    // handle method call com.meego.msyncd.unsubscribeStatus
+    QMetaObject::invokeMethod(parent(), "unsubscribeStatus", Q_ARG(QString, aListenerPath));
+}
+
 bool SyncDBusAdaptor::updateProfile(const QString &aProfileAsXml)
 {
     // handle method call com.meego.msyncd.updateProfile
@@ -75,6 +75,10 @@ class SyncDBusAdaptor: public QDBusAbstractAdaptor
 "      <arg direction=\"out\" type=\"x\" name=\"aPrevSyncTime\"/>\n"
 "      <arg direction=\"out\" type=\"x\" name=\"aNextSyncTime\"/>\n"
 "    </signal>\n"
+"    <signal name=\"deviceActivityChanged\">\n"
+"      <arg direction=\"out\" type=\"i\" name=\"aActivity\"/>\n"
+"      <arg direction=\"out\" type=\"b\" name=\"aCharging\"/>\n"
+"    </signal>\n"
 "    <method name=\"startSync\">\n"
 "      <arg direction=\"out\" type=\"b\"/>\n"
 "      <arg direction=\"in\" type=\"s\" name=\"aProfileId\"/>\n"
@@ -158,6 +162,26 @@ class SyncDBusAdaptor: public QDBusAbstractAdaptor
 "      <arg direction=\"out\" type=\"x\" name=\"aPrevSyncTime\"/>\n"
 "      <arg direction=\"out\" type=\"x\" name=\"aNextSyncTime\"/>\n"
 "    </method>\n"
+"    <method name=\"setForegroundActive\">\n"
+"      <arg direction=\"in\" type=\"b\" name=\"aActive\"/>\n"
+"      <annotation value=\"true\" name=\"org.freedesktop.DBus.Method.NoReply\"/>\n"
+"    </method>\n"
+"    <method name=\"subscribeStatus\">\n"
+"      <arg direction=\"in\" type=\"s\" name=\"aListenerPath\"/>\n"
+"      <arg direction=\"in\" type=\"as\" name=\"aProfileIds\"/>\n"
+"      <arg direction=\"in\" type=\"au\" name=\"aAccountIds\"/>\n"
+"      <annotation value=\"QList&lt;uint>\" name=\"com.trolltech.QtDBus.QtTypeName.In2\"/>\n"
+"      <annotation value=\"true\" name=\"org.freedesktop.DBus.Method.NoReply\"/>\n"
+"    </method>\n"
+"    <method name=\"unsubscribeStatus\">\n"
+"      <arg direction=\"in\" type=\"s\" name=\"aListenerPath\"/>\n"
+"      <annotation value=\"true\" name=\"org.freedesktop.DBus.Method.NoReply\"/>\n"
+"    </method>\n"
+"    <method name=\"reportTargetResults\">\n"
+"      <arg direction=\"in\" type=\"s\" name=\"aProfileId\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"aTargetResults\"/>\n"
+"      <annotation value=\"true\" name=\"org.freedesktop.DBus.Method.NoReply\"/>\n"
+"    </method>\n"
 "  </interface>\n"
         "")
 public:
@@ -173,22 +197,27 @@ public Q_SLOTS: // METHODS
     bool isConnectivityAvailable(int connectivityType);
     Q_NOREPLY void releaseStorages(const QStringList &aStorageNames);
     bool removeProfile(const QString &aProfileId);
+    Q_NOREPLY void reportTargetResults(const QString &aProfileId, const QString &aTargetResults);
     bool requestStorages(const QStringList &aStorageNames);
     QStringList runningSyncs();
     bool saveSyncResults(const QString &aProfileId, const QString &aSyncResults);
     bool setSyncSchedule(const QString &aProfileId, const QString &aScheduleAsXml);
+    Q_NOREPLY void setForegroundActive(bool aActive);
     Q_NOREPLY void start(uint aAccountId);
     bool startSync(const QString &aProfileId);
     int status(uint aAccountId, int &aFailedReason, qlonglong &aPrevSyncTime, qlonglong &aNextSyncTime);
     Q_NOREPLY void stop(uint aAccountId);
+    Q_NOREPLY void subscribeStatus(const QString &aListenerPath, const QStringList &aProfileIds, const QList<uint> &aAccountIds);
     QString syncProfile(const QString &aProfileId);
     QStringList syncProfilesByKey(const QString &aKey, const QString &aValue);
     QStringList syncProfilesByType(const QString &aType);
     QList<uint> syncingAccounts();
+    Q_NOREPLY void unsubscribeStatus(const QString &aListenerPath);
     bool updateProfile(const QString &aProfileAsXml);
 Q_SIGNALS: // SIGNALS
     void backupDone();
     void backupInProgress();
+    void deviceActivityChanged(int aActivity, bool aCharging);
     void restoreDone();
     void restoreInProgress();
     void resultsAvailable(const QString &aProfileName, const QString &aResultsAsXml);
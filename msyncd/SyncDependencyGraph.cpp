@@ -0,0 +1,116 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "SyncDependencyGraph.h"
+#include "LogMacros.h"
+
+#include <QSet>
+
+using namespace Buteo;
+
+bool SyncDependencyGraph::setPredecessors(const QString &aProfileName,
+                                          const QStringList &aPredecessors)
+{
+    FUNCTION_CALL_TRACE;
+
+    iPredecessors.remove(aProfileName);
+
+    bool accepted = true;
+    QStringList predecessors;
+    foreach (const QString &predecessor, aPredecessors)
+    {
+        if (predecessor == aProfileName || dependsOn(predecessor, aProfileName))
+        {
+            LOG_WARNING("Ignoring cyclic dependency of" << aProfileName
+                        << "on" << predecessor);
+            accepted = false;
+        }
+        else if (!predecessors.contains(predecessor))
+        {
+            predecessors.append(predecessor);
+        } // no else
+    }
+
+    if (!predecessors.isEmpty())
+    {
+        iPredecessors.insert(aProfileName, predecessors);
+    } // no else
+
+    return accepted;
+}
+
+void SyncDependencyGraph::removeProfile(const QString &aProfileName)
+{
+    FUNCTION_CALL_TRACE;
+
+    iPredecessors.remove(aProfileName);
+}
+
+void SyncDependencyGraph::clear()
+{
+    FUNCTION_CALL_TRACE;
+
+    iPredecessors.clear();
+}
+
+QStringList SyncDependencyGraph::predecessors(const QString &aProfileName) const
+{
+    return iPredecessors.value(aProfileName);
+}
+
+QStringList SyncDependencyGraph::dependents(const QString &aProfileName) const
+{
+    QStringList dependents;
+    QHash<QString, QStringList>::const_iterator i;
+    for (i = iPredecessors.constBegin(); i != iPredecessors.constEnd(); ++i)
+    {
+        if (i.value().contains(aProfileName))
+        {
+            dependents.append(i.key());
+        } // no else
+    }
+
+    return dependents;
+}
+
+bool SyncDependencyGraph::dependsOn(const QString &aProfileName,
+                                    const QString &aAncestor) const
+{
+    QSet<QString> visited;
+    QStringList pending = predecessors(aProfileName);
+    while (!pending.isEmpty())
+    {
+        QString name = pending.takeLast();
+        if (name == aAncestor)
+        {
+            return true;
+        } // no else
+
+        if (!visited.contains(name))
+        {
+            visited.insert(name);
+            pending.append(predecessors(name));
+        } // no else
+    }
+
+    return false;
+}
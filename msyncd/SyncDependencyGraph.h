@@ -0,0 +1,92 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef SYNCDEPENDENCYGRAPH_H
+#define SYNCDEPENDENCYGRAPH_H
+
+#include <QHash>
+#include <QStringList>
+
+namespace Buteo {
+
+/*! \brief Dependencies between sync profiles.
+ *
+ * Holds the "run after" relations declared in sync profiles as a directed
+ * acyclic graph. Dependencies that would create a cycle are rejected.
+ */
+class SyncDependencyGraph
+{
+public:
+
+    /*! \brief Sets the profiles a profile depends on
+     *
+     * Replaces the earlier dependencies of the profile.
+     * @param aProfileName Name of the profile
+     * @param aPredecessors Names of the profiles to run before it
+     * @return False if some of the dependencies were rejected because they
+     *  would have created a cycle
+     */
+    bool setPredecessors(const QString &aProfileName,
+                         const QStringList &aPredecessors);
+
+    /*! \brief Removes the dependencies of a profile
+     *
+     * Dependencies of other profiles on the removed profile are kept, so
+     * that they apply again if the profile is added back.
+     * @param aProfileName Name of the profile
+     */
+    void removeProfile(const QString &aProfileName);
+
+    //! \brief Removes all dependencies
+    void clear();
+
+    /*! \brief Returns the profiles a profile depends on directly
+     *
+     * @param aProfileName Name of the profile
+     * @return Names of the predecessors
+     */
+    QStringList predecessors(const QString &aProfileName) const;
+
+    /*! \brief Returns the profiles depending directly on a profile
+     *
+     * @param aProfileName Name of the profile
+     * @return Names of the dependents
+     */
+    QStringList dependents(const QString &aProfileName) const;
+
+    /*! \brief Checks if a profile depends on another, directly or through
+     *  other profiles
+     *
+     * @param aProfileName Name of the profile
+     * @param aAncestor Name of the possible ancestor
+     * @return True if the profile depends on the ancestor
+     */
+    bool dependsOn(const QString &aProfileName, const QString &aAncestor) const;
+
+private:
+
+    QHash<QString, QStringList> iPredecessors;
+};
+
+}
+
+#endif // SYNCDEPENDENCYGRAPH_H
@@ -0,0 +1,96 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "SyncEvent.h"
+
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+
+using namespace Buteo;
+
+namespace {
+
+//! Storage for the interned strings.
+struct AtomTable
+{
+    AtomTable()
+    {
+        // Atom 0 is reserved for the empty string.
+        iStrings.append(QString());
+    }
+
+    QReadWriteLock iLock;
+    QHash<QString, quint32> iAtoms;
+    QVector<QString> iStrings;
+};
+
+AtomTable &atomTable()
+{
+    static AtomTable table;
+    return table;
+}
+
+}
+
+quint32 SyncEventAtoms::intern(const QString &aString)
+{
+    if (aString.isEmpty())
+    {
+        return NONE;
+    } // no else
+
+    AtomTable &table = atomTable();
+    {
+        QReadLocker locker(&table.iLock);
+        QHash<QString, quint32>::const_iterator i = table.iAtoms.constFind(aString);
+        if (i != table.iAtoms.constEnd())
+        {
+            return i.value();
+        } // no else
+    }
+
+    QWriteLocker locker(&table.iLock);
+    // Another thread may have interned the string in the meanwhile.
+    QHash<QString, quint32>::const_iterator i = table.iAtoms.constFind(aString);
+    if (i != table.iAtoms.constEnd())
+    {
+        return i.value();
+    } // no else
+
+    quint32 atom = table.iStrings.size();
+    table.iStrings.append(aString);
+    table.iAtoms.insert(aString, atom);
+    return atom;
+}
+
+QString SyncEventAtoms::string(quint32 aAtom)
+{
+    AtomTable &table = atomTable();
+    QReadLocker locker(&table.iLock);
+    if (aAtom < static_cast<quint32>(table.iStrings.size()))
+    {
+        return table.iStrings.at(aAtom);
+    } // no else
+
+    return QString();
+}
@@ -0,0 +1,112 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef SYNCEVENT_H
+#define SYNCEVENT_H
+
+#include "SyncCommonDefs.h"
+#include <QString>
+#include <QMetaType>
+
+namespace Buteo {
+
+/*! \brief Compact sync event relayed from plug-in threads to the main loop.
+ *
+ * Events carry interned identifiers instead of strings, so relaying an
+ * event does not copy or allocate anything. Use SyncEventAtoms to map
+ * between identifiers and strings.
+ */
+struct SyncEvent {
+
+    //! Event type
+    enum Type {
+        //! \see SyncPluginBase::transferProgress
+        TRANSFER_PROGRESS,
+        //! \see SyncPluginBase::syncProgressDetail
+        PROGRESS_DETAIL,
+        //! \see SyncPluginBase::accquiredStorage
+        STORAGE_ACQUIRED
+    };
+
+    //! Event type, one of Type
+    quint8 type;
+
+    //! Transfer database, one of Sync::TransferDatabase
+    quint8 database;
+
+    //! Transfer type, one of Sync::TransferType
+    quint8 transferType;
+
+    //! Profile name atom
+    quint32 profile;
+
+    //! MIME type atom
+    quint32 mimeType;
+
+    //! Committed items for transfer progress, detail for progress detail
+    qint32 value;
+
+    //! Default constructor
+    SyncEvent() : type(PROGRESS_DETAIL), database(0), transferType(0),
+                  profile(0), mimeType(0), value(0) { }
+
+    //! Constructor with all parameters
+    SyncEvent(Type aType, quint32 aProfile, quint32 aMimeType = 0,
+              qint32 aValue = 0, Sync::TransferDatabase aDatabase = Sync::LOCAL_DATABASE,
+              Sync::TransferType aTransferType = Sync::ITEM_ADDED)
+        : type(aType), database(aDatabase), transferType(aTransferType),
+          profile(aProfile), mimeType(aMimeType), value(aValue) { }
+};
+
+/*! \brief Process wide table of interned strings used by sync events.
+ *
+ * Atoms are never released, so the table should only be used for strings
+ * from a small set such as profile names and MIME types. All functions are
+ * thread safe.
+ */
+class SyncEventAtoms
+{
+public:
+
+    //! Atom of the empty string
+    static const quint32 NONE = 0;
+
+    /*! \brief Returns the atom of a string, interning it if needed
+     *
+     * @param aString String to intern
+     * @return Atom
+     */
+    static quint32 intern(const QString &aString);
+
+    /*! \brief Returns the string of an atom
+     *
+     * @param aAtom Atom returned by intern()
+     * @return The string, empty if the atom is unknown
+     */
+    static QString string(quint32 aAtom);
+};
+
+}
+
+Q_DECLARE_METATYPE(Buteo::SyncEvent);
+
+#endif // SYNCEVENT_H
@@ -0,0 +1,176 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "SyncEventChannel.h"
+#include "LogMacros.h"
+
+#include <QMetaObject>
+
+using namespace Buteo;
+
+// The ring buffer follows the bounded queue design by Dmitry Vyukov. Each
+// cell has a sequence number telling whether it is free for the producer at
+// a given position or holds an event for the consumer. Producers claim
+// positions with a compare-and-swap, the single consumer needs no atomics
+// for its own position. Positions wrap around, so differences are computed
+// with unsigned arithmetic.
+
+static inline int loadAcquire(QAtomicInt &aValue)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+    return aValue.fetchAndAddAcquire(0);
+#else
+    return aValue.loadAcquire();
+#endif
+}
+
+static inline void storeRelease(QAtomicInt &aValue, int aNewValue)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+    aValue.fetchAndStoreRelease(aNewValue);
+#else
+    aValue.storeRelease(aNewValue);
+#endif
+}
+
+static inline int distance(int aFrom, int aTo)
+{
+    return static_cast<int>(static_cast<quint32>(aTo) - static_cast<quint32>(aFrom));
+}
+
+static inline int advance(int aPos, int aSteps)
+{
+    return static_cast<int>(static_cast<quint32>(aPos) + static_cast<quint32>(aSteps));
+}
+
+SyncEventChannel::SyncEventChannel(int aCapacity, QObject *aParent)
+:   QObject(aParent),
+    iCells(0),
+    iMask(0),
+    iEnqueuePos(0),
+    iDequeuePos(0),
+    iWakeUpPending(0)
+{
+    FUNCTION_CALL_TRACE;
+
+    int capacity = 2;
+    while (capacity < aCapacity)
+    {
+        capacity *= 2;
+    }
+
+    iMask = capacity - 1;
+    iCells = new Cell[capacity];
+    for (int i = 0; i < capacity; ++i)
+    {
+        storeRelease(iCells[i].iSequence, i);
+    }
+
+    qRegisterMetaType<Buteo::SyncEvent>("Buteo::SyncEvent");
+}
+
+SyncEventChannel::~SyncEventChannel()
+{
+    FUNCTION_CALL_TRACE;
+
+    delete [] iCells;
+    iCells = 0;
+}
+
+bool SyncEventChannel::post(const SyncEvent &aEvent)
+{
+    Cell *cell = 0;
+    int pos = loadAcquire(iEnqueuePos);
+    for (;;)
+    {
+        cell = &iCells[pos & iMask];
+        int diff = distance(pos, loadAcquire(cell->iSequence));
+        if (diff == 0)
+        {
+            if (iEnqueuePos.testAndSetOrdered(pos, advance(pos, 1)))
+            {
+                break;
+            } // no else
+        }
+        else if (diff < 0)
+        {
+            // Channel is full.
+            return false;
+        } // no else
+        pos = loadAcquire(iEnqueuePos);
+    }
+
+    cell->iEvent = aEvent;
+    storeRelease(cell->iSequence, advance(pos, 1));
+
+    // Wake up the consumer once per batch.
+    if (iWakeUpPending.testAndSetOrdered(0, 1))
+    {
+        QMetaObject::invokeMethod(this, "onWakeUp", Qt::QueuedConnection);
+    } // no else
+
+    return true;
+}
+
+int SyncEventChannel::drain()
+{
+    int count = 0;
+    SyncEvent event;
+    while (pop(event))
+    {
+        emit eventReceived(event);
+        ++count;
+    }
+
+    return count;
+}
+
+int SyncEventChannel::capacity() const
+{
+    return iMask + 1;
+}
+
+void SyncEventChannel::onWakeUp()
+{
+    // Clear the flag first, so that events posted while draining schedule a
+    // new wake up.
+    iWakeUpPending.fetchAndStoreOrdered(0);
+    drain();
+}
+
+bool SyncEventChannel::pop(SyncEvent &aEvent)
+{
+    Cell *cell = &iCells[iDequeuePos & iMask];
+    int diff = distance(advance(iDequeuePos, 1), loadAcquire(cell->iSequence));
+    if (diff < 0)
+    {
+        // Channel is empty, or the producer of the next event has not
+        // finished writing it yet.
+        return false;
+    } // no else
+
+    aEvent = cell->iEvent;
+    storeRelease(cell->iSequence, advance(iDequeuePos, iMask + 1));
+    iDequeuePos = advance(iDequeuePos, 1);
+
+    return true;
+}
@@ -0,0 +1,123 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef SYNCEVENTCHANNEL_H
+#define SYNCEVENTCHANNEL_H
+
+#include "SyncEvent.h"
+#include <QObject>
+#include <QAtomicInt>
+
+namespace Buteo {
+
+class SyncEventChannelTest;
+
+/*! \brief Lock-free channel for sync events from plug-in threads.
+ *
+ * Any number of threads can post events to the channel. Events are
+ * delivered in the thread of the channel object, in posting order, by
+ * emitting eventReceived(). The channel is a bounded ring buffer: posting
+ * does not take locks or allocate memory, and the consumer is woken up by
+ * one queued call per batch of events instead of one per event.
+ *
+ * When the ring is full post() fails and the caller should fall back to
+ * another delivery path.
+ */
+class SyncEventChannel : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    //! Default number of events the channel can hold
+    static const int DEFAULT_CAPACITY = 1024;
+
+    /*! \brief Constructor
+     *
+     * @param aCapacity Number of events the channel can hold. Rounded up to
+     *  the next power of two.
+     * @param aParent Parent object
+     */
+    explicit SyncEventChannel(int aCapacity = DEFAULT_CAPACITY, QObject *aParent = 0);
+
+    //! \brief Destructor
+    virtual ~SyncEventChannel();
+
+    /*! \brief Posts an event to the channel
+     *
+     * Can be called from any thread.
+     * @param aEvent Event to post
+     * @return True if the event was queued, false if the channel is full
+     */
+    bool post(const SyncEvent &aEvent);
+
+    /*! \brief Delivers all queued events
+     *
+     * Must be called in the thread of the channel. Normally called
+     * automatically after events have been posted.
+     * @return Number of events delivered
+     */
+    int drain();
+
+    /*! \brief Returns the capacity of the channel
+     *
+     * @return Number of events the channel can hold
+     */
+    int capacity() const;
+
+signals:
+
+    /*! \brief Emitted for each delivered event
+     *
+     * @param aEvent The event
+     */
+    void eventReceived(const Buteo::SyncEvent &aEvent);
+
+private slots:
+
+    void onWakeUp();
+
+private:
+
+    bool pop(SyncEvent &aEvent);
+
+    //! One slot of the ring buffer
+    struct Cell
+    {
+        QAtomicInt iSequence;
+        SyncEvent iEvent;
+    };
+
+    Cell *iCells;
+    int iMask;
+    QAtomicInt iEnqueuePos;
+    int iDequeuePos;
+    QAtomicInt iWakeUpPending;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class SyncEventChannelTest;
+#endif
+};
+
+}
+
+#endif // SYNCEVENTCHANNEL_H
@@ -50,8 +50,8 @@ bool SyncOnChange::enable(const QHash<QString,QList<SyncProfile*> >& aSOCStorage
     }
     if(storages.count() > aFailedStorages.count())
     {
-        QObject::connect(iStorageChangeNotifier, SIGNAL(storageChange(QString)),
-                         this, SLOT(sync(QString)));
+        QObject::connect(iStorageChangeNotifier, SIGNAL(storageChange(QString,QStringList)),
+                         this, SLOT(sync(QString,QStringList)));
     }
     return enabled;
 }
@@ -59,6 +59,7 @@ bool SyncOnChange::enable(const QHash<QString,QList<SyncProfile*> >& aSOCStorage
 void SyncOnChange::enable()
 {
     FUNCTION_CALL_TRACE;
+    iSuppressCount.clear();
     if(iStorageChangeNotifier)
     {
         QStringList aFailedStorages;
@@ -79,10 +80,62 @@ void SyncOnChange::disable()
     iStorageChangeNotifier->stopListen();
 }
 
-void SyncOnChange::disableNext()
+QStringList SyncOnChange::disable(const QStringList& aStorageNames, bool aAfterNextChange)
 {
     FUNCTION_CALL_TRACE;
-    iStorageChangeNotifier->stopListen(true);
+    QStringList storages = aStorageNames.isEmpty() ? getSOCStorageNames() : aStorageNames;
+    QStringList suppressed;
+    QStringList stopped;
+
+    for(QStringList::const_iterator storageItr = storages.constBegin();
+        storageItr != storages.constEnd(); ++storageItr)
+    {
+        if(iSOCStorageMap.contains(*storageItr))
+        {
+            suppressed << *storageItr;
+            if(iSuppressCount[*storageItr]++ == 0)
+            {
+                stopped << *storageItr;
+            }
+        }
+    }
+    LOG_DEBUG("Suppressing SOC for" << suppressed);
+    iStorageChangeNotifier->stopListen(stopped, aAfterNextChange);
+    return suppressed;
+}
+
+void SyncOnChange::enable(const QStringList& aStorageNames)
+{
+    FUNCTION_CALL_TRACE;
+    QStringList resumed;
+
+    for(QStringList::const_iterator storageItr = aStorageNames.constBegin();
+        storageItr != aStorageNames.constEnd(); ++storageItr)
+    {
+        if(iSuppressCount.contains(*storageItr) && --iSuppressCount[*storageItr] <= 0)
+        {
+            iSuppressCount.remove(*storageItr);
+            resumed << *storageItr;
+        }
+    }
+
+    if(iStorageChangeNotifier && !resumed.isEmpty())
+    {
+        LOG_DEBUG("Resuming SOC for" << resumed);
+        QStringList aFailedStorages;
+        iStorageChangeNotifier->startListen(resumed, aFailedStorages);
+        for(QStringList::const_iterator failedStorageItr = aFailedStorages.constBegin();
+            failedStorageItr != aFailedStorages.constEnd(); ++failedStorageItr)
+        {
+            cleanup(*failedStorageItr);
+        }
+        iStorageChangeNotifier->checkForChanges(resumed);
+    }
+}
+
+QString SyncOnChange::writeOrigin(const QString& aProfileName)
+{
+    return QString("buteo-syncfw:") + aProfileName;
 }
 
 void SyncOnChange::cleanup(const QString& aStorageName)
@@ -115,7 +168,7 @@ QStringList SyncOnChange::getSOCStorageNames()
     return storages;
 }
 
-void SyncOnChange::sync(QString aStorageName)
+void SyncOnChange::sync(QString aStorageName, QStringList aOrigins)
 {
     FUNCTION_CALL_TRACE;
     QList<SyncProfile*> profilesList;
@@ -127,6 +180,18 @@ void SyncOnChange::sync(QString aStorageName)
     for(QList<SyncProfile*>::iterator profileItr = profilesList.begin();
         profileItr != profilesList.end(); ++profileItr)
     {
+        const QString origin = writeOrigin((*profileItr)->name());
+        bool ownChanges = !aOrigins.isEmpty();
+        for(QStringList::const_iterator originItr = aOrigins.constBegin();
+            ownChanges && originItr != aOrigins.constEnd(); ++originItr)
+        {
+            ownChanges = (*originItr == origin);
+        }
+        if(ownChanges)
+        {
+            LOG_DEBUG("Ignoring changes written by" << (*profileItr)->name());
+            continue;
+        }
         iSOCScheduler->addProfile(*profileItr);
     }
 }
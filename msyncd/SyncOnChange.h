@@ -12,6 +12,7 @@ class SyncProfile;
 class StorageChangeNotifier;
 class PluginManager;
 class SyncOnChangeScheduler;
+class SyncOnChangeTest;
 
 /*! \brief this class initiates a sync if there are changes
  * in storage(s) it's asked to monitor
@@ -60,9 +61,38 @@ public:
      */
     void disable();
 
-    /*! \brief Note the next change, and disable SOC if that happens
+    /*! \brief Suppresses sync on change for the given storages
+     *
+     * Suppressions are counted per storage, so that storages used by
+     * several sessions stay suppressed until all of them have called
+     * enable() for the storages.
+     *
+     * @param aStorageNames Storages to suppress, all SOC storages if empty
+     * @param aAfterNextChange If true, the notifiers note the next change
+     *  before they stop, otherwise they stop immediately
+     * @return Storages that were suppressed. Pass these to enable() later.
      */
-    void disableNext();
+    QStringList disable(const QStringList& aStorageNames, bool aAfterNextChange);
+
+    /*! \brief Lifts a suppression made with disable() for the given storages
+     *
+     * Storages that are no longer suppressed by anyone start listening
+     * again, and are checked for changes made while they were suppressed.
+     *
+     * @param aStorageNames Storages returned by disable()
+     */
+    void enable(const QStringList& aStorageNames);
+
+    /*! \brief Returns the write origin token of a sync profile
+     *
+     * Storages written by a session of the profile tag their changes with
+     * this token, so that the changes do not trigger a new sync of the same
+     * profile.
+     *
+     * @param aProfileName Name of the sync profile
+     * @return Write origin token
+     */
+    static QString writeOrigin(const QString& aProfileName);
 
     /*! \brief adds a profile to the list of profiles interested in soc for a specific storage
      *
@@ -73,8 +103,12 @@ public:
 
 public Q_SLOTS:
     /*! initiate sync for this storage
+     *
+     * Profiles that wrote all of the changes themselves are skipped.
+     * @param aStorageName Name of the changed storage
+     * @param aOrigins Write origins of the changes, empty if not known
      */
-    void sync(QString aStorageName);
+    void sync(QString aStorageName, QStringList aOrigins);
 
 private:
     /*! \brief destroys profile objects interested in SOC for this
@@ -91,6 +125,11 @@ private:
     StorageChangeNotifier* iStorageChangeNotifier;
     QHash<QString,QList<SyncProfile*> > iSOCStorageMap;
     SyncOnChangeScheduler* iSOCScheduler;
+    QHash<QString,int> iSuppressCount;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class SyncOnChangeTest;
+#endif
 };
 
 }
@@ -11,6 +11,7 @@ namespace Buteo
 {
 
 class SyncProfile;
+class SyncOnChangeTest;
 
 class SyncOnChangeScheduler : public SyncScheduler
 {
@@ -63,6 +64,10 @@ private Q_SLOTS:
 
 private:
     QStringList iSOCProfileNames;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class SyncOnChangeTest;
+#endif
 };
 
 class SyncOnChangeTimer : public QObject
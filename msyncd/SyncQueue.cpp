@@ -24,6 +24,7 @@
 #include "SyncSession.h"
 #include "SyncProfile.h"
 #include "LogMacros.h"
+#include <QtAlgorithms>
 
 using namespace Buteo;
 
@@ -44,6 +45,8 @@ SyncSession *SyncQueue::dequeue()
     if (!iItems.isEmpty())
     {
         p = iItems.dequeue();
+        iBypassed.remove(p);
+        promoteWarm();
     } // no else
 
     return p;
@@ -60,6 +63,8 @@ SyncSession* SyncQueue::dequeue(const QString &aProfileName)
         {
             ret = *i;
             iItems.erase(i);
+            iBypassed.remove(ret);
+            promoteWarm();
             break;
         }
     }
@@ -110,9 +115,10 @@ bool SyncQueue::contains(const QString &aProfileName) const
 bool syncSessionPointerLessThan(SyncSession *&aLhs, SyncSession *&aRhs)
 {
     if (aLhs && aRhs) {
-        // Manual sync has higher priority than scheduled sync.
-        if (aLhs->isScheduled() != aRhs->isScheduled())
-            return !aLhs->isScheduled();
+        // Manual sync has higher priority than scheduled sync. Scheduled
+        // syncs that a manual sync is waiting for inherit its priority.
+        if (aLhs->hasManualPriority() != aRhs->hasManualPriority())
+            return aLhs->hasManualPriority();
 
         SyncProfile *lhsProfile = aLhs->profile();
         SyncProfile *rhsProfile = aRhs->profile();
@@ -133,7 +139,66 @@ void SyncQueue::sort()
 {
     FUNCTION_CALL_TRACE;
 
-    // @todo: Sort queued profiles using some criteria.
+    // Stable, so that sessions with the same priority keep their order.
+    qStableSort(iItems.begin(), iItems.end(), syncSessionPointerLessThan);
+    promoteWarm();
+}
+
+void SyncQueue::setWarmStorages(const QStringList &aStorages)
+{
+    FUNCTION_CALL_TRACE;
+
+    iWarmStorages = aStorages;
+    iWarmStorages.sort();
+    promoteWarm();
+}
+
+void SyncQueue::promoteWarm()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iWarmStorages.isEmpty() || iItems.size() < 2 ||
+        storageSet(iItems.first()) == iWarmStorages)
+    {
+        return;
+    } // no else
+
+    for (int i = 1; i < iItems.size(); ++i)
+    {
+        // Stay within the highest priority, and do not starve the sessions
+        // that have already been bypassed too often.
+        SyncSession *first = iItems.first();
+        if (syncSessionPointerLessThan(first, iItems[i]) ||
+            syncSessionPointerLessThan(iItems[i], first) ||
+            iBypassed.value(iItems[i - 1]) >= MAX_BYPASS)
+        {
+            break;
+        } // no else
+
+        if (storageSet(iItems[i]) == iWarmStorages)
+        {
+            LOG_DEBUG("Moving session" << iItems[i]->profileName() <<
+                      "to the front, storages are warm");
+            for (int j = 0; j < i; ++j)
+            {
+                iBypassed[iItems[j]]++;
+            }
+            iItems.move(i, 0);
+            break;
+        } // no else
+    }
+}
+
+QStringList SyncQueue::storageSet(SyncSession *aSession)
+{
+    QStringList storages;
+    if (aSession && aSession->profile())
+    {
+        storages = aSession->profile()->storageBackendNames();
+        storages.sort();
+    } // no else
+
+    return storages;
 }
 
 const QList<SyncSession*>& SyncQueue::getQueuedSyncSessions() const
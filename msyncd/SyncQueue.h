@@ -24,6 +24,8 @@
 #define SYNCQUEUE_H
 
 #include <QQueue>
+#include <QHash>
+#include <QStringList>
 
 namespace Buteo {
     
@@ -33,10 +35,19 @@ class SyncSession;
  *
  * The queue is sorted every time when new items are added to it, so that
  * the sync sessions with highest priority will be at the front of the queue.
+ *
+ * Among the sessions of the highest priority, a session using the same set
+ * of storage backends as the session that finished last is moved to the
+ * front, so that it can reuse the storage caches that are still warm. A
+ * session is bypassed this way at most MAX_BYPASS times.
  */
 class SyncQueue
 {
 public:
+
+    //! Maximum number of times a session can be bypassed by warm sessions
+    static const int MAX_BYPASS = 2;
+
     /*! \brief Adds a new profile to the queue. Queue is sorted automatically.
      *
      * \param aSession Session to add to queue
@@ -86,11 +97,29 @@ public:
      */
     const QList<SyncSession*>& getQueuedSyncSessions() const;
 
+    /*! \brief Sets the storage backends that were used last.
+     *
+     * A queued session of the highest priority using the same storage
+     * backends is moved to the front of the queue.
+     *
+     * \param aStorages Storage backend names of the session that finished
+     */
+    void setWarmStorages(const QStringList &aStorages);
+
 private:
 
     void sort();
 
+    void promoteWarm();
+
+    static QStringList storageSet(SyncSession *aSession);
+
     QQueue<SyncSession*> iItems;
+
+    QStringList iWarmStorages;
+
+    // Number of times a queued session has been bypassed.
+    QHash<SyncSession*, int> iBypassed;
 };
 
 }
@@ -53,6 +53,8 @@ SyncScheduler::SyncScheduler(QObject *aParent)
     if(iAlarmInventory) {
     	connect ( iAlarmInventory, SIGNAL(triggerAlarm(int)),
               this, SLOT(doAlarmActions(int)) );
+    	connect ( iAlarmInventory, SIGNAL(clockChanged(qint64)),
+              this, SIGNAL(clockChanged()) );
     	if(!iAlarmInventory->init()) {
     		LOG_WARNING("AlarmInventory Init Failed");
     	}
@@ -142,6 +144,7 @@ bool SyncScheduler::addProfile(const SyncProfile* aProfile)
 void SyncScheduler::removeProfile(const QString &aProfileName)
 {
     FUNCTION_CALL_TRACE;
+    iNextSyncTimes.remove(aProfileName);
 #ifdef USE_KEEPALIVE
     if(iBackgroundActivity->remove(aProfileName)) {
         LOG_DEBUG("Scheduled sync removed: profile =" << aProfileName);
@@ -156,10 +159,16 @@ void SyncScheduler::removeProfile(const QString &aProfileName)
 #endif
 }
 
+QMap<QString, QDateTime> SyncScheduler::nextSyncTimes() const
+{
+    return iNextSyncTimes;
+}
+
 void SyncScheduler::doIPHeartbeatActions(QString aProfileName)
 {
     FUNCTION_CALL_TRACE;
 
+    iNextSyncTimes.remove(aProfileName);
     emit syncNow(aProfileName);
 }
 
@@ -201,6 +210,7 @@ int SyncScheduler::setNextAlarm(const SyncProfile* aProfile, QDateTime aNextSync
     if (nextSyncTime.isValid()) {
         // The existing event object can be used by just updating the alarm time
         // and enqueuing it again.
+        iNextSyncTimes.insert(aProfile->name(), nextSyncTime);
         
 #ifdef USE_KEEPALIVE
         alarmEventID = 1;
@@ -219,7 +229,7 @@ int SyncScheduler::setNextAlarm(const SyncProfile* aProfile, QDateTime aNextSync
             iBackgroundActivity->removeSwitch(aProfile->name());
         }
 #else
-        iAlarmInventory->addAlarm(nextSyncTime);
+        alarmEventID = iAlarmInventory->addAlarm(nextSyncTime);
 #endif
         if (alarmEventID == 0)
         {
@@ -249,6 +259,7 @@ void SyncScheduler::doAlarmActions(int aAlarmEventID)
         if(iIPHeartBeatMan->setHeartBeat(syncProfileName, IPHB_GS_WAIT_2_5_MINS, IPHB_GS_WAIT_2_5_MINS)) {
         //Do nothing, sync will be triggered on getting heart beat
         } else {
+            iNextSyncTimes.remove(syncProfileName);
             emit syncNow(syncProfileName);
         }
     } // no else, in error cases simply ignore
@@ -93,6 +93,14 @@ public:
      */
     void removeProfile(const QString &aProfileName);
 
+    /*! \brief Returns the times of the scheduled syncs
+     *
+     * Includes retries of failed syncs. Profiles whose sync has already
+     * been triggered are not included until they are scheduled again.
+     * \return Next sync times, by profile name
+     */
+    QMap<QString, QDateTime> nextSyncTimes() const;
+
 private slots:
 
 #ifndef USE_KEEPALIVE
@@ -129,6 +137,14 @@ signals:
      */
     void syncNow(QString aProfileName);
 
+    /*! \brief Signal emitted when the wall clock has been changed
+     *
+     * Scheduled syncs wait on the monotonic clock and are not moved by the
+     * change. Profiles whose schedule depends on the time of day should be
+     * added again to follow the new wall clock time.
+     */
+    void clockChanged();
+
 private: // functions
     
     /**
@@ -161,6 +177,9 @@ private: // functions
     
 private: // data
 
+    /// Next sync times of the scheduled profiles
+    QMap<QString, QDateTime> iNextSyncTimes;
+
 #ifdef USE_KEEPALIVE
     /// BackgroundSync management object
     BackgroundSync *iBackgroundActivity;
@@ -39,6 +39,8 @@ SyncSession::SyncSession(SyncProfile *aProfile, QObject *aParent)
     iPluginRunnerOwned(false),
     iScheduled(false),
     iAborted(false),
+    iYielding(false),
+    iPriorityBoosted(false),
     iStarted(false),
     iFinished(false),
     iCreateProfile(false),
@@ -95,18 +97,33 @@ void SyncSession::setPluginRunner(PluginRunner *aPluginRunner,
         // been started already
         iStarted = true;
         // Connect signals from plug-in runner.
-        connect(iPluginRunner, SIGNAL(transferProgress(const QString &,
-            Sync::TransferDatabase, Sync::TransferType, const QString &,int)),
-            this, SLOT(onTransferProgress(const QString &, Sync::TransferDatabase,
-            Sync::TransferType, const QString &,int)));
-        connect(iPluginRunner, SIGNAL(error(const QString &, const QString &, int)),
-            this, SLOT(onError(const QString &, const QString &, int)));
-        connect(iPluginRunner, SIGNAL(success(const QString &, const QString &)),
-            this, SLOT(onSuccess(const QString &, const QString &)));
-        connect(iPluginRunner, SIGNAL(storageAccquired(const QString &)),
-            this, SLOT(onStorageAccquired(const QString &)));
-        connect(iPluginRunner,SIGNAL(syncProgressDetail(const QString &,int)),
-                this ,SLOT(onSyncProgressDetail(const QString &,int)));
+        if (iSessionId.isEmpty())
+        {
+            connect(iPluginRunner, SIGNAL(transferProgress(const QString &,
+                Sync::TransferDatabase, Sync::TransferType, const QString &,int)),
+                this, SLOT(onTransferProgress(const QString &, Sync::TransferDatabase,
+                Sync::TransferType, const QString &,int)));
+            connect(iPluginRunner, SIGNAL(error(const QString &, const QString &, int)),
+                this, SLOT(onError(const QString &, const QString &, int)));
+            connect(iPluginRunner, SIGNAL(success(const QString &, const QString &)),
+                this, SLOT(onSuccess(const QString &, const QString &)));
+            connect(iPluginRunner, SIGNAL(storageAccquired(const QString &)),
+                this, SLOT(onStorageAccquired(const QString &)));
+            connect(iPluginRunner,SIGNAL(syncProgressDetail(const QString &,int)),
+                    this ,SLOT(onSyncProgressDetail(const QString &,int)));
+        }
+        else
+        {
+            // Several peer sessions share the plug-in runner.
+            connect(iPluginRunner, SIGNAL(sessionTransferProgress(const QString &,
+                Sync::TransferDatabase, Sync::TransferType, const QString &,int)),
+                this, SLOT(onSessionTransferProgress(const QString &, Sync::TransferDatabase,
+                Sync::TransferType, const QString &,int)));
+            connect(iPluginRunner, SIGNAL(sessionError(const QString &, const QString &, int)),
+                this, SLOT(onSessionError(const QString &, const QString &, int)));
+            connect(iPluginRunner, SIGNAL(sessionSuccess(const QString &, const QString &)),
+                this, SLOT(onSessionSuccess(const QString &, const QString &)));
+        }
         connect(iPluginRunner, SIGNAL(done()), this, SLOT(onDone()));
         connect(iPluginRunner, SIGNAL(destroyed(QObject*)),
             this, SLOT(onDestroyed(QObject*)));
@@ -114,6 +131,18 @@ void SyncSession::setPluginRunner(PluginRunner *aPluginRunner,
     }
 }
 
+void SyncSession::setSessionId(const QString &aSessionId)
+{
+    FUNCTION_CALL_TRACE;
+
+    iSessionId = aSessionId;
+}
+
+QString SyncSession::sessionId() const
+{
+    return iSessionId;
+}
+
 PluginRunner *SyncSession::pluginRunner()
 {
     FUNCTION_CALL_TRACE;
@@ -198,13 +227,39 @@ void SyncSession::abort(Sync::SyncStatus aStatus)
     {
         iAborted = true;
 
-        if (iPluginRunner != 0)
+        if (iPluginRunner != 0 && !iSessionId.isEmpty())
         {
-            iPluginRunner->abort(aStatus);
+            iPluginRunner->abortSession(iSessionId, aStatus);
         }
+        else if (iPluginRunner != 0)
+        {
+            iPluginRunner->abort(aStatus);
+        } // no else
     }
 }
 
+bool SyncSession::yield()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (!iStarted || iFinished || iAborted || iYielding)
+    {
+        return iYielding;
+    } // no else
+
+    if (iPluginRunner != 0)
+    {
+        iYielding = iPluginRunner->yield();
+    } // no else
+
+    return iYielding;
+}
+
+bool SyncSession::isYielding() const
+{
+    return iYielding;
+}
+
 QMap<QString,bool> SyncSession::getStorageMap()
 {
     FUNCTION_CALL_TRACE
@@ -229,6 +284,18 @@ void SyncSession::setProfileCreated(bool aProfileCreated)
     iCreateProfile = aProfileCreated;
 }
 
+QDateTime SyncSession::profileModified() const
+{
+    FUNCTION_CALL_TRACE
+    return iProfileModified;
+}
+
+void SyncSession::setProfileModified(const QDateTime &aModified)
+{
+    FUNCTION_CALL_TRACE
+    iProfileModified = aModified;
+}
+
 void SyncSession::stop()
 {
     FUNCTION_CALL_TRACE;
@@ -285,6 +352,20 @@ bool SyncSession::isScheduled() const
     return iScheduled;
 }
 
+void SyncSession::setPriorityBoosted(bool aBoosted)
+{
+    FUNCTION_CALL_TRACE;
+
+    iPriorityBoosted = aBoosted;
+}
+
+bool SyncSession::hasManualPriority() const
+{
+    FUNCTION_CALL_TRACE;
+
+    return !iScheduled || iPriorityBoosted;
+}
+
 void SyncSession::onSuccess(const QString &aProfileName, const QString &aMessage)
 {
     FUNCTION_CALL_TRACE;
@@ -305,7 +386,7 @@ void SyncSession::onSuccess(const QString &aProfileName, const QString &aMessage
 
     if (iPluginRunner != 0)
     {
-        updateResults(iPluginRunner->syncResults());
+        updateResults(runnerResults());
     }
     emit finished(profileName(), iStatus, iMessage, iErrorCode);
 
@@ -319,13 +400,21 @@ void SyncSession::onError(const QString &aProfileName, const QString &aMessage,
     Q_UNUSED(aProfileName);
 
     iFinished = true;
-    iStatus = mapToSyncStatusError(aErrorCode);
+    if (iYielding && aErrorCode == SyncResults::YIELDED)
+    {
+        // Checkpointed on request, not a failure.
+        iStatus = Sync::SYNC_QUEUED;
+    }
+    else
+    {
+        iStatus = mapToSyncStatusError(aErrorCode);
+    }
     iMessage = aMessage;
     iErrorCode = aErrorCode;
 
     if (iPluginRunner != 0)
     {
-        updateResults(iPluginRunner->syncResults());
+        updateResults(runnerResults());
     }
     emit finished(profileName(), iStatus, iMessage, iErrorCode);
 }
@@ -373,6 +462,55 @@ void SyncSession::onSyncProgressDetail(const QString &aProfileName,int aProgress
     emit syncProgressDetail (profileName(), aProgressDetail);
 }
 
+void SyncSession::onSessionSuccess(const QString &aSessionId,
+                                   const QString &aMessage)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aSessionId == iSessionId)
+    {
+        onSuccess(profileName(), aMessage);
+    } // no else
+}
+
+void SyncSession::onSessionError(const QString &aSessionId,
+                                 const QString &aMessage, int aErrorCode)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aSessionId == iSessionId)
+    {
+        onError(profileName(), aMessage, aErrorCode);
+    } // no else
+}
+
+void SyncSession::onSessionTransferProgress(const QString &aSessionId,
+    Sync::TransferDatabase aDatabase, Sync::TransferType aType,
+    const QString &aMimeType, int aCommittedItems)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aSessionId == iSessionId)
+    {
+        emit transferProgress(profileName(), aDatabase, aType, aMimeType,
+                              aCommittedItems);
+    } // no else
+}
+
+SyncResults SyncSession::runnerResults()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iSessionId.isEmpty())
+    {
+        return iPluginRunner->syncResults();
+    }
+    else
+    {
+        return iPluginRunner->sessionResults(iSessionId);
+    }
+}
+
 void SyncSession::onDone()
 {
     FUNCTION_CALL_TRACE;
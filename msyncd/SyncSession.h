@@ -28,6 +28,7 @@
 #include "SyncResults.h"
 #include <QObject>
 #include <QMap>
+#include <QDateTime>
 
 namespace Buteo {
 
@@ -67,6 +68,22 @@ public:
      */
     void setPluginRunner(PluginRunner *aPluginRunner, bool aTransferOwnership);
 
+    /*! \brief Sets the id of the peer session this session represents
+     *
+     * Used when a server plug-in serves several peers concurrently. Must be
+     * set before the plug-in runner. The session then follows only the
+     * signals of its own peer session, and plug-in wide storage and progress
+     * detail signals are not relayed.
+     * @param aSessionId Session id given by the server plug-in
+     */
+    void setSessionId(const QString &aSessionId);
+
+    /*! \brief Gets the id of the peer session
+     *
+     * @return Session id, empty if the session uses the whole plug-in
+     */
+    QString sessionId() const;
+
     /*! \brief Gets the plug-in runner associated with this session
      *
      * @return Plug-in runner
@@ -96,6 +113,20 @@ public:
      */
     void abort(Sync::SyncStatus aStatus = Sync::SYNC_ABORTED);
 
+    /*! \brief Asks the session to checkpoint and yield its storages
+     *
+     * If the plug-in agrees, the session finishes with status
+     * Sync::SYNC_QUEUED instead of an error, and can be queued again.
+     * @return True if the session will yield
+     */
+    bool yield();
+
+    /*! \brief Checks if the session has agreed to yield
+     *
+     * @return True if yielding
+     */
+    bool isYielding() const;
+
     /*! \brief Stops the session. Returns when the session is stopped.
      */
     void stop();
@@ -132,6 +163,19 @@ public:
      */
     bool isScheduled() const;
 
+    /*! \brief Gives a scheduled session the priority of a manual sync
+     *
+     * Used when a sync requested by the user is waiting for this session.
+     * @param aBoosted True to boost the priority, false to restore it
+     */
+    void setPriorityBoosted(bool aBoosted);
+
+    /*! \brief Checks if the session runs with the priority of a manual sync
+     *
+     * @return True if the session is manual or its priority is boosted
+     */
+    bool hasManualPriority() const;
+
     /*! \brief Sets the results for this session
      *
      * This function can be used in error situations to set the results to this
@@ -181,6 +225,20 @@ public:
     //! \brief sets Profile Created flag to true
     void setProfileCreated(bool aProfileCreated);
 
+    /*! \brief Returns the modification time of the profile file when the
+     *  session profile was loaded
+     *
+     * @return Modification time, invalid if not known
+     */
+    QDateTime profileModified() const;
+
+    /*! \brief Sets the modification time of the profile file when the
+     *  session profile was loaded
+     *
+     * @param aModified Modification time
+     */
+    void setProfileModified(const QDateTime &aModified);
+
     //! \brief Maps sync failure error code from stack to SyncStatus
         Sync::SyncStatus mapToSyncStatusError(int aErrorCode);
 
@@ -218,6 +276,8 @@ private:
 
     bool tryStart();
 
+    SyncResults runnerResults();
+
 private slots:
 
     // Slots for catching plug-in runner signals.
@@ -234,6 +294,15 @@ private slots:
 
     void onSyncProgressDetail(const QString &aProfileName,int aProgressDetail);
 
+    void onSessionSuccess(const QString &aSessionId, const QString &aMessage);
+
+    void onSessionError(const QString &aSessionId, const QString &aMessage,
+                        int aErrorCode);
+
+    void onSessionTransferProgress(const QString &aSessionId,
+            Sync::TransferDatabase aDatabase, Sync::TransferType aType,
+            const QString &aMimeType, int aCommittedItems);
+
     void onDone();
 
     void onDestroyed(QObject *aPluginRunner);
@@ -248,6 +317,8 @@ private slots:
 
     PluginRunner *iPluginRunner;
 
+    QString iSessionId;
+
     SyncResults iResults;
 
     Sync::SyncStatus iStatus;
@@ -260,12 +331,18 @@ private slots:
 
     bool iAborted;
 
+    bool iYielding;
+
+    bool iPriorityBoosted;
+
     bool iStarted;
 
     bool iFinished;
 
     bool iCreateProfile;
 
+    QDateTime iProfileModified;
+
     QString iMessage;
 
     QString iRemoteId ;
@@ -0,0 +1,326 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "TaskExecutor.h"
+#include "LogMacros.h"
+
+#include <QThread>
+#include <QMetaObject>
+
+namespace Buteo {
+
+/*! \brief Worker thread of the executor, with its own task queue.
+ *
+ * The owner pushes and pops at the back of the queue, other workers steal
+ * from the front.
+ */
+class TaskExecutor::Worker : public QThread
+{
+public:
+
+    Worker(TaskExecutor &aExecutor, int aIndex)
+    :   iExecutor(aExecutor),
+        iIndex(aIndex)
+    {
+    }
+
+    void push(ExecutorTask *aTask)
+    {
+        QMutexLocker locker(&iQueueMutex);
+        iQueue.append(aTask);
+    }
+
+    ExecutorTask *popNewest()
+    {
+        QMutexLocker locker(&iQueueMutex);
+        return iQueue.isEmpty() ? 0 : iQueue.takeLast();
+    }
+
+    ExecutorTask *stealOldest()
+    {
+        QMutexLocker locker(&iQueueMutex);
+        return iQueue.isEmpty() ? 0 : iQueue.takeFirst();
+    }
+
+    QList<ExecutorTask*> takeAll()
+    {
+        QMutexLocker locker(&iQueueMutex);
+        QList<ExecutorTask*> tasks = iQueue;
+        iQueue.clear();
+        return tasks;
+    }
+
+protected:
+
+    virtual void run()
+    {
+        forever
+        {
+            ExecutorTask *task = iExecutor.take(iIndex);
+            if (task != 0)
+            {
+                task->execute();
+            }
+            else if (!iExecutor.waitForWork())
+            {
+                break;
+            } // no else
+        }
+    }
+
+private:
+
+    TaskExecutor &iExecutor;
+
+    int iIndex;
+
+    QMutex iQueueMutex;
+
+    QList<ExecutorTask*> iQueue;
+};
+
+}
+
+using namespace Buteo;
+
+ExecutorTask::ExecutorTask(QObject *aParent)
+:   QObject(aParent),
+    iFinished(false),
+    iAutoDelete(true)
+{
+}
+
+ExecutorTask::~ExecutorTask()
+{
+}
+
+bool ExecutorTask::isFinished() const
+{
+    return iFinished;
+}
+
+QVariant ExecutorTask::result() const
+{
+    return iResult;
+}
+
+void ExecutorTask::setAutoDelete(bool aAutoDelete)
+{
+    iAutoDelete = aAutoDelete;
+}
+
+bool ExecutorTask::autoDelete() const
+{
+    return iAutoDelete;
+}
+
+void ExecutorTask::runNow()
+{
+    FUNCTION_CALL_TRACE;
+
+    iResult = run();
+    onFinished();
+}
+
+void ExecutorTask::execute()
+{
+    iResult = run();
+
+    // Report completion in the thread of the task object. The event queue
+    // also publishes the result to that thread.
+    QMetaObject::invokeMethod(this, "onFinished", Qt::QueuedConnection);
+}
+
+void ExecutorTask::onFinished()
+{
+    iFinished = true;
+    emit finished();
+
+    if (iAutoDelete)
+    {
+        deleteLater();
+    } // no else
+}
+
+TaskExecutor::TaskExecutor(int aThreadCount)
+:   iPending(0),
+    iNextQueue(0),
+    iStarted(false),
+    iStopping(false)
+{
+    FUNCTION_CALL_TRACE;
+
+    int threadCount = aThreadCount;
+    if (threadCount <= 0)
+    {
+        threadCount = qBound(1, QThread::idealThreadCount(), MAX_THREADS);
+    } // no else
+
+    for (int i = 0; i < threadCount; ++i)
+    {
+        iWorkers.append(new Worker(*this, i));
+    }
+}
+
+TaskExecutor::~TaskExecutor()
+{
+    FUNCTION_CALL_TRACE;
+
+    shutdown();
+    qDeleteAll(iWorkers);
+    iWorkers.clear();
+}
+
+bool TaskExecutor::submit(ExecutorTask *aTask)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aTask == 0)
+    {
+        return false;
+    } // no else
+
+    {
+        QMutexLocker locker(&iIdleMutex);
+        if (iStopping)
+        {
+            LOG_WARNING("Executor has been shut down, task not run");
+            return false;
+        } // no else
+
+        if (!iStarted)
+        {
+            LOG_DEBUG("Starting" << iWorkers.count() << "executor threads");
+            foreach (Worker *worker, iWorkers)
+            {
+                worker->start(QThread::LowPriority);
+            }
+            iStarted = true;
+        } // no else
+    }
+
+    // Keep work created by a task on the same worker, spread the rest.
+    Worker *target = 0;
+    QThread *current = QThread::currentThread();
+    foreach (Worker *worker, iWorkers)
+    {
+        if (worker == current)
+        {
+            target = worker;
+            break;
+        } // no else
+    }
+
+    if (target == 0)
+    {
+        int next = iNextQueue.fetchAndAddRelaxed(1) & 0x7FFFFFFF;
+        target = iWorkers.at(next % iWorkers.count());
+    } // no else
+
+    target->push(aTask);
+    iPending.ref();
+
+    QMutexLocker locker(&iIdleMutex);
+    iWorkAvailable.wakeOne();
+
+    return true;
+}
+
+void TaskExecutor::shutdown()
+{
+    FUNCTION_CALL_TRACE;
+
+    {
+        QMutexLocker locker(&iIdleMutex);
+        if (iStopping)
+        {
+            return;
+        } // no else
+        iStopping = true;
+        iWorkAvailable.wakeAll();
+    }
+
+    if (!iStarted)
+    {
+        return;
+    } // no else
+
+    foreach (Worker *worker, iWorkers)
+    {
+        worker->wait();
+    }
+
+    int discarded = 0;
+    foreach (Worker *worker, iWorkers)
+    {
+        foreach (ExecutorTask *task, worker->takeAll())
+        {
+            if (task->autoDelete())
+            {
+                delete task;
+            } // no else
+            ++discarded;
+        }
+    }
+    iPending.fetchAndStoreOrdered(0);
+
+    if (discarded > 0)
+    {
+        LOG_DEBUG("Discarded" << discarded << "pending tasks");
+    } // no else
+}
+
+int TaskExecutor::threadCount() const
+{
+    return iWorkers.count();
+}
+
+ExecutorTask *TaskExecutor::take(int aIndex)
+{
+    ExecutorTask *task = iWorkers.at(aIndex)->popNewest();
+
+    for (int i = 1; task == 0 && i < iWorkers.count(); ++i)
+    {
+        task = iWorkers.at((aIndex + i) % iWorkers.count())->stealOldest();
+    }
+
+    if (task != 0)
+    {
+        iPending.deref();
+    } // no else
+
+    return task;
+}
+
+bool TaskExecutor::waitForWork()
+{
+    QMutexLocker locker(&iIdleMutex);
+
+    // Submitters count the task before taking the lock to wake a worker, so
+    // checking the count under the lock cannot miss a wake up.
+    if (!iStopping && iPending.fetchAndAddOrdered(0) <= 0)
+    {
+        iWorkAvailable.wait(&iIdleMutex);
+    } // no else
+
+    return !iStopping;
+}
@@ -0,0 +1,208 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef TASKEXECUTOR_H
+#define TASKEXECUTOR_H
+
+#include <QObject>
+#include <QVariant>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+
+namespace Buteo {
+
+class TaskExecutor;
+class TaskExecutorTest;
+
+/*! \brief A unit of background work run by TaskExecutor.
+ *
+ * Derived classes implement run(), which is called in one of the executor
+ * threads. When run() returns, finished() is emitted in the thread the task
+ * object lives in, so results can be picked up from the event loop of that
+ * thread. The task object must therefore live in a thread that runs an
+ * event loop.
+ */
+class ExecutorTask : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /*! \brief Constructor
+     *
+     * @param aParent Parent object
+     */
+    explicit ExecutorTask(QObject *aParent = 0);
+
+    //! \brief Destructor
+    virtual ~ExecutorTask();
+
+    /*! \brief Checks if the task has finished
+     *
+     * @return True if run() has completed and finished() has been emitted
+     */
+    bool isFinished() const;
+
+    /*! \brief Returns the value returned by run()
+     *
+     * @return Result, invalid until the task has finished
+     */
+    QVariant result() const;
+
+    /*! \brief Sets if the task is deleted after finished() has been emitted
+     *
+     * Tasks are deleted automatically by default.
+     * @param aAutoDelete True to delete automatically
+     */
+    void setAutoDelete(bool aAutoDelete);
+
+    /*! \brief Checks if the task is deleted automatically
+     *
+     * @return True if the task is deleted after finished()
+     */
+    bool autoDelete() const;
+
+    /*! \brief Runs the task in the calling thread
+     *
+     * finished() is emitted before this function returns. An automatically
+     * deleted task is deleted later from the event loop.
+     */
+    void runNow();
+
+signals:
+
+    //! \brief Emitted in the thread of the task when the task has finished
+    void finished();
+
+protected:
+
+    /*! \brief Does the work of the task
+     *
+     * Called in an executor thread. Must not touch objects that are not
+     * safe to use from several threads.
+     * @return Result of the task
+     */
+    virtual QVariant run() = 0;
+
+private slots:
+
+    void onFinished();
+
+private:
+
+    friend class TaskExecutor;
+
+    void execute();
+
+    QVariant iResult;
+
+    bool iFinished;
+
+    bool iAutoDelete;
+};
+
+/*! \brief Work-stealing executor for daemon background tasks.
+ *
+ * Runs CPU and IO heavy work, like profile serialization and log
+ * persistence, outside the main thread. Every worker thread has its own
+ * queue. Tasks submitted from outside the executor are spread over the
+ * queues, tasks submitted from a worker go to the queue of that worker.
+ * A worker takes the newest task from its own queue and, when it runs out
+ * of work, steals the oldest task from the queues of other workers.
+ *
+ * Worker threads are started when the first task is submitted.
+ */
+class TaskExecutor
+{
+public:
+
+    //! Maximum number of worker threads
+    static const int MAX_THREADS = 4;
+
+    /*! \brief Constructor
+     *
+     * @param aThreadCount Number of worker threads. If 0, the ideal thread
+     *  count of the device is used, limited to MAX_THREADS.
+     */
+    explicit TaskExecutor(int aThreadCount = 0);
+
+    /*! \brief Destructor
+     *
+     * Shuts the executor down.
+     */
+    ~TaskExecutor();
+
+    /*! \brief Submits a task for execution
+     *
+     * Can be called from any thread, including the worker threads.
+     * @param aTask Task to run. If the executor has been shut down, the
+     *  task is not run.
+     * @return True if the task was queued
+     */
+    bool submit(ExecutorTask *aTask);
+
+    /*! \brief Stops the worker threads
+     *
+     * Waits for the running tasks to complete. Tasks that have not been
+     * started are discarded, and deleted if they are deleted automatically.
+     */
+    void shutdown();
+
+    /*! \brief Returns the number of worker threads
+     *
+     * @return Thread count
+     */
+    int threadCount() const;
+
+private:
+
+    class Worker;
+    friend class Worker;
+
+    ExecutorTask *take(int aIndex);
+
+    bool waitForWork();
+
+    QList<Worker*> iWorkers;
+
+    QAtomicInt iPending;
+
+    QAtomicInt iNextQueue;
+
+    QMutex iIdleMutex;
+
+    QWaitCondition iWorkAvailable;
+
+    bool iStarted;
+
+    bool iStopping;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class TaskExecutorTest;
+#endif
+};
+
+}
+
+#endif // TASKEXECUTOR_H
@@ -0,0 +1,263 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "UsagePredictor.h"
+#include "SyncProfile.h"
+#include "SyncLog.h"
+#include "SyncResults.h"
+#include "ProfileEngineDefs.h"
+#include "LogMacros.h"
+
+#include <QStringList>
+#include <QtAlgorithms>
+
+using namespace Buteo;
+
+UsagePredictor::UsagePredictor(QObject *aParent)
+:   QObject(aParent)
+{
+    FUNCTION_CALL_TRACE;
+
+    iTimer.setSingleShot(true);
+    connect(&iTimer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+}
+
+UsagePredictor::~UsagePredictor()
+{
+    FUNCTION_CALL_TRACE;
+}
+
+void UsagePredictor::addProfile(const SyncProfile &aProfile)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (!aProfile.boolKey(KEY_PREFETCH))
+    {
+        removeProfile(aProfile.name());
+        return;
+    } // no else
+
+    Usage usage;
+    SyncLog *log = aProfile.log();
+    if (log != 0)
+    {
+        foreach (const SyncResults *results, log->allResults())
+        {
+            if (results != 0 && !results->isScheduled())
+            {
+                recordUse(usage, results->syncTime().toLocalTime());
+            } // no else
+        }
+    } // no else
+    usage.iLastSync = aProfile.lastSuccessfulSyncTime();
+    usage.iLastPrefetch = iUsage.value(aProfile.name()).iLastPrefetch;
+
+    iUsage.insert(aProfile.name(), usage);
+    rearm();
+}
+
+void UsagePredictor::removeProfile(const QString &aProfileName)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iUsage.remove(aProfileName) > 0)
+    {
+        rearm();
+    } // no else
+}
+
+bool UsagePredictor::isTracked(const QString &aProfileName) const
+{
+    return iUsage.contains(aProfileName);
+}
+
+QStringList UsagePredictor::trackedProfiles() const
+{
+    return iUsage.keys();
+}
+
+void UsagePredictor::recordManualSync(const QString &aProfileName,
+                                      const QDateTime &aTime)
+{
+    FUNCTION_CALL_TRACE;
+
+    QHash<QString, Usage>::iterator i = iUsage.find(aProfileName);
+    if (i != iUsage.end())
+    {
+        recordUse(*i, aTime);
+        rearm();
+    } // no else
+}
+
+void UsagePredictor::recordSync(const QString &aProfileName,
+                                const QDateTime &aTime)
+{
+    FUNCTION_CALL_TRACE;
+
+    QHash<QString, Usage>::iterator i = iUsage.find(aProfileName);
+    if (i != iUsage.end())
+    {
+        i->iLastSync = aTime;
+        rearm();
+    } // no else
+}
+
+QDateTime UsagePredictor::nextPrefetch(const QString &aProfileName) const
+{
+    FUNCTION_CALL_TRACE;
+
+    QHash<QString, Usage>::const_iterator i = iUsage.constFind(aProfileName);
+    if (i == iUsage.constEnd())
+    {
+        return QDateTime();
+    } // no else
+
+    const Usage &usage = *i;
+    const QDateTime currentTime = now();
+    const QDateTime currentSlot = QDateTime(currentTime.date(), QTime(0, 0))
+        .addSecs(slotOf(currentTime) * SLOT_MINUTES * 60);
+
+    // The current slot has already started, look at the following ones.
+    for (int slot = 1; slot <= SLOTS_PER_DAY; ++slot)
+    {
+        const QDateTime start = currentSlot.addSecs(slot * SLOT_MINUTES * 60);
+        if (!isPredicted(usage, slotOf(start), start.date()) ||
+            usage.iLastPrefetch == start)
+        {
+            continue;
+        } // no else
+
+        if (usage.iLastSync.isValid() &&
+            usage.iLastSync >= start.addSecs(-FRESH_MINUTES * 60))
+        {
+            continue;
+        } // no else
+
+        return start.addSecs(-PREFETCH_LEAD_MINUTES * 60);
+    }
+
+    return QDateTime();
+}
+
+QDateTime UsagePredictor::now() const
+{
+    return QDateTime::currentDateTime();
+}
+
+void UsagePredictor::onTimeout()
+{
+    FUNCTION_CALL_TRACE;
+
+    const QDateTime currentTime = now();
+    QStringList due;
+    QHash<QString, Usage>::iterator i;
+    for (i = iUsage.begin(); i != iUsage.end(); ++i)
+    {
+        const QDateTime prefetch = nextPrefetch(i.key());
+        if (prefetch.isValid() && prefetch <= currentTime)
+        {
+            i->iLastPrefetch = prefetch.addSecs(PREFETCH_LEAD_MINUTES * 60);
+            due.append(i.key());
+        } // no else
+    }
+
+    rearm();
+
+    foreach (const QString &profileName, due)
+    {
+        LOG_DEBUG( "Use of profile" << profileName << "predicted, prefetching" );
+        emit prefetchDue(profileName);
+    }
+}
+
+int UsagePredictor::slotOf(const QDateTime &aTime)
+{
+    const QTime time = aTime.time();
+    return (time.hour() * 60 + time.minute()) / SLOT_MINUTES;
+}
+
+void UsagePredictor::recordUse(Usage &aUsage, const QDateTime &aTime)
+{
+    if (!aTime.isValid())
+    {
+        return;
+    } // no else
+
+    QList<QDate> &days = aUsage.iDays[slotOf(aTime)];
+    const QDate date = aTime.date();
+    QList<QDate>::iterator i = qLowerBound(days.begin(), days.end(), date);
+    if (i == days.end() || *i != date)
+    {
+        days.insert(i, date);
+    } // no else
+
+    // Forget the days that are too old to matter for predictions.
+    const QDate oldest = days.last().addDays(-HISTORY_DAYS);
+    while (days.first() < oldest)
+    {
+        days.removeFirst();
+    }
+}
+
+bool UsagePredictor::isPredicted(const Usage &aUsage, int aSlot,
+                                 const QDate &aDate) const
+{
+    const QDate oldest = aDate.addDays(-HISTORY_DAYS);
+    int daysWithUse = 0;
+    foreach (const QDate &day, aUsage.iDays.at(aSlot))
+    {
+        if (day >= oldest && day < aDate)
+        {
+            ++daysWithUse;
+        } // no else
+    }
+
+    return daysWithUse >= MIN_DAYS;
+}
+
+void UsagePredictor::rearm()
+{
+    FUNCTION_CALL_TRACE;
+
+    QDateTime earliest;
+    foreach (const QString &profileName, iUsage.keys())
+    {
+        const QDateTime prefetch = nextPrefetch(profileName);
+        if (prefetch.isValid() && (!earliest.isValid() || prefetch < earliest))
+        {
+            earliest = prefetch;
+        } // no else
+    }
+
+    if (!earliest.isValid())
+    {
+        iTimer.stop();
+        return;
+    } // no else
+
+    qint64 wait = now().msecsTo(earliest);
+    if (wait < 0)
+    {
+        wait = 0;
+    } // no else
+    iTimer.start(static_cast<int>(wait));
+}
@@ -0,0 +1,193 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef USAGEPREDICTOR_H
+#define USAGEPREDICTOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QList>
+#include <QStringList>
+#include <QDate>
+#include <QDateTime>
+#include <QTimer>
+
+namespace Buteo {
+
+class SyncProfile;
+class UsagePredictorTest;
+
+/*! \brief Predicts when the user is about to need the data of a profile.
+ *
+ * The predictor learns, for profiles with the prefetch key set, at which
+ * time of day the user starts syncs manually. The day is split into half
+ * hour slots. A slot is predicted when manual syncs fell into it on at least
+ * MIN_DAYS different days of the last HISTORY_DAYS days. The history comes
+ * from the sync log of the profile and from manual sync requests made while
+ * msyncd is running.
+ *
+ * PREFETCH_LEAD_MINUTES before a predicted slot starts, prefetchDue() is
+ * emitted, unless the profile already synced successfully less than
+ * FRESH_MINUTES before the slot. The predictor only uses the clock given
+ * by now(), so tests can drive it deterministically.
+ */
+class UsagePredictor : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    //! Length of a time slot in minutes
+    static const int SLOT_MINUTES = 30;
+
+    //! Number of days of history used for the predictions
+    static const int HISTORY_DAYS = 14;
+
+    //! Days with use in a slot needed to predict use in it
+    static const int MIN_DAYS = 3;
+
+    //! Minutes before a predicted slot when the prefetch sync is started
+    static const int PREFETCH_LEAD_MINUTES = 10;
+
+    //! A sync this recent before a predicted slot makes prefetch unnecessary
+    static const int FRESH_MINUTES = 30;
+
+    /*! \brief Constructor
+     *
+     * @param aParent Parent object
+     */
+    explicit UsagePredictor(QObject *aParent = 0);
+
+    //! \brief Destructor
+    virtual ~UsagePredictor();
+
+    /*! \brief Starts or stops tracking a profile
+     *
+     * If prefetch is enabled in the profile, the usage history is rebuilt
+     * from the manual syncs in the sync log of the profile. Otherwise the
+     * profile is not tracked anymore.
+     * @param aProfile Sync profile
+     */
+    void addProfile(const SyncProfile &aProfile);
+
+    /*! \brief Stops tracking a profile
+     *
+     * @param aProfileName Name of the profile
+     */
+    void removeProfile(const QString &aProfileName);
+
+    /*! \brief Checks if a profile is tracked
+     *
+     * @param aProfileName Name of the profile
+     * @return True if prefetch is enabled for the profile
+     */
+    bool isTracked(const QString &aProfileName) const;
+
+    /*! \brief Returns the tracked profiles
+     *
+     * @return Names of the profiles with prefetch enabled
+     */
+    QStringList trackedProfiles() const;
+
+    /*! \brief Records a sync requested by the user
+     *
+     * Ignored for profiles that are not tracked.
+     * @param aProfileName Name of the profile
+     * @param aTime Time of the request
+     */
+    void recordManualSync(const QString &aProfileName, const QDateTime &aTime);
+
+    /*! \brief Records a successful sync of a profile
+     *
+     * @param aProfileName Name of the profile
+     * @param aTime Time the sync finished
+     */
+    void recordSync(const QString &aProfileName, const QDateTime &aTime);
+
+    /*! \brief Returns when the next prefetch sync of a profile is due
+     *
+     * Looks at most one day ahead.
+     * @param aProfileName Name of the profile
+     * @return Time of the prefetch, may be in the past if it is due now.
+     *  Invalid if no use of the profile is predicted.
+     */
+    QDateTime nextPrefetch(const QString &aProfileName) const;
+
+signals:
+
+    /*! \brief Emitted when a profile should be synced before predicted use
+     *
+     * @param aProfileName Name of the profile
+     */
+    void prefetchDue(const QString &aProfileName);
+
+protected:
+
+    /*! \brief Returns the current time
+     *
+     * @return Current local time
+     */
+    virtual QDateTime now() const;
+
+private slots:
+
+    void onTimeout();
+
+private:
+
+    static const int SLOTS_PER_DAY = 24 * 60 / SLOT_MINUTES;
+
+    struct Usage
+    {
+        //! Days with manual syncs, in ascending order, for each slot
+        QVector<QList<QDate> > iDays;
+
+        //! Last successful sync
+        QDateTime iLastSync;
+
+        //! Start of the slot the last prefetch was made for
+        QDateTime iLastPrefetch;
+
+        Usage() : iDays(SLOTS_PER_DAY) { }
+    };
+
+    static int slotOf(const QDateTime &aTime);
+
+    static void recordUse(Usage &aUsage, const QDateTime &aTime);
+
+    bool isPredicted(const Usage &aUsage, int aSlot, const QDate &aDate) const;
+
+    void rearm();
+
+    QHash<QString, Usage> iUsage;
+
+    QTimer iTimer;
+
+#ifdef SYNCFW_UNIT_TESTS
+    friend class UsagePredictorTest;
+#endif
+};
+
+}
+
+#endif // USAGEPREDICTOR_H
@@ -55,6 +55,13 @@ Q_DECL_EXPORT int main( int argc, char* argv[] )
         LOG_FATAL("Failed to create synchronizer");
     }
 
+    // With --idle-exit msyncd exits while idle and relies on D-Bus
+    // activation to be started again. The systemd unit must then restart
+    // it only on failure, not always.
+    if (app.arguments().contains("--idle-exit")) {
+        synchronizer->setIdleExitEnabled(true);
+    }
+
     if(!synchronizer->initialize() ) {
         delete synchronizer;
         synchronizer = 0;
@@ -42,6 +42,9 @@ QMAKE_LIBDIR_QT += ../libsyncprofile/
 
 LIBS += -L../libbuteosyncfw
 
+# clock_gettime
+LIBS += -lrt
+
 # Input
 HEADERS += ServerActivator.h \
     synchronizer.h \
@@ -64,7 +67,22 @@ HEADERS += ServerActivator.h \
     SyncSigHandler.h \
     StorageChangeNotifier.h \
     SyncOnChange.h \
-    SyncOnChangeScheduler.h
+    SyncOnChangeScheduler.h \
+    SyncEvent.h \
+    SyncEventChannel.h \
+    TaskExecutor.h \
+    SyncDependencyGraph.h \
+    SessionLimiter.h \
+    CredentialBroker.h \
+    UsagePredictor.h \
+    IdleExit.h \
+    SessionPeerCache.h \
+    StatusStream.h \
+    ReplyCache.h \
+    StorageCycleMeter.h \
+    PluginWatchdog.h \
+    LiveResults.h \
+    DeadlineTimer.h
 
 SOURCES += ServerActivator.cpp \
     synchronizer.cpp \
@@ -85,7 +103,22 @@ SOURCES += ServerActivator.cpp \
     SyncSigHandler.cpp \
     StorageChangeNotifier.cpp \
     SyncOnChange.cpp \
-    SyncOnChangeScheduler.cpp
+    SyncOnChangeScheduler.cpp \
+    SyncEvent.cpp \
+    SyncEventChannel.cpp \
+    TaskExecutor.cpp \
+    SyncDependencyGraph.cpp \
+    SessionLimiter.cpp \
+    CredentialBroker.cpp \
+    UsagePredictor.cpp \
+    IdleExit.cpp \
+    SessionPeerCache.cpp \
+    StatusStream.cpp \
+    ReplyCache.cpp \
+    StorageCycleMeter.cpp \
+    PluginWatchdog.cpp \
+    LiveResults.cpp \
+    DeadlineTimer.cpp
 
 contains(DEFINES, USE_KEEPALIVE) {
     PKGCONFIG += keepalive
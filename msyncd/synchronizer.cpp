@@ -35,10 +35,10 @@
 #include "SyncLog.h"
 #include "ClientPlugin.h"
 #include "ServerPlugin.h"
+#include "WritePacer.h"
 #include "ProfileFactory.h"
 #include "ProfileEngineDefs.h"
 #include "LogMacros.h"
-#include "BtHelper.h"
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
 #include <QDeviceInfo>
@@ -47,6 +47,7 @@
 #include <QtSystemInfo/QSystemDeviceInfo>
 #endif
 #include <QtDebug>
+#include <QDir>
 #include <fcntl.h>
 #include <termios.h>
 
@@ -55,11 +56,171 @@ using namespace Buteo;
 static const QString SYNC_DBUS_OBJECT = "/synchronizer";
 static const QString SYNC_DBUS_SERVICE = "com.meego.msyncd";
 
-static const QString BT_PROPERTIES_NAME = "Name";
-
 // Maximum time in milliseconds to wait for a thread to stop
 static const unsigned long long MAX_THREAD_STOP_WAIT_TIME = 5000;
 
+// Interval in milliseconds for saving results reported by running sessions
+static const int CHECKPOINT_INTERVAL_MS = 10000;
+
+// Background tasks for D-Bus methods. ProfileManager only works on the
+// profile files, so the tasks can use the shared instance. Profile change
+// signals emitted from a task are queued to the main thread.
+
+//! Serializes all visible sync profiles to XML
+class VisibleProfilesTask : public ExecutorTask
+{
+public:
+    VisibleProfilesTask(ProfileManager &aProfileManager)
+    :   iProfileManager(aProfileManager)
+    {
+    }
+
+protected:
+    virtual QVariant run()
+    {
+        FUNCTION_CALL_TRACE;
+        QStringList profilesAsXml;
+
+        QList<SyncProfile*> profiles = iProfileManager.allVisibleSyncProfiles();
+        foreach (SyncProfile *profile, profiles) {
+            if (profile) {
+                profilesAsXml.append(profile->toString());
+            }
+        }
+        qDeleteAll(profiles);
+
+        LOG_DEBUG("allVisibleSyncProfiles profilesAsXml"<<profilesAsXml);
+        return profilesAsXml;
+    }
+
+private:
+    ProfileManager &iProfileManager;
+};
+
+//! Serializes the sync profiles having a given key value to XML
+class ProfilesByKeyTask : public ExecutorTask
+{
+public:
+    ProfilesByKeyTask(ProfileManager &aProfileManager, const QString &aKey,
+                      const QString &aValue)
+    :   iProfileManager(aProfileManager),
+        iKey(aKey),
+        iValue(aValue)
+    {
+    }
+
+protected:
+    virtual QVariant run()
+    {
+        FUNCTION_CALL_TRACE;
+        LOG_DEBUG("syncProfile key : "<< iKey <<"Value :"<< iValue);
+        QStringList profilesAsXml;
+
+        if(!iKey.isEmpty() && !iValue.isEmpty()) {
+            QList<ProfileManager::SearchCriteria> filters;
+            ProfileManager::SearchCriteria filter;
+            filter.iType = ProfileManager::SearchCriteria::EQUAL;
+            filter.iKey = iKey;
+            filter.iValue = iValue;
+            filters.append(filter);
+            QList<SyncProfile*> profiles = iProfileManager.getSyncProfilesByData(filters);
+
+            if (profiles.size() > 0) {
+                LOG_DEBUG("Found matching profiles  :" << profiles.size());
+                foreach (SyncProfile *profile, profiles) {
+                   profilesAsXml.append(profile->toString());
+                }
+                qDeleteAll(profiles);
+            } else {
+                LOG_DEBUG("No profile found with key :" << iKey << "Value : " << iValue );
+            }
+        }
+
+        return profilesAsXml;
+    }
+
+private:
+    ProfileManager &iProfileManager;
+    QString iKey;
+    QString iValue;
+};
+
+//! Serializes the last sync results of a profile to XML
+class LastResultTask : public ExecutorTask
+{
+public:
+    LastResultTask(ProfileManager &aProfileManager, const QString &aProfileId)
+    :   iProfileManager(aProfileManager),
+        iProfileId(aProfileId)
+    {
+    }
+
+protected:
+    virtual QVariant run()
+    {
+        FUNCTION_CALL_TRACE;
+        QString lastSyncResult;
+
+        if(!iProfileId.isEmpty()) {
+            SyncProfile *profile = iProfileManager.syncProfile (iProfileId);
+            if(profile) {
+                const SyncResults * syncResults = profile->lastResults();
+                if (syncResults) {
+                    lastSyncResult = syncResults->toString();
+                    LOG_DEBUG("SyncResults found:"<<lastSyncResult);
+                }
+                else {
+                    LOG_DEBUG("SyncResults not Found!!!");
+                }
+                delete profile;
+            }
+            else {
+
+                LOG_DEBUG("No profile found with aProfileId"<<iProfileId);
+            }
+        }
+        return lastSyncResult;
+    }
+
+private:
+    ProfileManager &iProfileManager;
+    QString iProfileId;
+};
+
+//! Parses sync results from XML and appends them to the log of a profile
+class SaveResultsTask : public ExecutorTask
+{
+public:
+    SaveResultsTask(ProfileManager &aProfileManager, const QString &aProfileId,
+                    const QString &aSyncResults)
+    :   iProfileManager(aProfileManager),
+        iProfileId(aProfileId),
+        iSyncResults(aSyncResults)
+    {
+    }
+
+protected:
+    virtual QVariant run()
+    {
+        FUNCTION_CALL_TRACE;
+        QDomDocument doc;
+        bool status = false;
+        if (doc.setContent(iSyncResults, true)) {
+            Buteo::SyncResults results(doc.documentElement());
+            status = iProfileManager.saveSyncResults(iProfileId , results);
+        } else {
+            LOG_CRITICAL("Invalid Profile Xml Received from msyncd");
+        }
+
+        return status;
+    }
+
+private:
+    ProfileManager &iProfileManager;
+    QString iProfileId;
+    QString iSyncResults;
+};
+
 Synchronizer::Synchronizer( QCoreApplication* aApplication )
 :   iNetworkManager(0),
     iSyncScheduler(0),
@@ -69,8 +230,9 @@ Synchronizer::Synchronizer( QCoreApplication* aApplication )
     iAccounts(0),
     iClosing(false),
     iSOCEnabled(false),
-    iSyncUIInterface(NULL)
-
+    iSyncUIInterface(NULL),
+    iProfileService(iProfileManager),
+    iPeerCache(iProfileManager)
 {
     FUNCTION_CALL_TRACE;
 
@@ -114,9 +276,47 @@ bool Synchronizer::initialize()
             this, SLOT(slotSyncStatus(QString, int, QString, int)),
             Qt::QueuedConnection);
 
+    connect(this, SIGNAL(syncStatus(QString, int, QString, int)),
+            &iStatusStream, SLOT(publishStatus(QString, int, QString, int)));
+    connect(this, SIGNAL(transferProgress(QString, int, int, QString, int)),
+            &iStatusStream, SLOT(publishProgress(QString, int, int, QString, int)));
+
     connect(&iProfileManager ,SIGNAL(signalProfileChanged(QString,int,QString)),
             this, SIGNAL(signalProfileChanged(QString,int,QString)));
 
+    connect(&iProfileManager ,SIGNAL(signalProfileChanged(QString,int,QString)),
+            this, SLOT(updateDependencies(QString,int)));
+    loadDependencies();
+
+    connect(&iProfileManager ,SIGNAL(signalProfileChanged(QString,int,QString)),
+            this, SLOT(updateUsagePredictor(QString,int)));
+    connect(&iUsagePredictor, SIGNAL(prefetchDue(QString)),
+            this, SLOT(onPrefetchDue(QString)));
+    loadUsagePredictions();
+
+    connect(&iProfileManager ,SIGNAL(signalProfileChanged(QString,int,QString)),
+            &iPeerCache, SLOT(invalidate(QString,int,QString)));
+
+    connect(&iProfileManager ,SIGNAL(signalProfileChanged(QString,int,QString)),
+            &iReplyCache, SLOT(invalidate()));
+    QStringList profileDirs;
+    const QStringList roots = QStringList()
+            << ProfileManager::DEFAULT_PRIMARY_PROFILE_PATH
+            << ProfileManager::DEFAULT_SECONDARY_PROFILE_PATH;
+    foreach (const QString &root, roots)
+    {
+        profileDirs << root + QDir::separator() + Profile::TYPE_SYNC
+                    << root + QDir::separator() + Profile::TYPE_CLIENT
+                    << root + QDir::separator() + Profile::TYPE_SERVER
+                    << root + QDir::separator() + Profile::TYPE_STORAGE;
+    }
+    iReplyCache.watch(profileDirs);
+    iPeerCache.preload();
+
+    connect(&iEventChannel, SIGNAL(eventReceived(const Buteo::SyncEvent &)),
+            this, SLOT(onSyncEvent(const Buteo::SyncEvent &)),
+            Qt::DirectConnection);
+
     iNetworkManager = new NetworkManager(this);
     Q_ASSERT(iNetworkManager);
 
@@ -143,11 +343,16 @@ bool Synchronizer::initialize()
             Qt::QueuedConnection);
     connect(this, SIGNAL(storageReleased()),
             this, SLOT(onStorageReleased()), Qt::QueuedConnection);
+    iLimiterTimer.setSingleShot(true);
+    connect(&iLimiterTimer, SIGNAL(timeout()), this, SLOT(onLimiterTimeout()));
+    iCheckpointTimer.setInterval(CHECKPOINT_INTERVAL_MS);
+    connect(&iCheckpointTimer, SIGNAL(timeout()), this, SLOT(onCheckpoint()));
 
     startServers();
 
     // Initialize scheduler
     initializeScheduler();
+    restoreIdleState();
 
     // For Backup/restore handling
     iSyncBackup =  new SyncBackup();
@@ -189,6 +394,9 @@ bool Synchronizer::initialize()
     {
         LOG_DEBUG("No profiles interested in SOC");
     }
+
+    connect(&iIdleExit, SIGNAL(idle()), this, SLOT(onIdle()));
+    iIdleExit.reset();
     return true;
 }
 
@@ -232,6 +440,7 @@ void Synchronizer::close()
     LOG_DEBUG("Stopping msyncd");
 
     iClosing = true;
+    iIdleExit.setEnabled(false);
 
     // Stop running sessions
     if(iSOCEnabled)
@@ -258,6 +467,11 @@ void Synchronizer::close()
     delete iSyncBackup;
     iSyncBackup = 0;
 
+    // Finish running background tasks. Callers waiting for replies to
+    // discarded tasks get a D-Bus timeout.
+    iExecutor.shutdown();
+    iPendingReplies.clear();
+    iReplyCache.invalidate();
 
     // Unregister from D-Bus.
     QDBusConnection dbus = QDBusConnection::sessionBus();
@@ -278,6 +492,10 @@ bool Synchronizer::startSync(QString aProfileName)
     FUNCTION_CALL_TRACE;
 
     // Manually triggered sync.
+    if (calledFromDBus())
+    {
+        iUsagePredictor.recordManualSync(aProfileName, QDateTime::currentDateTime());
+    } // no else
     return startSync(aProfileName, false);
 }
 
@@ -348,16 +566,9 @@ bool Synchronizer::setSyncSchedule(QString aProfileId , QString aScheduleAsXml)
 
 bool Synchronizer::saveSyncResults(QString aProfileId, QString aSyncResults)
 {
-    QDomDocument doc;
-    bool status = false;
-    if (doc.setContent(aSyncResults, true)) {
-        Buteo::SyncResults results(doc.documentElement());
-        status = iProfileManager.saveSyncResults(aProfileId , results);
-    } else {
-        LOG_CRITICAL("Invalid Profile Xml Received from msyncd");
-    }
+    FUNCTION_CALL_TRACE;
 
-    return status;
+    return runTask(new SaveResultsTask(iProfileManager, aProfileId, aSyncResults)).toBool();
 }
 
 bool Synchronizer::startSync(const QString &aProfileName, bool aScheduled)
@@ -379,12 +590,24 @@ bool Synchronizer::startSync(const QString &aProfileName, bool aScheduled)
         LOG_DEBUG( "Sync already in progress" );
         return true;
     }
-    else if (iSyncQueue.contains(aProfileName))
+    else if (iSyncQueue.contains(aProfileName) ||
+             iWaitingDependents.contains(aProfileName))
     {
         LOG_DEBUG( "Sync request already in queue" );
         emit syncStatus(aProfileName, Sync::SYNC_QUEUED, "", 0);
         return true;
     }
+    else if (hasPendingPredecessor(aProfileName))
+    {
+        LOG_DEBUG( "Waiting for the profiles to run after:" << iDependencies.predecessors(aProfileName) );
+        iWaitingDependents.insert(aProfileName, aScheduled);
+        if (!aScheduled)
+        {
+            boostPredecessors(aProfileName);
+        } // no else
+        emit syncStatus(aProfileName, Sync::SYNC_QUEUED, "", 0);
+        return true;
+    }
 
     SyncProfile *profile = iProfileManager.syncProfile(aProfileName);
     if (!profile)
@@ -419,8 +642,8 @@ bool Synchronizer::startSync(const QString &aProfileName, bool aScheduled)
 
     session->setScheduled(aScheduled);
 
-    if (clientProfileActive(profile->clientProfile()->name())) {
-        LOG_DEBUG( "Sync request of the same type in progress, adding request to the sync queue" );
+    if (!admitSession(*profile)) {
+        LOG_DEBUG( "Session limit of the profile reached, adding request to the sync queue" );
         iSyncQueue.enqueue(session);
         emit syncStatus(aProfileName, Sync::SYNC_QUEUED, "", 0);
         return false;
@@ -429,33 +652,13 @@ bool Synchronizer::startSync(const QString &aProfileName, bool aScheduled)
     // @todo: Complete profile with data from account manager.
     //iAccounts->addAccountData(*profile);
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
-    QBatteryInfo iDeviceInfo;
-    QBatteryInfo::LevelStatus batteryStat = iDeviceInfo.levelStatus();
-#elif QT_VERSION >= QT_VERSION_CHECK(5, 0, 0) && QT_VERSION < QT_VERSION_CHECK(5, 2, 0)
-    QBatteryInfo iDeviceInfo;
-    QBatteryInfo::BatteryStatus batteryStat = iDeviceInfo.batteryStatus(0);
-#else
-    QtMobility::QSystemDeviceInfo iDeviceInfo;
-    QtMobility::QSystemDeviceInfo::BatteryStatus batteryStat = iDeviceInfo.batteryStatus();
-#endif
-
     if (!profile->isValid())
     {
         LOG_WARNING( "Profile is not valid" );
         session->setFailureResult(SyncResults::SYNC_RESULT_FAILED, Buteo::SyncResults::INTERNAL_ERROR);
         emit syncStatus(aProfileName, Sync::SYNC_ERROR, "Internal Error", Buteo::SyncResults::INTERNAL_ERROR);
     }
-#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
-    else if( aScheduled && ( (batteryStat == QBatteryInfo::LevelEmpty) ||
-                             (batteryStat == QBatteryInfo::LevelLow) ))
-#elif QT_VERSION >= QT_VERSION_CHECK(5, 0, 0) && QT_VERSION < QT_VERSION_CHECK(5, 2, 0)
-    else if( aScheduled && ( (batteryStat == QBatteryInfo::BatteryEmpty) ||
-                             (batteryStat == QBatteryInfo::BatteryLow) ))
-#else
-    else if( aScheduled && ( (batteryStat != QtMobility::QSystemDeviceInfo::BatteryNormal) &&
-                             (batteryStat != QtMobility::QSystemDeviceInfo::BatteryLow) ))
-#endif
+    else if( aScheduled && isLowPower() )
     {
         LOG_DEBUG( "Low power, scheduled sync aborted" );
         session->setFailureResult(SyncResults::SYNC_RESULT_FAILED, Buteo::SyncResults::LOW_BATTERY_POWER);
@@ -465,6 +668,10 @@ bool Synchronizer::startSync(const QString &aProfileName, bool aScheduled)
     {
         LOG_DEBUG( "Needed storage(s) already in use, queuing sync request" );
         iSyncQueue.enqueue(session);
+        if (!aScheduled)
+        {
+            preemptSessions(session);
+        } // no else
         emit syncStatus(aProfileName, Sync::SYNC_QUEUED, "", 0);
         success = true;
     }
@@ -517,23 +724,21 @@ bool Synchronizer::startSyncNow(SyncSession *aSession)
     }
 
     LOG_DEBUG("Disable sync on change");
-    //As sync is ongoing, disable sync on change for now, we can query later if
-    //there are changes.
+    //As sync is ongoing, disable sync on change for the storages used by the
+    //session for now, we can query later if there are changes.
     if(iSOCEnabled)
     {
-        if(profile->isSOCProfile())
-        {
-            iSyncOnChange.disable();
-        }
-        else
-        {
-            iSyncOnChange.disableNext();
-        }
+        iSOCSuppressedStorages[aSession->profileName()] =
+            iSyncOnChange.disable(profile->storageBackendNames(),
+                                  !profile->isSOCProfile());
     }
 
     iProfileManager.addRetriesInfo(profile);
 
-    PluginRunner *pluginRunner = new ClientPluginRunner(
+    // Storage writes of the session are paced by the charging state.
+    updateDeviceActivity(false);
+
+    ClientPluginRunner *pluginRunner = new ClientPluginRunner(
             clientProfile->name(), aSession->profile(), &iPluginManager, this,
             this);
     aSession->setPluginRunner(pluginRunner, true);
@@ -543,6 +748,11 @@ bool Synchronizer::startSyncNow(SyncSession *aSession)
         return false;
     }
 
+    pluginRunner->setCredentialBroker(&iCredentialBroker);
+
+    // Progress events bypass the session and reach us through the channel.
+    pluginRunner->setEventChannel(&iEventChannel, aSession->profileName());
+
     // Relay connectivity state change signal to plug-in runner.
     connect(iTransportTracker, SIGNAL(connectivityStateChanged(Sync::ConnectivityType, bool)),
             pluginRunner, SIGNAL(connectivityStateChanged(Sync::ConnectivityType, bool)));
@@ -594,6 +804,12 @@ bool Synchronizer::startSyncNow(SyncSession *aSession)
 
         LOG_DEBUG( "Sync session started" );
         iActiveSessions.insert(aSession->profileName(), aSession);
+        iSessionLimiter.sessionStarted(*profile);
+        iLiveResults.begin(aSession->profileName(), aSession->isScheduled());
+        if (!iCheckpointTimer.isActive())
+        {
+            iCheckpointTimer.start();
+        } // no else
     }
     else
     {
@@ -611,11 +827,16 @@ void Synchronizer::onSessionFinished(const QString &aProfileName,
 
     LOG_DEBUG( "Session finished:" << aProfileName << ", status:" << aStatus);
 
+    bool itemsChanged = false;
+    bool scheduled = false;
     if(iActiveSessions.contains(aProfileName))
     {
         SyncSession *session = iActiveSessions[aProfileName];
         if (session)
         {
+            itemsChanged = hasItemChanges(session->results());
+            scheduled = session->isScheduled();
+
             switch(aStatus)
             {
             case Sync::SYNC_DONE:
@@ -623,17 +844,36 @@ void Synchronizer::onSessionFinished(const QString &aProfileName,
                 QMap<QString,bool> storageMap = session->getStorageMap();
                 //session->setFailureResult(SyncResults::SYNC_RESULT_SUCCESS, Buteo::SyncResults::NO_ERROR);
                 SyncProfile *sessionProf = session->profile();
-                iProfileManager.enableStorages(*sessionProf, storageMap);
+
+                // A profile changed on disk during the session is loaded
+                // again, so that only the storages of the session are
+                // written over the changes.
+                SyncProfile *currentProf = 0;
+                QDateTime loaded = session->profileModified();
+                if (loaded.isValid() &&
+                    iProfileManager.lastModified(sessionProf->name()) != loaded)
+                {
+                    LOG_DEBUG("Profile" << sessionProf->name() << "changed during the session");
+                    currentProf = iProfileManager.syncProfile(sessionProf->name());
+                } // no else
+                SyncProfile *savedProf = (currentProf != 0) ? currentProf : sessionProf;
+                iProfileManager.enableStorages(*savedProf, storageMap);
 
                 // If caps have not been modified, i.e. fetched from the remote device yet, set
                 // enabled storages also visible. If caps have been modified, we must not touch visibility anymore
-                if (sessionProf->boolKey(KEY_CAPS_MODIFIED) == false)
+                if (savedProf->boolKey(KEY_CAPS_MODIFIED) == false)
                 {
-                    iProfileManager.setStoragesVisible(*sessionProf, storageMap);
+                    iProfileManager.setStoragesVisible(*savedProf, storageMap);
                 }
 
-                iProfileManager.updateProfile(*sessionProf);
+                if (!iSessionProfileCopies.contains(aProfileName))
+                {
+                    iProfileManager.updateProfile(*savedProf);
+                } // no else
+                delete currentProf;
+                currentProf = 0;
                 iProfileManager.retriesDone(sessionProf->name());
+                iUsagePredictor.recordSync(aProfileName, QDateTime::currentDateTime());
                 break;
             }
 
@@ -646,6 +886,10 @@ void Synchronizer::onSessionFinished(const QString &aProfileName,
                 }
                 break;
             }
+            case Sync::SYNC_QUEUED:
+                LOG_DEBUG( "Session yielded, queuing it again" );
+                break;
+
             case Sync::SYNC_ERROR:
             {
                 session->setFailureResult(SyncResults::SYNC_RESULT_FAILED, aErrorCode);
@@ -671,6 +915,25 @@ void Synchronizer::onSessionFinished(const QString &aProfileName,
             }
 
             iActiveSessions.remove(aProfileName);
+            iSessionProfileCopies.remove(aProfileName);
+            if (aStatus == Sync::SYNC_QUEUED &&
+                !iProfilesToRemove.contains(aProfileName))
+            {
+                // Yielded to a manual sync, the network session is still
+                // needed when the session is started again.
+                requeueSession(session);
+                emit syncStatus(aProfileName, aStatus, aMessage, aErrorCode);
+                while (startNextSync())
+                {
+                    //intentionally empty
+                }
+                return;
+            }
+            if (session->profile() != 0)
+            {
+                // Prefer queued sessions that can reuse the same storages.
+                iSyncQueue.setWarmStorages(session->profile()->storageBackendNames());
+            } // no else
             if(session->isScheduled())
             {
                 // Calling this multiple times has no effect, even if the
@@ -678,6 +941,12 @@ void Synchronizer::onSessionFinished(const QString &aProfileName,
                 iNetworkManager->disconnectSession();
             }
             cleanupSession(session, aStatus);
+            if (aErrorCode == SyncResults::PLUGIN_HUNG &&
+                iStorageBooker.releaseClientStorages(aProfileName) > 0)
+            {
+                // Reservations the hung plug-in made itself.
+                emit storageReleased();
+            } // no else
             if(iProfilesToRemove.contains(aProfileName))
             {
                 cleanupProfile(aProfileName);
@@ -700,17 +969,16 @@ void Synchronizer::onSessionFinished(const QString &aProfileName,
     emit syncStatus(aProfileName, aStatus, aMessage, aErrorCode);
     emit syncDone(aProfileName);
 
-    //Re-enable sync on change
-    if(iSOCEnabled)
-    {
-        iSyncOnChange.enable();
-    }
+    releaseDependents(aProfileName, aStatus == Sync::SYNC_DONE, itemsChanged,
+                      scheduled);
 
     // Try starting new sync sessions waiting in the queue.
     while (startNextSync())
     {
         //intentionally empty
     }
+
+    iIdleExit.reset();
 }
 
 void Synchronizer::onSyncProgressDetail(const QString &aProfileName,int aProgressDetail)
@@ -750,23 +1018,7 @@ bool Synchronizer::startNextSync()
     QString profileName = session->profileName();
     LOG_DEBUG( "Trying to start next sync in queue. Profile:" << profileName );
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
-    QBatteryInfo iDeviceInfo;
-    QBatteryInfo::LevelStatus batteryStat = iDeviceInfo.levelStatus();
-    if (session->isScheduled() && ((batteryStat == QBatteryInfo::LevelEmpty) ||
-                             (batteryStat == QBatteryInfo::LevelLow)))
-#elif QT_VERSION >= QT_VERSION_CHECK(5, 0, 0) && QT_VERSION < QT_VERSION_CHECK(5, 2, 0)
-    QBatteryInfo iDeviceInfo;
-    QBatteryInfo::BatteryStatus batteryStat = iDeviceInfo.batteryStatus(0);
-    if (session->isScheduled() && ((batteryStat == QBatteryInfo::BatteryEmpty) ||
-                             (batteryStat == QBatteryInfo::BatteryLow)))
-#else
-    QtMobility::QSystemDeviceInfo iDeviceInfo;
-    QtMobility::QSystemDeviceInfo::BatteryStatus batteryStat = iDeviceInfo.batteryStatus();
-
-    if (session->isScheduled() && ((batteryStat != QtMobility::QSystemDeviceInfo::BatteryNormal) &&
-                                   (batteryStat != QtMobility::QSystemDeviceInfo::BatteryLow)) )
-#endif
+    if (session->isScheduled() && isLowPower())
     {
         LOG_DEBUG( "Low power, scheduled sync aborted" );
         iSyncQueue.dequeue();
@@ -775,15 +1027,19 @@ bool Synchronizer::startNextSync()
         emit syncStatus(profileName, Sync::SYNC_ERROR, "Low Battery", Buteo::SyncResults::LOW_BATTERY_POWER);
         tryNext = true;
     }
+    else if (!admitSession(*profile)) {
+        LOG_DEBUG( "Session limit of the profile reached, wait for finish" );
+        return false;
+    }
     else if (!session->reserveStorages(&iStorageBooker))
     {
         LOG_DEBUG( "Needed storage(s) already in use" );
+        if (session->hasManualPriority())
+        {
+            preemptSessions(session);
+        } // no else
         tryNext = false;
     }
-    else if (clientProfileActive(profile->clientProfile()->name())) {
-        LOG_DEBUG( "Client profile active, wait for finish" );
-        return false;
-    }
     else
     {
         // Sync can be started now.
@@ -811,6 +1067,22 @@ void Synchronizer::cleanupSession(SyncSession *aSession, Sync::SyncStatus aStatu
     if (aSession != 0)
     {
         QString profileName = aSession->profileName();
+
+        //Re-enable sync on change for the storages used by the session
+        if(iSOCEnabled)
+        {
+            iSyncOnChange.enable(iSOCSuppressedStorages.take(profileName));
+        }
+
+        iSessionLimiter.sessionFinished(profileName);
+
+        if (!aSession->sessionId().isEmpty())
+        {
+            QMutexLocker locker(&iPeerSessionMutex);
+            QString key = iPeerSessions.key(profileName);
+            iPeerSessions.remove(key);
+        } // no else
+
         if (!profileName.isEmpty())
         {
             LOG_DEBUG("aStatus"<<aStatus);
@@ -818,10 +1090,14 @@ void Synchronizer::cleanupSession(SyncSession *aSession, Sync::SyncStatus aStatu
             if ((profile->lastResults()==0) && (aStatus == Sync::SYNC_DONE)) {
                 iProfileManager.saveRemoteTargetId(*profile, aSession->results().getTargetId());
             }
-            iProfileManager.saveSyncResults(profileName, aSession->results());
+            // Replaces the last checkpoint of the session, if any
+            QDateTime checkpointTime = iLiveResults.startTime(profileName);
+            SyncResults results = iLiveResults.finish(profileName, aSession->results());
+            addProcessUsage(aSession, results);
+            iProfileManager.saveSyncResults(profileName, results, checkpointTime);
 
             // UI needs to know that Sync Log has been updated.
-            emit resultsAvailable(profileName,aSession->results().toString());
+            emit resultsAvailable(profileName,results.toString());
 
             if ( aSession->isScheduled() )
             {
@@ -836,28 +1112,556 @@ void Synchronizer::cleanupSession(SyncSession *aSession, Sync::SyncStatus aStatu
     }
 }
 
-void Synchronizer::abortSync(QString aProfileName)
+bool Synchronizer::preemptSessions(SyncSession *aSession)
+{
+    FUNCTION_CALL_TRACE;
+
+    bool yielding = false;
+    SyncProfile *profile = aSession->profile();
+    if (profile == 0)
+    {
+        return yielding;
+    } // no else
+
+    QStringList owners;
+    foreach (const QString &storage, profile->storageBackendNames())
+    {
+        QString owner = iStorageBooker.storageOwner(storage);
+        if (!owner.isEmpty() && owner != aSession->profileName() &&
+            !owners.contains(owner))
+        {
+            owners.append(owner);
+        } // no else
+    }
+
+    foreach (const QString &owner, owners)
+    {
+        SyncSession *active = iActiveSessions.value(owner);
+        if (active == 0 || active->hasManualPriority())
+        {
+            continue;
+        } // no else
+
+        if (active->yield())
+        {
+            LOG_DEBUG( "Scheduled sync" << owner << "yields to" << aSession->profileName() );
+            yielding = true;
+        }
+        else
+        {
+            LOG_DEBUG( "Scheduled sync" << owner << "cannot yield" );
+        }
+    }
+
+    return yielding;
+}
+
+void Synchronizer::requeueSession(SyncSession *aSession)
+{
+    FUNCTION_CALL_TRACE;
+
+    QString profileName = aSession->profileName();
+    bool scheduled = aSession->isScheduled();
+
+    if (iSOCEnabled)
+    {
+        iSyncOnChange.enable(iSOCSuppressedStorages.take(profileName));
+    } // no else
+
+    iSessionLimiter.sessionFinished(profileName);
+
+    if (!aSession->sessionId().isEmpty())
+    {
+        QMutexLocker locker(&iPeerSessionMutex);
+        QString key = iPeerSessions.key(profileName);
+        iPeerSessions.remove(key);
+    } // no else
+
+    // The part synchronized before yielding replaces its last checkpoint,
+    // the session started again is logged separately.
+    aSession->setFailureResult(SyncResults::SYNC_RESULT_CANCELLED,
+                               SyncResults::YIELDED);
+    QDateTime checkpointTime = iLiveResults.startTime(profileName);
+    SyncResults results = iLiveResults.finish(profileName, aSession->results());
+    addProcessUsage(aSession, results);
+    iProfileManager.saveSyncResults(profileName, results, checkpointTime);
+
+    aSession->releaseStorages();
+    aSession->deleteLater();
+
+    // The session is started again from a fresh copy of the profile, the
+    // plug-in continues from its own checkpoint.
+    SyncProfile *profile = iProfileManager.syncProfile(profileName);
+    if (profile == 0)
+    {
+        LOG_WARNING( "Profile of the yielded session not found:" << profileName );
+        return;
+    } // no else
+
+    SyncSession *session = new SyncSession(profile, this);
+    session->setScheduled(scheduled);
+    iSyncQueue.enqueue(session);
+}
+
+void Synchronizer::addProcessUsage(SyncSession *aSession, SyncResults &aResults)
+{
+    FUNCTION_CALL_TRACE;
+
+    // A server plug-in process serves many sessions, so only client
+    // plug-in processes are accounted to a session. The runner may be gone
+    // already if the plug-in crashed, the plug-in name is in the profile.
+    SyncProfile *profile = aSession->profile();
+    const Profile *client = (profile != 0) ? profile->clientProfile() : 0;
+    PluginRunner *runner = aSession->pluginRunner();
+    if (client == 0 ||
+        (runner != 0 && runner->pluginType() != PluginRunner::PLUGIN_CLIENT))
+    {
+        return;
+    } // no else
+
+    ProcessLimits::Usage usage = iPluginManager.processUsage(client->name());
+    if (usage.valid)
+    {
+        LOG_DEBUG("Plug-in" << client->name() << "used" << usage.cpuTime <<
+                  "ms CPU time and" << usage.peakMemory << "kB memory at peak");
+        aResults.setProcessUsage(usage.cpuTime, usage.peakMemory);
+    } // no else
+}
+
+void Synchronizer::boostPredecessors(const QString &aProfileName)
+{
+    FUNCTION_CALL_TRACE;
+
+    foreach (const QString &predecessor, iDependencies.predecessors(aProfileName))
+    {
+        SyncSession *session = iSyncQueue.dequeue(predecessor);
+        if (session != 0)
+        {
+            LOG_DEBUG( "Queued sync" << predecessor << "inherits the priority of" << aProfileName );
+            session->setPriorityBoosted(true);
+            iSyncQueue.enqueue(session);
+        } // no else
+    }
+}
+
+void Synchronizer::abortSync(QString aProfileName)
+{
+    FUNCTION_CALL_TRACE;
+
+    LOG_DEBUG( "Abort sync requested for profile: " << aProfileName );
+    if (iActiveSessions.contains(aProfileName))
+    {
+        iActiveSessions[aProfileName]->abort();
+    }
+    else
+    {
+        LOG_WARNING( "No sync in progress with the given profile" );
+        // Check if sync was queued, in which case, remove it from the queue
+        SyncSession *queuedSession = iSyncQueue.dequeue(aProfileName);
+        if(queuedSession)
+        {
+            LOG_DEBUG("Removed queued sync" << aProfileName);
+            iSessionLimiter.sessionCancelled(aProfileName);
+            delete queuedSession;
+        }
+        bool waiting = (iWaitingDependents.remove(aProfileName) > 0);
+        SyncResults syncResults(QDateTime::currentDateTime(), SyncResults::SYNC_RESULT_CANCELLED, Buteo::SyncResults::ABORTED);
+        iProfileManager.saveSyncResults(aProfileName, syncResults);
+        emit syncStatus(aProfileName, Sync::SYNC_CANCELLED, "", Buteo::SyncResults::ABORTED);
+        if (waiting || queuedSession)
+        {
+            releaseDependents(aProfileName, false, false, false);
+        } // no else
+    }
+}
+
+bool Synchronizer::hasItemChanges(const SyncResults &aResults)
+{
+    foreach (const TargetResults &target, aResults.targetResults())
+    {
+        ItemCounts local = target.localItems();
+        ItemCounts remote = target.remoteItems();
+        if (local.added || local.deleted || local.modified ||
+            remote.added || remote.deleted || remote.modified)
+        {
+            return true;
+        } // no else
+    }
+
+    return false;
+}
+
+bool Synchronizer::hasPendingPredecessor(const QString &aProfileName) const
+{
+    foreach (const QString &predecessor, iDependencies.predecessors(aProfileName))
+    {
+        if (iActiveSessions.contains(predecessor) ||
+            iSyncQueue.contains(predecessor) ||
+            iWaitingDependents.contains(predecessor))
+        {
+            return true;
+        } // no else
+    }
+
+    return false;
+}
+
+void Synchronizer::releaseDependents(const QString &aProfileName, bool aSucceeded,
+                                     bool aItemsChanged, bool aScheduled)
+{
+    FUNCTION_CALL_TRACE;
+
+    foreach (const QString &dependent, iDependencies.dependents(aProfileName))
+    {
+        if (iWaitingDependents.contains(dependent))
+        {
+            if (!aSucceeded)
+            {
+                // Dependents run only after their predecessors succeed.
+                LOG_DEBUG("Cancelling" << dependent << "as" << aProfileName << "did not succeed");
+                iWaitingDependents.remove(dependent);
+                SyncResults syncResults(QDateTime::currentDateTime(), SyncResults::SYNC_RESULT_CANCELLED, Buteo::SyncResults::ABORTED);
+                iProfileManager.saveSyncResults(dependent, syncResults);
+                emit syncStatus(dependent, Sync::SYNC_CANCELLED, "", Buteo::SyncResults::ABORTED);
+                releaseDependents(dependent, false, false, false);
+            }
+            else if (!hasPendingPredecessor(dependent))
+            {
+                LOG_DEBUG("Starting waiting dependent" << dependent);
+                startSync(dependent, iWaitingDependents.take(dependent));
+            } // no else
+        }
+        else if (aSucceeded && aItemsChanged)
+        {
+            if (!iActiveSessions.contains(dependent) && !iSyncQueue.contains(dependent))
+            {
+                LOG_DEBUG("Changes in" << aProfileName << ", starting dependent" << dependent);
+                startSync(dependent, aScheduled);
+            } // no else
+        }
+        else if (aSucceeded)
+        {
+            LOG_DEBUG("Nothing changed in" << aProfileName << ", skipping dependent" << dependent);
+        } // no else
+    }
+}
+
+void Synchronizer::loadDependencies()
+{
+    FUNCTION_CALL_TRACE;
+
+    iDependencies.clear();
+    QList<SyncProfile*> profiles = iProfileManager.allSyncProfiles();
+    foreach (SyncProfile *profile, profiles)
+    {
+        iDependencies.setPredecessors(profile->name(), profile->runAfter());
+    }
+    qDeleteAll(profiles);
+}
+
+void Synchronizer::updateDependencies(QString aProfileName, int aChangeType)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aChangeType == ProfileManager::PROFILE_REMOVED)
+    {
+        iDependencies.removeProfile(aProfileName);
+    }
+    else if (aChangeType != ProfileManager::PROFILE_LOGS_MODIFIED)
+    {
+        SyncProfile *profile = iProfileManager.syncProfile(aProfileName);
+        if (profile)
+        {
+            iDependencies.setPredecessors(aProfileName, profile->runAfter());
+            delete profile;
+        } // no else
+    } // no else
+}
+
+void Synchronizer::loadUsagePredictions()
+{
+    FUNCTION_CALL_TRACE;
+
+    QList<SyncProfile*> profiles = iProfileManager.allSyncProfiles();
+    foreach (SyncProfile *profile, profiles)
+    {
+        if (profile->boolKey(KEY_PREFETCH))
+        {
+            iUsagePredictor.addProfile(*profile);
+        } // no else
+    }
+    qDeleteAll(profiles);
+}
+
+void Synchronizer::updateUsagePredictor(QString aProfileName, int aChangeType)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aChangeType == ProfileManager::PROFILE_REMOVED)
+    {
+        iUsagePredictor.removeProfile(aProfileName);
+    }
+    else if (aChangeType != ProfileManager::PROFILE_LOGS_MODIFIED)
+    {
+        SyncProfile *profile = iProfileManager.syncProfile(aProfileName);
+        if (profile)
+        {
+            iUsagePredictor.addProfile(*profile);
+            delete profile;
+        } // no else
+    } // no else
+}
+
+void Synchronizer::onPrefetchDue(const QString &aProfileName)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iActiveSessions.contains(aProfileName) ||
+        iSyncQueue.contains(aProfileName) ||
+        iWaitingDependents.contains(aProfileName) ||
+        isBackupRestoreInProgress())
+    {
+        return;
+    } // no else
+
+    if (isLowPower())
+    {
+        LOG_DEBUG( "Low power, skipping prefetch of" << aProfileName );
+        return;
+    } // no else
+
+    if (!iNetworkManager->isOnline())
+    {
+        LOG_DEBUG( "Offline, skipping prefetch of" << aProfileName );
+        return;
+    } // no else
+
+    LOG_DEBUG( "Prefetching profile" << aProfileName );
+    startScheduledSync(aProfileName);
+}
+
+void Synchronizer::setIdleExitEnabled(bool aEnabled)
+{
+    FUNCTION_CALL_TRACE;
+
+    iIdleExit.setEnabled(aEnabled);
+}
+
+bool Synchronizer::isIdle()
+{
+    FUNCTION_CALL_TRACE;
+
+    return iActiveSessions.isEmpty() && iSyncQueue.isEmpty() &&
+           iServers.isEmpty() && iWaitingOnlineSyncs.isEmpty() &&
+           iWaitingDependents.isEmpty() && iPendingReplies.isEmpty() &&
+           !iStorageBooker.hasReservations() && !iSOCEnabled &&
+           !isBackupRestoreInProgress();
+}
+
+void Synchronizer::onIdle()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (!isIdle() || iSyncScheduler == 0)
+    {
+        iIdleExit.reset();
+        return;
+    } // no else
+
+    QMap<QString, QDateTime> syncTimes = iSyncScheduler->nextSyncTimes();
+
+    // Prefetch predictions are rebuilt from the sync logs on activation,
+    // only the wakeup is needed for them.
+    QList<QDateTime> wakeups = syncTimes.values();
+    foreach (const QString &profileName, iUsagePredictor.trackedProfiles())
+    {
+        wakeups.append(iUsagePredictor.nextPrefetch(profileName));
+    }
+
+    QDateTime now = QDateTime::currentDateTime();
+    QDateTime wakeup;
+    foreach (const QDateTime &time, wakeups)
+    {
+        if (time.isValid() && (!wakeup.isValid() || time < wakeup))
+        {
+            wakeup = time;
+        } // no else
+    }
+
+    if (wakeup.isValid() && now.secsTo(wakeup) < IdleExit::MIN_SLEEP_MINUTES * 60)
+    {
+        LOG_DEBUG("Sync due at" << wakeup << ", not exiting");
+        iIdleExit.reset();
+        return;
+    } // no else
+
+    if (!iIdleExit.suspend(syncTimes, wakeup))
+    {
+        iIdleExit.reset();
+        return;
+    } // no else
+
+    LOG_DEBUG("Idle, exiting");
+    QCoreApplication::exit(0);
+}
+
+void Synchronizer::restoreIdleState()
+{
+    FUNCTION_CALL_TRACE;
+
+    QMap<QString, QDateTime> syncTimes = iIdleExit.takeState();
+    QDateTime now = QDateTime::currentDateTime();
+
+    QMapIterator<QString, QDateTime> i(syncTimes);
+    while (i.hasNext())
+    {
+        i.next();
+        SyncProfile *profile = iProfileManager.syncProfile(i.key());
+        if (profile == 0 || !profile->isEnabled())
+        {
+            delete profile;
+            continue;
+        } // no else
+
+        if (i.value() <= now)
+        {
+            LOG_DEBUG("Starting sync missed while exited:" << i.key());
+            QMetaObject::invokeMethod(this, "startScheduledSync",
+                                      Qt::QueuedConnection,
+                                      Q_ARG(QString, i.key()));
+        }
+        else
+        {
+            // Keeps also the times of retries, which are not in the profile.
+            iSyncScheduler->addProfileForSyncRetry(profile, i.value());
+        }
+        delete profile;
+    }
+}
+
+bool Synchronizer::isLowPower() const
+{
+    FUNCTION_CALL_TRACE;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    QBatteryInfo iDeviceInfo;
+    QBatteryInfo::LevelStatus batteryStat = iDeviceInfo.levelStatus();
+    return (batteryStat == QBatteryInfo::LevelEmpty) ||
+           (batteryStat == QBatteryInfo::LevelLow);
+#elif QT_VERSION >= QT_VERSION_CHECK(5, 0, 0) && QT_VERSION < QT_VERSION_CHECK(5, 2, 0)
+    QBatteryInfo iDeviceInfo;
+    QBatteryInfo::BatteryStatus batteryStat = iDeviceInfo.batteryStatus(0);
+    return (batteryStat == QBatteryInfo::BatteryEmpty) ||
+           (batteryStat == QBatteryInfo::BatteryLow);
+#else
+    QtMobility::QSystemDeviceInfo iDeviceInfo;
+    QtMobility::QSystemDeviceInfo::BatteryStatus batteryStat = iDeviceInfo.batteryStatus();
+    return (batteryStat != QtMobility::QSystemDeviceInfo::BatteryNormal) &&
+           (batteryStat != QtMobility::QSystemDeviceInfo::BatteryLow);
+#endif
+}
+
+bool Synchronizer::isCharging() const
+{
+    FUNCTION_CALL_TRACE;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    QBatteryInfo iDeviceInfo;
+    return iDeviceInfo.chargingState() == QBatteryInfo::Charging;
+#elif QT_VERSION >= QT_VERSION_CHECK(5, 0, 0) && QT_VERSION < QT_VERSION_CHECK(5, 2, 0)
+    QBatteryInfo iDeviceInfo;
+    return iDeviceInfo.chargingState(0) == QBatteryInfo::Charging;
+#else
+    QtMobility::QSystemDeviceInfo iDeviceInfo;
+    return iDeviceInfo.currentPowerState() ==
+           QtMobility::QSystemDeviceInfo::WallPowerChargingBattery;
+#endif
+}
+
+void Synchronizer::setForegroundActive(bool aActive)
+{
+    FUNCTION_CALL_TRACE;
+
+    WritePacer::Activity activity = aActive ? WritePacer::ACTIVITY_FOREGROUND :
+                                              WritePacer::ACTIVITY_IDLE;
+    bool changed = (activity != WritePacer::activity());
+    if (changed)
+    {
+        LOG_DEBUG( "Foreground activity changed:" << aActive );
+        WritePacer::setActivity(activity);
+    } // no else
+
+    updateDeviceActivity(changed);
+}
+
+void Synchronizer::updateDeviceActivity(bool aChanged)
+{
+    FUNCTION_CALL_TRACE;
+
+    bool charging = isCharging();
+    if (charging != WritePacer::isCharging())
+    {
+        WritePacer::setCharging(charging);
+        aChanged = true;
+    } // no else
+
+    if (aChanged)
+    {
+        emit deviceActivityChanged(WritePacer::activity(), charging);
+    } // no else
+}
+
+void Synchronizer::subscribeStatus(QString aListenerPath, QStringList aProfileIds,
+                                   QList<unsigned int> aAccountIds)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (!calledFromDBus())
+    {
+        return;
+    } // no else
+
+    QStringList profileNames = aProfileIds;
+    foreach (unsigned int accountId, aAccountIds)
+    {
+        QList<SyncProfile*> profiles = iProfileManager.getSyncProfilesByData(
+                QString::null, QString::null, KEY_ACCOUNT_ID,
+                QString::number(accountId));
+        foreach (SyncProfile *profile, profiles)
+        {
+            if (!profileNames.contains(profile->name()))
+            {
+                profileNames.append(profile->name());
+            } // no else
+        }
+        qDeleteAll(profiles);
+    }
+
+    iStatusStream.subscribe(message().service(), aListenerPath, profileNames);
+}
+
+void Synchronizer::unsubscribeStatus(QString aListenerPath)
 {
     FUNCTION_CALL_TRACE;
 
-    LOG_DEBUG( "Abort sync requested for profile: " << aProfileName );
-    if (iActiveSessions.contains(aProfileName))
+    if (calledFromDBus())
     {
-        iActiveSessions[aProfileName]->abort();
+        iStatusStream.unsubscribe(message().service(), aListenerPath);
+    } // no else
+}
+
+void Synchronizer::reportTargetResults(QString aProfileId, QString aTargetResults)
+{
+    FUNCTION_CALL_TRACE;
+
+    QDomDocument doc;
+    if (doc.setContent(aTargetResults, true))
+    {
+        iLiveResults.add(aProfileId, TargetResults(doc.documentElement()));
     }
     else
     {
-        LOG_WARNING( "No sync in progress with the given profile" );
-        // Check if sync was queued, in which case, remove it from the queue
-        SyncSession *queuedSession = iSyncQueue.dequeue(aProfileName);
-        if(queuedSession)
-        {
-            LOG_DEBUG("Removed queued sync" << aProfileName);
-            delete queuedSession;
-        }
-        SyncResults syncResults(QDateTime::currentDateTime(), SyncResults::SYNC_RESULT_CANCELLED, Buteo::SyncResults::ABORTED);
-        iProfileManager.saveSyncResults(aProfileName, syncResults);
-        emit syncStatus(aProfileName, Sync::SYNC_CANCELLED, "", Buteo::SyncResults::ABORTED);
+        LOG_WARNING("Invalid target results reported for" << aProfileId);
     }
 }
 
@@ -915,20 +1719,17 @@ bool Synchronizer::cleanupProfile(const QString &aProfileId)
     return status;
 }
 
-bool Synchronizer::clientProfileActive(const QString &clientProfileName)
+bool Synchronizer::admitSession(const SyncProfile &aProfile)
 {
-    QList<SyncSession*> activeSessions = iActiveSessions.values();
-    foreach(SyncSession *session, activeSessions)
+    FUNCTION_CALL_TRACE;
+
+    qint64 wait = iSessionLimiter.admit(aProfile);
+    if (wait > 0 && !iLimiterTimer.isActive())
     {
-        if(session->profile())
-        {
-            SyncProfile *profile = session->profile();
-            if (profile->clientProfile()->name() == clientProfileName) {
-                return true;
-            }
-        }
-    }
-    return false;
+        LOG_DEBUG("Retrying queued syncs in" << wait << "ms");
+        iLimiterTimer.start(static_cast<int>(wait));
+    } // no else
+    return (wait == 0);
 }
 
 bool Synchronizer::removeProfile(QString aProfileId)
@@ -1017,6 +1818,7 @@ void Synchronizer::releaseStorages(QStringList aStorageNames)
 
     iStorageBooker.releaseStorages(aStorageNames);
     emit storageReleased();
+    iIdleExit.reset();
 }
 
 QStringList Synchronizer::runningSyncs()
@@ -1037,6 +1839,34 @@ void Synchronizer::onStorageReleased()
     }
 }
 
+void Synchronizer::onLimiterTimeout()
+{
+    FUNCTION_CALL_TRACE;
+
+    while (startNextSync())
+    {
+        // Intentionally empty.
+    }
+}
+
+void Synchronizer::onCheckpoint()
+{
+    FUNCTION_CALL_TRACE;
+
+    foreach (const QString &profileName, iLiveResults.takeDirty())
+    {
+        LOG_DEBUG("Saving checkpoint of session" << profileName);
+        iProfileManager.saveSyncResults(profileName,
+                                        iLiveResults.snapshot(profileName),
+                                        iLiveResults.startTime(profileName));
+    }
+
+    if (iLiveResults.count() == 0)
+    {
+        iCheckpointTimer.stop();
+    } // no else
+}
+
 void Synchronizer::onTransferProgress( const QString &aProfileName,
         Sync::TransferDatabase aDatabase, Sync::TransferType aType,
         const QString &aMimeType, int aCommittedItems )
@@ -1061,30 +1891,150 @@ void Synchronizer::onStorageAccquired ( const QString &aProfileName,
     LOG_DEBUG( "Profile:" << aProfileName );
     if (!aProfileName.isEmpty() && !aMimeType.isEmpty()){
         SyncSession *session = qobject_cast<SyncSession*>(QObject::sender());
-        if (session){
-            QMap<QString,bool> storageMap = session->getStorageMap();
-            if (aMimeType.compare(QString("text/x-vcard"), Qt::CaseInsensitive) == 0)
-                storageMap["hcontacts"] = true;
-            else if (aMimeType.compare(QString("text/x-vcalendar"), Qt::CaseInsensitive) == 0)
-                storageMap["hcalendar"] = true;
-            else if (aMimeType.compare(QString("text/plain"), Qt::CaseInsensitive) == 0)
-                storageMap["hnotes"] = true;
-            #ifdef BM_SYNC
-            else if (aMimeType.compare(QString("text/x-vbookmark"), Qt::CaseInsensitive) == 0)
-                storageMap["hbookmarks"] = true;
-            #endif
-            #ifdef SMS_SYNC
-            else if (aMimeType.compare(QString("text/x-vmsg"), Qt::CaseInsensitive) == 0)
-                storageMap["hsms"] = true;
-            #endif
-            else
-                LOG_DEBUG( "Unsupported mime type" << aMimeType );
+        updateStorageMap(session, aMimeType);
+    }
+}
 
-            session->setStorageMap(storageMap);
+void Synchronizer::updateStorageMap(SyncSession *aSession, const QString &aMimeType)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aSession){
+        QMap<QString,bool> storageMap = aSession->getStorageMap();
+        if (aMimeType.compare(QString("text/x-vcard"), Qt::CaseInsensitive) == 0)
+            storageMap["hcontacts"] = true;
+        else if (aMimeType.compare(QString("text/x-vcalendar"), Qt::CaseInsensitive) == 0)
+            storageMap["hcalendar"] = true;
+        else if (aMimeType.compare(QString("text/plain"), Qt::CaseInsensitive) == 0)
+            storageMap["hnotes"] = true;
+        #ifdef BM_SYNC
+        else if (aMimeType.compare(QString("text/x-vbookmark"), Qt::CaseInsensitive) == 0)
+            storageMap["hbookmarks"] = true;
+        #endif
+        #ifdef SMS_SYNC
+        else if (aMimeType.compare(QString("text/x-vmsg"), Qt::CaseInsensitive) == 0)
+            storageMap["hsms"] = true;
+        #endif
+        else
+            LOG_DEBUG( "Unsupported mime type" << aMimeType );
+
+        aSession->setStorageMap(storageMap);
+    }
+}
+
+void Synchronizer::onSyncEvent(const SyncEvent &aEvent)
+{
+    const QString profileName = SyncEventAtoms::string(aEvent.profile);
+
+    switch (aEvent.type)
+    {
+        case SyncEvent::TRANSFER_PROGRESS:
+            onTransferProgress(profileName,
+                static_cast<Sync::TransferDatabase>(aEvent.database),
+                static_cast<Sync::TransferType>(aEvent.transferType),
+                SyncEventAtoms::string(aEvent.mimeType), aEvent.value);
+            break;
+        case SyncEvent::PROGRESS_DETAIL:
+            onSyncProgressDetail(profileName, aEvent.value);
+            break;
+        case SyncEvent::STORAGE_ACQUIRED:
+        {
+            const QString mimeType = SyncEventAtoms::string(aEvent.mimeType);
+            LOG_DEBUG( "Mime type:" << mimeType );
+            LOG_DEBUG( "Profile:" << profileName );
+            if (!mimeType.isEmpty())
+            {
+                updateStorageMap(iActiveSessions.value(profileName), mimeType);
+            } // no else
+            break;
         }
+        default:
+            LOG_WARNING( "Unknown sync event" << aEvent.type );
+            break;
     }
 }
 
+QVariant Synchronizer::runTask(ExecutorTask *aTask)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (calledFromDBus())
+    {
+        QDBusMessage call = message();
+        setDelayedReply(true);
+        connect(aTask, SIGNAL(finished()), this, SLOT(onTaskFinished()));
+        iPendingReplies.insert(aTask, call);
+        if (iExecutor.submit(aTask))
+        {
+            return QVariant();
+        } // no else
+
+        // Executor is not available, reply right away.
+        iPendingReplies.remove(aTask);
+        disconnect(aTask, SIGNAL(finished()), this, SLOT(onTaskFinished()));
+        setDelayedReply(false);
+    } // no else
+
+    aTask->runNow();
+    return aTask->result();
+}
+
+QVariant Synchronizer::runQuery(const QString &aKey, ExecutorTask *aTask)
+{
+    FUNCTION_CALL_TRACE;
+
+    QVariant reply;
+    if (iReplyCache.lookup(aKey, reply))
+    {
+        delete aTask;
+        return reply;
+    } // no else
+
+    ExecutorTask *running = iReplyCache.runningQuery(aKey);
+    if (running != 0 && calledFromDBus())
+    {
+        // Share the result of the identical query being computed.
+        setDelayedReply(true);
+        iPendingReplies.insert(running, message());
+        delete aTask;
+        return QVariant();
+    } // no else
+
+    iReplyCache.queryStarted(aKey, aTask);
+    reply = runTask(aTask);
+    if (!iPendingReplies.contains(aTask))
+    {
+        // Task was run synchronously, it is deleted later.
+        iReplyCache.queryFinished(aTask, reply);
+    } // no else
+
+    return reply;
+}
+
+void Synchronizer::onTaskFinished()
+{
+    FUNCTION_CALL_TRACE;
+
+    ExecutorTask *task = qobject_cast<ExecutorTask*>(sender());
+    if (task && iPendingReplies.contains(task))
+    {
+        iReplyCache.queryFinished(task, task->result());
+
+        QList<QDBusMessage> calls = iPendingReplies.values(task);
+        iPendingReplies.remove(task);
+        foreach (const QDBusMessage &call, calls)
+        {
+            QDBusMessage reply = call.createReply(task->result());
+            if (!QDBusConnection::sessionBus().send(reply))
+            {
+                LOG_WARNING("Failed to send D-Bus reply");
+            } // no else
+        }
+    } // no else
+
+    iIdleExit.reset();
+}
+
 bool Synchronizer::requestStorage(const QString &aStorageName,
         const SyncPluginBase *aCaller)
 {
@@ -1094,6 +2044,28 @@ bool Synchronizer::requestStorage(const QString &aStorageName,
             aCaller->getProfileName());
 }
 
+bool Synchronizer::requestSessionStorage(const QString &aStorageName,
+        const SyncPluginBase *aCaller, const QString &aSessionId)
+{
+    FUNCTION_CALL_TRACE;
+
+    // Storages are booked to the session, so that concurrent peer sessions
+    // of one plug-in cannot use the same storage.
+    QString owner;
+    {
+        QMutexLocker locker(&iPeerSessionMutex);
+        owner = iPeerSessions.value(aCaller->getProfileName() + "/" + aSessionId);
+    }
+
+    if (owner.isEmpty())
+    {
+        LOG_WARNING("Unknown peer session" << aSessionId);
+        return false;
+    } // no else
+
+    return iStorageBooker.reserveStorage(aStorageName, owner);
+}
+
 void Synchronizer::releaseStorage(const QString &aStorageName,
         const SyncPluginBase */*aCaller*/)
 {
@@ -1113,6 +2085,14 @@ StoragePlugin* Synchronizer::createStorage(const QString &aPluginName)
         plugin = iPluginManager.createStorage(aPluginName);
     } // no else
 
+    // Tag the writes of the session that has reserved the storage, so that
+    // they do not trigger sync on change for the same profile.
+    QString owner = iStorageBooker.storageOwner(aPluginName);
+    if (plugin && !owner.isEmpty())
+    {
+        plugin->setWriteOrigin(SyncOnChange::writeOrigin(owner));
+    } // no else
+
     return plugin;
 }
 
@@ -1123,6 +2103,8 @@ void Synchronizer::initializeScheduler()
         iSyncScheduler = new SyncScheduler(this);
         connect(iSyncScheduler, SIGNAL(syncNow(QString)),
                 this, SLOT(startScheduledSync(QString)), Qt::QueuedConnection);
+        connect(iSyncScheduler, SIGNAL(clockChanged()),
+                this, SLOT(onClockChanged()), Qt::QueuedConnection);
         QList<SyncProfile*> profiles = iProfileManager.allSyncProfiles();
         foreach (SyncProfile *profile, profiles)
         {
@@ -1139,6 +2121,10 @@ void Synchronizer::destroyStorage(StoragePlugin *aStorage)
 {
     FUNCTION_CALL_TRACE;
 
+    if (aStorage != 0)
+    {
+        iStorageCycles.cycleCompleted(aStorage->getPluginName());
+    } // no else
     iPluginManager.destroyStorage(aStorage);
 }
 
@@ -1280,6 +2266,8 @@ void Synchronizer::startServer(const QString &aProfileName)
 
     connect(pluginRunner, SIGNAL(newSession(const QString &)),
             this, SLOT(onNewSession(const QString &)));
+    connect(pluginRunner, SIGNAL(newPeerSession(const QString &, const QString &)),
+            this, SLOT(onNewPeerSession(const QString &, const QString &)));
 
     if (!pluginRunner->init() || !pluginRunner->start())
     {
@@ -1348,69 +2336,93 @@ void Synchronizer::onServerDone()
         pluginRunner->deleteLater();
         pluginRunner = 0;
     }
+
+    iIdleExit.reset();
 }
 
-bool syncProfilePointerLessThan(SyncProfile *&aLhs, SyncProfile *&aRhs)
+void Synchronizer::onNewSession(const QString &aDestination)
 {
-    if (aLhs && aRhs) {
-        if (aLhs->isHidden() != aRhs->isHidden())
-            return !aLhs->isHidden();
-        if (aLhs->isEnabled() != aRhs->isEnabled())
-            return aLhs->isEnabled();
-    }
+    FUNCTION_CALL_TRACE;
 
-    return false;
+    LOG_DEBUG("New session from" << aDestination);
+    startServerSession(qobject_cast<ServerPluginRunner*>(QObject::sender()),
+                       aDestination, QString());
 }
 
-void Synchronizer::onNewSession(const QString &aDestination)
+void Synchronizer::onNewPeerSession(const QString &aDestination,
+                                    const QString &aSessionId)
+{
+    FUNCTION_CALL_TRACE;
+
+    LOG_DEBUG("New peer session" << aSessionId << "from" << aDestination);
+    startServerSession(qobject_cast<ServerPluginRunner*>(QObject::sender()),
+                       aDestination, aSessionId);
+}
+
+void Synchronizer::startServerSession(ServerPluginRunner *aPluginRunner,
+                                      const QString &aDestination,
+                                      const QString &aSessionId)
 {
     FUNCTION_CALL_TRACE;
 
-    LOG_DEBUG("New session from" << aDestination);
     bool createNewProfile = false;
-    ServerPluginRunner *pluginRunner =
-            qobject_cast<ServerPluginRunner*>(QObject::sender());
+    ServerPluginRunner *pluginRunner = aPluginRunner;
     if (pluginRunner != 0)
     {
-        SyncProfile *profile = 0;
-        QList<SyncProfile*> syncProfiles;
-        BtHelper btHelp(aDestination);
-        QMap <QString , QVariant> mapVal = btHelp.getDeviceProperties();
-        uint classType = mapVal.value("Class").toInt();
-        uint computerclass = 0x100; //Major Device Class - Computer
-
-        if(aDestination.contains("USB") || classType & computerclass)
+        bool temporary = false;
+        SyncProfile *profile = iPeerCache.sessionProfile(aDestination,
+                temporary, createNewProfile);
+        if (profile == 0)
         {
-            syncProfiles = iProfileManager.getSyncProfilesByData(
-                    QString::null, QString::null, KEY_DISPLAY_NAME, PC_SYNC);
-        }
-        else
+            LOG_WARNING("No profile for session from" << aDestination);
+            if (!aSessionId.isEmpty())
+            {
+                pluginRunner->abortSession(aSessionId, Sync::SYNC_ERROR);
+            } // no else
+            return;
+        } // no else
+
+        if (!aSessionId.isEmpty() && iActiveSessions.contains(profile->name()))
         {
-            syncProfiles = iProfileManager.getSyncProfilesByData(
-                    QString::null, Profile::TYPE_SYNC, KEY_BT_ADDRESS, aDestination);
+            if (!temporary)
+            {
+                // A stored profile syncs with one peer at a time.
+                LOG_WARNING("Profile" << profile->name() << "is already syncing");
+                delete profile;
+                pluginRunner->abortSession(aSessionId, Sync::SYNC_ERROR);
+                return;
+            } // no else
+
+            // Concurrent peers sharing a template get their own session name.
+            // The renamed copy only lives for the session, it is not saved.
+            QStringList keys;
+            keys << profile->name() << aSessionId;
+            profile->setName(keys);
+            createNewProfile = false;
+            iSessionProfileCopies.insert(profile->name());
         } // no else
-        if (syncProfiles.isEmpty())
+
+        if (temporary)
         {
             LOG_DEBUG( "No sync profiles found with a matching destination address" );
-            // destination a bt address
-            profile = iProfileManager.createTempSyncProfile(aDestination, createNewProfile);
-            profile->setKey(Buteo::KEY_UUID, iUUID);
-            profile->setKey(Buteo::KEY_REMOTE_NAME, iRemoteName);
+            // iUUID is the value last handed out by getValue(), which belongs
+            // to this session only if the plug-in runs one session at a time.
+            QString uuid = iUUID;
+            if (!aSessionId.isEmpty() || uuid.isEmpty())
+            {
+                uuid = QUuid::createUuid().toString();
+                uuid = uuid.remove(QRegExp("[{}]"));
+            } // no else
+            profile->setKey(Buteo::KEY_UUID, uuid);
+            profile->setKey(Buteo::KEY_REMOTE_NAME, iPeerCache.peerName(aDestination));
             if(createNewProfile) {
                 iProfileManager.updateProfile(*profile);
             }
         }
         else
         {
-            // Sort profiles to preference order. Visible and enabled are preferred.
-            qSort(syncProfiles.begin(), syncProfiles.end(), syncProfilePointerLessThan);
-
-            profile = syncProfiles.first();
-            LOG_DEBUG( "Found" << syncProfiles.count() << "sync profiles with a "
-                    "matching destination address. Selecting" <<
-                    profile->name());
-            syncProfiles.removeFirst();
-            qDeleteAll(syncProfiles);
+            LOG_DEBUG( "Selected profile" << profile->name() <<
+                    "for session from" << aDestination );
         }
         // If the profile is not hidden, UI must be informed.
         if(!profile->isHidden())
@@ -1444,14 +2456,19 @@ void Synchronizer::onNewSession(const QString &aDestination)
         if (session != 0)
         {
             LOG_DEBUG("Disable sync on change");
-            //As sync is ongoing, disable sync on change for now, we can query later if
-            //there are changes.
+            //As sync is ongoing, disable sync on change for the storages used by
+            //the session for now, we can query later if there are changes.
             if(iSOCEnabled)
             {
-                iSyncOnChange.disableNext();
+                iSOCSuppressedStorages[profile->name()] =
+                    iSyncOnChange.disable(profile->storageBackendNames(), true);
             }
 
             session->setProfileCreated(createNewProfile);
+            if (!temporary)
+            {
+                session->setProfileModified(iProfileManager.lastModified(profile->name()));
+            } // no else
             // disable all storages
             // @todo : Can we remove hardcoding of the storageNames ???
             QMap<QString,bool> storageMap;
@@ -1467,7 +2484,16 @@ void Synchronizer::onNewSession(const QString &aDestination)
 
             session->setStorageMap(storageMap);
 
+            if (!aSessionId.isEmpty())
+            {
+                session->setSessionId(aSessionId);
+                QMutexLocker locker(&iPeerSessionMutex);
+                iPeerSessions.insert(pluginRunner->plugin()->getProfileName() +
+                                     "/" + aSessionId, profile->name());
+            } // no else
+
             iActiveSessions.insert(profile->name(), session);
+            iSessionLimiter.sessionStarted(*profile, false);
 
             // Connect signals from sync session.
             connect(session, SIGNAL(transferProgress(const QString &,
@@ -1525,6 +2551,31 @@ void Synchronizer::reschedule(const QString &aProfileName)
     }
 }
 
+void Synchronizer::onClockChanged()
+{
+    FUNCTION_CALL_TRACE;
+
+    if (iSyncScheduler == 0)
+        return;
+
+    foreach (const QString &profileName, iSyncScheduler->nextSyncTimes().keys())
+    {
+        SyncProfile *profile = iProfileManager.syncProfile(profileName);
+        if (profile)
+        {
+            SyncSchedule schedule = profile->syncSchedule();
+            if ((schedule.time().isValid() && !schedule.days().isEmpty()) ||
+                schedule.rushEnabled())
+            {
+                LOG_DEBUG("Clock changed, rescheduling" << profileName);
+                reschedule(profileName);
+            } // no else
+            delete profile;
+            profile = NULL;
+        } // no else
+    }
+}
+
 void Synchronizer::slotSyncStatus(QString aProfileName, int aStatus, QString /*aMessage*/, int /*aMoreDetails*/)
 {
     FUNCTION_CALL_TRACE;
@@ -1768,47 +2819,17 @@ QList<unsigned int> Synchronizer::syncingAccounts()
 QString Synchronizer::getLastSyncResult(const QString &aProfileId)
 {
     FUNCTION_CALL_TRACE;
-    QString lastSyncResult;
-
-    if(!aProfileId.isEmpty()) {
-        SyncProfile *profile = iProfileManager.syncProfile (aProfileId);
-        if(profile) {
-            const SyncResults * syncResults = profile->lastResults();
-            if (syncResults) {
-                lastSyncResult = syncResults->toString();
-                LOG_DEBUG("SyncResults found:"<<lastSyncResult);
-            }
-            else {
-                LOG_DEBUG("SyncResults not Found!!!");
-            }
-            delete profile;
-        }
-        else {
 
-            LOG_DEBUG("No profile found with aProfileId"<<aProfileId);
-        }
-    }
-    return lastSyncResult;
+    return runQuery(ReplyCache::key("getLastSyncResult", QStringList() << aProfileId),
+                    new LastResultTask(iProfileManager, aProfileId)).toString();
 }
 
 QStringList Synchronizer::allVisibleSyncProfiles()
 {
     FUNCTION_CALL_TRACE;
-    QStringList profilesAsXml;
 
-    QList<Buteo::SyncProfile *> profiles = iProfileManager.allVisibleSyncProfiles();
-
-    if(!profiles.isEmpty()) {
-        foreach(Buteo::SyncProfile *profile , profiles) {
-            if(profile) {
-                profilesAsXml.append(profile->toString());
-                delete profile;
-                profile = NULL;
-            }
-        }
-    }
-    LOG_DEBUG("allVisibleSyncProfiles profilesAsXml"<<profilesAsXml);
-    return profilesAsXml;
+    return runQuery(ReplyCache::key("allVisibleSyncProfiles"),
+                    new VisibleProfilesTask(iProfileManager)).toStringList();
 }
 
 
@@ -1836,37 +2857,25 @@ QString Synchronizer::syncProfile(const QString &aProfileId)
 QStringList Synchronizer::syncProfilesByKey(const QString &aKey, const QString &aValue)
 {
     FUNCTION_CALL_TRACE;
-    LOG_DEBUG("syncProfile key : "<< aKey <<"Value :"<< aValue);
-    QStringList profilesAsXml;
-
-    if(!aKey.isEmpty() && !aValue.isEmpty()) {
-        QList<ProfileManager::SearchCriteria> filters;
-        ProfileManager::SearchCriteria filter;
-        filter.iType = ProfileManager::SearchCriteria::EQUAL;
-        filter.iKey = aKey;
-        filter.iValue = aValue;
-        filters.append(filter);
-        QList<SyncProfile*> profiles = iProfileManager.getSyncProfilesByData(filters);
-
-        if (profiles.size() > 0) {
-            LOG_DEBUG("Found matching profiles  :" << profiles.size());
-            foreach (SyncProfile *profile, profiles) {
-               profilesAsXml.append(profile->toString());
-            }
-            qDeleteAll(profiles);
-        } else {
-            LOG_DEBUG("No profile found with key :" << aKey << "Value : " << aValue );
-        }
-    }
 
-    return profilesAsXml;
+    return runQuery(ReplyCache::key("syncProfilesByKey", QStringList() << aKey << aValue),
+                    new ProfilesByKeyTask(iProfileManager, aKey, aValue)).toStringList();
 }
 
 QStringList Synchronizer::syncProfilesByType(const QString &aType)
 {
     FUNCTION_CALL_TRACE;
     LOG_DEBUG("Profile Type : "<< aType);
-    return iProfileManager.profileNames(aType);
+
+    QString key = ReplyCache::key("syncProfilesByType", QStringList() << aType);
+    QVariant reply;
+    if (!iReplyCache.lookup(key, reply))
+    {
+        reply = iProfileManager.profileNames(aType);
+        iReplyCache.insert(key, reply);
+    } // no else
+
+    return reply.toStringList();
 }
 
 void Synchronizer::onNetworkStateChanged(bool aState)
@@ -1896,35 +2905,14 @@ void Synchronizer::onNetworkStateChanged(bool aState)
 Profile* Synchronizer::getSyncProfileByRemoteAddress(const QString& aAddress)
 {
     FUNCTION_CALL_TRACE;
-    Profile* profile = 0;
-    QList<SyncProfile*> profiles;
-    if("USB" == aAddress)
-    {
-        profiles = iProfileManager.getSyncProfilesByData(
-                QString::null, QString::null, KEY_DISPLAY_NAME, PC_SYNC);
-    }
-    else
-    {
-        BtHelper btHelp(aAddress);
-        QMap <QString , QVariant> mapVal = btHelp.getDeviceProperties();
-        uint classType = mapVal.value("Class").toInt();
-        uint computerclass = 0x100; //Major Device Class - Computer
-        if(classType & computerclass)
-        {
-            profiles = iProfileManager.getSyncProfilesByData(
-                    QString::null, QString::null, KEY_DISPLAY_NAME, PC_SYNC);
-        }
-        else
-        {
-            profiles = iProfileManager.getSyncProfilesByData("",
-                                          Buteo::Profile::TYPE_SYNC,
-                                          Buteo::KEY_BT_ADDRESS,
-                                          aAddress);
-        }
-    }
-    if(!profiles.isEmpty())
+    bool temporary = false;
+    bool save = false;
+    SyncProfile* profile = iPeerCache.sessionProfile(aAddress, temporary, save);
+    if(temporary)
     {
-        profile = profiles.first();
+        // Only stored profiles are reported.
+        delete profile;
+        profile = 0;
     }
     return profile;
 }
@@ -1942,26 +2930,26 @@ QString Synchronizer::getValue(const QString& aAddress, const QString& aKey)
 
     if(Buteo::KEY_REMOTE_NAME == aKey)
     {
-        if("USB" == aAddress)
-        {
-            iRemoteName = PC_SYNC;
-        }
-        else
-        {
-            BtHelper btHelper(aAddress);
-            QMap <QString , QVariant> mapVal = btHelper.getDeviceProperties();
-            uint classType = mapVal.value("Class").toInt();
-            uint computerclass = 0x100; //Major Device Class - Computer
-            if(classType & computerclass)
-            {
-                iRemoteName = PC_SYNC;
-            }
-            else
-            {
-                iRemoteName = btHelper.getDeviceProperties().value(BT_PROPERTIES_NAME).toString();
-            }
-        }
+        iRemoteName = iPeerCache.peerName(aAddress);
         value = iRemoteName;
     }
     return value;
 }
+
+ProfileService* Synchronizer::profileService()
+{
+    FUNCTION_CALL_TRACE;
+
+    return &iProfileService;
+}
+
+void Synchronizer::reportTargetResults(const SyncPluginBase *aCaller,
+                                       const TargetResults &aDelta)
+{
+    FUNCTION_CALL_TRACE;
+
+    if (aCaller)
+    {
+        iLiveResults.add(aCaller->getProfileName(), aDelta);
+    } // no else
+}
@@ -30,9 +30,22 @@
 #include "SyncBackup.h"
 #include "SyncOnChange.h"
 #include "SyncOnChangeScheduler.h"
+#include "SyncEventChannel.h"
+#include "TaskExecutor.h"
+#include "SyncDependencyGraph.h"
+#include "SessionLimiter.h"
+#include "CredentialBroker.h"
+#include "UsagePredictor.h"
+#include "IdleExit.h"
+#include "SessionPeerCache.h"
+#include "StatusStream.h"
+#include "ReplyCache.h"
+#include "StorageCycleMeter.h"
+#include "LiveResults.h"
 
 #include "SyncCommonDefs.h"
 #include "ProfileManager.h"
+#include "ProfileService.h"
 #include "PluginManager.h"
 #include "PluginCbInterface.h"
 #include "ClientPlugin.h"
@@ -41,8 +54,12 @@
 #include <QMutex>
 #include <QCoreApplication>
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QString>
 #include <QDBusInterface>
+#include <QDBusContext>
+#include <QTimer>
 
 
 namespace Buteo {
@@ -59,7 +76,8 @@ class AccountsHelper;
 /// This class manages other components and connects them to provide
 /// the fully functioning synchronization framework.
 class Synchronizer : public SyncDBusInterface, // Derived from QObject
-                     public PluginCbInterface
+                     public PluginCbInterface,
+                     protected QDBusContext
 {
     Q_OBJECT
 public:
@@ -77,6 +95,15 @@ public:
     /// \brief stops the daemon and unregisters the dbus object
     void close();
 
+    /*! \brief Enables exiting the daemon while it is idle
+     *
+     * Must be called before initialize(). When enabled, the daemon exits
+     * after a while without sessions, servers and imminent scheduled syncs,
+     * and is activated again over D-Bus for the next scheduled sync.
+     * \param aEnabled True to enable
+     */
+    void setIdleExitEnabled(bool aEnabled);
+
 
 // From PluginCbInterface
 // ---------------------------------------------------------------------------
@@ -88,6 +115,11 @@ public:
     virtual void releaseStorage(const QString &aStorageName,
                                 const SyncPluginBase *aCaller);
 
+    /// \see PluginCbInterface::requestSessionStorage
+    virtual bool requestSessionStorage(const QString &aStorageName,
+                                       const SyncPluginBase *aCaller,
+                                       const QString &aSessionId);
+
     /// \see PluginCbInterface::createStorage
     virtual StoragePlugin* createStorage(const QString &aPluginName);
 
@@ -103,6 +135,13 @@ public:
     /// \see PluginCbInterface::getValue
     virtual QString getValue(const QString& aAddress, const QString& aKey);
 
+    /// \see PluginCbInterface::profileService
+    virtual ProfileService* profileService();
+
+    /// \see PluginCbInterface::reportTargetResults
+    virtual void reportTargetResults(const SyncPluginBase *aCaller,
+                                     const TargetResults &aDelta);
+
 
 // From SyncDBusInterface
 // --------------------------------------------------------------------------
@@ -210,6 +249,19 @@ public slots:
      */
     int status(unsigned int aAccountId, int &aFailedReason, qlonglong &aPrevSyncTime, qlonglong &aNextSyncTime);
 
+    //! \see SyncDBusInterface::setForegroundActive
+    virtual void setForegroundActive(bool aActive);
+
+    //! \see SyncDBusInterface::subscribeStatus
+    virtual void subscribeStatus(QString aListenerPath, QStringList aProfileIds,
+                                 QList<unsigned int> aAccountIds);
+
+    //! \see SyncDBusInterface::unsubscribeStatus
+    virtual void unsubscribeStatus(QString aListenerPath);
+
+    //! \see SyncDBusInterface::reportTargetResults
+    virtual void reportTargetResults(QString aProfileId, QString aTargetResults);
+
 signals:
 
         //! emitted by releaseStorages call
@@ -231,6 +283,14 @@ private slots:
      */
     void onStorageReleased();
 
+    /*! \brief Tries to start the next sync in queue after a rate limit wait
+     */
+    void onLimiterTimeout();
+
+    /*! \brief Saves the results reported by running sessions to the log
+     */
+    void onCheckpoint();
+
     void onTransferProgress( const QString &aProfileName,
         Sync::TransferDatabase aDatabase, Sync::TransferType aType,
         const QString &aMimeType, int aCommittedItems );
@@ -242,10 +302,50 @@ private slots:
 
     void onSyncProgressDetail(const QString &aProfileName,int aProgressDetail);
 
+    /*! \brief Dispatches an event received from the event channel
+     *
+     * @param aEvent The event
+     */
+    void onSyncEvent(const Buteo::SyncEvent &aEvent);
+
+    /*! \brief Sends the delayed D-Bus replies of a finished background task
+     */
+    void onTaskFinished();
+
+    /*! \brief Updates the dependencies of a changed profile
+     *
+     * @param aProfileName Name of the profile
+     * @param aChangeType ProfileManager::ProfileChangeType
+     */
+    void updateDependencies(QString aProfileName, int aChangeType);
+
+    /*! \brief Updates the usage predictions of a changed profile
+     *
+     * @param aProfileName Name of the profile
+     * @param aChangeType ProfileManager::ProfileChangeType
+     */
+    void updateUsagePredictor(QString aProfileName, int aChangeType);
+
+    /*! \brief Starts a speculative sync before predicted use of a profile
+     *
+     * The sync is run as a scheduled sync, and skipped on low battery or
+     * when the device is offline.
+     * @param aProfileName Name of the profile
+     */
+    void onPrefetchDue(const QString &aProfileName);
+
+    /*! \brief Exits the daemon if it has nothing to do
+     *
+     * Persists the scheduled syncs and registers the next wakeup first.
+     */
+    void onIdle();
+
     void onServerDone();
 
     void onNewSession(const QString &aDestination);
 
+    void onNewPeerSession(const QString &aDestination, const QString &aSessionId);
+
     void slotNetworkSessionOpened();
 
     void slotNetworkSessionError();
@@ -278,6 +378,13 @@ private slots:
      */
     void reschedule(const QString &aProfileName);
 
+    /*! \brief Reschedules profiles with time of day rules after a clock change
+     *
+     * Interval schedules keep waiting on the monotonic clock, so that a
+     * clock change neither repeats nor skips their syncs.
+     */
+    void onClockChanged();
+
     /*! \brief Handles the sync status signal
      *
      * @param aProfileName Name of the profile
@@ -313,6 +420,37 @@ private:
      */
     void cleanupSession(SyncSession *aSession, Sync::SyncStatus aStatus);
 
+    /*! \brief Asks scheduled sessions holding storages needed by a manual
+     *  sync to yield
+     *
+     * The owners of the storages are looked up from the storage booker.
+     * @param aSession Session of the manual sync
+     * @return True if at least one session will yield
+     */
+    bool preemptSessions(SyncSession *aSession);
+
+    /*! \brief Queues a session that yielded its storages again
+     *
+     * The checkpoint of the session is kept by the plug-in, so the session
+     * is not rescheduled and its results are not saved.
+     * @param aSession Session that finished with Sync::SYNC_QUEUED
+     */
+    void requeueSession(SyncSession *aSession);
+
+    /*! \brief Adds the resources used by the client plug-in process of a
+     *  session to its results
+     *
+     * @param aSession Finished session
+     * @param aResults Results of the session
+     */
+    void addProcessUsage(SyncSession *aSession, SyncResults &aResults);
+
+    /*! \brief Gives queued predecessors of a manual sync its priority
+     *
+     * @param aProfileName Name of the profile of the manual sync
+     */
+    void boostPredecessors(const QString &aProfileName);
+
     /*! \brief Start all server plug-ins
      *
      * @param resume, if true resume servers instead of starting them
@@ -349,7 +487,107 @@ private:
      */
     bool cleanupProfile(const QString &profileId);
 
-    bool clientProfileActive(const QString &clientProfileName);
+    /*! \brief Checks the session limits of a profile
+     *
+     * Schedules a new attempt to start queued syncs if the profile must
+     * wait for the rate limit.
+     * @param aProfile Sync profile
+     * @return True if a session of the profile can be started now
+     */
+    bool admitSession(const SyncProfile &aProfile);
+
+    /*! \brief Marks the storage of the given MIME type used in a session
+     *
+     * @param aSession Sync session
+     * @param aMimeType MIME type of the accquired storage
+     */
+    void updateStorageMap(SyncSession *aSession, const QString &aMimeType);
+
+    /*! \brief Runs a task for the current method call
+     *
+     * If the method was called over D-Bus, the task is run by the executor
+     * and the result of the task is sent as a delayed reply when the task
+     * finishes. Otherwise the task is run synchronously.
+     * @param aTask Task to run, deleted automatically
+     * @return Result of the task, or an invalid value if the reply is delayed
+     */
+    QVariant runTask(ExecutorTask *aTask);
+
+    /*! \brief Runs a read-only query for the current method call
+     *
+     * The reply is taken from the reply cache if the profile store has not
+     * changed since the same query was last answered. If an identical query
+     * is being computed for another D-Bus caller, the call waits for its
+     * result. Otherwise the task is run with runTask().
+     * @param aKey Query key, see ReplyCache::key()
+     * @param aTask Task computing the reply, deleted automatically
+     * @return Reply, or an invalid value if the reply is delayed
+     */
+    QVariant runQuery(const QString &aKey, ExecutorTask *aTask);
+
+    /*! \brief Checks if sync results contain item changes
+     *
+     * @param aResults Sync results
+     * @return True if items were added, modified or deleted
+     */
+    static bool hasItemChanges(const SyncResults &aResults);
+
+    /*! \brief Checks if a profile has a predecessor that is syncing or
+     *  waiting to sync
+     *
+     * @param aProfileName Name of the profile
+     * @return True if the sync of the profile must wait
+     */
+    bool hasPendingPredecessor(const QString &aProfileName) const;
+
+    /*! \brief Starts or cancels the dependents of a finished profile
+     *
+     * Dependents waiting for the profile are started when none of their
+     * predecessors is pending anymore, or cancelled if the profile failed.
+     * Other dependents are started if the profile changed items.
+     *
+     * @param aProfileName Name of the finished profile
+     * @param aSucceeded True if the sync succeeded
+     * @param aItemsChanged True if the sync changed items
+     * @param aScheduled True if the finished sync was a scheduled one
+     */
+    void releaseDependents(const QString &aProfileName, bool aSucceeded,
+                           bool aItemsChanged, bool aScheduled);
+
+    //! \brief Loads the usage history of the profiles with prefetch enabled
+    void loadUsagePredictions();
+
+    /*! \brief Checks if the battery is too low for scheduled syncs
+     *
+     * @return True on low battery
+     */
+    bool isLowPower() const;
+
+    /*! \brief Checks if the device is charging
+     *
+     * @return True if charging
+     */
+    bool isCharging() const;
+
+    /*! \brief Refreshes the charging state used for pacing storage writes
+     *
+     * Notifies out-of-process plug-ins if the device activity changed.
+     * @param aChanged True if the activity hint was changed by the caller
+     */
+    void updateDeviceActivity(bool aChanged);
+
+    //! \brief Builds the dependency graph from the sync profiles
+    void loadDependencies();
+
+    /*! \brief Checks if the daemon has no work that keeps it running
+     *
+     * @return True if there are no sessions, servers, pending requests,
+     *  storage reservations or sync on change
+     */
+    bool isIdle();
+
+    //! \brief Schedules the syncs persisted when the daemon exited idle
+    void restoreIdleState();
 
     QMap<QString, SyncSession*> iActiveSessions;
 
@@ -387,6 +625,32 @@ private:
 
     SyncOnChangeScheduler iSyncOnChangeScheduler;
 
+    SyncEventChannel iEventChannel;
+
+    TaskExecutor iExecutor;
+
+    //! Pending delayed D-Bus replies, by the task producing the reply
+    QMultiMap<ExecutorTask*, QDBusMessage> iPendingReplies;
+
+    SyncDependencyGraph iDependencies;
+
+    //! Syncs waiting for their predecessors, with the scheduled flag
+    QMap<QString, bool> iWaitingDependents;
+
+    SessionLimiter iSessionLimiter;
+
+    //! Timer for starting queued syncs delayed by a rate limit
+    QTimer iLimiterTimer;
+
+    //! SSO credentials shared by all client sessions
+    CredentialBroker iCredentialBroker;
+
+    //! Predicted use of profiles, for prefetch syncs
+    UsagePredictor iUsagePredictor;
+
+    //! Exits the daemon while it is idle
+    IdleExit iIdleExit;
+
     /*! \brief Save the counter for given profile
      *
      * @param aProfile profile to save counter
@@ -401,6 +665,9 @@ private:
 
     bool iSOCEnabled;
 
+    //! Storages for which sync on change is suppressed, by profile name
+    QHash<QString, QStringList> iSOCSuppressedStorages;
+
     QString iUUID;
 
     QString iRemoteName;
@@ -410,6 +677,47 @@ private:
 #endif
 
     QDBusInterface *iSyncUIInterface;
+
+    //! Cached profile access offered to plug-ins
+    ProfileService iProfileService;
+
+    //! Pre-resolved profiles for incoming server sessions
+    SessionPeerCache iPeerCache;
+
+    //! Status updates for subscribed clients
+    StatusStream iStatusStream;
+
+    //! Cached replies of read-only D-Bus queries
+    ReplyCache iReplyCache;
+
+    //! Storage plug-in init/uninit cycles
+    StorageCycleMeter iStorageCycles;
+
+    //! Results reported by plug-ins of running sessions
+    LiveResults iLiveResults;
+
+    //! Timer for saving reported results of running sessions
+    QTimer iCheckpointTimer;
+
+    /*! \brief Starts a session for an incoming server connection
+     *
+     * @param aPluginRunner Runner of the server plug-in
+     * @param aDestination Address of the peer
+     * @param aSessionId Peer session id, empty if the session uses the
+     *  whole plug-in
+     */
+    void startServerSession(ServerPluginRunner *aPluginRunner,
+                            const QString &aDestination,
+                            const QString &aSessionId);
+
+    //! Profile names of running peer sessions, by server profile and session id
+    QHash<QString, QString> iPeerSessions;
+
+    //! Guards iPeerSessions, which server plug-in threads read
+    QMutex iPeerSessionMutex;
+
+    //! Names of per-session profile copies, which are never saved
+    QSet<QString> iSessionProfileCopies;
 };
 
 }
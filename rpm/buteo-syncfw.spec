@@ -14,6 +14,7 @@ BuildRequires: pkgconfig(accounts-qt)
 BuildRequires: pkgconfig(libsignon-qt)
 BuildRequires: pkgconfig(QtSystemInfo)
 BuildRequires: libiphb-devel
+BuildRequires: pkgconfig(zlib)
 Requires: %{name}-msyncd
 # TODO: needs a proper fix
 # Patch0: 0001-Synchronizer-removeProfile-remove-profiles-even-if-p.patch
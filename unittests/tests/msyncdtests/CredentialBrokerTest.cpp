@@ -0,0 +1,90 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "CredentialBrokerTest.h"
+
+using namespace Buteo;
+
+void CredentialBrokerTest::testCache()
+{
+    ManualClockBroker broker;
+    QString username;
+    QString secret;
+
+    QVERIFY(!broker.cachedCredentials("google", username, secret));
+
+    broker.storeCredentials("google", "user", "secret");
+    QVERIFY(broker.cachedCredentials("google", username, secret));
+    QCOMPARE(username, QString("user"));
+    QCOMPARE(secret, QString("secret"));
+    QVERIFY(!broker.cachedCredentials("ovi", username, secret));
+
+    broker.invalidate("google");
+    QVERIFY(!broker.cachedCredentials("google", username, secret));
+
+    broker.storeCredentials("google", "user", "secret");
+    broker.storeCredentials("ovi", "user", "secret");
+    broker.invalidateAll();
+    QVERIFY(!broker.cachedCredentials("google", username, secret));
+    QVERIFY(!broker.cachedCredentials("ovi", username, secret));
+}
+
+void CredentialBrokerTest::testCachedRequest()
+{
+    ManualClockBroker broker;
+    QSignalSpy ready(&broker, SIGNAL(credentialsReady(const QString &, const QString &, const QString &)));
+
+    broker.storeCredentials("google", "user", "secret");
+    broker.requestCredentials("google");
+
+    QCOMPARE(ready.count(), 1);
+    QCOMPARE(ready.first().at(0).toString(), QString("google"));
+    QCOMPARE(ready.first().at(1).toString(), QString("user"));
+    QCOMPARE(ready.first().at(2).toString(), QString("secret"));
+}
+
+void CredentialBrokerTest::testExpiry()
+{
+    ManualClockBroker broker;
+    QString username;
+    QString secret;
+
+    broker.storeCredentials("google", "user", "secret");
+    broker.storeCredentials("ovi", "user", "secret");
+    QVERIFY(broker.iRefreshTimer.isActive());
+
+    // Nothing to do before half of the lifetime has passed.
+    broker.iNow = CredentialBroker::CREDENTIALS_TTL / 4;
+    QVERIFY(broker.expireCredentials().isEmpty());
+
+    // Used credentials are refreshed, unused ones dropped.
+    QVERIFY(broker.cachedCredentials("google", username, secret));
+    broker.iNow = CredentialBroker::CREDENTIALS_TTL / 2;
+    QCOMPARE(broker.expireCredentials(), QStringList() << "google");
+    QVERIFY(!broker.cachedCredentials("ovi", username, secret));
+
+    // Credentials are not used after their lifetime.
+    broker.iNow = CredentialBroker::CREDENTIALS_TTL;
+    QVERIFY(!broker.cachedCredentials("google", username, secret));
+}
+
+QTEST_MAIN(Buteo::CredentialBrokerTest)
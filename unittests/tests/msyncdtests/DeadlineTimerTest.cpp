@@ -0,0 +1,142 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "DeadlineTimerTest.h"
+
+#include <sys/timerfd.h>
+
+using namespace Buteo;
+
+// Time left until the deadline timerfd fires, 0 if it is not armed
+static qint64 armedMsecs(int aFd)
+{
+    struct itimerspec spec;
+    if (timerfd_gettime(aFd, &spec) != 0)
+    {
+        return -1;
+    } // no else
+    return static_cast<qint64>(spec.it_value.tv_sec) * 1000 +
+           spec.it_value.tv_nsec / 1000000;
+}
+
+void DeadlineTimerTest::testDeadline()
+{
+    ManualClockDeadlineTimer timer;
+    QSignalSpy timeouts(&timer, SIGNAL(timeout()));
+    QVERIFY(!timer.isActive());
+    QCOMPARE(timer.remaining(), (qint64)-1);
+
+    // Wall times in the past are due now.
+    QCOMPARE(timer.deadlineFor(timer.iWall.addSecs(-60)), timer.iNow);
+
+    // The timer is armed once, for the whole wait.
+    QVERIFY(timer.iDeadlineFd >= 0);
+    timer.startAt(timer.iWall.addSecs(2 * 60 * 60));
+    QVERIFY(timer.isActive());
+    QCOMPARE(timer.deadline(), timer.iNow + 2 * 60 * 60 * 1000);
+    qint64 armed = armedMsecs(timer.iDeadlineFd);
+    QVERIFY(armed > 2 * 60 * 60 * 1000 - 1000);
+    QVERIFY(armed <= 2 * 60 * 60 * 1000);
+    QVERIFY(!timer.iTimer.isActive());
+
+    timer.advance(60 * 1000);
+    timer.check();
+    QCOMPARE(timeouts.count(), 0);
+    QCOMPARE(timer.remaining(), (qint64)(119 * 60 * 1000));
+    armed = armedMsecs(timer.iDeadlineFd);
+    QVERIFY(armed > 119 * 60 * 1000 - 1000);
+    QVERIFY(armed <= 119 * 60 * 1000);
+
+    // Suspend past the deadline fires on the next check.
+    timer.advance(3 * 60 * 60 * 1000);
+    timer.check();
+    QCOMPARE(timeouts.count(), 1);
+    QVERIFY(!timer.isActive());
+
+    // Checks of a stopped timer do nothing.
+    timer.start(timer.iNow + 500);
+    QVERIFY(armedMsecs(timer.iDeadlineFd) <= 500);
+    timer.stop();
+    QCOMPARE(armedMsecs(timer.iDeadlineFd), (qint64)0);
+    timer.advance(1000);
+    timer.check();
+    QCOMPARE(timeouts.count(), 1);
+}
+
+void DeadlineTimerTest::testWallClockJump()
+{
+    ManualClockDeadlineTimer timer;
+    QSignalSpy timeouts(&timer, SIGNAL(timeout()));
+    QSignalSpy changes(&timer, SIGNAL(clockChanged(qint64)));
+
+    timer.startAt(timer.iWall.addSecs(30 * 60));
+    const qint64 deadline = timer.deadline();
+
+    // Small drift is not a clock change.
+    timer.advance(60 * 1000);
+    timer.iWall = timer.iWall.addMSecs(500);
+    timer.check();
+    QCOMPARE(changes.count(), 0);
+
+    // Setting the wall clock an hour ahead neither fires nor moves the timer.
+    timer.iWall = timer.iWall.addSecs(60 * 60);
+    timer.check();
+    QCOMPARE(changes.count(), 1);
+    QCOMPARE(changes.at(0).at(0).toLongLong(), (qint64)(60 * 60 * 1000));
+    QCOMPARE(timeouts.count(), 0);
+    QCOMPARE(timer.deadline(), deadline);
+
+    // Setting it back is reported as well.
+    timer.iWall = timer.iWall.addSecs(-2 * 60 * 60);
+    timer.check();
+    QCOMPARE(changes.count(), 2);
+    QVERIFY(changes.at(1).at(0).toLongLong() < 0);
+    QCOMPARE(timeouts.count(), 0);
+
+    timer.iNow = deadline;
+    timer.check();
+    QCOMPARE(timeouts.count(), 1);
+}
+
+void DeadlineTimerTest::testExpiry()
+{
+    DeadlineTimer timer;
+    QSignalSpy timeouts(&timer, SIGNAL(timeout()));
+
+    timer.start(DeadlineTimer::bootTime() + 100);
+    QTest::qWait(50);
+    QCOMPARE(timeouts.count(), 0);
+    QTest::qWait(250);
+    QCOMPARE(timeouts.count(), 1);
+    QVERIFY(!timer.isActive());
+}
+
+void DeadlineTimerTest::testBootTime()
+{
+    qint64 first = DeadlineTimer::bootTime();
+    QTest::qWait(20);
+    qint64 second = DeadlineTimer::bootTime();
+    QVERIFY(first > 0);
+    QVERIFY(second >= first + 10);
+}
+
+QTEST_MAIN(Buteo::DeadlineTimerTest)
@@ -0,0 +1,117 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "IdleExitTest.h"
+
+#include <QSignalSpy>
+
+using namespace Buteo;
+
+void IdleExitTest::init()
+{
+    iStatePath = QDir::tempPath() + "/idleexittest-state.xml";
+    QFile::remove(iStatePath);
+}
+
+void IdleExitTest::cleanup()
+{
+    QFile::remove(iStatePath);
+}
+
+void IdleExitTest::testEnable()
+{
+    RecordingIdleExit idleExit(iStatePath);
+    QVERIFY(!idleExit.isEnabled());
+    QCOMPARE(idleExit.iTimer.interval(), IdleExit::IDLE_TIMEOUT_MINUTES * 60 * 1000);
+
+    // Disabled idle exit never times out.
+    idleExit.reset();
+    QVERIFY(!idleExit.iTimer.isActive());
+
+    idleExit.setEnabled(true);
+    idleExit.reset();
+    QVERIFY(idleExit.iTimer.isActive());
+
+    idleExit.iTimer.setInterval(10);
+    QSignalSpy spy(&idleExit, SIGNAL(idle()));
+    idleExit.reset();
+    QTest::qWait(100);
+    QCOMPARE(spy.count(), 1);
+
+    idleExit.reset();
+    idleExit.setEnabled(false);
+    QVERIFY(!idleExit.iTimer.isActive());
+}
+
+void IdleExitTest::testStateRoundTrip()
+{
+    RecordingIdleExit idleExit(iStatePath);
+    QDateTime now = QDateTime::currentDateTime();
+    QDateTime first(now.date().addDays(1), QTime(8, 0));
+    QDateTime second(now.date().addDays(2), QTime(20, 30));
+
+    QMap<QString, QDateTime> syncTimes;
+    syncTimes.insert("email", first);
+    syncTimes.insert("calendar", second);
+    QVERIFY(idleExit.suspend(syncTimes, first));
+    QCOMPARE(idleExit.iWakeups, QList<QDateTime>() << first);
+    QVERIFY(QFile::exists(iStatePath));
+
+    RecordingIdleExit restored(iStatePath);
+    QCOMPARE(restored.takeState(), syncTimes);
+
+    // The state is used only once.
+    QVERIFY(!QFile::exists(iStatePath));
+    QVERIFY(restored.takeState().isEmpty());
+}
+
+void IdleExitTest::testNoWakeup()
+{
+    RecordingIdleExit idleExit(iStatePath);
+    QVERIFY(idleExit.suspend(QMap<QString, QDateTime>(), QDateTime()));
+    QVERIFY(idleExit.iWakeups.isEmpty());
+    QVERIFY(idleExit.takeState().isEmpty());
+}
+
+void IdleExitTest::testWakeupFailure()
+{
+    RecordingIdleExit idleExit(iStatePath);
+    idleExit.iWakeupResult = false;
+
+    QMap<QString, QDateTime> syncTimes;
+    QDateTime wakeup = QDateTime::currentDateTime().addSecs(3600);
+    syncTimes.insert("email", wakeup);
+    QVERIFY(!idleExit.suspend(syncTimes, wakeup));
+    QVERIFY(!QFile::exists(iStatePath));
+}
+
+void IdleExitTest::testWakeupUnit()
+{
+    // Registering the same wakeup again must not reuse the unit name.
+    QDateTime wakeup = QDateTime::currentDateTime().addSecs(3600);
+    QString first = IdleExit::wakeupUnit(wakeup);
+    QString second = IdleExit::wakeupUnit(wakeup);
+    QVERIFY(first.startsWith(QString("msyncd-wakeup-%1-").arg(wakeup.toTime_t())));
+    QVERIFY(first != second);
+}
+
+QTEST_MAIN(Buteo::IdleExitTest)
@@ -0,0 +1,138 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "LiveResultsTest.h"
+#include "LiveResults.h"
+
+using namespace Buteo;
+
+static const QString PROFILE = "testprofile";
+
+void LiveResultsTest::testAdd()
+{
+    LiveResults live;
+    QVERIFY(!live.add(PROFILE, TargetResults("hcontacts", ItemCounts(1, 0, 0),
+                                            ItemCounts(0, 0, 0))));
+    QVERIFY(!live.contains(PROFILE));
+
+    live.begin(PROFILE);
+    QVERIFY(live.contains(PROFILE));
+    QCOMPARE(live.startTime(PROFILE).time().msec(), 0);
+    QVERIFY(live.add(PROFILE, TargetResults("hcontacts", ItemCounts(1, 2, 3),
+                                           ItemCounts(4, 5, 6))));
+    QVERIFY(live.add(PROFILE, TargetResults("hcontacts", ItemCounts(1, 1, 1),
+                                           ItemCounts(1, 1, 1))));
+    QVERIFY(live.add(PROFILE, TargetResults("hcalendar", ItemCounts(7, 0, 0),
+                                           ItemCounts(0, 0, 0))));
+
+    SyncResults results = live.snapshot(PROFILE);
+    QCOMPARE(results.majorCode(), (int)SyncResults::SYNC_RESULT_INVALID);
+    QCOMPARE(results.syncTime(), live.startTime(PROFILE));
+    QVERIFY(!results.isScheduled());
+    QCOMPARE(results.targetResults().size(), 2);
+    foreach (const TargetResults &target, results.targetResults())
+    {
+        if (target.targetName() == "hcontacts")
+        {
+            QCOMPARE(target.localItems().added, (unsigned)2);
+            QCOMPARE(target.localItems().deleted, (unsigned)3);
+            QCOMPARE(target.localItems().modified, (unsigned)4);
+            QCOMPARE(target.remoteItems().added, (unsigned)5);
+            QCOMPARE(target.remoteItems().deleted, (unsigned)6);
+            QCOMPARE(target.remoteItems().modified, (unsigned)7);
+        }
+        else
+        {
+            QCOMPARE(target.targetName(), QString("hcalendar"));
+            QCOMPARE(target.localItems().added, (unsigned)7);
+        }
+    }
+
+    // Starting again keeps the counts.
+    QDateTime start = live.startTime(PROFILE);
+    live.begin(PROFILE);
+    QCOMPARE(live.startTime(PROFILE), start);
+    QCOMPARE(live.snapshot(PROFILE).targetResults().size(), 2);
+}
+
+void LiveResultsTest::testScheduled()
+{
+    LiveResults live;
+    live.begin(PROFILE, true);
+    QVERIFY(live.snapshot(PROFILE).isScheduled());
+
+    // Checkpoints of scheduled syncs are not counted as manual ones.
+    live.add(PROFILE, TargetResults("hcontacts", ItemCounts(1, 0, 0),
+                                    ItemCounts(0, 0, 0)));
+    QVERIFY(live.snapshot(PROFILE).isScheduled());
+}
+
+void LiveResultsTest::testDirty()
+{
+    LiveResults live;
+    live.begin(PROFILE);
+    live.begin("other");
+    QVERIFY(live.takeDirty().isEmpty());
+
+    live.add(PROFILE, TargetResults("hcontacts", ItemCounts(1, 0, 0),
+                                    ItemCounts(0, 0, 0)));
+    QCOMPARE(live.takeDirty(), QStringList() << PROFILE);
+    QVERIFY(live.takeDirty().isEmpty());
+
+    live.add(PROFILE, TargetResults("hcontacts", ItemCounts(1, 0, 0),
+                                    ItemCounts(0, 0, 0)));
+    live.finish(PROFILE, SyncResults());
+    QVERIFY(live.takeDirty().isEmpty());
+    QCOMPARE(live.count(), 1);
+}
+
+void LiveResultsTest::testFinish()
+{
+    LiveResults live;
+    live.begin(PROFILE);
+    live.add(PROFILE, TargetResults("hcontacts", ItemCounts(1, 0, 0),
+                                    ItemCounts(0, 0, 0)));
+
+    // Reported targets are used when the plug-in returns none.
+    SyncResults final1(QDateTime::currentDateTime(),
+                       SyncResults::SYNC_RESULT_FAILED, SyncResults::ABORTED);
+    SyncResults results = live.finish(PROFILE, final1);
+    QCOMPARE(results.majorCode(), (int)SyncResults::SYNC_RESULT_FAILED);
+    QCOMPARE(results.targetResults().size(), 1);
+    QVERIFY(!live.contains(PROFILE));
+    QVERIFY(!live.startTime(PROFILE).isValid());
+
+    // Targets returned by the plug-in are final.
+    live.begin(PROFILE);
+    live.add(PROFILE, TargetResults("hcontacts", ItemCounts(1, 0, 0),
+                                    ItemCounts(0, 0, 0)));
+    SyncResults final2(QDateTime::currentDateTime(),
+                       SyncResults::SYNC_RESULT_SUCCESS, SyncResults::NO_ERROR);
+    final2.addTargetResults(TargetResults("hcontacts", ItemCounts(5, 0, 0),
+                                          ItemCounts(0, 0, 0)));
+    results = live.finish(PROFILE, final2);
+    QCOMPARE(results.targetResults().size(), 1);
+    QCOMPARE(results.targetResults().at(0).localItems().added, (unsigned)5);
+    QCOMPARE(live.count(), 0);
+}
+
+QTEST_MAIN(Buteo::LiveResultsTest)
@@ -0,0 +1,113 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "PluginWatchdogTest.h"
+#include "SyncProfile.h"
+#include "ProfileEngineDefs.h"
+
+using namespace Buteo;
+
+void PluginWatchdogTest::testConfigure()
+{
+    PluginWatchdog watchdog;
+    QCOMPARE(watchdog.deadline(PluginWatchdog::PHASE_SYNC),
+             static_cast<int>(PluginWatchdog::DEFAULT_SYNC_TIMEOUT));
+
+    SyncProfile profile("profile");
+    profile.merge(Profile("client", Profile::TYPE_CLIENT));
+    Profile *client = profile.subProfile("client", Profile::TYPE_CLIENT);
+    QVERIFY(client != 0);
+    client->setKey(KEY_INIT_TIMEOUT, "10");
+    client->setKey(KEY_SYNC_TIMEOUT, "0");
+    client->setKey(KEY_UNINIT_TIMEOUT, "invalid");
+    watchdog.configure(profile);
+
+    QCOMPARE(watchdog.deadline(PluginWatchdog::PHASE_INIT), 10);
+    QCOMPARE(watchdog.deadline(PluginWatchdog::PHASE_SYNC), 0);
+    QCOMPARE(watchdog.deadline(PluginWatchdog::PHASE_UNINIT),
+             static_cast<int>(PluginWatchdog::DEFAULT_UNINIT_TIMEOUT));
+
+    // No deadline, no timer.
+    watchdog.enterPhase(PluginWatchdog::PHASE_SYNC);
+    QVERIFY(!watchdog.iTimer.isActive());
+}
+
+void PluginWatchdogTest::testHung()
+{
+    PluginWatchdog watchdog;
+    watchdog.setDeadline(PluginWatchdog::PHASE_INIT, 1);
+    QSignalSpy hung(&watchdog, SIGNAL(hung(int)));
+
+    watchdog.enterPhase(PluginWatchdog::PHASE_INIT);
+    QCOMPARE(watchdog.phase(), PluginWatchdog::PHASE_INIT);
+    watchdog.recordActivity();
+    watchdog.recordActivity();
+    QTest::qWait(1500);
+
+    QCOMPARE(hung.count(), 1);
+    QCOMPARE(hung.first().first().toInt(), static_cast<int>(PluginWatchdog::PHASE_INIT));
+    QString diagnostic = watchdog.diagnostic("plugin");
+    QVERIFY(diagnostic.contains("plugin"));
+    QVERIFY(diagnostic.contains("init"));
+    QVERIFY(diagnostic.contains("2 progress events"));
+}
+
+void PluginWatchdogTest::testPhaseChange()
+{
+    PluginWatchdog watchdog;
+    watchdog.setDeadline(PluginWatchdog::PHASE_INIT, 1);
+    watchdog.setDeadline(PluginWatchdog::PHASE_SYNC, 3);
+    QSignalSpy hung(&watchdog, SIGNAL(hung(int)));
+
+    // Leaving a phase in time restarts the watch.
+    watchdog.enterPhase(PluginWatchdog::PHASE_INIT);
+    watchdog.enterPhase(PluginWatchdog::PHASE_SYNC);
+    QTest::qWait(1500);
+    QCOMPARE(hung.count(), 0);
+
+    watchdog.stop();
+    QCOMPARE(watchdog.phase(), PluginWatchdog::PHASE_IDLE);
+    QVERIFY(!watchdog.iTimer.isActive());
+}
+
+void PluginWatchdogTest::testSyncProgress()
+{
+    PluginWatchdog watchdog;
+    watchdog.setDeadline(PluginWatchdog::PHASE_SYNC, 1);
+    QSignalSpy hung(&watchdog, SIGNAL(hung(int)));
+
+    // A sync that makes progress may run past its deadline.
+    watchdog.enterPhase(PluginWatchdog::PHASE_SYNC);
+    for (int i = 0; i < 4; ++i)
+    {
+        QTest::qWait(500);
+        watchdog.recordActivity();
+    }
+    QCOMPARE(hung.count(), 0);
+
+    // A whole period without progress is a hang.
+    QTest::qWait(2500);
+    QCOMPARE(hung.count(), 1);
+    QCOMPARE(hung.first().first().toInt(), static_cast<int>(PluginWatchdog::PHASE_SYNC));
+}
+
+QTEST_MAIN(Buteo::PluginWatchdogTest)
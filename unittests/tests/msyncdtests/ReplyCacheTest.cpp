@@ -0,0 +1,151 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "ReplyCacheTest.h"
+
+using namespace Buteo;
+
+void ReplyCacheTest::testKey()
+{
+    QCOMPARE(ReplyCache::key("m"), ReplyCache::key("m", QStringList()));
+    QVERIFY(ReplyCache::key("m", QStringList() << "a") !=
+            ReplyCache::key("m", QStringList() << "b"));
+
+    // Argument boundaries are part of the key.
+    QVERIFY(ReplyCache::key("m", QStringList() << "ab" << "c") !=
+            ReplyCache::key("m", QStringList() << "a" << "bc"));
+}
+
+void ReplyCacheTest::testLookup()
+{
+    ReplyCache cache;
+    QVariant reply;
+    QVERIFY(!cache.lookup("k", reply));
+
+    cache.insert("k", QStringList() << "p1");
+    QVERIFY(cache.lookup("k", reply));
+    QCOMPARE(reply.toStringList(), QStringList() << "p1");
+}
+
+void ReplyCacheTest::testRunningQuery()
+{
+    ReplyCache cache;
+    DummyQueryTask task;
+    QVERIFY(cache.runningQuery("k") == 0);
+
+    cache.queryStarted("k", &task);
+    QVERIFY(cache.runningQuery("k") == &task);
+
+    // The result of a finished query is cached.
+    cache.queryFinished(&task, QString("result"));
+    QVERIFY(cache.runningQuery("k") == 0);
+    QVariant reply;
+    QVERIFY(cache.lookup("k", reply));
+    QCOMPARE(reply.toString(), QString("result"));
+
+    // Tasks that are not queries are ignored.
+    DummyQueryTask other;
+    cache.queryFinished(&other, QString("other"));
+    QCOMPARE(cache.iReplies.count(), 1);
+}
+
+void ReplyCacheTest::testInvalidate()
+{
+    ReplyCache cache;
+    DummyQueryTask task;
+    int revision = cache.revision();
+
+    cache.insert("k1", QString("old"));
+    cache.queryStarted("k2", &task);
+    cache.invalidate();
+    QCOMPARE(cache.revision(), revision + 1);
+
+    QVariant reply;
+    QVERIFY(!cache.lookup("k1", reply));
+
+    // A query started before the change is neither joined nor cached.
+    QVERIFY(cache.runningQuery("k2") == 0);
+    cache.queryFinished(&task, QString("stale"));
+    QVERIFY(!cache.lookup("k2", reply));
+}
+
+void ReplyCacheTest::testLimit()
+{
+    ReplyCache cache;
+    for (int i = 0; i < ReplyCache::MAX_REPLIES; ++i)
+    {
+        cache.insert(QString::number(i), i);
+    }
+    QCOMPARE(cache.iReplies.count(), static_cast<int>(ReplyCache::MAX_REPLIES));
+
+    // Replacing a reply does not clear the cache.
+    cache.insert("0", 0);
+    QCOMPARE(cache.iReplies.count(), static_cast<int>(ReplyCache::MAX_REPLIES));
+
+    cache.insert("new", 1);
+    QCOMPARE(cache.iReplies.count(), 1);
+}
+
+void ReplyCacheTest::testExpiry()
+{
+    ManualClockReplyCache cache;
+    QVariant reply;
+
+    cache.insert("k", QString("fresh"));
+    cache.iNow = ReplyCache::MAX_AGE_MS;
+    QVERIFY(cache.lookup("k", reply));
+
+    // Replies older than the limit are not served.
+    cache.iNow = ReplyCache::MAX_AGE_MS + 1;
+    QVERIFY(!cache.lookup("k", reply));
+
+    // Caching the reply again restarts its age.
+    cache.insert("k", QString("again"));
+    QVERIFY(cache.lookup("k", reply));
+    QCOMPARE(reply.toString(), QString("again"));
+}
+
+void ReplyCacheTest::testWatch()
+{
+    QString dirPath = QDir::tempPath() + QDir::separator() + "replycachetest";
+    QDir dir;
+    dir.mkpath(dirPath);
+    QFile::remove(dirPath + QDir::separator() + "p.xml");
+
+    ReplyCache cache;
+    cache.watch(QStringList() << dirPath << dirPath + "-missing");
+    cache.insert("k", QString("old"));
+    int revision = cache.revision();
+
+    // A profile written by another process invalidates the cache.
+    QFile file(dirPath + QDir::separator() + "p.xml");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    QTRY_VERIFY(cache.revision() > revision);
+    QVariant reply;
+    QVERIFY(!cache.lookup("k", reply));
+
+    QFile::remove(dirPath + QDir::separator() + "p.xml");
+    dir.rmdir(dirPath);
+}
+
+QTEST_MAIN(Buteo::ReplyCacheTest)
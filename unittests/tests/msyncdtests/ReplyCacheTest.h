@@ -0,0 +1,69 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef REPLYCACHETEST_H
+#define REPLYCACHETEST_H
+
+#include <QtTest/QtTest>
+#include "ReplyCache.h"
+#include "TaskExecutor.h"
+
+namespace Buteo {
+
+//! Task that is never run, used as a query handle
+class DummyQueryTask : public ExecutorTask
+{
+protected:
+    virtual QVariant run() { return QVariant(); }
+};
+
+//! Reply cache with a clock controlled by the test
+class ManualClockReplyCache : public ReplyCache
+{
+public:
+    ManualClockReplyCache() : iNow(0) { }
+
+    qint64 iNow;
+
+protected:
+    virtual qint64 now() const { return iNow; }
+};
+
+class ReplyCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testKey();
+    void testLookup();
+    void testRunningQuery();
+    void testInvalidate();
+    void testLimit();
+    void testExpiry();
+    void testWatch();
+
+};
+
+}
+
+#endif // REPLYCACHETEST_H
@@ -136,5 +136,44 @@ void ServerPluginRunnerTest::testSignals()
 
 }
 
+void ServerPluginRunnerTest::testPeerSessionLimit()
+{
+    QSignalSpy sessionSpy(iServerPluginRunner, SIGNAL(newPeerSession(QString, QString)));
+    QSignalSpy errorSpy(iServerPluginRunner, SIGNAL(sessionError(QString, QString, int)));
+    QSignalSpy successSpy(iServerPluginRunner, SIGNAL(sessionSuccess(QString, QString)));
+
+    // The dummy server serves one session at a time.
+    QCOMPARE(iServerPluginRunner->iPlugin->maxSessions(), 1);
+
+    iServerPluginRunner->onNewPeerSession("device1", "session1");
+    QCOMPARE(sessionSpy.count(), 1);
+    QVERIFY(iServerPluginRunner->iSessionIds.contains("session1"));
+
+    // Sessions over the limit and repeated session ids are rejected.
+    iServerPluginRunner->onNewPeerSession("device2", "session2");
+    iServerPluginRunner->onNewPeerSession("device1", "session1");
+    QCOMPARE(sessionSpy.count(), 1);
+    QCOMPARE(iServerPluginRunner->iSessionIds.count(), 1);
+    QVERIFY(!iServerPluginRunner->iSessionIds.contains("session2"));
+
+    // A successful session releases its slot.
+    iServerPluginRunner->onSessionSuccess("session1", "done");
+    QCOMPARE(successSpy.count(), 1);
+    QVERIFY(iServerPluginRunner->iSessionIds.isEmpty());
+
+    iServerPluginRunner->onNewPeerSession("device2", "session2");
+    QCOMPARE(sessionSpy.count(), 2);
+    QVERIFY(iServerPluginRunner->iSessionIds.contains("session2"));
+
+    // So does a failed one.
+    iServerPluginRunner->onSessionError("session2", "failed", Sync::SYNC_ERROR);
+    QCOMPARE(errorSpy.count(), 1);
+    QVERIFY(iServerPluginRunner->iSessionIds.isEmpty());
+
+    iServerPluginRunner->onNewPeerSession("device3", "session3");
+    QCOMPARE(sessionSpy.count(), 3);
+    iServerPluginRunner->onSessionSuccess("session3", "done");
+    QVERIFY(iServerPluginRunner->iSessionIds.isEmpty());
+}
 
 QTEST_MAIN(Buteo::ServerPluginRunnerTest)
@@ -45,6 +45,7 @@ private slots:
     void testStartAbort();
     void testSyncResults();
     void testSignals();
+    void testPeerSessionLimit();
 
 private:
     ServerPluginRunner *iServerPluginRunner;
@@ -0,0 +1,151 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "SessionLimiterTest.h"
+#include "SyncProfile.h"
+
+#include <QDomDocument>
+
+using namespace Buteo;
+
+static const qint64 HOUR = 60 * 60 * 1000;
+
+SyncProfile *SessionLimiterTest::createProfile(const QString &aName,
+                                               const QString &aPlugin,
+                                               const QString &aClientKeys)
+{
+    QString xml = QString(
+        "<profile type=\"sync\" name=\"%1\" >"
+            "<profile type=\"client\" name=\"%2\">%3</profile>"
+        "</profile>").arg(aName, aPlugin, aClientKeys);
+    QDomDocument doc;
+    if (!doc.setContent(xml, false))
+    {
+        return 0;
+    } // no else
+    return new SyncProfile(doc.documentElement());
+}
+
+void SessionLimiterTest::testDefaultLimit()
+{
+    ManualClockLimiter limiter;
+    QScopedPointer<SyncProfile> contacts(createProfile("contacts", "syncml", ""));
+    QScopedPointer<SyncProfile> calendar(createProfile("calendar", "syncml", ""));
+    QScopedPointer<SyncProfile> photos(createProfile("photos", "dav", ""));
+    QVERIFY(contacts != 0 && calendar != 0 && photos != 0);
+
+    // One session per client plug-in by default.
+    QCOMPARE(limiter.admit(*contacts), qint64(0));
+    limiter.sessionStarted(*contacts);
+    QCOMPARE(limiter.admit(*calendar), SessionLimiter::WAIT_FOR_SESSION);
+    QCOMPARE(limiter.admit(*photos), qint64(0));
+
+    limiter.sessionFinished("contacts");
+    QCOMPARE(limiter.admit(*calendar), qint64(0));
+
+    // Sessions started by a remote device count as well.
+    limiter.sessionStarted(*calendar, false);
+    QCOMPARE(limiter.admit(*contacts), SessionLimiter::WAIT_FOR_SESSION);
+    limiter.sessionFinished("calendar");
+    QCOMPARE(limiter.admit(*contacts), qint64(0));
+}
+
+void SessionLimiterTest::testUnlimited()
+{
+    ManualClockLimiter limiter;
+    const QString keys = "<key name=\"max_sessions\" value=\"0\" />";
+    QScopedPointer<SyncProfile> contacts(createProfile("contacts", "sync", keys));
+    QScopedPointer<SyncProfile> calendar(createProfile("calendar", "sync", keys));
+    QVERIFY(contacts != 0 && calendar != 0);
+
+    limiter.sessionStarted(*contacts);
+    QCOMPARE(limiter.admit(*calendar), qint64(0));
+    limiter.sessionStarted(*calendar);
+    QCOMPARE(limiter.admit(*contacts), qint64(0));
+}
+
+void SessionLimiterTest::testHostLimit()
+{
+    ManualClockLimiter limiter;
+    const QString keys = "<key name=\"max_sessions\" value=\"3\" />"
+                         "<key name=\"max_sessions_per_host\" value=\"1\" />";
+    QScopedPointer<SyncProfile> contacts(createProfile("contacts", "dav", keys +
+        "<key name=\"Remote database\" value=\"https://Dav.Example.com/card\" />"));
+    QScopedPointer<SyncProfile> calendar(createProfile("calendar", "dav", keys +
+        "<key name=\"remote_host\" value=\"dav.example.com\" />"));
+    QScopedPointer<SyncProfile> tasks(createProfile("tasks", "dav", keys +
+        "<key name=\"Remote database\" value=\"https://tasks.example.org/\" />"));
+    QVERIFY(contacts != 0 && calendar != 0 && tasks != 0);
+
+    limiter.sessionStarted(*contacts);
+    QCOMPARE(limiter.admit(*calendar), SessionLimiter::WAIT_FOR_SESSION);
+    QCOMPARE(limiter.admit(*tasks), qint64(0));
+    limiter.sessionStarted(*tasks);
+
+    limiter.sessionFinished("contacts");
+    QCOMPARE(limiter.admit(*calendar), qint64(0));
+}
+
+void SessionLimiterTest::testRateLimit()
+{
+    ManualClockLimiter limiter;
+    const QString keys = "<key name=\"max_sessions\" value=\"0\" />"
+                         "<key name=\"rate_limit\" value=\"4\" />"
+                         "<key name=\"rate_limit_burst\" value=\"2\" />";
+    QScopedPointer<SyncProfile> contacts(createProfile("contacts", "dav", keys));
+    QVERIFY(contacts != 0);
+
+    // The burst is available immediately.
+    for (int i = 0; i < 2; ++i)
+    {
+        QCOMPARE(limiter.admit(*contacts), qint64(0));
+        limiter.sessionStarted(*contacts);
+        limiter.sessionFinished("contacts");
+    }
+
+    // Then one token every 15 minutes.
+    QCOMPARE(limiter.admit(*contacts), HOUR / 4);
+    limiter.iNow = HOUR / 8;
+    QCOMPARE(limiter.admit(*contacts), HOUR / 8);
+    limiter.iNow = HOUR / 4;
+    QCOMPARE(limiter.admit(*contacts), qint64(0));
+    limiter.sessionStarted(*contacts);
+    limiter.sessionFinished("contacts");
+
+    SessionLimiter::ThrottleStats stats = limiter.stats("dav");
+    QCOMPARE(stats.throttled, 1);
+    QCOMPARE(stats.totalWait, HOUR / 4);
+    QCOMPARE(stats.maxWait, HOUR / 4);
+    QCOMPARE(limiter.stats("syncml").throttled, 0);
+
+    // The bucket does not grow past the burst size.
+    limiter.iNow = 10 * HOUR;
+    for (int i = 0; i < 2; ++i)
+    {
+        QCOMPARE(limiter.admit(*contacts), qint64(0));
+        limiter.sessionStarted(*contacts);
+        limiter.sessionFinished("contacts");
+    }
+    QVERIFY(limiter.admit(*contacts) > 0);
+}
+
+QTEST_MAIN(Buteo::SessionLimiterTest)
@@ -0,0 +1,180 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "SessionPeerCacheTest.h"
+#include "SyncProfile.h"
+#include "ProfileEngineDefs.h"
+
+using namespace Buteo;
+
+static const QString PC_ADDRESS("00:11:22:33:44:55");
+static const QString DEVICE_ADDRESS("66:77:88:99:AA:BB");
+
+void SessionPeerCacheTest::initTestCase()
+{
+    iProfileManager = new ProfileManager("peercache1", "peercache2");
+
+    SyncProfile btTemplate("bt_template");
+    QVERIFY(!iProfileManager->updateProfile(btTemplate).isEmpty());
+
+    iCache = new FakePeerCache(*iProfileManager);
+
+    QMap<QString, QVariant> pc;
+    pc.insert("Class", 0x10c);
+    pc.insert("Name", "Laptop");
+    iCache->iProperties.insert(PC_ADDRESS, pc);
+
+    QMap<QString, QVariant> device;
+    device.insert("Class", 0x5a020c);
+    device.insert("Name", "Phone");
+    iCache->iProperties.insert(DEVICE_ADDRESS, device);
+
+    iCache->preload();
+}
+
+void SessionPeerCacheTest::cleanupTestCase()
+{
+    delete iCache;
+    iProfileManager->removeProfile("bt_template");
+    delete iProfileManager;
+}
+
+void SessionPeerCacheTest::testClassification()
+{
+    iCache->iLookups = 0;
+    QCOMPARE(iCache->peerClass("USB"), SessionPeerCache::PEER_PC);
+    QCOMPARE(iCache->peerName("USB"), PC_SYNC);
+    QCOMPARE(iCache->iLookups, 0);
+
+    QCOMPARE(iCache->peerClass(PC_ADDRESS), SessionPeerCache::PEER_PC);
+    QCOMPARE(iCache->peerName(PC_ADDRESS), PC_SYNC);
+    QCOMPARE(iCache->peerClass(DEVICE_ADDRESS), SessionPeerCache::PEER_DEVICE);
+    QCOMPARE(iCache->peerName(DEVICE_ADDRESS), QString("Phone"));
+
+    // Each address is looked up only once.
+    QCOMPARE(iCache->iLookups, 2);
+}
+
+void SessionPeerCacheTest::testFailedLookup()
+{
+    const QString address("CC:DD:EE:FF:00:11");
+    iCache->iLookups = 0;
+    QCOMPARE(iCache->peerClass(address), SessionPeerCache::PEER_DEVICE);
+    QVERIFY(iCache->peerName(address).isEmpty());
+
+    // Failed lookups are retried.
+    QCOMPARE(iCache->iLookups, 2);
+
+    QMap<QString, QVariant> pc;
+    pc.insert("Class", 0x10c);
+    iCache->iProperties.insert(address, pc);
+    QCOMPARE(iCache->peerClass(address), SessionPeerCache::PEER_PC);
+    QCOMPARE(iCache->peerClass(address), SessionPeerCache::PEER_PC);
+    QCOMPARE(iCache->iLookups, 3);
+    iCache->iProperties.remove(address);
+}
+
+void SessionPeerCacheTest::testPcProfile()
+{
+    bool temporary = false;
+    bool save = true;
+    SyncProfile *profile = iCache->sessionProfile("USB", temporary, save);
+    QVERIFY(profile != 0);
+    QVERIFY(temporary);
+    QVERIFY(!save);
+    QCOMPARE(profile->name(), PC_SYNC);
+    QCOMPARE(profile->key(KEY_DISPLAY_NAME), PC_SYNC);
+    QVERIFY(profile->isHidden());
+
+    // Each session gets its own copy.
+    SyncProfile *other = iCache->sessionProfile(PC_ADDRESS, temporary, save);
+    QVERIFY(other != 0);
+    QVERIFY(other != profile);
+    QCOMPARE(other->name(), PC_SYNC);
+
+    delete profile;
+    delete other;
+}
+
+void SessionPeerCacheTest::testDeviceProfile()
+{
+    bool temporary = false;
+    bool save = false;
+    SyncProfile *profile = iCache->sessionProfile(DEVICE_ADDRESS, temporary,
+                                                  save);
+    QVERIFY(profile != 0);
+    QVERIFY(temporary);
+    QVERIFY(save);
+    QCOMPARE(profile->key(KEY_BT_ADDRESS), DEVICE_ADDRESS);
+    QCOMPARE(profile->key(KEY_DISPLAY_NAME), QString("Phone"));
+    QVERIFY(profile->isEnabled());
+    QVERIFY(!profile->isHidden());
+    delete profile;
+}
+
+void SessionPeerCacheTest::testStoredProfile()
+{
+    bool temporary = false;
+    bool save = false;
+    SyncProfile *profile = iCache->sessionProfile(DEVICE_ADDRESS, temporary,
+                                                  save);
+    QVERIFY(profile != 0);
+    QString name = iProfileManager->updateProfile(*profile);
+    QVERIFY(!name.isEmpty());
+    delete profile;
+
+    // A profile stored after a miss is found without invalidation.
+    profile = iCache->sessionProfile(DEVICE_ADDRESS, temporary, save);
+    QVERIFY(profile != 0);
+    QVERIFY(!temporary);
+    QVERIFY(!save);
+    QCOMPARE(profile->name(), name);
+    delete profile;
+
+    // Log changes and changes of other profiles keep the found profile.
+    QVERIFY(iCache->iProfiles.contains(DEVICE_ADDRESS));
+    iCache->invalidate(name, ProfileManager::PROFILE_LOGS_MODIFIED, QString());
+    SyncProfile other("other");
+    iCache->invalidate(other.name(), ProfileManager::PROFILE_MODIFIED,
+                       other.toString());
+    QVERIFY(iCache->iProfiles.contains(DEVICE_ADDRESS));
+
+    // A change of the profile itself drops it.
+    profile = iProfileManager->syncProfile(name);
+    QVERIFY(profile != 0);
+    iCache->invalidate(name, ProfileManager::PROFILE_MODIFIED,
+                       profile->toString());
+    delete profile;
+    QVERIFY(!iCache->iProfiles.contains(DEVICE_ADDRESS));
+
+    // A profile removed on disk is noticed without invalidation.
+    profile = iCache->sessionProfile(DEVICE_ADDRESS, temporary, save);
+    QVERIFY(!temporary);
+    delete profile;
+    iProfileManager->removeProfile(name);
+    profile = iCache->sessionProfile(DEVICE_ADDRESS, temporary, save);
+    QVERIFY(profile != 0);
+    QVERIFY(temporary);
+    delete profile;
+}
+
+QTEST_MAIN(Buteo::SessionPeerCacheTest)
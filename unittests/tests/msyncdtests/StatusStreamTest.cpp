@@ -0,0 +1,119 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "StatusStreamTest.h"
+#include "SyncCommonDefs.h"
+#include "ProfileEngineDefs.h"
+
+#include <QtXml/QDomDocument>
+
+using namespace Buteo;
+
+// Returns the updates of a batch as "tag:profile:value" strings.
+static QStringList parseBatch(const QString &aBatch)
+{
+    QStringList updates;
+    QDomDocument doc;
+    if (!doc.setContent(aBatch))
+    {
+        return updates;
+    } // no else
+
+    QDomElement e = doc.documentElement().firstChildElement();
+    for (; !e.isNull(); e = e.nextSiblingElement())
+    {
+        QString value = (e.tagName() == TAG_PROGRESS) ?
+                e.attribute(ATTR_ITEMS) : e.attribute(ATTR_STATUS);
+        updates.append(e.tagName() + ":" + e.attribute(ATTR_NAME) + ":" + value);
+    }
+    return updates;
+}
+
+void StatusStreamTest::testFiltering()
+{
+    RecordingStatusStream stream;
+    stream.subscribe(":1.10", "/listener", QStringList() << "p1");
+    stream.subscribe(":1.11", "/listener", QStringList() << "p2");
+    QVERIFY(stream.isFollowed("p1"));
+    QVERIFY(!stream.isFollowed("p3"));
+
+    stream.publishStatus("p1", Sync::SYNC_STARTED, "", 0);
+    stream.publishStatus("p3", Sync::SYNC_STARTED, "", 0);
+    QVERIFY(stream.iFlushTimer.isActive());
+    stream.flush();
+
+    // Only the client following p1 is woken up.
+    QCOMPARE(stream.iServices, QStringList() << ":1.10");
+    QCOMPARE(parseBatch(stream.iBatches.first()),
+             QStringList() << QString("status:p1:%1").arg(Sync::SYNC_STARTED));
+
+    // Nothing is delivered when nothing is pending.
+    stream.flush();
+    QCOMPARE(stream.iBatches.count(), 1);
+}
+
+void StatusStreamTest::testCoalescing()
+{
+    RecordingStatusStream stream;
+    stream.subscribe(":1.10", "/listener", QStringList() << "p1" << "p2");
+
+    stream.publishStatus("p1", Sync::SYNC_STARTED, "", 0);
+    stream.publishProgress("p1", Sync::LOCAL_DATABASE, Sync::ITEM_ADDED, "text/x-vcard", 1);
+    stream.publishProgress("p2", Sync::LOCAL_DATABASE, Sync::ITEM_ADDED, "text/x-vcard", 1);
+    stream.publishProgress("p1", Sync::LOCAL_DATABASE, Sync::ITEM_ADDED, "text/x-vcard", 2);
+    stream.publishStatus("p1", Sync::SYNC_PROGRESS, "", Sync::SYNC_PROGRESS_SENDING_ITEMS);
+    stream.publishStatus("p1", Sync::SYNC_PROGRESS, "", Sync::SYNC_PROGRESS_RECEIVING_ITEMS);
+    stream.publishStatus("p1", Sync::SYNC_DONE, "", 0);
+    stream.publishProgress("p1", Sync::LOCAL_DATABASE, Sync::ITEM_ADDED, "text/x-vcard", 5);
+    stream.flush();
+
+    QCOMPARE(stream.iBatches.count(), 1);
+    QStringList expected;
+    expected << QString("status:p1:%1").arg(Sync::SYNC_STARTED)
+             << "progress:p1:3"
+             << "progress:p2:1"
+             << QString("status:p1:%1").arg(Sync::SYNC_PROGRESS)
+             << QString("status:p1:%1").arg(Sync::SYNC_DONE)
+             << "progress:p1:5";
+    QCOMPARE(parseBatch(stream.iBatches.first()), expected);
+}
+
+void StatusStreamTest::testUnsubscribe()
+{
+    RecordingStatusStream stream;
+    stream.subscribe(":1.10", "/listener", QStringList() << "p1");
+    stream.publishStatus("p1", Sync::SYNC_STARTED, "", 0);
+
+    // Resubscribing drops pending updates of profiles no longer followed.
+    stream.subscribe(":1.10", "/listener", QStringList() << "p2");
+    stream.flush();
+    QVERIFY(stream.iBatches.isEmpty());
+
+    stream.unsubscribe(":1.10", "/listener");
+    QVERIFY(!stream.isFollowed("p2"));
+
+    stream.subscribe(":1.12", "/listener", QStringList() << "p1");
+    stream.onServiceUnregistered(":1.12");
+    QVERIFY(!stream.isFollowed("p1"));
+}
+
+QTEST_MAIN(Buteo::StatusStreamTest)
@@ -91,4 +91,44 @@ void StorageBookerTest::testBooking()
 
 }
 
+void StorageBookerTest::testOwner()
+{
+    const QString STORAGE1 = "Storage1";
+    const QString CLIENT1 = "Client1";
+
+    StorageBooker booker;
+    QCOMPARE(booker.storageOwner(STORAGE1), QString());
+
+    QCOMPARE(booker.reserveStorage(STORAGE1, CLIENT1), true);
+    QCOMPARE(booker.storageOwner(STORAGE1), CLIENT1);
+    QCOMPARE(booker.reserveStorage(STORAGE1, CLIENT1), true);
+    QCOMPARE(booker.releaseStorage(STORAGE1), (unsigned)1);
+    QCOMPARE(booker.storageOwner(STORAGE1), CLIENT1);
+    QCOMPARE(booker.releaseStorage(STORAGE1), (unsigned)0);
+    QCOMPARE(booker.storageOwner(STORAGE1), QString());
+}
+
+void StorageBookerTest::testReleaseClient()
+{
+    const QString STORAGE1 = "Storage1";
+    const QString STORAGE2 = "Storage2";
+    const QString STORAGE3 = "Storage3";
+    const QString CLIENT1 = "Client1";
+    const QString CLIENT2 = "Client2";
+
+    StorageBooker booker;
+    QCOMPARE(booker.reserveStorage(STORAGE1, CLIENT1), true);
+    QCOMPARE(booker.reserveStorage(STORAGE1, CLIENT1), true);
+    QCOMPARE(booker.reserveStorage(STORAGE2, CLIENT1), true);
+    QCOMPARE(booker.reserveStorage(STORAGE3, CLIENT2), true);
+
+    // All references of the client are dropped, others are kept.
+    QCOMPARE(booker.releaseClientStorages(CLIENT1), (unsigned)2);
+    QCOMPARE(booker.isStorageAvailable(STORAGE1, CLIENT2), true);
+    QCOMPARE(booker.isStorageAvailable(STORAGE2, CLIENT2), true);
+    QCOMPARE(booker.storageOwner(STORAGE3), CLIENT2);
+    QCOMPARE(booker.releaseClientStorages(CLIENT1), (unsigned)0);
+    QCOMPARE(booker.releaseClientStorages(QString()), (unsigned)0);
+}
+
 QTEST_MAIN(Buteo::StorageBookerTest)
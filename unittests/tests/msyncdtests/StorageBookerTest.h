@@ -34,6 +34,8 @@ class StorageBookerTest: public QObject
 private slots:
 
     void testBooking();
+    void testOwner();
+    void testReleaseClient();
 };
 
 }
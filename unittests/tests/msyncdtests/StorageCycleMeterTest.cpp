@@ -0,0 +1,48 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "StorageCycleMeterTest.h"
+
+using namespace Buteo;
+
+static const qint64 MINUTE = 60 * 1000;
+
+void StorageCycleMeterTest::testCyclesPerHour()
+{
+    ManualClockCycleMeter meter;
+    QCOMPARE(meter.cyclesPerHour(), 0);
+
+    meter.cycleCompleted("hcontacts");
+    meter.iNow = 30 * MINUTE;
+    meter.cycleCompleted("hcalendar");
+    meter.cycleCompleted("hcontacts");
+    QCOMPARE(meter.cyclesPerHour(), 3);
+
+    // The first cycle drops out of the window after an hour.
+    meter.iNow = 60 * MINUTE;
+    QCOMPARE(meter.cyclesPerHour(), 2);
+    meter.iNow = 90 * MINUTE;
+    QCOMPARE(meter.cyclesPerHour(), 0);
+    QCOMPARE(meter.totalCycles(), 3);
+}
+
+QTEST_MAIN(Buteo::StorageCycleMeterTest)
@@ -0,0 +1,89 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "SyncDependencyGraphTest.h"
+#include "SyncDependencyGraph.h"
+
+using namespace Buteo;
+
+void SyncDependencyGraphTest::testDependencies()
+{
+    SyncDependencyGraph graph;
+
+    // contacts -> avatars -> thumbnails, calendar independent.
+    QVERIFY(graph.setPredecessors("avatars", QStringList() << "contacts"));
+    QVERIFY(graph.setPredecessors("thumbnails", QStringList() << "avatars" << "avatars"));
+
+    QCOMPARE(graph.predecessors("avatars"), QStringList() << "contacts");
+    QCOMPARE(graph.predecessors("thumbnails"), QStringList() << "avatars");
+    QVERIFY(graph.predecessors("contacts").isEmpty());
+    QVERIFY(graph.predecessors("calendar").isEmpty());
+
+    QCOMPARE(graph.dependents("contacts"), QStringList() << "avatars");
+    QCOMPARE(graph.dependents("avatars"), QStringList() << "thumbnails");
+    QVERIFY(graph.dependents("thumbnails").isEmpty());
+    QVERIFY(graph.dependents("calendar").isEmpty());
+
+    QVERIFY(graph.dependsOn("thumbnails", "contacts"));
+    QVERIFY(graph.dependsOn("avatars", "contacts"));
+    QVERIFY(!graph.dependsOn("contacts", "avatars"));
+    QVERIFY(!graph.dependsOn("calendar", "contacts"));
+
+    // Replacing dependencies.
+    QVERIFY(graph.setPredecessors("thumbnails", QStringList() << "calendar"));
+    QVERIFY(graph.dependents("avatars").isEmpty());
+    QCOMPARE(graph.dependents("calendar"), QStringList() << "thumbnails");
+}
+
+void SyncDependencyGraphTest::testCycles()
+{
+    SyncDependencyGraph graph;
+
+    QVERIFY(!graph.setPredecessors("a", QStringList() << "a"));
+    QVERIFY(graph.predecessors("a").isEmpty());
+
+    QVERIFY(graph.setPredecessors("b", QStringList() << "a"));
+    QVERIFY(graph.setPredecessors("c", QStringList() << "b"));
+
+    // a -> b -> c -> a would be a cycle, the edge is dropped.
+    QVERIFY(!graph.setPredecessors("a", QStringList() << "c" << "d"));
+    QCOMPARE(graph.predecessors("a"), QStringList() << "d");
+    QVERIFY(!graph.dependsOn("a", "c"));
+}
+
+void SyncDependencyGraphTest::testRemove()
+{
+    SyncDependencyGraph graph;
+
+    QVERIFY(graph.setPredecessors("b", QStringList() << "a"));
+    QVERIFY(graph.setPredecessors("c", QStringList() << "b"));
+
+    graph.removeProfile("b");
+    QVERIFY(graph.predecessors("b").isEmpty());
+    QVERIFY(graph.dependents("a").isEmpty());
+    QCOMPARE(graph.dependents("b"), QStringList() << "c");
+
+    graph.clear();
+    QVERIFY(graph.dependents("b").isEmpty());
+}
+
+QTEST_MAIN(Buteo::SyncDependencyGraphTest)
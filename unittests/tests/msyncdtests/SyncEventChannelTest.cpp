@@ -0,0 +1,262 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "SyncEventChannelTest.h"
+
+#include <QElapsedTimer>
+#include <cstdlib>
+#include <new>
+
+using namespace Buteo;
+
+// Count heap allocations made through operator new. Queued signal delivery
+// allocates the call event and a copy of each argument this way.
+static QAtomicInt gAllocations(0);
+
+void *operator new(size_t aSize)
+{
+    gAllocations.ref();
+    void *p = std::malloc(aSize ? aSize : 1);
+    if (p == 0)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t aSize)
+{
+    return operator new(aSize);
+}
+
+void operator delete(void *aPtr) throw()
+{
+    std::free(aPtr);
+}
+
+void operator delete[](void *aPtr) throw()
+{
+    std::free(aPtr);
+}
+
+static int allocations()
+{
+    return gAllocations.fetchAndAddOrdered(0);
+}
+
+static const int BENCHMARK_EVENTS = 1000;
+static const int BENCHMARK_ROUNDS = 100;
+
+void SyncEventChannelTest::testAtoms()
+{
+    quint32 profile = SyncEventAtoms::intern("testprofile");
+    quint32 mime = SyncEventAtoms::intern("text/x-vcard");
+
+    QVERIFY(profile != SyncEventAtoms::NONE);
+    QVERIFY(profile != mime);
+    QCOMPARE(SyncEventAtoms::intern("testprofile"), profile);
+    QCOMPARE(SyncEventAtoms::string(profile), QString("testprofile"));
+    QCOMPARE(SyncEventAtoms::string(mime), QString("text/x-vcard"));
+    QCOMPARE(SyncEventAtoms::intern(QString()), SyncEventAtoms::NONE);
+    QVERIFY(SyncEventAtoms::string(0xFFFFFFF).isEmpty());
+}
+
+void SyncEventChannelTest::testPostAndDrain()
+{
+    SyncEventChannel channel(8);
+    SyncEventCollector collector;
+    collector.iStore = true;
+    connect(&channel, SIGNAL(eventReceived(const Buteo::SyncEvent &)),
+            &collector, SLOT(onEvent(const Buteo::SyncEvent &)));
+
+    quint32 profile = SyncEventAtoms::intern("testprofile");
+    quint32 mime = SyncEventAtoms::intern("text/x-vcard");
+    QVERIFY(channel.post(SyncEvent(SyncEvent::TRANSFER_PROGRESS, profile, mime, 5,
+                                   Sync::REMOTE_DATABASE, Sync::ITEM_MODIFIED)));
+    QVERIFY(channel.post(SyncEvent(SyncEvent::STORAGE_ACQUIRED, profile, mime)));
+    QVERIFY(channel.post(SyncEvent(SyncEvent::PROGRESS_DETAIL, profile, SyncEventAtoms::NONE, 3)));
+
+    QCOMPARE(channel.drain(), 3);
+    QCOMPARE(channel.drain(), 0);
+    QCOMPARE(collector.iEvents.count(), 3);
+
+    const SyncEvent &first = collector.iEvents.at(0);
+    QCOMPARE(int(first.type), int(SyncEvent::TRANSFER_PROGRESS));
+    QCOMPARE(first.profile, profile);
+    QCOMPARE(first.mimeType, mime);
+    QCOMPARE(first.value, 5);
+    QCOMPARE(int(first.database), int(Sync::REMOTE_DATABASE));
+    QCOMPARE(int(first.transferType), int(Sync::ITEM_MODIFIED));
+    QCOMPARE(int(collector.iEvents.at(1).type), int(SyncEvent::STORAGE_ACQUIRED));
+    QCOMPARE(int(collector.iEvents.at(2).type), int(SyncEvent::PROGRESS_DETAIL));
+    QCOMPARE(collector.iEvents.at(2).value, 3);
+}
+
+void SyncEventChannelTest::testCapacity()
+{
+    SyncEventChannel channel(3);
+    QCOMPARE(channel.capacity(), 4);
+
+    for (int i = 0; i < channel.capacity(); ++i)
+    {
+        QVERIFY(channel.post(SyncEvent(SyncEvent::PROGRESS_DETAIL, 1, 0, i)));
+    }
+    QVERIFY(!channel.post(SyncEvent(SyncEvent::PROGRESS_DETAIL, 1, 0, 99)));
+
+    QCOMPARE(channel.drain(), 4);
+    QVERIFY(channel.post(SyncEvent(SyncEvent::PROGRESS_DETAIL, 1, 0, 100)));
+    QCOMPARE(channel.drain(), 1);
+}
+
+void SyncEventChannelTest::testWakeUp()
+{
+    SyncEventChannel channel;
+    SyncEventCollector collector;
+    collector.iStore = false;
+    connect(&channel, SIGNAL(eventReceived(const Buteo::SyncEvent &)),
+            &collector, SLOT(onEvent(const Buteo::SyncEvent &)));
+
+    channel.post(SyncEvent(SyncEvent::PROGRESS_DETAIL, 1));
+    channel.post(SyncEvent(SyncEvent::PROGRESS_DETAIL, 1));
+    QCOMPARE(collector.iCount, 0);
+
+    QCoreApplication::processEvents();
+    QCOMPARE(collector.iCount, 2);
+}
+
+void SyncEventChannelTest::testConcurrentProducers()
+{
+    const int producerCount = 4;
+    const int eventsPerProducer = 20000;
+
+    SyncEventChannel channel(64);
+    SyncEventCollector collector;
+    collector.iStore = true;
+    connect(&channel, SIGNAL(eventReceived(const Buteo::SyncEvent &)),
+            &collector, SLOT(onEvent(const Buteo::SyncEvent &)));
+
+    QList<SyncEventProducer*> producers;
+    for (int i = 0; i < producerCount; ++i)
+    {
+        producers.append(new SyncEventProducer(channel, i, eventsPerProducer));
+    }
+    foreach (SyncEventProducer *producer, producers)
+    {
+        producer->start();
+    }
+
+    while (collector.iCount < producerCount * eventsPerProducer)
+    {
+        if (channel.drain() == 0)
+        {
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    foreach (SyncEventProducer *producer, producers)
+    {
+        QVERIFY(producer->wait(10000));
+    }
+    qDeleteAll(producers);
+
+    // Events of each producer must arrive in posting order.
+    QVector<int> next(producerCount, 0);
+    foreach (const SyncEvent &event, collector.iEvents)
+    {
+        QVERIFY(event.profile < static_cast<quint32>(producerCount));
+        QCOMPARE(event.value, next[event.profile]);
+        ++next[event.profile];
+    }
+    for (int i = 0; i < producerCount; ++i)
+    {
+        QCOMPARE(next[i], eventsPerProducer);
+    }
+
+    // Flush the wake ups queued by the producers.
+    QCoreApplication::processEvents();
+}
+
+void SyncEventChannelTest::benchmarkRelay()
+{
+    const QString profileName("benchmarkprofile");
+    const QString mimeType("text/x-vcard");
+    const int total = BENCHMARK_EVENTS * BENCHMARK_ROUNDS;
+
+    // Current path: queued string based signal per event.
+    SyncEventEmitter emitter;
+    SyncEventCollector signalCollector;
+    connect(&emitter, SIGNAL(transferProgress(const QString &, Sync::TransferDatabase,
+                Sync::TransferType, const QString &, int)),
+            &signalCollector, SLOT(onTransferProgress(const QString &, Sync::TransferDatabase,
+                Sync::TransferType, const QString &, int)),
+            Qt::QueuedConnection);
+
+    QElapsedTimer timer;
+    int allocationsBefore = allocations();
+    timer.start();
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round)
+    {
+        for (int i = 0; i < BENCHMARK_EVENTS; ++i)
+        {
+            emitter.emitProgress(profileName, mimeType, i);
+        }
+        QCoreApplication::sendPostedEvents();
+    }
+    qint64 signalTime = qMax<qint64>(timer.elapsed(), 1);
+    double signalAllocations = double(allocations() - allocationsBefore) / total;
+    QCOMPARE(signalCollector.iCount, total);
+
+    // New path: compact events through the channel.
+    SyncEventChannel channel(BENCHMARK_EVENTS);
+    SyncEventCollector channelCollector;
+    channelCollector.iStore = false;
+    connect(&channel, SIGNAL(eventReceived(const Buteo::SyncEvent &)),
+            &channelCollector, SLOT(onEvent(const Buteo::SyncEvent &)),
+            Qt::DirectConnection);
+    quint32 profile = SyncEventAtoms::intern(profileName);
+
+    allocationsBefore = allocations();
+    timer.restart();
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round)
+    {
+        for (int i = 0; i < BENCHMARK_EVENTS; ++i)
+        {
+            channel.post(SyncEvent(SyncEvent::TRANSFER_PROGRESS, profile,
+                                   SyncEventAtoms::intern(mimeType), i));
+        }
+        QCoreApplication::sendPostedEvents();
+    }
+    qint64 channelTime = qMax<qint64>(timer.elapsed(), 1);
+    double channelAllocations = double(allocations() - allocationsBefore) / total;
+    QCOMPARE(channelCollector.iCount, total);
+
+    qDebug() << "Signal path: " << (total * 1000 / signalTime) << "events/s,"
+             << signalAllocations << "allocations/event";
+    qDebug() << "Channel path:" << (total * 1000 / channelTime) << "events/s,"
+             << channelAllocations << "allocations/event";
+
+    // One wake up call per batch is the only allocation left.
+    QVERIFY(channelAllocations < 0.01);
+    QVERIFY(channelAllocations < signalAllocations);
+}
+
+QTEST_MAIN(Buteo::SyncEventChannelTest)
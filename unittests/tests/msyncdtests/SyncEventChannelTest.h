@@ -0,0 +1,130 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef SYNCEVENTCHANNELTEST_H
+#define SYNCEVENTCHANNELTEST_H
+
+#include <QtTest/QtTest>
+#include <QThread>
+#include "SyncEventChannel.h"
+
+namespace Buteo {
+
+//! Collects events delivered by the channel.
+class SyncEventCollector : public QObject
+{
+    Q_OBJECT
+
+public:
+    SyncEventCollector() : iCount(0), iStore(true) { }
+
+    QList<SyncEvent> iEvents;
+    int iCount;
+    bool iStore;
+
+public slots:
+    void onEvent(const Buteo::SyncEvent &aEvent)
+    {
+        ++iCount;
+        if (iStore)
+        {
+            iEvents.append(aEvent);
+        }
+    }
+
+    void onTransferProgress(const QString &aProfileName,
+        Sync::TransferDatabase aDatabase, Sync::TransferType aType,
+        const QString &aMimeType, int aCommittedItems)
+    {
+        Q_UNUSED(aProfileName);
+        Q_UNUSED(aDatabase);
+        Q_UNUSED(aType);
+        Q_UNUSED(aMimeType);
+        Q_UNUSED(aCommittedItems);
+        ++iCount;
+    }
+};
+
+//! Emits progress the way plug-ins do on the signal based path.
+class SyncEventEmitter : public QObject
+{
+    Q_OBJECT
+
+public:
+    void emitProgress(const QString &aProfileName, const QString &aMimeType, int aItems)
+    {
+        emit transferProgress(aProfileName, Sync::LOCAL_DATABASE, Sync::ITEM_ADDED,
+                              aMimeType, aItems);
+    }
+
+signals:
+    void transferProgress(const QString &aProfileName,
+        Sync::TransferDatabase aDatabase, Sync::TransferType aType,
+        const QString &aMimeType, int aCommittedItems);
+};
+
+//! Posts events to a channel from a separate thread.
+class SyncEventProducer : public QThread
+{
+    Q_OBJECT
+
+public:
+    SyncEventProducer(SyncEventChannel &aChannel, quint32 aProfile, int aCount)
+        : iChannel(aChannel), iProfile(aProfile), iCount(aCount) { }
+
+protected:
+    virtual void run()
+    {
+        for (int i = 0; i < iCount; ++i)
+        {
+            SyncEvent event(SyncEvent::PROGRESS_DETAIL, iProfile, SyncEventAtoms::NONE, i);
+            while (!iChannel.post(event))
+            {
+                yieldCurrentThread();
+            }
+        }
+    }
+
+private:
+    SyncEventChannel &iChannel;
+    quint32 iProfile;
+    int iCount;
+};
+
+class SyncEventChannelTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testAtoms();
+    void testPostAndDrain();
+    void testCapacity();
+    void testWakeUp();
+    void testConcurrentProducers();
+    void benchmarkRelay();
+
+};
+
+}
+
+#endif // SYNCEVENTCHANNELTEST_H
@@ -0,0 +1,171 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "SyncOnChangeTest.h"
+#include "SyncOnChange.h"
+#include "SyncOnChangeScheduler.h"
+#include "StorageChangeNotifier.h"
+#include "SyncProfile.h"
+
+using namespace Buteo;
+
+static const QString CONTACTS = "hcontacts";
+static const QString CALENDAR = "hcalendar";
+
+void SyncOnChangeTest::init()
+{
+    iContacts = new FakeChangeNotifier(CONTACTS);
+    iCalendar = new FakeChangeNotifier(CALENDAR);
+    iScheduler = new SyncOnChangeScheduler;
+    iSOC = new SyncOnChange;
+
+    iSOC->iSOCScheduler = iScheduler;
+    iSOC->addProfile(CONTACTS, new SyncProfile("p1"));
+    iSOC->addProfile(CONTACTS, new SyncProfile("p2"));
+    iSOC->addProfile(CALENDAR, new SyncProfile("p3"));
+    iSOC->iStorageChangeNotifier->iNotifierMap.insert(CONTACTS, iContacts);
+    iSOC->iStorageChangeNotifier->iNotifierMap.insert(CALENDAR, iCalendar);
+    connect(iSOC->iStorageChangeNotifier, SIGNAL(storageChange(QString,QStringList)),
+            iSOC, SLOT(sync(QString,QStringList)));
+}
+
+void SyncOnChangeTest::cleanup()
+{
+    delete iSOC;
+    iSOC = 0;
+    delete iScheduler;
+    iScheduler = 0;
+    delete iContacts;
+    iContacts = 0;
+    delete iCalendar;
+    iCalendar = 0;
+}
+
+QStringList SyncOnChangeTest::scheduledProfiles() const
+{
+    QStringList profiles = iScheduler->iSOCProfileNames;
+    profiles.sort();
+    return profiles;
+}
+
+void SyncOnChangeTest::testNestedSuppression()
+{
+    QStringList storages = QStringList() << CONTACTS;
+
+    QCOMPARE(iSOC->disable(storages, false), storages);
+    QCOMPARE(iSOC->disable(storages, false), storages);
+    QVERIFY(!iContacts->iEnabled);
+    QCOMPARE(iContacts->iDisables, 1);
+    QVERIFY(iCalendar->iEnabled);
+
+    // The storage listens again only when every suppression is lifted.
+    iSOC->enable(storages);
+    QVERIFY(!iContacts->iEnabled);
+    QCOMPARE(iContacts->iEnables, 0);
+
+    iSOC->enable(storages);
+    QVERIFY(iContacts->iEnabled);
+    QCOMPARE(iContacts->iEnables, 1);
+    QVERIFY(iSOC->iSuppressCount.isEmpty());
+
+    // Lifting a suppression that was not made has no effect.
+    iSOC->enable(storages);
+    QCOMPARE(iContacts->iEnables, 1);
+    QVERIFY(iSOC->iSuppressCount.isEmpty());
+}
+
+void SyncOnChangeTest::testAfterNextChange()
+{
+    QStringList storages = QStringList() << CONTACTS;
+
+    iSOC->disable(storages, true);
+    QCOMPARE(iContacts->iDisables, 1);
+    QVERIFY(iContacts->iAfterNextChange);
+
+    // Nested suppressions do not stop the notifier again.
+    iSOC->disable(storages, false);
+    QCOMPARE(iContacts->iDisables, 1);
+    QVERIFY(iContacts->iAfterNextChange);
+
+    iSOC->enable(storages);
+    iSOC->enable(storages);
+    QVERIFY(iContacts->iEnabled);
+
+    iSOC->disable(storages, false);
+    QCOMPARE(iContacts->iDisables, 2);
+    QVERIFY(!iContacts->iAfterNextChange);
+    iSOC->enable(storages);
+}
+
+void SyncOnChangeTest::testSuppressAll()
+{
+    // Storages without SOC profiles are ignored.
+    QCOMPARE(iSOC->disable(QStringList() << "hnotes", false), QStringList());
+
+    QStringList suppressed = iSOC->disable(QStringList(), false);
+    suppressed.sort();
+    QCOMPARE(suppressed, QStringList() << CALENDAR << CONTACTS);
+    QVERIFY(!iContacts->iEnabled);
+    QVERIFY(!iCalendar->iEnabled);
+
+    iSOC->enable(suppressed);
+    QVERIFY(iContacts->iEnabled);
+    QVERIFY(iCalendar->iEnabled);
+}
+
+void SyncOnChangeTest::testOwnWrites()
+{
+    // Changes written only by a profile do not trigger a sync of it.
+    iSOC->sync(CONTACTS, QStringList() << SyncOnChange::writeOrigin("p1")
+                                       << SyncOnChange::writeOrigin("p1"));
+    QCOMPARE(scheduledProfiles(), QStringList() << "p2");
+
+    // Untagged changes come from other writers.
+    iSOC->sync(CONTACTS, QStringList() << SyncOnChange::writeOrigin("p1")
+                                       << QString());
+    QCOMPARE(scheduledProfiles(), QStringList() << "p1" << "p2");
+}
+
+void SyncOnChangeTest::testUnknownOrigins()
+{
+    iSOC->sync(CALENDAR, QStringList() << SyncOnChange::writeOrigin("p3"));
+    QVERIFY(scheduledProfiles().isEmpty());
+
+    // Notifiers that cannot tell the origins trigger all profiles.
+    iSOC->sync(CALENDAR, QStringList());
+    QCOMPARE(scheduledProfiles(), QStringList() << "p3");
+}
+
+void SyncOnChangeTest::testChangesWhileSuppressed()
+{
+    QStringList storages = QStringList() << CONTACTS;
+    iSOC->disable(storages, true);
+
+    // Changes of the session are checked when the storage is resumed.
+    iContacts->iChanges = true;
+    iContacts->iOrigins << SyncOnChange::writeOrigin("p1");
+    iSOC->enable(storages);
+    QVERIFY(!iContacts->iChanges);
+    QCOMPARE(scheduledProfiles(), QStringList() << "p2");
+}
+
+QTEST_MAIN(Buteo::SyncOnChangeTest)
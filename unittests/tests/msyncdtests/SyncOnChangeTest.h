@@ -0,0 +1,94 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef SYNCONCHANGETEST_H
+#define SYNCONCHANGETEST_H
+
+#include <QtTest/QtTest>
+#include "StorageChangeNotifierPlugin.h"
+
+namespace Buteo {
+
+class SyncOnChange;
+class SyncOnChangeScheduler;
+
+//! Change notifier that records how it is driven
+class FakeChangeNotifier : public StorageChangeNotifierPlugin
+{
+    Q_OBJECT
+
+public:
+    FakeChangeNotifier(const QString &aStorageName)
+    :   StorageChangeNotifierPlugin(aStorageName), iEnabled(true),
+        iEnables(0), iDisables(0), iAfterNextChange(false),
+        iChanges(false) { }
+
+    virtual QString name() const { return iStorageName; }
+    virtual bool hasChanges() const { return iChanges; }
+    virtual void changesReceived() { iChanges = false; iOrigins.clear(); }
+    virtual void enable() { iEnabled = true; iEnables++; }
+    virtual void disable(bool disableAfterNextChange = false)
+    {
+        iEnabled = false;
+        iDisables++;
+        iAfterNextChange = disableAfterNextChange;
+    }
+    virtual QStringList changeOrigins() const { return iOrigins; }
+
+    bool iEnabled;
+    int iEnables;
+    int iDisables;
+    bool iAfterNextChange;
+    bool iChanges;
+    QStringList iOrigins;
+};
+
+class SyncOnChangeTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void init();
+    void cleanup();
+
+    void testNestedSuppression();
+    void testAfterNextChange();
+    void testSuppressAll();
+    void testOwnWrites();
+    void testUnknownOrigins();
+    void testChangesWhileSuppressed();
+
+private:
+
+    QStringList scheduledProfiles() const;
+
+    FakeChangeNotifier *iContacts;
+    FakeChangeNotifier *iCalendar;
+    SyncOnChangeScheduler *iScheduler;
+    SyncOnChange *iSOC;
+
+};
+
+}
+
+#endif // SYNCONCHANGETEST_H
@@ -27,6 +27,17 @@
 
 using namespace Buteo;
 
+// Creates a profile using the given storage backends.
+static SyncProfile *storageProfile(const QString &aName, const QStringList &aStorages)
+{
+    SyncProfile *profile = new SyncProfile(aName);
+    foreach (const QString &storage, aStorages)
+    {
+        profile->merge(Profile(storage, Profile::TYPE_STORAGE));
+    }
+    return profile;
+}
+
 void SyncQueueTest::testQueue()
 {
     const QString NAME1 = "Name1";
@@ -62,4 +73,93 @@ void SyncQueueTest::testQueue()
 
 }
 
+void SyncQueueTest::testPriority()
+{
+    SyncSession scheduled1(new SyncProfile("Scheduled1"));
+    SyncSession scheduled2(new SyncProfile("Scheduled2"));
+    SyncSession manual(new SyncProfile("Manual"));
+    scheduled1.setScheduled(true);
+    scheduled2.setScheduled(true);
+    SyncQueue q;
+
+    // Manual sync goes before the scheduled ones.
+    q.enqueue(&scheduled1);
+    q.enqueue(&scheduled2);
+    q.enqueue(&manual);
+    QCOMPARE(q.head(), &manual);
+
+    // Boosted session keeps its place among sessions of the same priority.
+    QCOMPARE(q.dequeue(), &manual);
+    scheduled2.setPriorityBoosted(true);
+    QCOMPARE(scheduled2.hasManualPriority(), true);
+    q.enqueue(q.dequeue("Scheduled2"));
+    q.enqueue(&manual);
+    QCOMPARE(q.dequeue(), &scheduled2);
+    QCOMPARE(q.dequeue(), &manual);
+    QCOMPARE(q.dequeue(), &scheduled1);
+    QCOMPARE(q.isEmpty(), true);
+}
+
+void SyncQueueTest::testWarmStorages()
+{
+    SyncSession contacts1(storageProfile("Contacts1", QStringList() << "hcontacts"));
+    SyncSession calendar(storageProfile("Calendar", QStringList() << "hcalendar"));
+    SyncSession contacts2(storageProfile("Contacts2", QStringList() << "hcontacts"));
+    SyncSession manual(storageProfile("Manual", QStringList() << "hcalendar"));
+    contacts1.setScheduled(true);
+    calendar.setScheduled(true);
+    contacts2.setScheduled(true);
+    SyncQueue q;
+
+    // Arrival order without warm storages.
+    q.enqueue(&calendar);
+    q.enqueue(&contacts2);
+    QCOMPARE(q.head(), &calendar);
+
+    // The session using the storages of the finished session goes first.
+    q.setWarmStorages(QStringList() << "hcontacts");
+    QCOMPARE(q.head(), &contacts2);
+    QCOMPARE(q.dequeue(), &contacts2);
+    QCOMPARE(q.dequeue(), &calendar);
+
+    // Priority is not overridden.
+    q.enqueue(&contacts1);
+    q.enqueue(&manual);
+    QCOMPARE(q.head(), &manual);
+    QCOMPARE(q.dequeue(), &manual);
+    QCOMPARE(q.dequeue(), &contacts1);
+    QCOMPARE(q.isEmpty(), true);
+}
+
+void SyncQueueTest::testBypassLimit()
+{
+    SyncSession calendar(storageProfile("Calendar", QStringList() << "hcalendar"));
+    QList<SyncSession*> warm;
+    for (int i = 0; i <= SyncQueue::MAX_BYPASS; ++i)
+    {
+        warm.append(new SyncSession(storageProfile(QString("Contacts%1").arg(i),
+                                                   QStringList() << "hcontacts")));
+    }
+    SyncQueue q;
+    q.setWarmStorages(QStringList() << "hcontacts");
+
+    // Calendar is bypassed MAX_BYPASS times, then its turn comes.
+    q.enqueue(&calendar);
+    foreach (SyncSession *session, warm)
+    {
+        q.enqueue(session);
+        if (session == warm.last())
+        {
+            QCOMPARE(q.head(), &calendar);
+        }
+        else
+        {
+            QCOMPARE(q.dequeue(), session);
+        }
+    }
+    QCOMPARE(q.dequeue(), &calendar);
+    QCOMPARE(q.dequeue(), warm.last());
+    qDeleteAll(warm);
+}
+
 QTEST_MAIN(Buteo::SyncQueueTest)
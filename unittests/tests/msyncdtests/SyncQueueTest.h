@@ -34,6 +34,9 @@ class SyncQueueTest: public QObject
 private slots:
 
     void testQueue();
+    void testPriority();
+    void testWarmStorages();
+    void testBypassLimit();
 };
 
 }
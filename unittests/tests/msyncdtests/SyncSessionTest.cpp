@@ -290,6 +290,30 @@ void SyncSessionTest :: testOnError()
 
 }
 
+void SyncSessionTest :: testYield()
+{
+    // Not started, nothing to yield
+    QCOMPARE(iSyncSession->yield(), false);
+
+    iSyncSession->setPluginRunner(iSyncSessionPluginRunnerTest, true);
+
+    // Plug-in refuses to yield
+    isValuePassedTrue = false;
+    QCOMPARE(iSyncSession->yield(), false);
+    QCOMPARE(SyncSessionPluginRunnerTest::testValue, 4);
+    QCOMPARE(iSyncSession->isYielding(), false);
+
+    isValuePassedTrue = true;
+    QCOMPARE(iSyncSession->yield(), true);
+    QCOMPARE(iSyncSession->isYielding(), true);
+
+    // Yielded session finishes as queued, not as an error
+    iSyncSession->onError("sampleProfile", "", SyncResults::YIELDED);
+    QCOMPARE(iSyncSession->iStatus, Sync::SYNC_QUEUED);
+    QVERIFY(iSyncSession->iFinished);
+    QCOMPARE(iSyncSession->yield(), true);
+}
+
 void SyncSessionTest ::  testOnTransferProgress()
 {
     // registering metatypes that are not known
@@ -326,6 +350,31 @@ void SyncSessionTest :: testOnDone()
     QCOMPARE(sampleSpy.count(), 3);
 }
 
+void SyncSessionTest :: testPeerSession()
+{
+    qRegisterMetaType<Sync::SyncStatus>("Sync::SyncStatus");
+
+    QSignalSpy sampleSpy(iSyncSession, SIGNAL(finished(QString, Sync::SyncStatus,QString, int)));
+
+    iSyncSession->setSessionId("peer1");
+    QCOMPARE(iSyncSession->sessionId(), QString("peer1"));
+    iSyncSession->setPluginRunner(iSyncSessionPluginRunnerTest, true);
+
+    // Plug-in wide results and other peer sessions are ignored.
+    QMetaObject::invokeMethod(iSyncSessionPluginRunnerTest, "success",
+                              Q_ARG(QString, "foo"), Q_ARG(QString, "done"));
+    QMetaObject::invokeMethod(iSyncSessionPluginRunnerTest, "sessionSuccess",
+                              Q_ARG(QString, "peer2"), Q_ARG(QString, "done"));
+    QCOMPARE(sampleSpy.count(), 0);
+    QVERIFY(!iSyncSession->isFinished());
+
+    QMetaObject::invokeMethod(iSyncSessionPluginRunnerTest, "sessionError",
+                              Q_ARG(QString, "peer1"), Q_ARG(QString, "failed"),
+                              Q_ARG(int, 4));
+    QCOMPARE(sampleSpy.count(), 1);
+    QVERIFY(iSyncSession->isFinished());
+    QCOMPARE(iSyncSession->iErrorCode, 4);
+}
 
 // ############################################
 /*
@@ -376,6 +425,14 @@ void SyncSessionPluginRunnerTest :: abort(Sync::SyncStatus /*aStatus*/)
     testValue = 2;
 }
 
+bool SyncSessionPluginRunnerTest :: yield()
+{
+    // check the value after returning to the calling function
+
+    testValue = 4;
+    return SyncSessionTest::isValuePassedTrue;
+}
+
 SyncResults SyncSessionPluginRunnerTest :: syncResults()
 {
     SyncResults results;
@@ -54,8 +54,10 @@ private slots:
     void testStorages();
     void testOnSuccess();
     void testOnError();
+    void testYield();
     void testOnTransferProgress();
     void testOnDone();
+    void testPeerSession();
 
 private:
 
@@ -78,6 +80,7 @@ public slots:
     bool start();
     void stop();
     void abort(Sync::SyncStatus aStatus = Sync::SYNC_ABORTED);
+    bool yield();
     bool cleanUp();
     SyncResults syncResults();
     SyncPluginBase *plugin();
@@ -0,0 +1,168 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "TaskExecutorTest.h"
+
+using namespace Buteo;
+
+bool TaskExecutorTest::waitFinished(const QList<ExecutorTask*> &aTasks, int aTimeout)
+{
+    QTime timer;
+    timer.start();
+    while (timer.elapsed() < aTimeout)
+    {
+        bool finished = true;
+        foreach (ExecutorTask *task, aTasks)
+        {
+            finished = finished && task->isFinished();
+        }
+        if (finished)
+        {
+            return true;
+        }
+        QTest::qWait(10);
+    }
+    return false;
+}
+
+void TaskExecutorTest::testRunNow()
+{
+    ValueTask task(42);
+    task.setAutoDelete(false);
+    QSignalSpy spy(&task, SIGNAL(finished()));
+
+    task.runNow();
+
+    QVERIFY(task.isFinished());
+    QCOMPARE(task.result().toInt(), 42);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(task.iThread, QThread::currentThread());
+}
+
+void TaskExecutorTest::testSubmit()
+{
+    TaskExecutor executor(3);
+    QCOMPARE(executor.threadCount(), 3);
+
+    QList<ExecutorTask*> tasks;
+    for (int i = 0; i < 50; ++i)
+    {
+        ValueTask *task = new ValueTask(i);
+        task->setAutoDelete(false);
+        tasks.append(task);
+        QVERIFY(executor.submit(task));
+    }
+
+    QVERIFY(waitFinished(tasks));
+    for (int i = 0; i < tasks.count(); ++i)
+    {
+        ValueTask *task = static_cast<ValueTask*>(tasks.at(i));
+        QCOMPARE(task->result().toInt(), i);
+        QVERIFY(task->iThread != QThread::currentThread());
+    }
+    qDeleteAll(tasks);
+}
+
+void TaskExecutorTest::testStealing()
+{
+    TaskExecutor executor(2);
+    QSemaphore gate;
+
+    // The first task blocks one worker. Tasks queued behind it must be
+    // stolen by the other worker.
+    ValueTask *blocking = new ValueTask(0, &gate);
+    blocking->setAutoDelete(false);
+    QVERIFY(executor.submit(blocking));
+
+    QList<ExecutorTask*> tasks;
+    for (int i = 0; i < 10; ++i)
+    {
+        ValueTask *task = new ValueTask(i);
+        task->setAutoDelete(false);
+        tasks.append(task);
+        QVERIFY(executor.submit(task));
+    }
+
+    QVERIFY(waitFinished(tasks));
+    QVERIFY(!blocking->isFinished());
+
+    gate.release();
+    QVERIFY(waitFinished(QList<ExecutorTask*>() << blocking));
+
+    qDeleteAll(tasks);
+    delete blocking;
+}
+
+void TaskExecutorTest::testSubmitFromWorker()
+{
+    TaskExecutor executor(2);
+
+    QList<ValueTask*> children;
+    for (int i = 0; i < 5; ++i)
+    {
+        ValueTask *child = new ValueTask(i);
+        child->setAutoDelete(false);
+        children.append(child);
+    }
+
+    SpawningTask *parent = new SpawningTask(executor, children);
+    parent->setAutoDelete(false);
+    QVERIFY(executor.submit(parent));
+
+    QList<ExecutorTask*> all;
+    all << parent;
+    foreach (ValueTask *child, children)
+    {
+        all << child;
+    }
+    QVERIFY(waitFinished(all));
+    QCOMPARE(parent->result().toInt(), children.count());
+
+    qDeleteAll(all);
+}
+
+void TaskExecutorTest::testShutdown()
+{
+    TaskExecutor executor(1);
+    QSemaphore gate;
+
+    ValueTask *blocking = new ValueTask(0, &gate);
+    blocking->setAutoDelete(false);
+    QVERIFY(executor.submit(blocking));
+
+    QPointer<ExecutorTask> queued = new ValueTask(1);
+    QVERIFY(executor.submit(queued));
+
+    // Let the running task complete while shutdown waits for it.
+    gate.release();
+    executor.shutdown();
+
+    QVERIFY(queued.isNull() || !queued->isFinished());
+    ValueTask rejected(2);
+    rejected.setAutoDelete(false);
+    QVERIFY(!executor.submit(&rejected));
+
+    QVERIFY(waitFinished(QList<ExecutorTask*>() << blocking));
+    delete blocking;
+}
+
+QTEST_MAIN(Buteo::TaskExecutorTest)
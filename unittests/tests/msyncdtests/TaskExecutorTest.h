@@ -0,0 +1,99 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef TASKEXECUTORTEST_H
+#define TASKEXECUTORTEST_H
+
+#include <QtTest/QtTest>
+#include <QSemaphore>
+#include "TaskExecutor.h"
+
+namespace Buteo {
+
+//! Returns a fixed value, optionally blocking until released.
+class ValueTask : public ExecutorTask
+{
+public:
+    ValueTask(int aValue, QSemaphore *aGate = 0)
+        : iThread(0), iValue(aValue), iGate(aGate) { }
+
+    QThread *iThread;
+
+protected:
+    virtual QVariant run()
+    {
+        iThread = QThread::currentThread();
+        if (iGate)
+        {
+            iGate->acquire();
+        }
+        return iValue;
+    }
+
+private:
+    int iValue;
+    QSemaphore *iGate;
+};
+
+//! Submits child tasks from an executor thread.
+class SpawningTask : public ExecutorTask
+{
+public:
+    SpawningTask(TaskExecutor &aExecutor, QList<ValueTask*> &aChildren)
+        : iExecutor(aExecutor), iChildren(aChildren) { }
+
+protected:
+    virtual QVariant run()
+    {
+        foreach (ValueTask *child, iChildren)
+        {
+            iExecutor.submit(child);
+        }
+        return iChildren.count();
+    }
+
+private:
+    TaskExecutor &iExecutor;
+    QList<ValueTask*> &iChildren;
+};
+
+class TaskExecutorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testRunNow();
+    void testSubmit();
+    void testStealing();
+    void testSubmitFromWorker();
+    void testShutdown();
+
+private:
+
+    bool waitFinished(const QList<ExecutorTask*> &aTasks, int aTimeout = 5000);
+
+};
+
+}
+
+#endif // TASKEXECUTORTEST_H
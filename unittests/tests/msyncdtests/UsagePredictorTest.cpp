@@ -0,0 +1,159 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "UsagePredictorTest.h"
+#include "SyncProfile.h"
+#include "SyncLog.h"
+#include "SyncResults.h"
+#include "ProfileEngineDefs.h"
+
+#include <QSignalSpy>
+
+using namespace Buteo;
+
+static const QDate DAY(2026, 1, 5);
+
+static QDateTime at(int aDay, int aHour, int aMinute)
+{
+    return QDateTime(DAY.addDays(aDay), QTime(aHour, aMinute));
+}
+
+SyncProfile *UsagePredictorTest::createProfile(const QString &aName,
+                                               bool aPrefetch)
+{
+    SyncProfile *profile = new SyncProfile(aName);
+    profile->setBoolKey(KEY_PREFETCH, aPrefetch);
+    return profile;
+}
+
+void UsagePredictorTest::testPrediction()
+{
+    ManualClockPredictor predictor;
+    QScopedPointer<SyncProfile> mail(createProfile("mail", true));
+    predictor.addProfile(*mail);
+    QVERIFY(predictor.isTracked("mail"));
+
+    // Two days are not a pattern yet.
+    predictor.recordManualSync("mail", at(0, 8, 5));
+    predictor.recordManualSync("mail", at(1, 8, 20));
+    predictor.iNow = at(3, 7, 0);
+    QVERIFY(!predictor.nextPrefetch("mail").isValid());
+
+    // Several syncs on the same day count once.
+    predictor.recordManualSync("mail", at(1, 8, 25));
+    QVERIFY(!predictor.nextPrefetch("mail").isValid());
+
+    predictor.recordManualSync("mail", at(2, 8, 10));
+    QCOMPARE(predictor.nextPrefetch("mail"), at(3, 7, 50));
+
+    // Once the slot has started, the next prediction is for tomorrow.
+    predictor.iNow = at(3, 8, 0);
+    QCOMPARE(predictor.nextPrefetch("mail"), at(4, 7, 50));
+
+    // Old history is forgotten.
+    predictor.iNow = at(16, 7, 0);
+    QVERIFY(!predictor.nextPrefetch("mail").isValid());
+
+    predictor.removeProfile("mail");
+    QVERIFY(!predictor.isTracked("mail"));
+}
+
+void UsagePredictorTest::testNotTracked()
+{
+    ManualClockPredictor predictor;
+    QScopedPointer<SyncProfile> contacts(createProfile("contacts", false));
+    predictor.addProfile(*contacts);
+    QVERIFY(!predictor.isTracked("contacts"));
+
+    for (int day = 0; day < 5; ++day)
+    {
+        predictor.recordManualSync("contacts", at(day, 8, 0));
+    }
+    predictor.iNow = at(5, 7, 0);
+    QVERIFY(!predictor.nextPrefetch("contacts").isValid());
+}
+
+void UsagePredictorTest::testFreshSync()
+{
+    ManualClockPredictor predictor;
+    QScopedPointer<SyncProfile> calendar(createProfile("calendar", true));
+    predictor.addProfile(*calendar);
+    for (int day = 0; day < 3; ++day)
+    {
+        predictor.recordManualSync("calendar", at(day, 8, 0));
+    }
+
+    predictor.iNow = at(3, 7, 0);
+    predictor.recordSync("calendar", at(3, 7, 20));
+    QCOMPARE(predictor.nextPrefetch("calendar"), at(3, 7, 50));
+
+    // Synced recently enough before the predicted use.
+    predictor.recordSync("calendar", at(3, 7, 35));
+    QVERIFY(!predictor.nextPrefetch("calendar").isValid());
+}
+
+void UsagePredictorTest::testPrefetchDue()
+{
+    ManualClockPredictor predictor;
+    QSignalSpy spy(&predictor, SIGNAL(prefetchDue(const QString &)));
+    QScopedPointer<SyncProfile> mail(createProfile("mail", true));
+    predictor.addProfile(*mail);
+    for (int day = 0; day < 3; ++day)
+    {
+        predictor.recordManualSync("mail", at(day, 8, 40));
+    }
+
+    predictor.iNow = at(3, 8, 0);
+    predictor.onTimeout();
+    QCOMPARE(spy.count(), 0);
+
+    predictor.iNow = at(3, 8, 21);
+    predictor.onTimeout();
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QString("mail"));
+
+    // Only one prefetch per predicted slot.
+    predictor.onTimeout();
+    QCOMPARE(spy.count(), 1);
+}
+
+void UsagePredictorTest::testLearnFromLog()
+{
+    ManualClockPredictor predictor;
+    QScopedPointer<SyncProfile> mail(createProfile("mail", true));
+    SyncLog *log = new SyncLog("mail");
+    for (int day = 0; day < 4; ++day)
+    {
+        SyncResults results(at(day, 12, 10), SyncResults::SYNC_RESULT_SUCCESS,
+                            SyncResults::NO_ERROR);
+        // Scheduled syncs do not tell about the user.
+        results.setScheduled(day == 0);
+        log->addResults(results);
+    }
+    mail->setLog(log);
+
+    predictor.addProfile(*mail);
+    predictor.iNow = at(4, 9, 0);
+    QCOMPARE(predictor.nextPrefetch("mail"), at(4, 11, 50));
+}
+
+QTEST_MAIN(Buteo::UsagePredictorTest)
@@ -3,17 +3,32 @@ SUBDIRS = \
         AccountsHelperTest.pro \
         ClientPluginRunnerTest.pro \
         ClientThreadTest.pro \
+        CredentialBrokerTest.pro \
         PluginRunnerTest.pro \
         ServerActivatorTest.pro \
         ServerPluginRunnerTest.pro \
         ServerThreadTest.pro \
+        SessionLimiterTest.pro \
         StorageBookerTest.pro \
         SyncBackupTest.pro \
+        SyncDependencyGraphTest.pro \
+        SyncEventChannelTest.pro \
         SyncQueueTest.pro \
         SyncSessionTest.pro \
         SyncSigHandlerTest.pro \
         SynchronizerTest.pro \
+        TaskExecutorTest.pro \
         TransportTrackerTest.pro \
+        UsagePredictorTest.pro \
+        IdleExitTest.pro \
+        SessionPeerCacheTest.pro \
+        StatusStreamTest.pro \
+        ReplyCacheTest.pro \
+        StorageCycleMeterTest.pro \
+        PluginWatchdogTest.pro \
+        LiveResultsTest.pro \
+        DeadlineTimerTest.pro \
+        SyncOnChangeTest.pro \
 
 !contains(DEFINES, USE_KEEPALIVE) {
 SUBDIRS += \
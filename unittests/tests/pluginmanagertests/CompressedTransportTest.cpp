@@ -0,0 +1,217 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "CompressedTransportTest.h"
+#include "CompressedTransport.h"
+#include "StorageItem.h"
+#include "Profile.h"
+#include "SyncResults.h"
+#include "ProfileEngineDefs.h"
+
+#include <QBuffer>
+#include <QDomDocument>
+#include <zlib.h>
+
+using namespace Buteo;
+
+//! In-memory storage item used by the tests
+class MemoryItem : public StorageItem
+{
+public:
+    explicit MemoryItem( const QByteArray& aData ) : iData( aData ) { }
+
+    virtual bool write( qint64 aOffset, const QByteArray& aData )
+    {
+        iData.replace( aOffset, aData.size(), aData );
+        return true;
+    }
+
+    virtual bool read( qint64 aOffset, qint64 aLength, QByteArray& aData ) const
+    {
+        aData = iData.mid( aOffset, aLength );
+        return true;
+    }
+
+    virtual bool resize( qint64 aLen )
+    {
+        iData.resize( aLen );
+        return true;
+    }
+
+    virtual qint64 getSize() const
+    {
+        return iData.size();
+    }
+
+private:
+    QByteArray iData;
+};
+
+static QByteArray inflateData( const QByteArray& aData )
+{
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.next_in = Z_NULL;
+    stream.avail_in = 0;
+    // Detect zlib and gzip headers automatically.
+    if( inflateInit2( &stream, 15 + 32 ) != Z_OK ) {
+        return QByteArray();
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>( const_cast<char*>( aData.constData() ) );
+    stream.avail_in = aData.size();
+
+    QByteArray result;
+    char buffer[4096];
+    int status = Z_OK;
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>( buffer );
+        stream.avail_out = sizeof( buffer );
+        status = inflate( &stream, Z_NO_FLUSH );
+        result.append( buffer, sizeof( buffer ) - stream.avail_out );
+    } while( status == Z_OK );
+
+    inflateEnd( &stream );
+    return ( status == Z_STREAM_END ) ? result : QByteArray();
+}
+
+static QByteArray testPayload()
+{
+    QByteArray payload;
+    for( int i = 0; i < 2000; ++i ) {
+        payload.append( "BEGIN:VCARD\r\nVERSION:3.0\r\nFN:Contact " );
+        payload.append( QByteArray::number( i ) );
+        payload.append( "\r\nEND:VCARD\r\n" );
+    }
+    return payload;
+}
+
+void CompressedTransportTest::testNegotiate()
+{
+    Profile profile( "test", Profile::TYPE_CLIENT );
+    profile.setKey( KEY_COMPRESSION, "gzip, deflate" );
+
+    CompressedTransport transport( profile );
+    QCOMPARE( transport.acceptedEncodings(), QStringList() << "gzip" << "deflate" );
+
+    QCOMPARE( transport.negotiate( QStringList() << "deflate;q=1.0" << "br" ), QString( "deflate" ) );
+    QCOMPARE( transport.encoding(), QString( "deflate" ) );
+
+    QCOMPARE( transport.negotiate( QStringList() << "*" ), QString( "gzip" ) );
+
+    QCOMPARE( transport.negotiate( QStringList() << "br" ), CompressedTransport::IDENTITY );
+    QCOMPARE( transport.encoding(), CompressedTransport::IDENTITY );
+
+    // A quality value of zero refuses the encoding, also via "*".
+    QCOMPARE( transport.negotiate( QStringList() << "gzip;q=0" ), CompressedTransport::IDENTITY );
+    QCOMPARE( transport.negotiate( QStringList() << "gzip; q=0.0" << "deflate;q=0.5" ), QString( "deflate" ) );
+    QCOMPARE( transport.negotiate( QStringList() << "gzip;q=0" << "*" ), QString( "deflate" ) );
+    QCOMPARE( transport.negotiate( QStringList() << "*;q=0" ), CompressedTransport::IDENTITY );
+
+    // Without the profile key nothing is compressed.
+    Profile plain( "plain", Profile::TYPE_CLIENT );
+    CompressedTransport plainTransport( plain );
+    QCOMPARE( plainTransport.negotiate( QStringList() << "gzip" ), CompressedTransport::IDENTITY );
+}
+
+void CompressedTransportTest::testIdentity()
+{
+    Profile profile( "test", Profile::TYPE_CLIENT );
+    CompressedTransport transport( profile );
+
+    QByteArray payload = testPayload();
+    MemoryItem item( payload );
+
+    QBuffer output;
+    output.open( QIODevice::WriteOnly );
+    QVERIFY( transport.begin( output ) );
+    QVERIFY( transport.writeItem( item ) );
+    QVERIFY( transport.finish() );
+
+    QCOMPARE( output.data(), payload );
+    QCOMPARE( transport.uncompressedBytes(), qint64( payload.size() ) );
+    QCOMPARE( transport.compressedBytes(), qint64( payload.size() ) );
+}
+
+void CompressedTransportTest::testCompressItem()
+{
+    Profile profile( "test", Profile::TYPE_CLIENT );
+    profile.setKey( KEY_COMPRESSION, "gzip" );
+    profile.setKey( KEY_COMPRESSION_LEVEL, "9" );
+    CompressedTransport transport( profile );
+    QCOMPARE( transport.negotiate( QStringList() << "gzip" ), QString( "gzip" ) );
+
+    QByteArray payload = testPayload();
+    MemoryItem item1( payload );
+    MemoryItem item2( "tail" );
+
+    QBuffer output;
+    output.open( QIODevice::WriteOnly );
+    QVERIFY( transport.begin( output ) );
+    QVERIFY( transport.writeItem( item1 ) );
+    QVERIFY( transport.writeItem( item2 ) );
+    QVERIFY( transport.finish() );
+
+    // gzip magic bytes
+    QVERIFY( output.data().startsWith( "\x1f\x8b" ) );
+    QCOMPARE( inflateData( output.data() ), payload + "tail" );
+    QCOMPARE( transport.uncompressedBytes(), qint64( payload.size() + 4 ) );
+    QCOMPARE( transport.compressedBytes(), qint64( output.data().size() ) );
+    QVERIFY( transport.compressedBytes() < transport.uncompressedBytes() );
+}
+
+void CompressedTransportTest::testReportResults()
+{
+    Profile profile( "test", Profile::TYPE_CLIENT );
+    profile.setKey( KEY_COMPRESSION, "deflate" );
+    CompressedTransport transport( profile );
+    transport.negotiate( QStringList() << "deflate" );
+
+    QByteArray payload = testPayload();
+    QBuffer output;
+    output.open( QIODevice::WriteOnly );
+    QVERIFY( transport.begin( output ) );
+    QVERIFY( transport.write( payload.constData(), payload.size() ) );
+    QVERIFY( transport.finish() );
+
+    SyncResults results;
+    transport.reportTo( results );
+    QCOMPARE( results.uncompressedBytes(), qint64( payload.size() ) );
+    QCOMPARE( results.compressedBytes(), qint64( output.data().size() ) );
+    QCOMPARE( results.bytesSaved(), results.uncompressedBytes() - results.compressedBytes() );
+    QVERIFY( results.compressionRatio() > 1.0 );
+
+    // Reporting again does not count the same payload twice.
+    transport.reportTo( results );
+    QCOMPARE( results.uncompressedBytes(), qint64( payload.size() ) );
+    QCOMPARE( results.compressedBytes(), qint64( output.data().size() ) );
+
+    // Statistics survive the XML round trip used for out of process plugins.
+    QDomDocument doc;
+    SyncResults copy( results.toXml( doc ) );
+    QCOMPARE( copy.compressedBytes(), results.compressedBytes() );
+    QCOMPARE( copy.uncompressedBytes(), results.uncompressedBytes() );
+}
+
+QTEST_MAIN(Buteo::CompressedTransportTest)
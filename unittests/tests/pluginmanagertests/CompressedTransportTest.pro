@@ -0,0 +1,3 @@
+include(../testapplication.pri)
+
+LIBS += -lz
@@ -0,0 +1,176 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "ConflictResolverTest.h"
+#include "ConflictResolver.h"
+
+using namespace Buteo;
+
+static const QDateTime OLD_TIME = QDateTime::fromTime_t(100000);
+static const QDateTime NEW_TIME = QDateTime::fromTime_t(200000);
+
+void ConflictResolverTest::testOneSidedChanges()
+{
+    ConflictResolver resolver(SyncProfile::CR_POLICY_UNDEFINED);
+
+    QList<ItemChange> local;
+    local << ItemChange("c", ItemChange::DELETED, "1", QByteArray(), OLD_TIME)
+          << ItemChange("a", ItemChange::ADDED, "1", "ha", OLD_TIME);
+    QList<ItemChange> remote;
+    remote << ItemChange("b", ItemChange::MODIFIED, "2", "hb", OLD_TIME);
+
+    ApplyBatch localBatch;
+    ApplyBatch remoteBatch;
+    QCOMPARE(resolver.resolve(local, remote, localBatch, remoteBatch), 0);
+
+    QCOMPARE(remoteBatch.additions.size(), 1);
+    QCOMPARE(remoteBatch.additions.first().id, QString("a"));
+    QCOMPARE(remoteBatch.deletions.size(), 1);
+    QCOMPARE(remoteBatch.deletions.first().id, QString("c"));
+    QVERIFY(remoteBatch.modifications.isEmpty());
+
+    QCOMPARE(localBatch.modifications.size(), 1);
+    QCOMPARE(localBatch.modifications.first().id, QString("b"));
+    QVERIFY(localBatch.additions.isEmpty());
+    QVERIFY(localBatch.deletions.isEmpty());
+}
+
+void ConflictResolverTest::testIdenticalChanges()
+{
+    ConflictResolver resolver(SyncProfile::CR_POLICY_PREFER_LOCAL_CHANGES);
+
+    QList<ItemChange> local;
+    local << ItemChange("a", ItemChange::MODIFIED, "1", "same", OLD_TIME)
+          << ItemChange("b", ItemChange::DELETED, "1", QByteArray(), OLD_TIME);
+    QList<ItemChange> remote;
+    remote << ItemChange("a", ItemChange::MODIFIED, "7", "same", NEW_TIME)
+           << ItemChange("b", ItemChange::DELETED, "3", QByteArray(), NEW_TIME);
+
+    ApplyBatch localBatch;
+    ApplyBatch remoteBatch;
+    QCOMPARE(resolver.resolve(local, remote, localBatch, remoteBatch), 0);
+    QVERIFY(localBatch.isEmpty());
+    QVERIFY(remoteBatch.isEmpty());
+}
+
+void ConflictResolverTest::testPreferLocal()
+{
+    ConflictResolver resolver(SyncProfile::CR_POLICY_PREFER_LOCAL_CHANGES);
+
+    QList<ItemChange> local;
+    local << ItemChange("a", ItemChange::MODIFIED, "1", "l", OLD_TIME)
+          << ItemChange("b", ItemChange::MODIFIED, "1", "l", OLD_TIME);
+    QList<ItemChange> remote;
+    remote << ItemChange("a", ItemChange::MODIFIED, "1", "r", NEW_TIME)
+           << ItemChange("b", ItemChange::DELETED, "1", QByteArray(), NEW_TIME);
+
+    ApplyBatch localBatch;
+    ApplyBatch remoteBatch;
+    QCOMPARE(resolver.resolve(local, remote, localBatch, remoteBatch), 2);
+    QVERIFY(localBatch.isEmpty());
+    QCOMPARE(remoteBatch.modifications.size(), 1);
+    QCOMPARE(remoteBatch.modifications.first().id, QString("a"));
+    // Deleted remotely but local wins, the item has to be recreated.
+    QCOMPARE(remoteBatch.additions.size(), 1);
+    QCOMPARE(remoteBatch.additions.first().id, QString("b"));
+}
+
+void ConflictResolverTest::testPreferRemote()
+{
+    ConflictResolver resolver(SyncProfile::CR_POLICY_PREFER_REMOTE_CHANGES);
+
+    QList<ItemChange> local;
+    local << ItemChange("a", ItemChange::MODIFIED, "1", "l", NEW_TIME);
+    QList<ItemChange> remote;
+    remote << ItemChange("a", ItemChange::DELETED, "1", QByteArray(), OLD_TIME);
+
+    ApplyBatch localBatch;
+    ApplyBatch remoteBatch;
+    QCOMPARE(resolver.resolve(local, remote, localBatch, remoteBatch), 1);
+    QVERIFY(remoteBatch.isEmpty());
+    QCOMPARE(localBatch.deletions.size(), 1);
+    QCOMPARE(localBatch.deletions.first().id, QString("a"));
+}
+
+void ConflictResolverTest::testUndefinedPolicy()
+{
+    ConflictResolver resolver(SyncProfile::CR_POLICY_UNDEFINED);
+
+    QList<ItemChange> local;
+    local << ItemChange("a", ItemChange::MODIFIED, "1", "l", OLD_TIME)
+          << ItemChange("b", ItemChange::MODIFIED, "1", "l", NEW_TIME);
+    QList<ItemChange> remote;
+    remote << ItemChange("a", ItemChange::MODIFIED, "1", "r", NEW_TIME)
+           << ItemChange("b", ItemChange::MODIFIED, "1", "r", OLD_TIME);
+
+    ApplyBatch localBatch;
+    ApplyBatch remoteBatch;
+    QCOMPARE(resolver.resolve(local, remote, localBatch, remoteBatch), 2);
+    QCOMPARE(localBatch.modifications.size(), 1);
+    QCOMPARE(localBatch.modifications.first().id, QString("a"));
+    QCOMPARE(remoteBatch.modifications.size(), 1);
+    QCOMPARE(remoteBatch.modifications.first().id, QString("b"));
+}
+
+void ConflictResolverTest::testDuplicateIds()
+{
+    ConflictResolver resolver(SyncProfile::CR_POLICY_UNDEFINED);
+
+    QList<ItemChange> local;
+    local << ItemChange("a", ItemChange::ADDED, "1", "h1", OLD_TIME)
+          << ItemChange("a", ItemChange::MODIFIED, "2", "h2", NEW_TIME);
+
+    ApplyBatch localBatch;
+    ApplyBatch remoteBatch;
+    QCOMPARE(resolver.resolve(local, QList<ItemChange>(), localBatch, remoteBatch), 0);
+    QVERIFY(localBatch.isEmpty());
+    QVERIFY(remoteBatch.modifications.isEmpty());
+    QCOMPARE(remoteBatch.additions.size(), 1);
+    QCOMPARE(remoteBatch.additions.first().version, QString("2"));
+    QCOMPARE(remoteBatch.additions.first().hash, QByteArray("h2"));
+
+    // Added and deleted again, nothing to send.
+    local.clear();
+    local << ItemChange("b", ItemChange::ADDED, "1", "h1", OLD_TIME)
+          << ItemChange("c", ItemChange::DELETED, "1", "", OLD_TIME)
+          << ItemChange("b", ItemChange::MODIFIED, "2", "h2", OLD_TIME)
+          << ItemChange("b", ItemChange::DELETED, "3", "", NEW_TIME);
+    ApplyBatch remoteBatch2;
+    QCOMPARE(resolver.resolve(local, QList<ItemChange>(), localBatch, remoteBatch2), 0);
+    QVERIFY(remoteBatch2.additions.isEmpty());
+    QVERIFY(remoteBatch2.modifications.isEmpty());
+    QCOMPARE(remoteBatch2.deletions.size(), 1);
+    QCOMPARE(remoteBatch2.deletions.first().id, QString("c"));
+
+    // Deleted and added again, the other side has the item.
+    local.clear();
+    local << ItemChange("d", ItemChange::DELETED, "1", "", OLD_TIME)
+          << ItemChange("d", ItemChange::ADDED, "2", "h2", NEW_TIME);
+    ApplyBatch remoteBatch3;
+    QCOMPARE(resolver.resolve(local, QList<ItemChange>(), localBatch, remoteBatch3), 0);
+    QVERIFY(remoteBatch3.additions.isEmpty());
+    QVERIFY(remoteBatch3.deletions.isEmpty());
+    QCOMPARE(remoteBatch3.modifications.size(), 1);
+    QCOMPARE(remoteBatch3.modifications.first().version, QString("2"));
+}
+
+QTEST_MAIN(Buteo::ConflictResolverTest)
@@ -0,0 +1,147 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "FingerprintCacheTest.h"
+#include "FingerprintCache.h"
+#include "StorageItem.h"
+
+using namespace Buteo;
+
+const QString DBFILE("/tmp/fingerprintcachetest.db");
+const QString PROFILE("testprofile");
+const QString STORAGE("hcontacts");
+
+//! In-memory storage item used by the tests
+class MemoryItem : public StorageItem
+{
+public:
+    MemoryItem( const QString& aId, const QByteArray& aData ) : iData( aData )
+    {
+        setId( aId );
+    }
+
+    virtual bool write( qint64 aOffset, const QByteArray& aData )
+    {
+        iData.replace( aOffset, aData.size(), aData );
+        return true;
+    }
+
+    virtual bool read( qint64 aOffset, qint64 aLength, QByteArray& aData ) const
+    {
+        aData = iData.mid( aOffset, aLength );
+        return true;
+    }
+
+    virtual bool resize( qint64 aLen )
+    {
+        iData.resize( aLen );
+        return true;
+    }
+
+    virtual qint64 getSize() const
+    {
+        return iData.size();
+    }
+
+private:
+    QByteArray iData;
+};
+
+void FingerprintCacheTest::init()
+{
+    QFile::remove( DBFILE );
+    iCache = new FingerprintCache;
+    QVERIFY( iCache->init( DBFILE, PROFILE, STORAGE ) );
+}
+
+void FingerprintCacheTest::cleanup()
+{
+    delete iCache;
+    iCache = NULL;
+    QFile::remove( DBFILE );
+}
+
+void FingerprintCacheTest::testContentHash()
+{
+    MemoryItem item( "1", "BEGIN:VCARD\nFN:Foo\nEND:VCARD" );
+    QByteArray hash = FingerprintCache::contentHash( item );
+
+    QVERIFY( !hash.isEmpty() );
+    QCOMPARE( hash, FingerprintCache::contentHash( QByteArray( "BEGIN:VCARD\nFN:Foo\nEND:VCARD" ) ) );
+    QVERIFY( hash != FingerprintCache::contentHash( QByteArray( "BEGIN:VCARD\nFN:Bar\nEND:VCARD" ) ) );
+}
+
+void FingerprintCacheTest::testUpdateAndMatch()
+{
+    MemoryItem item1( "1", "foo" );
+    MemoryItem item2( "2", "bar" );
+    QList<StorageItem*> items;
+    items << &item1 << &item2;
+    QVERIFY( iCache->update( items ) );
+
+    QCOMPARE( iCache->fingerprint( "1" ), FingerprintCache::contentHash( QByteArray( "foo" ) ) );
+    QCOMPARE( iCache->itemsWithFingerprint( FingerprintCache::contentHash( QByteArray( "bar" ) ) ),
+              QList<QString>() << "2" );
+
+    QMap<QString, QByteArray> incoming;
+    incoming.insert( "1", FingerprintCache::contentHash( QByteArray( "foo" ) ) );
+    incoming.insert( "2", FingerprintCache::contentHash( QByteArray( "changed" ) ) );
+    incoming.insert( "3", FingerprintCache::contentHash( QByteArray( "new" ) ) );
+
+    QCOMPARE( iCache->matchingItems( incoming ), QList<QString>() << "1" );
+}
+
+void FingerprintCacheTest::testPersistence()
+{
+    MemoryItem item( "1", "foo" );
+    QList<StorageItem*> items;
+    items << &item;
+    QVERIFY( iCache->update( items ) );
+    QVERIFY( iCache->uninit() );
+
+    // Other storages of the same profile do not see the fingerprints.
+    QVERIFY( iCache->init( DBFILE, PROFILE, "hcalendar" ) );
+    QVERIFY( iCache->fingerprint( "1" ).isEmpty() );
+    QVERIFY( iCache->uninit() );
+
+    QVERIFY( iCache->init( DBFILE, PROFILE, STORAGE ) );
+    QCOMPARE( iCache->fingerprint( "1" ), FingerprintCache::contentHash( QByteArray( "foo" ) ) );
+}
+
+void FingerprintCacheTest::testRemove()
+{
+    MemoryItem item1( "1", "foo" );
+    MemoryItem item2( "2", "bar" );
+    QList<StorageItem*> items;
+    items << &item1 << &item2;
+    QVERIFY( iCache->update( items ) );
+
+    QVERIFY( iCache->remove( QList<QString>() << "1" ) );
+    QVERIFY( iCache->fingerprint( "1" ).isEmpty() );
+    QVERIFY( iCache->itemsWithFingerprint( FingerprintCache::contentHash( QByteArray( "foo" ) ) ).isEmpty() );
+    QVERIFY( !iCache->fingerprint( "2" ).isEmpty() );
+
+    QVERIFY( iCache->clear() );
+    QVERIFY( iCache->fingerprint( "2" ).isEmpty() );
+}
+
+QTEST_MAIN(Buteo::FingerprintCacheTest)
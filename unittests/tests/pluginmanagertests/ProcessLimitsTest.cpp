@@ -0,0 +1,114 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "ProcessLimitsTest.h"
+#include "ProcessLimits.h"
+#include "SyncProfile.h"
+#include "ProfileEngineDefs.h"
+
+#include <QCoreApplication>
+#include <QProcess>
+
+using namespace Buteo;
+
+void ProcessLimitsTest::testNoLimits()
+{
+    SyncProfile profile( "profile" );
+    ProcessLimits limits = ProcessLimits::fromProfile( profile, "plugin" );
+    QVERIFY( limits.isEmpty() );
+    QCOMPARE( limits.ioClass(), ProcessLimits::IO_CLASS_NONE );
+    QVERIFY( limits.toString().isEmpty() );
+    QVERIFY( limits.prepare() );
+}
+
+void ProcessLimitsTest::testFromProfile()
+{
+    SyncProfile profile( "profile" );
+    Profile client( "plugin", Profile::TYPE_CLIENT );
+    client.setKey( KEY_NICE, "10" );
+    client.setKey( KEY_IO_CLASS, "best-effort" );
+    client.setKey( KEY_IO_PRIORITY, "9" );
+    client.setKey( KEY_CPU_LIMIT, "60" );
+    client.setKey( KEY_MEMORY_LIMIT, "-1" );
+    profile.merge( client );
+
+    ProcessLimits limits = ProcessLimits::fromProfile( profile, "plugin" );
+    QVERIFY( !limits.isEmpty() );
+    QCOMPARE( limits.nice(), 10 );
+    QCOMPARE( limits.ioClass(), ProcessLimits::IO_CLASS_BEST_EFFORT );
+    // Out of range values are clamped or ignored.
+    QCOMPARE( limits.ioPriority(), 7 );
+    QCOMPARE( limits.cpuLimit(), qint64( 60 ) );
+    QCOMPARE( limits.memoryLimit(), qint64( 0 ) );
+    QCOMPARE( limits.toString(), QString( "nice=10 io=best-effort/7 cpu=60s" ) );
+
+    // Server profiles carry the keys themselves.
+    Profile server( "server", Profile::TYPE_SERVER );
+    server.setKey( KEY_IO_CLASS, "idle" );
+    limits = ProcessLimits::fromProfile( server, "server" );
+    QCOMPARE( limits.ioClass(), ProcessLimits::IO_CLASS_IDLE );
+    QCOMPARE( limits.nice(), 0 );
+}
+
+void ProcessLimitsTest::testApply()
+{
+    SyncProfile profile( "profile" );
+    Profile client( "plugin", Profile::TYPE_CLIENT );
+    client.setKey( KEY_CPU_LIMIT, "100" );
+    client.setKey( KEY_MEMORY_LIMIT, "4096" );
+    profile.merge( client );
+
+    ProcessLimits limits = ProcessLimits::fromProfile( profile, "plugin" );
+    QVERIFY( limits.prepare() );
+
+    LimitedProcess process( limits );
+    process.start( "/bin/sh", QStringList() << "-c" << "ulimit -t; ulimit -v" );
+    QVERIFY( process.waitForFinished() );
+    QCOMPARE( process.readAllStandardOutput(), QByteArray( "100\n4194304\n" ) );
+}
+
+void ProcessLimitsTest::testUsage()
+{
+    ProcessLimits::Usage usage = ProcessLimits::usage( QCoreApplication::applicationPid() );
+    QVERIFY( usage.valid );
+    QVERIFY( usage.cpuTime >= 0 );
+    QVERIFY( usage.peakMemory > 0 );
+
+    QVERIFY( !ProcessLimits::usage( -1 ).valid );
+}
+
+void ProcessLimitsTest::testChildrenUsage()
+{
+    ProcessLimits::Usage before = ProcessLimits::childrenUsage();
+    QVERIFY( before.valid );
+
+    // Exited children are accounted once they have been waited for.
+    QCOMPARE( QProcess::execute( "sh", QStringList() << "-c" <<
+        "i=0; while [ $i -lt 100000 ]; do i=$((i+1)); done" ), 0 );
+
+    ProcessLimits::Usage after = ProcessLimits::childrenUsage();
+    QVERIFY( after.valid );
+    QVERIFY( after.cpuTime > before.cpuTime );
+    QVERIFY( after.peakMemory > 0 );
+}
+
+QTEST_MAIN(Buteo::ProcessLimitsTest)
@@ -0,0 +1,124 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "WritePacerTest.h"
+#include "WritePacer.h"
+
+using namespace Buteo;
+
+//! Pacer that records the pauses instead of sleeping
+class RecordingPacer : public WritePacer
+{
+public:
+    QList<int> iSleeps;
+
+protected:
+    virtual void sleep( int aMsecs ) { iSleeps.append( aMsecs ); }
+};
+
+void WritePacerTest::cleanup()
+{
+    WritePacer::setActivity( WritePacer::ACTIVITY_UNKNOWN );
+    WritePacer::setCharging( false );
+}
+
+void WritePacerTest::testMode()
+{
+    QCOMPARE( WritePacer::mode(), WritePacer::MODE_NORMAL );
+
+    WritePacer::setCharging( true );
+    QCOMPARE( WritePacer::mode(), WritePacer::MODE_RELAXED );
+
+    // Foreground activity wins over charging.
+    WritePacer::setActivity( WritePacer::ACTIVITY_FOREGROUND );
+    QCOMPARE( WritePacer::mode(), WritePacer::MODE_FOREGROUND );
+
+    WritePacer::setCharging( false );
+    WritePacer::setActivity( WritePacer::ACTIVITY_IDLE );
+    QCOMPARE( WritePacer::mode(), WritePacer::MODE_RELAXED );
+}
+
+void WritePacerTest::testAdapt()
+{
+    WritePacer pacer;
+    QCOMPARE( pacer.chunkSize(), 32 );
+
+    // Fast full chunks grow the chunk size up to the limit.
+    pacer.chunkCommitted( 32, 10 );
+    QCOMPARE( pacer.chunkSize(), 48 );
+    for( int i = 0; i < 10; ++i ) {
+        pacer.chunkCommitted( pacer.chunkSize(), 10 );
+    }
+    QCOMPARE( pacer.chunkSize(), 128 );
+
+    // Partial chunks do not grow it.
+    pacer.chunkCommitted( 5, 1 );
+    QCOMPARE( pacer.chunkSize(), 128 );
+
+    // Slow chunks halve it.
+    pacer.chunkCommitted( 128, 300 );
+    QCOMPARE( pacer.chunkSize(), 64 );
+    pacer.chunkCommitted( 64, 80 );
+    QCOMPARE( pacer.chunkSize(), 64 );
+
+    // Foreground activity caps it.
+    WritePacer::setActivity( WritePacer::ACTIVITY_FOREGROUND );
+    QCOMPARE( pacer.chunkSize(), 16 );
+    pacer.chunkCommitted( 16, 100 );
+    QCOMPARE( pacer.chunkSize(), 8 );
+    for( int i = 0; i < 10; ++i ) {
+        pacer.chunkCommitted( pacer.chunkSize(), 100 );
+    }
+    QCOMPARE( pacer.chunkSize(), 1 );
+
+    // Idle device allows large chunks.
+    WritePacer::setActivity( WritePacer::ACTIVITY_IDLE );
+    for( int i = 0; i < 30; ++i ) {
+        pacer.chunkCommitted( pacer.chunkSize(), 10 );
+    }
+    QCOMPARE( pacer.chunkSize(), 1024 );
+}
+
+void WritePacerTest::testPause()
+{
+    RecordingPacer pacer;
+    pacer.wait();
+    QVERIFY( pacer.iSleeps.isEmpty() );
+
+    pacer.chunkCommitted( 32, 40 );
+    QCOMPARE( pacer.pause(), 40 );
+
+    WritePacer::setActivity( WritePacer::ACTIVITY_FOREGROUND );
+    QCOMPARE( pacer.pause(), 250 );
+    pacer.chunkCommitted( 16, 100 );
+    QCOMPARE( pacer.pause(), 400 );
+    pacer.chunkCommitted( 8, 5000 );
+    QCOMPARE( pacer.pause(), 2000 );
+    pacer.wait();
+    QCOMPARE( pacer.iSleeps, QList<int>() << 2000 );
+
+    WritePacer::setCharging( true );
+    WritePacer::setActivity( WritePacer::ACTIVITY_UNKNOWN );
+    QCOMPARE( pacer.pause(), 0 );
+}
+
+QTEST_MAIN(Buteo::WritePacerTest)
@@ -1,9 +1,14 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         ClientPluginTest.pro \
+        CompressedTransportTest.pro \
+        ConflictResolverTest.pro \
         DeletedItemsIdStorageTest.pro \
+        FingerprintCacheTest.pro \
+        ProcessLimitsTest.pro \
         ServerPluginTest.pro \
         StoragePluginTest.pro \
+        WritePacerTest.pro \
 
 coverage.CONFIG += recursive
 QMAKE_EXTRA_TARGETS += coverage
@@ -0,0 +1,195 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "ProfileCodecTest.h"
+#include "ProfileCodec.h"
+#include "SyncProfile.h"
+#include "SyncLog.h"
+#include "ProfileEngineDefs.h"
+
+#include <QDomDocument>
+
+using namespace Buteo;
+
+static const QString PROFILE_XML =
+    "<profile type=\"sync\" name=\"ovi-calendar\" >"
+        "<key value=\"true\" name=\"enabled\" />"
+        "<key value=\"contacts\" name=\"run_after\" />"
+        "<key value=\"notes\" name=\"run_after\" />"
+
+        "<profile type=\"client\" name=\"syncml\">"
+            "<key value=\"two-way\" name=\"Sync Direction\" />"
+        "</profile>"
+
+        "<profile type=\"storage\" name=\"hcalendar\" >"
+            "<key value=\"true\" name=\"enabled\" />"
+            "<key value=\"cal-backend\" name=\"backend\" />"
+        "</profile>"
+
+        "<schedule time=\"12:34:56\" interval=\"30\" days=\"1,2,3,4,5,6\" />"
+    "</profile>";
+
+static const QString CLIENT_XML =
+    "<profile type=\"client\" name=\"syncml\">"
+        "<key value=\"http\" name=\"transport\" />"
+        "<profile type=\"storage\" name=\"hnotes\" >"
+            "<key value=\"notes-backend\" name=\"backend\" />"
+        "</profile>"
+    "</profile>";
+
+void ProfileCodecTest::testElement()
+{
+    QDomDocument doc;
+    QVERIFY(doc.setContent(QString::fromUtf8(
+        "<root a=\"1\" b=\"\xc3\xa4\xc3\xb6\">"
+            "<child a=\"1\">text</child>"
+            "<child a=\"2\" />"
+        "</root>"), false));
+
+    QByteArray data = ProfileCodec::encodeElement(doc.documentElement());
+    QDomDocument decodedDoc;
+    QDomElement root = ProfileCodec::decodeElement(data, decodedDoc);
+    QVERIFY(!root.isNull());
+    QCOMPARE(root.tagName(), QString("root"));
+    QCOMPARE(root.attributes().count(), 2);
+    QCOMPARE(root.attribute("a"), QString("1"));
+    QCOMPARE(root.attribute("b"), QString::fromUtf8("\xc3\xa4\xc3\xb6"));
+
+    QDomElement child = root.firstChildElement("child");
+    QCOMPARE(child.attribute("a"), QString("1"));
+    QCOMPARE(child.text(), QString("text"));
+    child = child.nextSiblingElement("child");
+    QCOMPARE(child.attribute("a"), QString("2"));
+    QVERIFY(!child.hasChildNodes());
+    QVERIFY(child.nextSiblingElement().isNull());
+}
+
+void ProfileCodecTest::testSyncProfile()
+{
+    QDomDocument doc;
+    QVERIFY(doc.setContent(PROFILE_XML, false));
+    SyncProfile profile(doc.documentElement());
+
+    // Merge a sub-profile, as ProfileManager::expand does.
+    QDomDocument clientDoc;
+    QVERIFY(clientDoc.setContent(CLIENT_XML, false));
+    Profile client(clientDoc.documentElement());
+    profile.merge(client);
+    profile.setLoaded(true);
+    profile.clientProfile()->setKey(KEY_SYNC_DIRECTION, VALUE_FROM_REMOTE);
+
+    SyncLog *log = new SyncLog(profile.name());
+    log->addResults(SyncResults(QDateTime::currentDateTime(),
+                                SyncResults::SYNC_RESULT_SUCCESS,
+                                SyncResults::NO_ERROR));
+    profile.setLog(log);
+
+    QByteArray data = ProfileCodec::encode(profile);
+    QVERIFY(data.size() < profile.toString().toUtf8().size());
+
+    QScopedPointer<Profile> decoded(ProfileCodec::decode(data));
+    QVERIFY(decoded != 0);
+    QCOMPARE(decoded->type(), Profile::TYPE_SYNC);
+    QCOMPARE(decoded->name(), profile.name());
+    QVERIFY(decoded->isLoaded());
+
+    SyncProfile *syncProfile = static_cast<SyncProfile*>(decoded.data());
+    QCOMPARE(syncProfile->keyValues(KEY_RUN_AFTER), profile.keyValues(KEY_RUN_AFTER));
+    QCOMPARE(syncProfile->syncSchedule().interval(), (unsigned)30);
+    QCOMPARE(syncProfile->syncDirection(), SyncProfile::SYNC_DIRECTION_FROM_REMOTE);
+    QCOMPARE(syncProfile->clientProfile()->key("transport"), QString("http"));
+    QCOMPARE(syncProfile->storageBackendNames(), profile.storageBackendNames());
+    QCOMPARE(syncProfile->subProfileNames(), profile.subProfileNames());
+    foreach (const Profile *sub, syncProfile->allSubProfiles())
+    {
+        QVERIFY(sub->isLoaded());
+    }
+
+    // Merged contents stay merged, so saving writes the same file.
+    QDomDocument localDoc;
+    localDoc.appendChild(profile.toXml(localDoc, true));
+    QDomDocument decodedLocalDoc;
+    decodedLocalDoc.appendChild(syncProfile->toXml(decodedLocalDoc, true));
+    QCOMPARE(decodedLocalDoc.toString(), localDoc.toString());
+    QVERIFY(!decodedLocalDoc.toString().contains("transport"));
+    QVERIFY(!decodedLocalDoc.toString().contains("hnotes"));
+    QVERIFY(syncProfile->subProfile("hnotes", Profile::TYPE_STORAGE) != 0);
+    QCOMPARE(syncProfile->subProfile("hnotes", Profile::TYPE_STORAGE)->key("backend"),
+             QString("notes-backend"));
+
+    QVERIFY(syncProfile->log() != 0);
+    QVERIFY(syncProfile->lastResults() != 0);
+    QCOMPARE(syncProfile->lastResults()->majorCode(), (int)SyncResults::SYNC_RESULT_SUCCESS);
+}
+
+void ProfileCodecTest::testLogSummary()
+{
+    QDomDocument doc;
+    QVERIFY(doc.setContent(PROFILE_XML, false));
+    SyncProfile profile(doc.documentElement());
+
+    QDateTime failed = QDateTime::currentDateTime();
+    QDateTime succeeded = failed.addSecs(-60);
+    SyncResults success(succeeded, SyncResults::SYNC_RESULT_SUCCESS,
+                        SyncResults::NO_ERROR);
+    success.addTargetResults(TargetResults("hcontacts", ItemCounts(1, 2, 3),
+                                           ItemCounts(4, 5, 6)));
+    SyncLog *log = new SyncLog(profile.name());
+    log->addResults(success);
+    log->addResults(SyncResults(failed, SyncResults::SYNC_RESULT_FAILED,
+                                SyncResults::CONNECTION_ERROR));
+    profile.setLog(log);
+
+    QByteArray data = ProfileCodec::encode(profile, ProfileCodec::LOG_SUMMARY);
+    QVERIFY(data.size() < ProfileCodec::encode(profile).size());
+
+    QScopedPointer<Profile> decoded(ProfileCodec::decode(data));
+    QVERIFY(decoded != 0);
+    SyncProfile *syncProfile = static_cast<SyncProfile*>(decoded.data());
+    QVERIFY(syncProfile->log() != 0);
+    QCOMPARE(syncProfile->log()->allResults().size(), 2);
+    QCOMPARE(syncProfile->lastSyncTime().toTime_t(), failed.toTime_t());
+    QCOMPARE(syncProfile->lastSuccessfulSyncTime().toTime_t(), succeeded.toTime_t());
+    QCOMPARE(syncProfile->lastResults()->majorCode(), (int)SyncResults::SYNC_RESULT_FAILED);
+    QVERIFY(syncProfile->log()->allResults().first()->targetResults().isEmpty());
+}
+
+void ProfileCodecTest::testInvalidData()
+{
+    SyncProfile profile("invalid");
+    profile.setKey(KEY_ENABLED, BOOLEAN_TRUE);
+    QByteArray data = ProfileCodec::encode(profile);
+
+    QScopedPointer<Profile> decoded(ProfileCodec::decode(data));
+    QVERIFY(decoded != 0);
+
+    QVERIFY(ProfileCodec::decode(QByteArray()) == 0);
+    QVERIFY(ProfileCodec::decode(data.left(data.size() - 1)) == 0);
+    QVERIFY(ProfileCodec::decode(data + 'x') == 0);
+    QVERIFY(ProfileCodec::decode(profile.toString().toUtf8()) == 0);
+
+    QByteArray otherVersion = data;
+    otherVersion[3] = char(ProfileCodec::FORMAT_VERSION + 1);
+    QVERIFY(ProfileCodec::decode(otherVersion) == 0);
+}
+
+QTEST_MAIN(Buteo::ProfileCodecTest)
@@ -70,4 +70,37 @@ void ProfileFieldTest::testField()
     QCOMPARE(doc.toString(), doc2.toString());
 }
 
+void ProfileFieldTest::testTypedValidation()
+{
+    QDomDocument doc;
+
+    // Boolean options are added automatically.
+    QVERIFY(doc.setContent(QString("<field name=\"enabled\" type=\"boolean\"/>"), false));
+    ProfileField boolField(doc.documentElement());
+    QCOMPARE(boolField.validate("true"), true);
+    QCOMPARE(boolField.validate("false"), true);
+    QCOMPARE(boolField.validate("yes"), false);
+    QCOMPARE(boolField.validate(""), false);
+
+    QVERIFY(doc.setContent(QString("<field name=\"port\" type=\"integer\"/>"), false));
+    ProfileField intField(doc.documentElement());
+    QCOMPARE(intField.validate("8080"), true);
+    QCOMPARE(intField.validate("-1"), true);
+    QCOMPARE(intField.validate("80a"), false);
+
+    // Options take precedence over the type.
+    QVERIFY(doc.setContent(QString("<field name=\"interval\" type=\"integer\">"
+        "<option>15</option><option>30</option></field>"), false));
+    ProfileField optionField(doc.documentElement());
+    ProfileField optionCopy(optionField);
+    QCOMPARE(optionCopy.validate("30"), true);
+    QCOMPARE(optionCopy.validate("45"), false);
+
+    // Without options and type any value but an empty one is accepted.
+    QVERIFY(doc.setContent(QString("<field name=\"name\"/>"), false));
+    ProfileField anyField(doc.documentElement());
+    QCOMPARE(anyField.validate("anything"), true);
+    QCOMPARE(anyField.validate(""), false);
+}
+
 QTEST_MAIN(Buteo::ProfileFieldTest)
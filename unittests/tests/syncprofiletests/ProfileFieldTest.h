@@ -34,6 +34,7 @@ class ProfileFieldTest: public QObject
 private slots:
 
     void testField();
+    void testTypedValidation();
 
 };
 
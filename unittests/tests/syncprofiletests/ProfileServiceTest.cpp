@@ -0,0 +1,181 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#include "ProfileServiceTest.h"
+#include "ProfileService.h"
+#include "ProfileManager.h"
+#include "SyncProfile.h"
+#include "ProfileEngineDefs.h"
+
+#include <QScopedPointer>
+#include <QFile>
+
+using namespace Buteo;
+
+static const QString OVI_CALENDAR = "ovi-calendar";
+static const QString USERPROFILE_DIR = "syncprofiletests/testprofiles/user";
+static const QString SERVICE_DIR = USERPROFILE_DIR + "/service";
+
+void ProfileServiceTest::cleanupTestCase()
+{
+    QFile::remove(SERVICE_DIR + "/sync/" + OVI_CALENDAR + ".xml");
+}
+
+void ProfileServiceTest::testRead()
+{
+    ProfileManager pm(SERVICE_DIR, USERPROFILE_DIR);
+    ProfileService service(pm);
+
+    QVERIFY(service.profileNames().contains(OVI_CALENDAR));
+    QVERIFY(service.exists(OVI_CALENDAR));
+    QVERIFY(service.exists(OVI_CALENDAR + "/hcalendar"));
+    QVERIFY(!service.exists(OVI_CALENDAR + "/unknown"));
+    QVERIFY(!service.exists("unknown"));
+
+    QCOMPARE(service.value(OVI_CALENDAR, KEY_DESTINATION_TYPE), QString("online"));
+    QCOMPARE(service.value(OVI_CALENDAR + "/hcalendar", "Notebook Name"),
+             QString("myNotebook"));
+    QCOMPARE(service.value(OVI_CALENDAR, "unknown", "default"), QString("default"));
+    QCOMPARE(service.value("unknown", KEY_ENABLED, "default"), QString("default"));
+    QVERIFY(service.boolValue(OVI_CALENDAR, KEY_ENABLED));
+    QVERIFY(!service.boolValue(OVI_CALENDAR + "/syncml", "use_wbxml", true));
+    QCOMPARE(service.intValue(OVI_CALENDAR, "unknown", 5), 5);
+
+    QScopedPointer<SyncProfile> profile(service.syncProfile(OVI_CALENDAR));
+    QVERIFY(profile != 0);
+    QCOMPARE(profile->name(), OVI_CALENDAR);
+}
+
+void ProfileServiceTest::testCommit()
+{
+    ProfileManager pm(SERVICE_DIR, USERPROFILE_DIR);
+    ProfileService service(pm);
+
+    ProfileTransaction transaction(OVI_CALENDAR);
+    transaction.setIntValue(OVI_CALENDAR, "sync_counter", 3);
+    transaction.setBoolValue(OVI_CALENDAR + "/syncml", "use_wbxml", true);
+    transaction.setValues(OVI_CALENDAR, KEY_RUN_AFTER, QStringList() << "a" << "b");
+    QVERIFY(service.commit(transaction));
+
+    QCOMPARE(service.intValue(OVI_CALENDAR, "sync_counter"), 3);
+    QVERIFY(service.boolValue(OVI_CALENDAR + "/syncml", "use_wbxml"));
+    QCOMPARE(service.values(OVI_CALENDAR, KEY_RUN_AFTER), QStringList() << "a" << "b");
+
+    // Changes are saved.
+    QScopedPointer<SyncProfile> saved(pm.syncProfile(OVI_CALENDAR));
+    QVERIFY(saved != 0);
+    QCOMPARE(saved->key("sync_counter"), QString("3"));
+
+    // A transaction with an invalid path changes nothing.
+    ProfileTransaction invalid(OVI_CALENDAR);
+    invalid.setIntValue(OVI_CALENDAR, "sync_counter", 4);
+    invalid.setValue(OVI_CALENDAR + "/unknown", "key", "value");
+    QVERIFY(!service.commit(invalid));
+    QCOMPARE(service.intValue(OVI_CALENDAR, "sync_counter"), 3);
+
+    QVERIFY(service.setValue(OVI_CALENDAR, "sync_counter", QString()));
+    QVERIFY(service.value(OVI_CALENDAR, "sync_counter").isNull());
+    QVERIFY(!service.setValue("unknown", "key", "value"));
+}
+
+void ProfileServiceTest::testRevision()
+{
+    ProfileManager pm(SERVICE_DIR, USERPROFILE_DIR);
+    ProfileService service(pm);
+
+    int revision = service.revision(OVI_CALENDAR);
+    ProfileTransaction first(OVI_CALENDAR, revision);
+    first.setValue(OVI_CALENDAR, "state", "first");
+    ProfileTransaction second(OVI_CALENDAR, revision);
+    second.setValue(OVI_CALENDAR, "state", "second");
+
+    QVERIFY(service.commit(first));
+    QVERIFY(service.revision(OVI_CALENDAR) != revision);
+    QVERIFY(!service.commit(second));
+    QCOMPARE(service.value(OVI_CALENDAR, "state"), QString("first"));
+
+    // Changes made through the manager are seen by the service.
+    revision = service.revision(OVI_CALENDAR);
+    QScopedPointer<SyncProfile> profile(pm.syncProfile(OVI_CALENDAR));
+    QVERIFY(profile != 0);
+    profile->setKey("state", "manager");
+    pm.updateProfile(*profile);
+    QVERIFY(service.revision(OVI_CALENDAR) != revision);
+    QCOMPARE(service.value(OVI_CALENDAR, "state"), QString("manager"));
+
+    QVERIFY(service.setValue(OVI_CALENDAR, "state", QString()));
+}
+
+void ProfileServiceTest::testWatch()
+{
+    ProfileManager pm(SERVICE_DIR, USERPROFILE_DIR);
+    ProfileService service(pm);
+    ProfileWatcher watcher;
+
+    service.watch(OVI_CALENDAR, &watcher, "changed");
+    QVERIFY(service.setValue(OVI_CALENDAR, "state", "watched"));
+    QCOMPARE(watcher.iProfiles, QStringList() << OVI_CALENDAR);
+    QCOMPARE(watcher.iKeys.last(), QStringList() << "state");
+
+    // Changed keys are not known for changes made through the manager.
+    QScopedPointer<SyncProfile> profile(pm.syncProfile(OVI_CALENDAR));
+    QVERIFY(profile != 0);
+    pm.updateProfile(*profile);
+    QCOMPARE(watcher.iProfiles.size(), 2);
+    QVERIFY(watcher.iKeys.last().isEmpty());
+
+    service.unwatch(&watcher);
+    QVERIFY(service.setValue(OVI_CALENDAR, "state", QString()));
+    QCOMPARE(watcher.iProfiles.size(), 2);
+}
+
+void ProfileServiceTest::testExternalChange()
+{
+    ProfileManager pm(SERVICE_DIR, USERPROFILE_DIR);
+    ProfileService service(pm);
+    QVERIFY(service.setValue(OVI_CALENDAR, "state", "service"));
+    int revision = service.revision(OVI_CALENDAR);
+
+    // Another process saves the profile, the daemon's manager does not
+    // report it. File times may only have a resolution of a second.
+    QTest::qWait(1100);
+    ProfileManager other(SERVICE_DIR, USERPROFILE_DIR);
+    QScopedPointer<SyncProfile> profile(other.syncProfile(OVI_CALENDAR));
+    QVERIFY(profile != 0);
+    profile->setKey("state", "external");
+    other.updateProfile(*profile);
+
+    // A commit does not overwrite the change with the cached profile.
+    QVERIFY(service.setValue(OVI_CALENDAR, "other", "value"));
+    QScopedPointer<SyncProfile> saved(other.syncProfile(OVI_CALENDAR));
+    QVERIFY(saved != 0);
+    QCOMPARE(saved->key("state"), QString("external"));
+    QCOMPARE(saved->key("other"), QString("value"));
+
+    QCOMPARE(service.value(OVI_CALENDAR, "state"), QString("external"));
+    QVERIFY(service.revision(OVI_CALENDAR) != revision);
+
+    QVERIFY(service.setValue(OVI_CALENDAR, "state", QString()));
+    QVERIFY(service.setValue(OVI_CALENDAR, "other", QString()));
+}
+
+QTEST_MAIN(Buteo::ProfileServiceTest)
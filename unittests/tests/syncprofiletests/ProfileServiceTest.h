@@ -0,0 +1,65 @@
+/*
+ * This file is part of buteo-syncfw package
+ *
+ * Copyright (C) 2010 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Sateesh Kavuri <sateesh.kavuri@nokia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+#ifndef PROFILESERVICETEST_H
+#define PROFILESERVICETEST_H
+
+#include <QtTest/QtTest>
+
+namespace Buteo {
+
+//! Records the changes reported by ProfileService::watch
+class ProfileWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    QStringList iProfiles;
+    QList<QStringList> iKeys;
+
+public slots:
+    void changed(const QString &aProfileName, const QStringList &aKeys)
+    {
+        iProfiles.append(aProfileName);
+        iKeys.append(aKeys);
+    }
+};
+
+class ProfileServiceTest: public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void cleanupTestCase();
+
+    void testRead();
+    void testCommit();
+    void testRevision();
+    void testWatch();
+    void testExternalChange();
+
+};
+
+}
+
+#endif // PROFILESERVICETEST_H
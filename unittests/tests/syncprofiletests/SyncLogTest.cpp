@@ -117,5 +117,41 @@ void SyncLogTest::testAddResults()
     
 }
 
+void SyncLogTest::testReplaceResults()
+{
+    SyncLog log(NAME);
+    QDateTime start = QDateTime::fromString("2009-09-15T16:33:57", Qt::ISODate);
+
+    // Checkpoint of a running session.
+    SyncResults checkpoint(start, SyncResults::SYNC_RESULT_INVALID,
+                           SyncResults::NO_ERROR);
+    checkpoint.addTargetResults(TargetResults("hcontacts", ItemCounts(1, 0, 0),
+                                ItemCounts(0, 0, 0)));
+    log.replaceResults(start, checkpoint);
+    QCOMPARE(log.allResults().size(), 1);
+
+    // A later checkpoint replaces the earlier one.
+    SyncResults checkpoint2(start, SyncResults::SYNC_RESULT_INVALID,
+                            SyncResults::NO_ERROR);
+    checkpoint2.addTargetResults(TargetResults("hcontacts", ItemCounts(3, 0, 0),
+                                 ItemCounts(0, 0, 0)));
+    log.replaceResults(start, checkpoint2);
+    QCOMPARE(log.allResults().size(), 1);
+    QCOMPARE(log.lastResults()->targetResults().at(0).localItems().added,
+             (unsigned)3);
+
+    // Final results replace the checkpoint.
+    SyncResults finalResults(start, SyncResults::SYNC_RESULT_SUCCESS,
+                            SyncResults::NO_ERROR);
+    log.replaceResults(start, finalResults);
+    QCOMPARE(log.allResults().size(), 1);
+    QCOMPARE(log.lastResults()->majorCode(),
+             (int)SyncResults::SYNC_RESULT_SUCCESS);
+
+    // Finished entries are never replaced.
+    log.replaceResults(start, checkpoint);
+    QCOMPARE(log.allResults().size(), 2);
+}
+
 
 QTEST_MAIN(Buteo::SyncLogTest)
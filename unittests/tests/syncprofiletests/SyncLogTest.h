@@ -35,6 +35,7 @@ private slots:
 
     void testLog();
     void testAddResults();
+    void testReplaceResults();
 
 };
 
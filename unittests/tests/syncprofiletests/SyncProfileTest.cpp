@@ -147,6 +147,11 @@ void SyncProfileTest::testProperties()
     p.setConflictResolutionPolicy(SyncProfile::CR_POLICY_PREFER_LOCAL_CHANGES);
     QCOMPARE(client->key(KEY_CONFLICT_RESOLUTION_POLICY), VALUE_PREFER_LOCAL);
     emptyProfile.setConflictResolutionPolicy(SyncProfile::CR_POLICY_PREFER_REMOTE_CHANGES);
+
+    // Dependencies.
+    QVERIFY(p.runAfter().isEmpty());
+    p.setRunAfter(QStringList() << "contacts" << p.name() << " photos " << "contacts");
+    QCOMPARE(p.runAfter(), QStringList() << "contacts" << "photos");
 }
 
 void SyncProfileTest::testResults()
@@ -1,9 +1,11 @@
 include(../tests_common.pri)
 TEMPLATE = subdirs
 SUBDIRS = \
+        ProfileCodecTest.pro \
         ProfileFactoryTest.pro \
         ProfileFieldTest.pro \
         ProfileManagerTest.pro \
+        ProfileServiceTest.pro \
         ProfileTest.pro \
         StorageProfileTest.pro \
         SyncLogTest.pro \